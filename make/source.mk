@@ -28,6 +28,7 @@ COMMON_SRC = \
             drivers/serial_pinconfig.c \
             drivers/serial_uart.c \
             drivers/serial_uart_pinconfig.c \
+            drivers/serial_uart_rxdma.c \
             drivers/sound_beeper.c \
             drivers/stack_check.c \
             drivers/system.c \
@@ -64,7 +65,9 @@ COMMON_SRC = \
             fc/controlrate_profile.c \
             drivers/camera_control.c \
             drivers/accgyro/gyro_sync.c \
+            drivers/accgyro/accgyro_fifo.c \
             drivers/pwm_esc_detect.c \
+            drivers/dshot.c \
             drivers/pwm_output.c \
             drivers/rx/rx_spi.c \
             drivers/rx/rx_xn297.c \
@@ -72,16 +75,19 @@ COMMON_SRC = \
             drivers/serial_softserial.c \
             fc/fc_core.c \
             fc/fc_rc.c \
+            fc/rc_prediction.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
             flight/position.c \
+            flight/position_estimator.c \
             flight/failsafe.c \
             flight/gps_rescue.c \
             flight/imu.c \
             flight/mixer.c \
             flight/mixer_tricopter.c \
             flight/pid.c \
+            flight/rpm_filter.c \
             flight/servos.c \
             flight/servos_tricopter.c \
             interface/cli.c \
@@ -110,6 +116,8 @@ COMMON_SRC = \
             sensors/compass.c \
             sensors/gyro.c \
             sensors/gyroanalyse.c \
+            sensors/gyro_jitter.c \
+            sensors/gyro_fusion.c \
             sensors/initialisation.c \
             blackbox/blackbox.c \
             blackbox/blackbox_encoding.c \
@@ -155,6 +163,7 @@ COMMON_SRC = \
             telemetry/ltm.c \
             telemetry/mavlink.c \
             telemetry/msp_shared.c \
+            telemetry/telemetry_scheduler.c \
             telemetry/ibus.c \
             telemetry/ibus_shared.c \
             sensors/esc_sensor.c \
@@ -185,6 +194,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             common/maths.c \
             common/typeconversion.c \
             drivers/accgyro/accgyro_fake.c \
+            drivers/accgyro/accgyro_fifo.c \
             drivers/accgyro/accgyro_mpu.c \
             drivers/accgyro/accgyro_mpu3050.c \
             drivers/accgyro/accgyro_mpu6050.c \
@@ -206,6 +216,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/bus_spi.c \
             drivers/exti.c \
             drivers/io.c \
+            drivers/dshot.c \
             drivers/pwm_output.c \
             drivers/rcc.c \
             drivers/serial.c \
@@ -215,11 +226,13 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             fc/fc_core.c \
             fc/fc_tasks.c \
             fc/fc_rc.c \
+            fc/rc_prediction.c \
             fc/rc_controls.c \
             fc/runtime_config.c \
             flight/imu.c \
             flight/mixer.c \
             flight/pid.c \
+            flight/rpm_filter.c \
             rx/ibus.c \
             rx/rx.c \
             rx/rx_spi.c \
@@ -235,6 +248,8 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/boardalignment.c \
             sensors/gyro.c \
             sensors/gyroanalyse.c \
+            sensors/gyro_jitter.c \
+            sensors/gyro_fusion.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
 
@@ -76,4 +76,10 @@ const char * const debugModeNames[DEBUG_COUNT] = {
     "RC_SMOOTHING_RATE",
     "ANTI_GRAVITY",
     "IMU",
+    "RPM_FILTER",
+    "POSITION_ESTIMATOR",
+    "GYRO_FIFO",
+    "GYRO_JITTER",
+    "GYRO_FUSION",
+    "IMUF_LINK",
 };
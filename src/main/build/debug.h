@@ -94,6 +94,12 @@ typedef enum {
     DEBUG_RC_SMOOTHING_RATE,
     DEBUG_ANTI_GRAVITY,
     DEBUG_IMU,
+    DEBUG_RPM_FILTER,
+    DEBUG_POSITION_ESTIMATOR,
+    DEBUG_GYRO_FIFO,
+    DEBUG_GYRO_JITTER,
+    DEBUG_GYRO_FUSION,
+    DEBUG_IMUF_LINK,
     DEBUG_COUNT
 } debugType_e;
 
@@ -48,6 +48,11 @@
 
 #include "flight/pid.h"
 
+#ifdef USE_GYRO_IMUF9001
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_imuf9001.h"
+#endif
+
 #include "sensors/gyro.h"
 
 
@@ -459,6 +464,7 @@ static long cmsx_menuImuf_onExit(const OSD_Entry *self)
     gyroConfigMutable()->imuf_pitch_lpf_cutoff_hz = gyroConfig_imuf_pitch_lpf_cutoff_hz;
     gyroConfigMutable()->imuf_yaw_lpf_cutoff_hz = gyroConfig_imuf_yaw_lpf_cutoff_hz;
     gyroConfigMutable()->imuf_acc_lpf_cutoff_hz = gyroConfig_imuf_acc_lpf_cutoff_hz;
+    imufRequestFilterUpdate();
     return 0;
 }
 #endif
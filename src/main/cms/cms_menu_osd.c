@@ -103,6 +103,9 @@ OSD_Entry menuOsdActiveElemsEntries[] =
     {"HEADING",            OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_NUMERICAL_HEADING], 0},
     {"VARIO",              OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_NUMERICAL_VARIO], 0},
     {"G-FORCE",            OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_G_FORCE], 0},
+#ifdef USE_GYRO_IMUF9001
+    {"IMUF ERRORS",        OME_VISIBLE, NULL, &osdConfig_item_pos[OSD_IMUF_ERRORS], 0},
+#endif
     {"BACK",               OME_Back,    NULL, NULL, 0},
     {NULL,                 OME_END,     NULL, NULL, 0}
 };
@@ -69,8 +69,7 @@ void pt1FilterUpdateCutoff(pt1Filter_t *filter, float k)
 
 FAST_CODE float pt1FilterApply(pt1Filter_t *filter, float input)
 {
-    filter->state = filter->state + filter->k * (input - filter->state);
-    return filter->state;
+    return pt1FilterApplyInline(filter, input);
 }
 
 // Slew filter with limit
@@ -206,10 +205,7 @@ FAST_CODE float biquadFilterApplyDF1(biquadFilter_t *filter, float input)
 /* Computes a biquadFilter_t filter in direct form 2 on a sample (higher precision but can't handle changes in coefficients */
 FAST_CODE float biquadFilterApply(biquadFilter_t *filter, float input)
 {
-    const float result = filter->b0 * input + filter->x1;
-    filter->x1 = filter->b1 * input - filter->a1 * result + filter->x2;
-    filter->x2 = filter->b2 * input - filter->a2 * result;
-    return result;
+    return biquadFilterApplyInline(filter, input);
 }
 
 void laggedMovingAverageInit(laggedMovingAverage_t *filter, uint16_t windowSize, float *buf)
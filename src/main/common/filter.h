@@ -108,5 +108,20 @@ float pt1FilterApply(pt1Filter_t *filter, float input);
 void slewFilterInit(slewFilter_t *filter, float slewLimit, float threshold);
 float slewFilterApply(slewFilter_t *filter, float input);
 
+// inlined forms of the apply functions, for callers in the PID loop
+static inline float biquadFilterApplyInline(biquadFilter_t *filter, float input)
+{
+    const float result = filter->b0 * input + filter->x1;
+    filter->x1 = filter->b1 * input - filter->a1 * result + filter->x2;
+    filter->x2 = filter->b2 * input - filter->a2 * result;
+    return result;
+}
+
+static inline float pt1FilterApplyInline(pt1Filter_t *filter, float input)
+{
+    filter->state = filter->state + filter->k * (input - filter->state);
+    return filter->state;
+}
+
 void fastKalmanInit(fastKalman_t *filter, float q, uint32_t w, int axis, float updateRate);
 float fastKalmanUpdate(fastKalman_t *filter, float input);
@@ -86,10 +86,14 @@ typedef struct gyroDev_s {
     sensor_align_e gyroAlign;
     float gyroRateKHz;
     bool dataReady;
+    timeUs_t sampleTimeUs;                                  // when the sensor signalled the last sample, 0 without a data ready interrupt
     bool gyro_high_fsr;
     uint8_t hardware_lpf;
     uint8_t hardware_32khz_lpf;
     uint8_t mpuDividerDrops;
+    uint8_t fifoFormat;                                     // gyroFifoFormat_e, set by drivers that support FIFO burst reads
+    uint16_t fifoSize;                                      // bytes the sensor FIFO holds
+    uint16_t fifoSpiDivisor;                                // SPI clock the FIFO count and data registers are read at
     ioTag_t mpuIntExtiTag;
     uint8_t gyroHasOverflowProtection;
     gyroSensor_e gyroHardware;
@@ -0,0 +1,313 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_FIFO
+
+#include "common/maths.h"
+
+#include "drivers/bus_spi.h"
+#include "drivers/io.h"
+#include "drivers/time.h"
+
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_mpu.h"
+#include "drivers/accgyro/accgyro_fifo.h"
+
+#define GYRO_FIFO_AXES_SIZE         6       // three 16 bit axes
+
+#define MPU_FIFO_RECORD_SIZE        12      // acc then gyro, big endian
+#define MPU_FIFO_EN_ACC_GYRO        0x78    // XG, YG, ZG and ACCEL
+#define MPU_USER_CTRL_FIFO_EN       0x40
+#define MPU_USER_CTRL_I2C_IF_DIS    0x10
+#define MPU_USER_CTRL_FIFO_RST      0x04
+
+#define BMI160_REG_FIFO_LENGTH_0    0x22
+#define BMI160_REG_FIFO_DATA        0x24
+#define BMI160_REG_FIFO_CONFIG_1    0x47
+#define BMI160_REG_CMD              0x7E
+#define BMI160_CMD_FIFO_FLUSH       0xB0
+#define BMI160_FIFO_GYRO_ACC_HEADER 0xD0    // gyro and acc frames with headers
+#define BMI160_FIFO_LENGTH_MASK     0x07FF
+
+// BMI160 frame headers, the payload is mag, gyro then acc, little endian
+#define BMI160_FIFO_MODE_MASK       0xC0
+#define BMI160_FIFO_MODE_REGULAR    0x80
+#define BMI160_FIFO_HAS_MAG         0x10
+#define BMI160_FIFO_HAS_GYRO        0x08
+#define BMI160_FIFO_HAS_ACC         0x04
+#define BMI160_FIFO_SKIP            0x40
+#define BMI160_FIFO_SENSORTIME      0x44
+#define BMI160_FIFO_INPUT_CONFIG    0x48
+#define BMI160_FIFO_MAG_SIZE        8
+#define BMI160_FIFO_FRAME_MIN_SIZE  (1 + GYRO_FIFO_AXES_SIZE)
+#define BMI160_FIFO_FRAME_MAX_SIZE  (1 + BMI160_FIFO_MAG_SIZE + 2 * GYRO_FIFO_AXES_SIZE)
+
+// restart the acc average if nobody collects it
+#define GYRO_FIFO_MAX_ACC_SAMPLES   1024
+
+#define GYRO_FIFO_BUFFER_SIZE       MAX(GYRO_FIFO_MAX_SAMPLES * MPU_FIFO_RECORD_SIZE, GYRO_FIFO_MAX_SAMPLES * BMI160_FIFO_FRAME_MIN_SIZE)
+
+static gyroFifo_t *accFifo;
+
+static void readBigEndianAxes(const uint8_t *data, int16_t *axes)
+{
+    axes[X] = (int16_t)((data[0] << 8) | data[1]);
+    axes[Y] = (int16_t)((data[2] << 8) | data[3]);
+    axes[Z] = (int16_t)((data[4] << 8) | data[5]);
+}
+
+static void readLittleEndianAxes(const uint8_t *data, int16_t *axes)
+{
+    axes[X] = (int16_t)((data[1] << 8) | data[0]);
+    axes[Y] = (int16_t)((data[3] << 8) | data[2]);
+    axes[Z] = (int16_t)((data[5] << 8) | data[4]);
+}
+
+static uint8_t parseMpu(const uint8_t *data, int length, gyroFifoSample_t *samples, uint8_t maxSamples)
+{
+    uint8_t count = 0;
+    for (int offset = 0; offset + MPU_FIFO_RECORD_SIZE <= length && count < maxSamples; offset += MPU_FIFO_RECORD_SIZE) {
+        gyroFifoSample_t *sample = &samples[count++];
+        readBigEndianAxes(&data[offset], sample->acc);
+        readBigEndianAxes(&data[offset + GYRO_FIFO_AXES_SIZE], sample->gyro);
+        sample->hasAcc = true;
+        sample->hasGyro = true;
+    }
+    return count;
+}
+
+static uint8_t parseBmi160(const uint8_t *data, int length, gyroFifoSample_t *samples, uint8_t maxSamples)
+{
+    uint8_t count = 0;
+    int offset = 0;
+    while (offset < length && count < maxSamples) {
+        const uint8_t header = data[offset];
+        int frameLength = 1;
+
+        if ((header & BMI160_FIFO_MODE_MASK) == BMI160_FIFO_MODE_REGULAR) {
+            if (!(header & (BMI160_FIFO_HAS_MAG | BMI160_FIFO_HAS_GYRO | BMI160_FIFO_HAS_ACC))) {
+                // nothing left, the sensor pads an over-read with empty frames
+                break;
+            }
+            frameLength += (header & BMI160_FIFO_HAS_MAG) ? BMI160_FIFO_MAG_SIZE : 0;
+            frameLength += (header & BMI160_FIFO_HAS_GYRO) ? GYRO_FIFO_AXES_SIZE : 0;
+            frameLength += (header & BMI160_FIFO_HAS_ACC) ? GYRO_FIFO_AXES_SIZE : 0;
+            if (offset + frameLength > length) {
+                // the sensor sends a partly read frame again with the next burst
+                break;
+            }
+
+            const uint8_t *payload = &data[offset + 1];
+            if (header & BMI160_FIFO_HAS_MAG) {
+                payload += BMI160_FIFO_MAG_SIZE;
+            }
+            gyroFifoSample_t *sample = &samples[count++];
+            sample->hasGyro = header & BMI160_FIFO_HAS_GYRO;
+            if (sample->hasGyro) {
+                readLittleEndianAxes(payload, sample->gyro);
+                payload += GYRO_FIFO_AXES_SIZE;
+            }
+            sample->hasAcc = header & BMI160_FIFO_HAS_ACC;
+            if (sample->hasAcc) {
+                readLittleEndianAxes(payload, sample->acc);
+            }
+        } else if (header == BMI160_FIFO_SKIP || header == BMI160_FIFO_INPUT_CONFIG) {
+            frameLength += 1;
+        } else if (header == BMI160_FIFO_SENSORTIME) {
+            frameLength += 3;
+        } else {
+            // out of step with the frames, drop the rest of the burst
+            break;
+        }
+        offset += frameLength;
+    }
+    return count;
+}
+
+uint8_t gyroFifoParse(gyroFifoFormat_e format, const uint8_t *data, int length, gyroFifoSample_t *samples, uint8_t maxSamples)
+{
+    switch (format) {
+    case GYRO_FIFO_MPU:
+        return parseMpu(data, length, samples, maxSamples);
+    case GYRO_FIFO_BMI160:
+        return parseBmi160(data, length, samples, maxSamples);
+    default:
+        return 0;
+    }
+}
+
+// The FIFO registers are written at the clock the drivers use for their
+// configuration, then the bus goes back to the clock the FIFO is read at.
+static void gyroFifoReset(gyroFifo_t *fifo)
+{
+    spiSetDivisor(fifo->bus->busdev_u.spi.instance, SPI_CLOCK_INITIALIZATON);
+
+    switch (fifo->format) {
+    case GYRO_FIFO_MPU:
+        // FIFO_RST only takes effect while the FIFO is disabled
+        spiBusWriteRegister(fifo->bus, MPU_RA_USER_CTRL, MPU_USER_CTRL_I2C_IF_DIS | MPU_USER_CTRL_FIFO_RST);
+        spiBusWriteRegister(fifo->bus, MPU_RA_USER_CTRL, MPU_USER_CTRL_I2C_IF_DIS | MPU_USER_CTRL_FIFO_EN);
+        break;
+    case GYRO_FIFO_BMI160:
+        spiBusWriteRegister(fifo->bus, BMI160_REG_CMD, BMI160_CMD_FIFO_FLUSH);
+        break;
+    default:
+        break;
+    }
+
+    spiSetDivisor(fifo->bus->busdev_u.spi.instance, fifo->spiDivisor);
+}
+
+void gyroFifoInit(gyroFifo_t *fifo, const gyroDev_t *gyro)
+{
+    memset(fifo, 0, sizeof(*fifo));
+    fifo->bus = &gyro->bus;
+    fifo->format = gyro->fifoFormat;
+    fifo->size = gyro->fifoSize;
+    fifo->spiDivisor = gyro->fifoSpiDivisor;
+
+    if (fifo->format == GYRO_FIFO_NONE) {
+        return;
+    }
+
+    spiSetDivisor(fifo->bus->busdev_u.spi.instance, SPI_CLOCK_INITIALIZATON);
+
+    switch (fifo->format) {
+    case GYRO_FIFO_MPU:
+        spiBusWriteRegister(fifo->bus, MPU_RA_FIFO_EN, MPU_FIFO_EN_ACC_GYRO);
+        delayMicroseconds(15);
+        break;
+    case GYRO_FIFO_BMI160:
+        spiBusWriteRegister(fifo->bus, BMI160_REG_FIFO_CONFIG_1, BMI160_FIFO_GYRO_ACC_HEADER);
+        delayMicroseconds(15);
+        break;
+    default:
+        break;
+    }
+    gyroFifoReset(fifo);
+}
+
+static void gyroFifoAccumulateAcc(gyroFifo_t *fifo)
+{
+    for (int i = 0; i < fifo->sampleCount; i++) {
+        const gyroFifoSample_t *sample = &fifo->samples[i];
+        if (!sample->hasAcc) {
+            continue;
+        }
+        if (fifo->accCount >= GYRO_FIFO_MAX_ACC_SAMPLES) {
+            memset(fifo->accSum, 0, sizeof(fifo->accSum));
+            fifo->accCount = 0;
+        }
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            fifo->accSum[axis] += sample->acc[axis];
+        }
+        fifo->accCount++;
+    }
+}
+
+// Reads all complete frames queued in the sensor, up to GYRO_FIFO_MAX_SAMPLES,
+// with one burst after the fill level, at the clock gyroFifoReset left the bus
+// at. Returns the number of samples read.
+FAST_CODE uint8_t gyroFifoDrain(gyroFifo_t *fifo)
+{
+    uint8_t lengthData[2];
+    uint8_t dataRegister;
+    int pending;
+    int length;
+
+    fifo->sampleCount = 0;
+
+    switch (fifo->format) {
+    case GYRO_FIFO_MPU:
+        if (!spiBusReadRegisterBuffer(fifo->bus, MPU_RA_FIFO_COUNTH, lengthData, 2)) {
+            return 0;
+        }
+        pending = (lengthData[0] << 8) | lengthData[1];
+        // a full FIFO drops bytes, not whole records, so the stream is out of step
+        if (pending % MPU_FIFO_RECORD_SIZE || pending > fifo->size - MPU_FIFO_RECORD_SIZE) {
+            fifo->overflowCount++;
+            gyroFifoReset(fifo);
+            return 0;
+        }
+        length = MIN(pending, GYRO_FIFO_MAX_SAMPLES * MPU_FIFO_RECORD_SIZE);
+        dataRegister = MPU_RA_FIFO_R_W;
+        break;
+    case GYRO_FIFO_BMI160:
+        if (!spiBusReadRegisterBuffer(fifo->bus, BMI160_REG_FIFO_LENGTH_0, lengthData, 2)) {
+            return 0;
+        }
+        pending = ((lengthData[1] << 8) | lengthData[0]) & BMI160_FIFO_LENGTH_MASK;
+        if (pending > fifo->size - BMI160_FIFO_FRAME_MAX_SIZE) {
+            fifo->overflowCount++;
+            gyroFifoReset(fifo);
+            return 0;
+        }
+        // every frame is at least this long, so the burst never holds more samples than fit
+        length = MIN(pending, GYRO_FIFO_MAX_SAMPLES * BMI160_FIFO_FRAME_MIN_SIZE);
+        dataRegister = BMI160_REG_FIFO_DATA;
+        break;
+    default:
+        return 0;
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+
+    uint8_t data[GYRO_FIFO_BUFFER_SIZE];
+    IOLo(fifo->bus->busdev_u.spi.csnPin);
+    spiTransferByte(fifo->bus->busdev_u.spi.instance, dataRegister | 0x80);
+    spiTransfer(fifo->bus->busdev_u.spi.instance, NULL, data, length);
+    IOHi(fifo->bus->busdev_u.spi.csnPin);
+
+    fifo->sampleCount = gyroFifoParse(fifo->format, data, length, fifo->samples, GYRO_FIFO_MAX_SAMPLES);
+    gyroFifoAccumulateAcc(fifo);
+
+    return fifo->sampleCount;
+}
+
+void gyroFifoAttachAcc(gyroFifo_t *fifo)
+{
+    accFifo = fifo;
+}
+
+// Average of the acc samples drained with the gyro since the last call
+bool gyroFifoAccRead(accDev_t *acc)
+{
+    if (!accFifo || !accFifo->accCount) {
+        return false;
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        acc->ADCRaw[axis] = accFifo->accSum[axis] / accFifo->accCount;
+        accFifo->accSum[axis] = 0;
+    }
+    accFifo->accCount = 0;
+
+    return true;
+}
+
+#endif // USE_GYRO_FIFO
@@ -0,0 +1,71 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Combined gyro and acc reads through the on-chip FIFO. The sensor queues
+ * every sample it takes and the gyro task drains all of them in one burst,
+ * so no gyro sample is lost when the loop runs slower than the sensor and
+ * the acc data comes with the gyro data instead of a read of its own.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "drivers/bus.h"
+#include "drivers/accgyro/accgyro.h"
+
+// most samples drained in one burst, the rest stays queued for the next one
+#define GYRO_FIFO_MAX_SAMPLES 8
+
+typedef enum {
+    GYRO_FIFO_NONE = 0,
+    GYRO_FIFO_MPU,      // ICM20602, acc and gyro records
+    GYRO_FIFO_BMI160    // BMI160 in header mode
+} gyroFifoFormat_e;
+
+typedef struct gyroFifoSample_s {
+    int16_t gyro[XYZ_AXIS_COUNT];
+    int16_t acc[XYZ_AXIS_COUNT];
+    bool hasGyro;
+    bool hasAcc;
+} gyroFifoSample_t;
+
+typedef struct gyroFifo_s {
+    const busDevice_t *bus;
+    gyroFifoFormat_e format;
+    uint16_t size;
+    uint16_t spiDivisor;
+    gyroFifoSample_t samples[GYRO_FIFO_MAX_SAMPLES];
+    uint8_t sampleCount;
+    uint16_t overflowCount;     // times the sensor dropped samples before they were read
+    int32_t accSum[XYZ_AXIS_COUNT];
+    uint16_t accCount;
+} gyroFifo_t;
+
+uint8_t gyroFifoParse(gyroFifoFormat_e format, const uint8_t *data, int length, gyroFifoSample_t *samples, uint8_t maxSamples);
+
+void gyroFifoInit(gyroFifo_t *fifo, const gyroDev_t *gyro);
+uint8_t gyroFifoDrain(gyroFifo_t *fifo);
+
+void gyroFifoAttachAcc(gyroFifo_t *fifo);
+bool gyroFifoAccRead(accDev_t *acc);
@@ -27,6 +27,7 @@
 #include "accgyro.h"
 #include "accgyro_mpu.h"
 #include "accgyro_imuf9001.h"
+#include "accgyro_imuf9001_link.h"
 
 #include "common/axis.h"
 #include "build/debug.h"
@@ -58,6 +59,13 @@ volatile uint16_t imufCurrentVersion = IMUF_FIRMWARE_MIN_VERSION;
 FAST_RAM_ZERO_INIT volatile uint32_t isImufCalibrating;
 FAST_RAM_ZERO_INIT volatile imuFrame_t imufQuat;
 FAST_RAM_ZERO_INIT gyroDev_t *imufDev;
+#ifdef STM32F7
+// the DTCM is not cached, the DMA buffers need no cache maintenance there
+FAST_RAM_ZERO_INIT imufLink_t imufLink;
+#else
+// the DMA cannot reach the core coupled RAM of the F4
+imufLink_t imufLink;
+#endif
 
 #ifdef USE_HAL_F7_CRC
 //CRC stuff should really go in a separate CRC driver, but only IMUF uses it
@@ -590,6 +598,7 @@ void imufSpiGyroInit(gyroDev_t *gyro)
     rxData.param1 = VerifyAllowedCommMode(gyroConfig()->imuf_mode);
 
     setupImufParams(&rxData);
+    imufLinkInit(&imufLink, rxData.param1);
 
     for (attempt = 0; attempt < 10; attempt++)
     {
@@ -609,6 +618,57 @@ void imufSpiGyroInit(gyroDev_t *gyro)
     setArmingDisabled(ARMING_DISABLED_NO_GYRO);
 }
 
+// Sends the filter settings to the running IMU-F, false when it cannot take
+// them live and they only apply from the next boot
+bool imufRequestFilterUpdate(void)
+{
+#ifdef USE_IMUF_LIVE_UPDATE
+    if (imufCurrentVersion < IMUF_FIRMWARE_LIVE_UPDATE_VERSION) {
+        return false;
+    }
+
+    imufCommand_t params;
+    memset(&params, 0, sizeof(params));
+    setupImufParams(&params);
+    return imufLinkQueueUpdate(&imufLink, &params);
+#else
+    return false;
+#endif
+}
+
+// Takes the latest frame the DMA has brought in, the acc data comes with it
+FAST_CODE bool imufSpiGyroRead(gyroDev_t *gyro)
+{
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS] = { 0 };
+    if (!imufLinkReadFrame(&imufLink, frame, &gyro->sampleTimeUs)) {
+        return false;
+    }
+
+    const imufData_t *imufData = (const imufData_t *)frame;
+    acc.dev.ADCRaw[X]    = (int16_t)(imufData->accX * acc.dev.acc_1G);
+    acc.dev.ADCRaw[Y]    = (int16_t)(imufData->accY * acc.dev.acc_1G);
+    acc.dev.ADCRaw[Z]    = (int16_t)(imufData->accZ * acc.dev.acc_1G);
+    gyro->gyroADCf[X]    = imufData->gyroX;
+    gyro->gyroADCf[Y]    = imufData->gyroY;
+    gyro->gyroADCf[Z]    = imufData->gyroZ;
+    gyro->gyroADCRaw[X]  = (int16_t)(imufData->gyroX * 16.4f);
+    gyro->gyroADCRaw[Y]  = (int16_t)(imufData->gyroY * 16.4f);
+    gyro->gyroADCRaw[Z]  = (int16_t)(imufData->gyroZ * 16.4f);
+    if (imufLink.frameSize == GTBCM_GYRO_ACC_QUAT_FILTER_F) {
+        imufQuat.w       = imufData->quaternionW;
+        imufQuat.x       = imufData->quaternionX;
+        imufQuat.y       = imufData->quaternionY;
+        imufQuat.z       = imufData->quaternionZ;
+    }
+
+    DEBUG_SET(DEBUG_IMUF_LINK, 0, imufLink.stats.crcErrors);
+    DEBUG_SET(DEBUG_IMUF_LINK, 1, imufLink.stats.overruns);
+    DEBUG_SET(DEBUG_IMUF_LINK, 2, imufLink.stats.frames);
+    DEBUG_SET(DEBUG_IMUF_LINK, 3, imufLink.stats.updateSequence);
+
+    return true;
+}
+
 FAST_CODE bool imufReadAccData(accDev_t *acc) {
     UNUSED(acc);
     return true;
@@ -633,6 +693,7 @@ bool imufSpiGyroDetect(gyroDev_t *gyro)
     }
 
     gyro->initFn = imufSpiGyroInit;
+    gyro->readFn = imufSpiGyroRead;
     gyro->scale = 1.0f;
     gyro->mpuConfiguration.resetFn = resetImuf9001;
     return true;
@@ -27,6 +27,9 @@ bool imufSpiGyroDetect(gyroDev_t *gyro);
 void imufSpiGyroInit(gyroDev_t *gyro);
 void imufSpiAccInit(accDev_t *acc);
 
+bool imufSpiGyroRead(gyroDev_t *gyro);
+bool imufRequestFilterUpdate(void);
+
 void imufStartCalibration(void);
 void imufEndCalibration(void);
 
@@ -54,6 +57,11 @@ void imufEndCalibration(void);
 
 
 #define IMUF_FIRMWARE_MIN_VERSION  106
+#ifdef USE_IMUF_LIVE_UPDATE
+// No released IMU-F firmware takes filter updates while streaming yet, the
+// opcode and version are placeholders until one does
+#define IMUF_FIRMWARE_LIVE_UPDATE_VERSION  110   // takes IMUF_COMMAND_UPDATE_FILTERS while streaming
+#endif
 extern volatile uint16_t imufCurrentVersion;
 typedef struct imufVersion
 {   
@@ -112,7 +120,10 @@ typedef enum gyroCommands
     IMUF_COMMAND_REPORT_INFO     = 121,
     IMUF_COMMAND_SETUP           = 122,
     IMUF_COMMAND_SETPOINT        = 126,
-    IMUF_COMMAND_RESTART         = 127
+    IMUF_COMMAND_RESTART         = 127,
+#ifdef USE_IMUF_LIVE_UPDATE
+    IMUF_COMMAND_UPDATE_FILTERS  = 128,
+#endif
 } gyroCommands_t;
 
 typedef struct gyroFrame
@@ -227,7 +238,7 @@ typedef enum gpioState
 } gpioState_t;
 
 extern volatile imuFrame_t imufQuat;
-volatile uint32_t isImufCalibrating;
+extern volatile uint32_t isImufCalibrating;
 
 extern void initImuf9001(void);
 extern uint32_t getCrcImuf9001(uint32_t* data, uint32_t size);
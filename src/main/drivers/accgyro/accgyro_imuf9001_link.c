@@ -0,0 +1,147 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_IMUF9001
+
+#include "common/maths.h"
+
+#include "drivers/accgyro/accgyro_imuf9001_link.h"
+
+void imufLinkInit(imufLink_t *link, uint8_t frameSize)
+{
+    memset(link, 0, sizeof(*link));
+    link->frameSize = MIN(frameSize, IMUF_LINK_BUFFER_WORDS * sizeof(uint32_t));
+}
+
+// the frame counter is bumped by the transfer interrupt
+static uint32_t framesReceived(const imufLink_t *link)
+{
+    return *(volatile const uint32_t *)&link->stats.frames;
+}
+
+// Called as the IMU-F signals a sample, before the transfer is started into
+// rxBuffer[fill]. A transfer still running means a lost sample, the new one
+// is skipped once and the transfer restarted if it still has not finished.
+FAST_CODE bool imufLinkStartTransfer(imufLink_t *link, timeUs_t sampleTimeUs)
+{
+    if (link->busy) {
+        link->stats.overruns++;
+        if (!link->overrunSkipped) {
+            link->overrunSkipped = true;
+            return false;
+        }
+    }
+    link->overrunSkipped = false;
+    link->busy = true;
+    link->sampleTimeUs[link->fill] = sampleTimeUs;
+    return true;
+}
+
+// Called from the transfer complete interrupt, true when the frame is good
+// and has become the latest one
+FAST_CODE bool imufLinkTransferDone(imufLink_t *link)
+{
+    link->busy = false;
+
+    uint32_t *frame = link->rxBuffer[link->fill];
+    const uint32_t crcWord = link->frameSize / sizeof(uint32_t) - 1;
+    // only the low byte of the crc has ever been compared
+    if ((frame[crcWord] & 0xFF) != (getCrcImuf9001(frame, crcWord) & 0xFF)) {
+        link->stats.crcErrors++;
+        return false;
+    }
+
+    link->ready = link->fill;
+    link->fill ^= 1;
+    link->stats.frames++;
+    return true;
+}
+
+// Copies out the latest good frame if there is a new one. A frame that
+// completes during the copy may have the next transfer writing the buffer
+// being copied, the copy is then taken again from the newer frame.
+FAST_CODE bool imufLinkReadFrame(imufLink_t *link, uint32_t *frame, timeUs_t *sampleTimeUs)
+{
+    for (int attempt = 0; attempt < 2; attempt++) {
+        const uint32_t frames = framesReceived(link);
+        if (frames == link->framesRead) {
+            return false;
+        }
+        const uint8_t ready = link->ready;
+        memcpy(frame, link->rxBuffer[ready], link->frameSize);
+        *sampleTimeUs = link->sampleTimeUs[ready];
+        if (framesReceived(link) == frames) {
+            link->framesRead = frames;
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef USE_IMUF_LIVE_UPDATE
+// Queues the filter parameters of a setup command for the IMU-F, false when
+// a command does not fit the comm mode or the previous update is still queued
+// or going out, the transfer interrupt copies it until the last repeat
+bool imufLinkQueueUpdate(imufLink_t *link, const imufCommand_t *params)
+{
+    if (link->frameSize < IMUF_LINK_COMMAND_WORDS * sizeof(uint32_t) || link->updateTaken != link->updateQueued || link->updateRepeats) {
+        return false;
+    }
+    link->update = *params;
+    link->updateQueued++;
+    return true;
+}
+
+// Called for every transfer that carries no calibration command, false when
+// no update goes out with this frame. The update is written out again for
+// each repeat, a calibration command may have taken the frame in between.
+FAST_CODE bool imufLinkWriteUpdate(imufLink_t *link)
+{
+    imufCommand_t *command = (imufCommand_t *)link->txBuffer;
+
+    if (link->updateTaken != link->updateQueued) {
+        link->updateTaken = link->updateQueued;
+        link->updateRepeats = IMUF_LINK_UPDATE_REPEATS;
+        link->stats.updatesSent++;
+        link->stats.updateSequence = link->updateTaken;
+    }
+
+    if (link->updateRepeats) {
+        link->updateRepeats--;
+        *command = link->update;
+        command->command = IMUF_COMMAND_UPDATE_FILTERS;
+        command->param1 = (IMUF_LINK_PROTOCOL_VERSION << 16) | link->updateTaken;
+        command->crc = getCrcImuf9001((uint32_t *)command, IMUF_LINK_COMMAND_WORDS - 1);
+        return true;
+    }
+    if (command->command == IMUF_COMMAND_UPDATE_FILTERS) {
+        // sent often enough, stop before anything else goes out
+        memset(command, 0, sizeof(*command));
+    }
+    return false;
+}
+#endif // USE_IMUF_LIVE_UPDATE
+#endif
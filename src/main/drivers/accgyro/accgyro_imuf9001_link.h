@@ -0,0 +1,83 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Frame exchange with the IMU-F while it streams. Every sample the IMU-F
+ * signals starts one DMA transfer, a command frame out and a data frame in.
+ * The data frames land in two buffers in turn: the transfer fills one while
+ * the gyro task reads the latest good frame from the other, so the transfer
+ * runs alongside the PID loop and the interrupt only has to check the crc.
+ *
+ * With USE_IMUF_LIVE_UPDATE, filter updates go out as a versioned command
+ * carrying a sequence number. It is repeated for a few frames to ride out
+ * crc errors, the IMU-F applies each sequence number once.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+#include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_imuf9001.h"
+
+#define IMUF_LINK_PROTOCOL_VERSION  1
+#define IMUF_LINK_BUFFER_WORDS      15  // room for the largest comm mode
+#define IMUF_LINK_COMMAND_WORDS     12  // command, ten parameters and the crc
+#define IMUF_LINK_UPDATE_REPEATS    8   // frames a filter update is sent in
+
+typedef struct imufLinkStats_s {
+    uint32_t frames;            // good frames received
+    uint32_t crcErrors;
+    uint32_t overruns;          // samples lost to a transfer that was still running
+    uint16_t updatesSent;
+    uint16_t updateSequence;    // of the last update sent
+} imufLinkStats_t;
+
+typedef struct imufLink_s {
+    uint32_t rxBuffer[2][IMUF_LINK_BUFFER_WORDS];
+    uint32_t txBuffer[IMUF_LINK_BUFFER_WORDS];
+    volatile imufCommand_t update;  // queued filter update, taken by the next transfer
+    timeUs_t sampleTimeUs[2];
+    uint32_t framesRead;
+    imufLinkStats_t stats;
+    uint8_t frameSize;              // bytes per transfer, the comm mode
+    uint8_t fill;                   // buffer the running transfer writes
+    volatile uint8_t ready;         // buffer with the latest good frame
+    volatile bool busy;
+    bool overrunSkipped;
+    volatile uint8_t updateRepeats;
+    volatile uint16_t updateQueued;
+    volatile uint16_t updateTaken;
+} imufLink_t;
+
+// the link to the IMU-F on the board
+extern imufLink_t imufLink;
+
+void imufLinkInit(imufLink_t *link, uint8_t frameSize);
+bool imufLinkStartTransfer(imufLink_t *link, timeUs_t sampleTimeUs);
+bool imufLinkTransferDone(imufLink_t *link);
+bool imufLinkReadFrame(imufLink_t *link, uint32_t *frame, timeUs_t *sampleTimeUs);
+#ifdef USE_IMUF_LIVE_UPDATE
+bool imufLinkQueueUpdate(imufLink_t *link, const imufCommand_t *params);
+bool imufLinkWriteUpdate(imufLink_t *link);
+#endif
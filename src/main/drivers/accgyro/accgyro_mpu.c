@@ -61,6 +61,7 @@
 #include "drivers/accgyro/accgyro_mpu.h"
 #ifdef USE_GYRO_IMUF9001
 #include "drivers/accgyro/accgyro_imuf9001.h"
+#include "drivers/accgyro/accgyro_imuf9001_link.h"
 #include "rx/rx.h"
 #include "fc/fc_rc.h"
 #include "fc/runtime_config.h"
@@ -68,9 +69,11 @@
 
 mpuResetFnPtr mpuResetFn;
 
-#ifdef USE_GYRO_IMUF9001
-    imufData_t imufData;
+#ifdef USE_DMA_SPI_DEVICE
+// taken when the read starts, handed on to the gyro once the data has arrived
+static FAST_RAM_ZERO_INIT timeUs_t dmaSampleTimeUs;
 #endif
+
 #ifndef MPU_I2C_INSTANCE
 #define MPU_I2C_INSTANCE I2C_DEVICE
 #endif
@@ -126,6 +129,7 @@ FAST_CODE static void mpuIntExtiHandler(extiCallbackRec_t *cb)
 #ifdef USE_DMA_SPI_DEVICE
     //start dma read
     (void)(cb);
+    dmaSampleTimeUs = microsISR();
     gyroDmaSpiStartRead();
 #else
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
@@ -135,6 +139,7 @@ FAST_CODE static void mpuIntExtiHandler(extiCallbackRec_t *cb)
     lastCalledAtUs = nowUs;
 #endif
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
+    gyro->sampleTimeUs = microsISR();
     gyro->dataReady = true;
 #ifdef DEBUG_MPU_DATA_READY_INTERRUPT
     const uint32_t now2Us = micros();
@@ -195,41 +200,51 @@ FAST_CODE bool mpuGyroDmaSpiReadStart(gyroDev_t * gyro)
     (void)(gyro); ///not used at this time
     //no reason not to get acc and gyro data at the same time
 #ifdef USE_GYRO_IMUF9001
+    if (!imufLinkStartTransfer(&imufLink, dmaSampleTimeUs)) {
+        return false;
+    }
+    //the command frame is only touched between transfers
+    imufCommand_t *command = (imufCommand_t *)imufLink.txBuffer;
     if (isImufCalibrating == IMUF_IS_CALIBRATING) //calibrating
     {
         //two steps
         //step 1 is isImufCalibrating=1, this starts the calibration command and sends it to the IMU-f
         //step 2 is isImufCalibrating=2, this sets the tx buffer back to 0 so we don't keep sending the calibration command over and over
-        memset(dmaTxBuffer, 0, sizeof(imufCommand_t)); //clear buffer
-        //set calibration command with CRC, typecast the dmaTxBuffer as imufCommand_t
-        (*(imufCommand_t *)(dmaTxBuffer)).command = IMUF_COMMAND_CALIBRATE;
-        (*(imufCommand_t *)(dmaTxBuffer)).crc     = getCrcImuf9001((uint32_t *)dmaTxBuffer, 11); //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
+        memset(command, 0, sizeof(imufCommand_t)); //clear buffer
+        //set calibration command with CRC
+        command->command = IMUF_COMMAND_CALIBRATE;
+        command->crc     = getCrcImuf9001((uint32_t *)command, 11); //the crc command needs the frame as a uint32_t array
         //set isImufCalibrating to step 2, which is just used so the memset to 0 runs after the calibration commmand is sent
         isImufCalibrating = IMUF_DONE_CALIBRATING; //go to step two
     }
     else if (isImufCalibrating == IMUF_DONE_CALIBRATING)
     {
         // step 2, memset of the tx buffer has run, set isImufCalibrating to 0.
-        (*(imufCommand_t *)(dmaTxBuffer)).command = 0;
-        (*(imufCommand_t *)(dmaTxBuffer)).crc     = 0; //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
+        command->command = 0;
+        command->crc     = 0;
         imufEndCalibration();
     }
+#ifdef USE_IMUF_LIVE_UPDATE
+    else if (imufLinkWriteUpdate(&imufLink))
+    {
+        //a filter update is going out, the setpoint follows once it is done
+    }
+#endif
     else
     {
         if (isSetpointNew) {
             //send setpoint and arm status
-            (*(imufCommand_t *)(dmaTxBuffer)).command = IMUF_COMMAND_SETPOINT;
-            (*(imufCommand_t *)(dmaTxBuffer)).param1  = getSetpointRateInt(0);
-            (*(imufCommand_t *)(dmaTxBuffer)).param2  = getSetpointRateInt(1);
-            (*(imufCommand_t *)(dmaTxBuffer)).param3  = getSetpointRateInt(2);
-            (*(imufCommand_t *)(dmaTxBuffer)).crc     = getCrcImuf9001((uint32_t *)dmaTxBuffer, 11); //typecast the dmaTxBuffer as a uint32_t array which is what the crc command needs
+            command->command = IMUF_COMMAND_SETPOINT;
+            command->param1  = getSetpointRateInt(0);
+            command->param2  = getSetpointRateInt(1);
+            command->param3  = getSetpointRateInt(2);
+            command->crc     = getCrcImuf9001((uint32_t *)command, 11); //the crc command needs the frame as a uint32_t array
             isSetpointNew = 0;
         }
     }
 
-    memset(dmaRxBuffer, 0, gyroConfig()->imuf_mode); //clear buffer
-    //send and receive data using SPI and DMA
-    dmaSpiTransmitReceive(dmaTxBuffer, dmaRxBuffer, gyroConfig()->imuf_mode, 0);
+    //send and receive data using SPI and DMA, into the buffer the gyro task is not reading
+    dmaSpiTransmitReceive((uint8_t *)imufLink.txBuffer, (uint8_t *)imufLink.rxBuffer[imufLink.fill], imufLink.frameSize, 0);
 #else
     dmaTxBuffer[0] = MPU_RA_ACCEL_XOUT_H | 0x80;
     dmaSpiTransmitReceive(dmaTxBuffer, dmaRxBuffer, 15, 0);
@@ -240,31 +255,13 @@ FAST_CODE bool mpuGyroDmaSpiReadStart(gyroDev_t * gyro)
 FAST_CODE void mpuGyroDmaSpiReadFinish(gyroDev_t * gyro)
 {
     //spi rx dma callback
-#ifdef USE_GYRO_IMUF9001
-    memcpy(&imufData, dmaRxBuffer, sizeof(imufData_t));
-    acc.dev.ADCRaw[X]    = (int16_t)(imufData.accX * acc.dev.acc_1G);
-    acc.dev.ADCRaw[Y]    = (int16_t)(imufData.accY * acc.dev.acc_1G);
-    acc.dev.ADCRaw[Z]    = (int16_t)(imufData.accZ * acc.dev.acc_1G);
-    gyro->gyroADCf[X]    = imufData.gyroX;
-    gyro->gyroADCf[Y]    = imufData.gyroY;
-    gyro->gyroADCf[Z]    = imufData.gyroZ;
-    gyro->gyroADCRaw[X]  = (int16_t)(imufData.gyroX * 16.4f);
-    gyro->gyroADCRaw[Y]  = (int16_t)(imufData.gyroY * 16.4f);
-    gyro->gyroADCRaw[Z]  = (int16_t)(imufData.gyroZ * 16.4f);
-    if (gyroConfig()->imuf_mode == GTBCM_GYRO_ACC_QUAT_FILTER_F) {
-        imufQuat.w       = imufData.quaternionW;
-        imufQuat.x       = imufData.quaternionX;
-        imufQuat.y       = imufData.quaternionY;
-        imufQuat.z       = imufData.quaternionZ;
-    }
-#else
     acc.dev.ADCRaw[X]   = (int16_t)((dmaRxBuffer[1] << 8)  | dmaRxBuffer[2]);
     acc.dev.ADCRaw[Y]   = (int16_t)((dmaRxBuffer[3] << 8)  | dmaRxBuffer[4]);
     acc.dev.ADCRaw[Z]   = (int16_t)((dmaRxBuffer[5] << 8)  | dmaRxBuffer[6]);
     gyro->gyroADCRaw[X] = (int16_t)((dmaRxBuffer[9] << 8)  | dmaRxBuffer[10]);
     gyro->gyroADCRaw[Y] = (int16_t)((dmaRxBuffer[11] << 8) | dmaRxBuffer[12]);
     gyro->gyroADCRaw[Z] = (int16_t)((dmaRxBuffer[13] << 8) | dmaRxBuffer[14]);
-#endif // USE_GYRO_IMUF9001
+    gyro->sampleTimeUs = dmaSampleTimeUs;
 }
 #endif
 
@@ -47,6 +47,7 @@
 #include "drivers/time.h"
 
 #include "accgyro.h"
+#include "accgyro_fifo.h"
 #include "accgyro_spi_bmi160.h"
 
 
@@ -245,6 +246,7 @@ extiCallbackRec_t bmi160IntCallbackRec;
 void bmi160ExtiHandler(extiCallbackRec_t *cb)
 {
     gyroDev_t *gyro = container_of(cb, gyroDev_t, exti);
+    gyro->sampleTimeUs = microsISR();
     gyro->dataReady = true;
 }
 
@@ -360,6 +362,9 @@ bool bmi160SpiGyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = bmi160SpiGyroInit;
     gyro->readFn = bmi160GyroRead;
+    gyro->fifoFormat = GYRO_FIFO_BMI160;
+    gyro->fifoSize = 1024;
+    gyro->fifoSpiDivisor = BMI160_SPI_DIVISOR;
     gyro->scale = 1.0f / 16.4f;
 
     return true;
@@ -28,6 +28,7 @@
 #include "common/maths.h"
 
 #include "drivers/accgyro/accgyro.h"
+#include "drivers/accgyro/accgyro_fifo.h"
 #include "drivers/accgyro/accgyro_mpu.h"
 #include "drivers/accgyro/accgyro_spi_icm20689.h"
 #include "drivers/bus_spi.h"
@@ -170,6 +171,13 @@ bool icm20689SpiGyroDetect(gyroDev_t *gyro)
 
     gyro->initFn = icm20689GyroInit;
     gyro->readFn = mpuGyroReadSPI;
+    if (gyro->mpuDetectionResult.sensor == ICM_20602_SPI) {
+        // the other parts only allow 1MHz outside the sensor registers,
+        // too slow to drain the FIFO at gyro rates
+        gyro->fifoFormat = GYRO_FIFO_MPU;
+        gyro->fifoSize = 1008;
+        gyro->fifoSpiDivisor = SPI_CLOCK_STANDARD;
+    }
 
     // 16.4 dps/lsb scalefactor
     gyro->scale = 1.0f / 16.4f;
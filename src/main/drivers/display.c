@@ -33,6 +33,7 @@ void displayClearScreen(displayPort_t *instance)
     instance->vTable->clearScreen(instance);
     instance->cleared = true;
     instance->cursorRow = -1;
+    ++instance->clearCount;
 }
 
 void displayDrawScreen(displayPort_t *instance)
@@ -49,6 +50,7 @@ void displayGrab(displayPort_t *instance)
 {
     instance->vTable->grab(instance);
     instance->vTable->clearScreen(instance);
+    ++instance->clearCount;
     ++instance->grabCount;
 }
 
@@ -122,4 +124,5 @@ void displayInit(displayPort_t *instance, const displayPortVTable_t *vTable)
     instance->cleared = true;
     instance->grabCount = 0;
     instance->cursorRow = -1;
+    instance->clearCount = 0;
 }
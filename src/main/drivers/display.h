@@ -34,6 +34,10 @@ typedef struct displayPort_s {
     bool cleared;
     int8_t cursorRow;
     int8_t grabCount;
+
+    // Bumped whenever the screen contents are thrown away, so clients that
+    // redraw incrementally know they have to start over
+    uint8_t clearCount;
 } displayPort_t;
 
 // displayPort_t is used as a parameter group in 'displayport_msp.h' and 'displayport_max7456`.h'. Treat accordingly!
@@ -11,7 +11,6 @@ typedef enum dma_spi_read_status_e {
     DMA_SPI_BLOCKING_READ_IN_PROGRESS = 3,
 } dma_spi_read_status_t;
 
-extern volatile uint32_t crcErrorCount;
 extern volatile dma_spi_read_status_t dmaSpiReadStatus;
 extern volatile bool dmaSpiDeviceDataReady;
 extern uint8_t dmaTxBuffer[58];
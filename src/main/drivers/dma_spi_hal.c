@@ -10,7 +10,7 @@
 #include "drivers/accgyro/accgyro_mpu.h"
 #ifdef USE_GYRO_IMUF9001
 #include "drivers/accgyro/accgyro_imuf9001.h"
-FAST_RAM_ZERO_INIT volatile uint32_t crcErrorCount;
+#include "drivers/accgyro/accgyro_imuf9001_link.h"
 #endif
 
 FAST_RAM_ZERO_INIT SPI_HandleTypeDef dmaSpiHandle;
@@ -48,25 +48,11 @@ FAST_CODE_NOINLINE void DMA_SPI_RX_DMA_HANDLER(void)
         dmaSpiCsHi();
         //spi rx dma callback
         #ifdef USE_GYRO_IMUF9001
-            volatile uint32_t crc1 = ( (*(uint32_t *)(dmaRxBuffer+gyroConfig()->imuf_mode-4)) & 0xFF );
-            volatile uint32_t crc2 = ( getCrcImuf9001((uint32_t *)(dmaRxBuffer), (gyroConfig()->imuf_mode >> 2)-1) & 0xFF );
-            if(crc1 == crc2)
+            //the frame is only checked here, the gyro task reads it from the link
+            if(dmaSpiReadStatus != DMA_SPI_BLOCKING_READ_IN_PROGRESS && imufLinkTransferDone(&imufLink))
             {
-                if(dmaSpiReadStatus != DMA_SPI_BLOCKING_READ_IN_PROGRESS)
-                {
-                    gyroDmaSpiFinishRead();
-                }
                 dmaSpiDeviceDataReady = true;
             }
-            else
-            {
-                if (crcErrorCount > 100000)
-                {
-                    crcErrorCount = 0;
-                }
-                //error handler
-                crcErrorCount++; //check every so often and cause a failsafe is this number is above a certain ammount
-            }
         #else
             if(dmaSpiReadStatus != DMA_SPI_BLOCKING_READ_IN_PROGRESS)
             {
@@ -0,0 +1,165 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DSHOT
+
+#include "drivers/dshot.h"
+
+FAST_RAM_ZERO_INIT uint32_t dshotNibbleTable[16][4];
+
+void dshotBuildNibbleTable(uint32_t bit0, uint32_t bit1)
+{
+    for (int nibble = 0; nibble < 16; nibble++) {
+        for (int i = 0; i < 4; i++) {
+            dshotNibbleTable[nibble][i] = (nibble & (0x8 >> i)) ? bit1 : bit0;
+        }
+    }
+}
+
+FAST_CODE uint16_t dshotEncodePacket(uint16_t value, bool requestTelemetry, bool bidirectional)
+{
+    const uint16_t packet = (value << 1) | (requestTelemetry ? 1 : 0);
+
+    // checksum is the xor of the three data nibbles, inverted to request an eRPM response
+    uint16_t csum = packet ^ (packet >> 4) ^ (packet >> 8);
+    if (bidirectional) {
+        csum = ~csum;
+    }
+    csum &= 0xf;
+
+    return (packet << 4) | csum;
+}
+
+// Expands one packet into a buffer whose consecutive bit slots are `stride` words apart.
+// The trailing frame reset slots are never written and stay at zero.
+FAST_CODE uint8_t dshotLoadBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet)
+{
+    for (int i = 0; i < DSHOT_NIBBLE_COUNT; i++) {
+        const uint32_t *bits = dshotNibbleTable[packet >> 12];  // most significant nibble first
+        dmaBuffer[0] = bits[0];
+        dmaBuffer[stride] = bits[1];
+        dmaBuffer[stride * 2] = bits[2];
+        dmaBuffer[stride * 3] = bits[3];
+        dmaBuffer += stride * 4;
+        packet <<= 4;
+    }
+
+    return DSHOT_FRAME_BITS + DSHOT_RESET_SLOTS;
+}
+
+// Fills the interleaved CCR1..CCR4 burst buffer of one timer in a single pass.
+// Channels not in channelMask are left untouched so their outputs stay low.
+FAST_CODE void dshotLoadBurstBuffer(uint32_t *dmaBurstBuffer, const uint16_t *packets, uint8_t channelMask)
+{
+    for (int i = 0; i < DSHOT_NIBBLE_COUNT; i++) {
+        const int shift = 12 - i * 4;
+        uint32_t *slot = &dmaBurstBuffer[i * 4 * DSHOT_BURST_CHANNELS];
+
+        for (int channel = 0; channel < DSHOT_BURST_CHANNELS; channel++) {
+            if (!(channelMask & (1 << channel))) {
+                continue;
+            }
+            const uint32_t *bits = dshotNibbleTable[(packets[channel] >> shift) & 0xf];
+            slot[channel] = bits[0];
+            slot[channel + DSHOT_BURST_CHANNELS] = bits[1];
+            slot[channel + DSHOT_BURST_CHANNELS * 2] = bits[2];
+            slot[channel + DSHOT_BURST_CHANNELS * 3] = bits[3];
+        }
+    }
+}
+
+// 5 bit GCR symbol to nibble, 0xff for the 16 codes that are never sent
+static const uint8_t gcrDecodeTable[32] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x09, 0x0a, 0x0b, 0xff, 0x0d, 0x0e, 0x0f,
+    0xff, 0xff, 0x02, 0x03, 0xff, 0x05, 0x06, 0x07, 0xff, 0x00, 0x08, 0x01, 0xff, 0x04, 0x0c, 0xff
+};
+
+#define GCR_FRAME_BITS  21
+
+/*
+ * Decodes the eRPM response of a bidirectional ESC from the timer counts captured at each edge of
+ * the line. Every edge is a 1 bit followed by as many 0 bits as fit before the next edge, the
+ * final run extends to the end of the 21 bit frame. The leading bit is the start edge, the other
+ * 20 bits are four GCR symbols carrying eee mmmmmmmmm cccc, with the period in us being m << e.
+ *
+ * Returns the eRPM, 0 for a stopped motor, or DSHOT_TELEMETRY_INVALID.
+ */
+FAST_CODE uint32_t dshotDecodeTelemetryPacket(const uint32_t *edges, int edgeCount)
+{
+    if (edgeCount < 2) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    uint32_t value = 0;
+    int bits = 0;
+
+    for (int i = 1; i <= edgeCount && bits < GCR_FRAME_BITS; i++) {
+        int len;
+        if (i < edgeCount) {
+            // 16 bit difference so captures on 16 bit timers may wrap
+            const uint16_t ticks = edges[i] - edges[i - 1];
+            len = (ticks + DSHOT_TELEMETRY_BIT_TICKS / 2) / DSHOT_TELEMETRY_BIT_TICKS;
+        } else {
+            len = GCR_FRAME_BITS - bits;
+        }
+        if (len <= 0 || bits + len > GCR_FRAME_BITS) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        value = (value << len) | (1 << (len - 1));
+        bits += len;
+    }
+
+    if (bits != GCR_FRAME_BITS) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    uint32_t payload = 0;
+    for (int shift = 15; shift >= 0; shift -= 5) {
+        const uint8_t nibble = gcrDecodeTable[(value >> shift) & 0x1f];
+        if (nibble == 0xff) {
+            return DSHOT_TELEMETRY_INVALID;
+        }
+        payload = (payload << 4) | nibble;
+    }
+
+    // the nibbles including the checksum xor to 0xf
+    const uint32_t csum = payload ^ (payload >> 4) ^ (payload >> 8) ^ (payload >> 12);
+    if ((csum & 0xf) != 0xf) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    const uint32_t data = payload >> 4;
+    if (data == 0x0fff) {
+        return 0;
+    }
+
+    const uint32_t periodUs = (data & 0x1ff) << (data >> 9);
+    if (periodUs == 0) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+
+    return (60 * 1000000 + periodUs / 2) / periodUs;
+}
+#endif
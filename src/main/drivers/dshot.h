@@ -0,0 +1,41 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define DSHOT_FRAME_BITS        16
+#define DSHOT_NIBBLE_COUNT      (DSHOT_FRAME_BITS / 4)
+#define DSHOT_RESET_SLOTS       2   // zero compare slots that hold the line low between frames
+#define DSHOT_BURST_CHANNELS    4   // CCR1..CCR4 written per timer update in burst mode
+
+#define DSHOT_TELEMETRY_INPUT_LEN   32  // captured edges per response, a 21 bit GCR frame has at most 21
+#define DSHOT_TELEMETRY_BIT_TICKS   16  // GCR bits run at 5/4 of the DShot bit rate, whose bit is 20 timer ticks
+#define DSHOT_TELEMETRY_INVALID     UINT32_MAX
+
+// Timer compare values for each of the 16 possible nibbles, most significant bit first.
+// Built once at init so the per-loop expansion is a table copy rather than a bit loop.
+extern uint32_t dshotNibbleTable[16][4];
+
+void dshotBuildNibbleTable(uint32_t bit0, uint32_t bit1);
+
+uint16_t dshotEncodePacket(uint16_t value, bool requestTelemetry, bool bidirectional);
+uint8_t dshotLoadBuffer(uint32_t *dmaBuffer, int stride, uint16_t packet);
+void dshotLoadBurstBuffer(uint32_t *dmaBurstBuffer, const uint16_t *packets, uint8_t channelMask);
+uint32_t dshotDecodeTelemetryPacket(const uint32_t *edges, int edgeCount);
@@ -38,6 +38,7 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 #include "dma.h"
 #include "drivers/io.h"
 #include "light_ws2811strip.h"
@@ -57,9 +58,27 @@ uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_LED_STRIP_LENGTH];
 
+// The layers in io/ledstrip.c rewrite every LED on each update. Only LEDs
+// whose colour was changed are marked dirty, and of those only the ones whose
+// final colour differs from what is already expanded in ledStripDMABuffer
+// are converted to RGB and expanded again.
+static uint32_t ledDirtyMask;
+static hsvColor_t ledEncodedColor[WS2811_LED_STRIP_LENGTH];
+static int encodedLedFormat = -1; // none, everything has to be expanded
+
+STATIC_ASSERT(WS2811_LED_STRIP_LENGTH <= sizeof(ledDirtyMask) * 8, ledDirtyMask_too_small);
+
+static bool hsvColorEqual(const hsvColor_t *a, const hsvColor_t *b)
+{
+    return a->h == b->h && a->s == b->s && a->v == b->v;
+}
+
 void setLedHsv(uint16_t index, const hsvColor_t *color)
 {
-    ledColorBuffer[index] = *color;
+    if (!hsvColorEqual(&ledColorBuffer[index], color)) {
+        ledColorBuffer[index] = *color;
+        ledDirtyMask |= 1U << index;
+    }
 }
 
 void getLedHsv(uint16_t index, hsvColor_t *color)
@@ -69,12 +88,15 @@ void getLedHsv(uint16_t index, hsvColor_t *color)
 
 void setLedValue(uint16_t index, const uint8_t value)
 {
-    ledColorBuffer[index].v = value;
+    if (ledColorBuffer[index].v != value) {
+        ledColorBuffer[index].v = value;
+        ledDirtyMask |= 1U << index;
+    }
 }
 
 void scaleLedValue(uint16_t index, const uint8_t scalePercent)
 {
-    ledColorBuffer[index].v = ((uint16_t)ledColorBuffer[index].v * scalePercent / 100);
+    setLedValue(index, (uint16_t)ledColorBuffer[index].v * scalePercent / 100);
 }
 
 void setStripColor(const hsvColor_t *color)
@@ -96,6 +118,7 @@ void setStripColors(const hsvColor_t *colors)
 void ws2811LedStripInit(ioTag_t ioTag)
 {
     memset(ledStripDMABuffer, 0, sizeof(ledStripDMABuffer));
+    encodedLedFormat = -1;
     ws2811LedStripHardwareInit(ioTag);
 
     const hsvColor_t hsv_white = { 0, 255, 255 };
@@ -115,6 +138,22 @@ static int16_t ledIndex;
 #define USE_FAST_DMA_BUFFER_IMPL
 #ifdef USE_FAST_DMA_BUFFER_IMPL
 
+// Timer compare values for the 4 bits of each nibble, MSB first
+static uint16_t ledBitTable[16][4];
+static uint16_t ledBitTableCompare0;
+static uint16_t ledBitTableCompare1;
+
+static void buildLedBitTable(void)
+{
+    for (int nibble = 0; nibble < 16; nibble++) {
+        for (int bit = 0; bit < 4; bit++) {
+            ledBitTable[nibble][bit] = (nibble & (0x8 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+    ledBitTableCompare0 = BIT_COMPARE_0;
+    ledBitTableCompare1 = BIT_COMPARE_1;
+}
+
 STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color)
 {
     uint32_t packed_colour;
@@ -130,8 +169,12 @@ STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rg
         break;
     }
 
-    for (int8_t index = 23; index >= 0; index--) {
-        ledStripDMABuffer[dmaBufferOffset++] = (packed_colour & (1 << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+    for (int shift = 20; shift >= 0; shift -= 4) {
+        const uint16_t *bits = ledBitTable[(packed_colour >> shift) & 0xf];
+        ledStripDMABuffer[dmaBufferOffset++] = bits[0];
+        ledStripDMABuffer[dmaBufferOffset++] = bits[1];
+        ledStripDMABuffer[dmaBufferOffset++] = bits[2];
+        ledStripDMABuffer[dmaBufferOffset++] = bits[3];
     }
 }
 #else
@@ -167,14 +210,32 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
         return;
     }
 
-    dmaBufferOffset = 0;                // reset buffer memory index
-    ledIndex = 0;                       // reset led index
+#ifdef USE_FAST_DMA_BUFFER_IMPL
+    if (ledBitTableCompare0 != BIT_COMPARE_0 || ledBitTableCompare1 != BIT_COMPARE_1) {
+        buildLedBitTable();
+        encodedLedFormat = -1;
+    }
+#endif
+
+    const bool encodeAll = encodedLedFormat != (int)ledFormat;
+    uint32_t dirtyMask = encodeAll ? UINT32_MAX : ledDirtyMask;
+    ledDirtyMask = 0;
+    encodedLedFormat = ledFormat;
 
     // fill transmit buffer with correct compare values to achieve
     // correct pulse widths according to color values
-    while (ledIndex < WS2811_LED_STRIP_LENGTH)
+    for (ledIndex = 0; ledIndex < WS2811_LED_STRIP_LENGTH && dirtyMask; ledIndex++, dirtyMask >>= 1)
     {
+        if (!(dirtyMask & 1)) {
+            continue;
+        }
+        if (!encodeAll && hsvColorEqual(&ledEncodedColor[ledIndex], &ledColorBuffer[ledIndex])) {
+            continue;
+        }
+        ledEncodedColor[ledIndex] = ledColorBuffer[ledIndex];
+
         rgb24 = hsvToRgb24(&ledColorBuffer[ledIndex]);
+        dmaBufferOffset = ledIndex * WS2811_BITS_PER_LED;
 
 #ifdef USE_FAST_DMA_BUFFER_IMPL
         fastUpdateLEDDMABuffer(ledFormat, rgb24);
@@ -194,8 +255,6 @@ void ws2811UpdateStrip(ledStripFormatRGB_e ledFormat)
 
         updateLEDDMABuffer(rgb24->rgb.b);
 #endif
-
-        ledIndex++;
     }
 
     ws2811LedDataTransferInProgress = 1;
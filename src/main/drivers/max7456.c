@@ -28,6 +28,9 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+#include "common/utils.h"
+
 #include "pg/max7456.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -123,6 +126,7 @@
 #define MAX7456_SIGNAL_CHECK_INTERVAL_MS 1000 // msec
 
 // DMM special bits
+#define AUTO_INCREMENT 0x01
 #define CLEAR_DISPLAY 0x04
 #define CLEAR_DISPLAY_VERT 0x06
 #define INVERT_PIXEL_COLOR 0x08
@@ -204,6 +208,12 @@ uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 static uint8_t screenBuffer[VIDEO_BUFFER_CHARS_PAL+40]; // For faster writes we use memcpy so we need some space to don't overwrite buffer
 static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
 
+// Columns [dirtyStart, dirtyEnd) of each row may differ from shadowBuffer,
+// rows with dirtyStart >= dirtyEnd are known to be in sync. Only dirty spans
+// are compared and sent by max7456DrawScreen.
+static uint8_t dirtyStart[VIDEO_LINES_PAL];
+static uint8_t dirtyEnd[VIDEO_LINES_PAL];
+
 //Max chars to update in one idle
 
 #define MAX_CHARS2UPDATE    100
@@ -213,6 +223,15 @@ volatile bool dmaTransactionInProgress = false;
 
 static uint8_t spiBuff[MAX_CHARS2UPDATE*6];
 
+// SPI bytes (register address + data pairs) needed to send chars either one
+// by one with direct addressing (DMAH, DMAL, DMDI each), or as a run in
+// auto-increment mode (DMAH, DMAL, DMM, one DMDI per char, END_STRING, DMM).
+#define MAX7456_SINGLE_CHAR_BYTES    6
+#define MAX7456_RUN_BYTES(len)       (2 * (len) + 10)
+// Unchanged chars are resent inside a run at 2 bytes each, bridging a gap of
+// up to this many is cheaper than closing the run and opening a new one.
+#define MAX7456_RUN_MAX_GAP          4
+
 static uint8_t  videoSignalCfg;
 static uint8_t  videoSignalReg  = OSD_ENABLE; // OSD_ENABLE required to trigger first ReInit
 static uint8_t  displayMemoryModeReg = 0;
@@ -227,6 +246,23 @@ static uint8_t max7456DeviceType;
 
 static void max7456DrawScreenSlow(void);
 
+static void max7456MarkDirty(uint8_t row, uint8_t start, uint8_t end)
+{
+    if (dirtyStart[row] >= dirtyEnd[row]) {
+        dirtyStart[row] = start;
+        dirtyEnd[row] = end;
+    } else {
+        dirtyStart[row] = MIN(dirtyStart[row], start);
+        dirtyEnd[row] = MAX(dirtyEnd[row], end);
+    }
+}
+
+static void max7456MarkAllDirty(void)
+{
+    memset(dirtyStart, 0, sizeof(dirtyStart));
+    memset(dirtyEnd, CHARS_PER_LINE, sizeof(dirtyEnd));
+}
+
 static uint8_t max7456Send(uint8_t add, uint8_t data)
 {
     spiTransferByte(busdev->busdev_u.spi.instance, add);
@@ -405,6 +441,7 @@ void max7456ReInit(void)
 
     // Clear shadow to force redraw all screen in non-dma mode.
     memset(shadowBuffer, 0, maxScreenSize);
+    max7456MarkAllDirty();
     if (firstInit) {
         max7456DrawScreenSlow();
         firstInit = false;
@@ -529,6 +566,7 @@ void max7456Brightness(uint8_t black, uint8_t white)
 void max7456ClearScreen(void)
 {
     memset(screenBuffer, 0x20, VIDEO_BUFFER_CHARS_PAL);
+    max7456MarkAllDirty();
 }
 
 uint8_t* max7456GetScreenBuffer(void)
@@ -538,16 +576,36 @@ uint8_t* max7456GetScreenBuffer(void)
 
 void max7456WriteChar(uint8_t x, uint8_t y, uint8_t c)
 {
-    screenBuffer[y*CHARS_PER_LINE+x] = c;
+    if (x >= CHARS_PER_LINE || y >= VIDEO_LINES_PAL) {
+        return;
+    }
+    uint8_t *screenPos = &screenBuffer[y*CHARS_PER_LINE+x];
+    if (*screenPos != c) {
+        *screenPos = c;
+        max7456MarkDirty(y, x, x + 1);
+    }
 }
 
 void max7456Write(uint8_t x, uint8_t y, const char *buff)
 {
+    if (y >= VIDEO_LINES_PAL) {
+        return;
+    }
+    uint8_t start = CHARS_PER_LINE;
+    uint8_t end = 0;
     for (int i = 0; *(buff+i); i++) {
         if (x+i < CHARS_PER_LINE) {// Do not write over screen
-            screenBuffer[y*CHARS_PER_LINE+x+i] = *(buff+i);
+            uint8_t *screenPos = &screenBuffer[y*CHARS_PER_LINE+x+i];
+            if (*screenPos != (uint8_t)*(buff+i)) {
+                *screenPos = *(buff+i);
+                start = MIN(start, x+i);
+                end = x+i+1;
+            }
         }
     }
+    if (start < end) {
+        max7456MarkDirty(y, start, end);
+    }
 }
 
 bool max7456DmaInProgress(void)
@@ -561,9 +619,12 @@ bool max7456DmaInProgress(void)
 
 bool max7456BuffersSynced(void)
 {
-    for (int i = 0; i < maxScreenSize; i++) {
-        if (screenBuffer[i] != shadowBuffer[i]) {
-            return false;
+    for (int row = 0; row < max7456GetRowsCount(); row++) {
+        for (int col = dirtyStart[row]; col < dirtyEnd[row]; col++) {
+            const int pos = row * CHARS_PER_LINE + col;
+            if (screenBuffer[pos] != shadowBuffer[pos]) {
+                return false;
+            }
         }
     }
     return true;
@@ -619,9 +680,68 @@ void max7456ReInitIfRequired(void)
     //------------   end of (re)init-------------------------------------
 }
 
+static int max7456QueueChar(uint8_t *buff, uint16_t pos)
+{
+    buff[0] = MAX7456ADD_DMAH;
+    buff[1] = pos >> 8;
+    buff[2] = MAX7456ADD_DMAL;
+    buff[3] = pos & 0xff;
+    buff[4] = MAX7456ADD_DMDI;
+    buff[5] = screenBuffer[pos];
+    shadowBuffer[pos] = screenBuffer[pos];
+
+    return MAX7456_SINGLE_CHAR_BYTES;
+}
+
+// The chars must not contain END_STRING, it would end auto-increment mode
+static int max7456QueueRun(uint8_t *buff, uint16_t pos, int len)
+{
+    int n = 0;
+
+    buff[n++] = MAX7456ADD_DMAH;
+    buff[n++] = pos >> 8;
+    buff[n++] = MAX7456ADD_DMAL;
+    buff[n++] = pos & 0xff;
+    buff[n++] = MAX7456ADD_DMM;
+    buff[n++] = displayMemoryModeReg | AUTO_INCREMENT;
+    for (int i = pos; i < pos + len; i++) {
+        buff[n++] = MAX7456ADD_DMDI;
+        buff[n++] = screenBuffer[i];
+        shadowBuffer[i] = screenBuffer[i];
+    }
+    buff[n++] = MAX7456ADD_DMDI;
+    buff[n++] = END_STRING;
+    buff[n++] = MAX7456ADD_DMM;
+    buff[n++] = displayMemoryModeReg;
+
+    return n;
+}
+
+// Length of the run starting at the changed char at pos, up to the last
+// changed char that is at most MAX7456_RUN_MAX_GAP unchanged chars away from
+// the previous one. An END_STRING char is always sent on its own.
+static int max7456FindRun(int pos, int end)
+{
+    if (screenBuffer[pos] == END_STRING) {
+        return 1;
+    }
+
+    int last = pos;
+    for (int i = pos + 1; i < end && i - last <= MAX7456_RUN_MAX_GAP + 1; i++) {
+        if (screenBuffer[i] == END_STRING) {
+            break;
+        }
+        if (screenBuffer[i] != shadowBuffer[i]) {
+            last = i;
+        }
+    }
+
+    return last - pos + 1;
+}
+
 void max7456DrawScreen(void)
 {
-    static uint16_t pos = 0;
+    static uint8_t row = 0;
 
     if (!max7456Lock && !fontIsLoading) {
 
@@ -631,21 +751,51 @@ void max7456DrawScreen(void)
 
         max7456ReInitIfRequired();
 
+        // Walk the dirty spans starting where the previous call stopped,
+        // filling at most one spiBuff per call.
+        const uint8_t rowCount = max7456GetRowsCount();
         int buff_len = 0;
-        for (int k = 0; k < MAX_CHARS2UPDATE; k++) {
-            if (screenBuffer[pos] != shadowBuffer[pos]) {
-                spiBuff[buff_len++] = MAX7456ADD_DMAH;
-                spiBuff[buff_len++] = pos >> 8;
-                spiBuff[buff_len++] = MAX7456ADD_DMAL;
-                spiBuff[buff_len++] = pos & 0xff;
-                spiBuff[buff_len++] = MAX7456ADD_DMDI;
-                spiBuff[buff_len++] = screenBuffer[pos];
-                shadowBuffer[pos] = screenBuffer[pos];
+        bool full = false;
+        for (int r = 0; r < rowCount && !full; r++) {
+            if (row >= rowCount) {
+                row = 0;
+            }
+
+            while (dirtyStart[row] < dirtyEnd[row]) {
+                const int rowPos = row * CHARS_PER_LINE;
+                const int start = dirtyStart[row];
+
+                if (screenBuffer[rowPos + start] == shadowBuffer[rowPos + start]) {
+                    dirtyStart[row]++;
+                    continue;
+                }
+
+                const int len = max7456FindRun(rowPos + start, rowPos + dirtyEnd[row]);
+                int changed = 0;
+                for (int i = start; i < start + len; i++) {
+                    changed += screenBuffer[rowPos + i] != shadowBuffer[rowPos + i];
+                }
+                const bool useRun = MAX7456_RUN_BYTES(len) < changed * MAX7456_SINGLE_CHAR_BYTES;
+                const int bytes = useRun ? MAX7456_RUN_BYTES(len) : changed * MAX7456_SINGLE_CHAR_BYTES;
+                if (buff_len + bytes > (int)sizeof(spiBuff)) {
+                    full = true;
+                    break;
+                }
+
+                if (useRun) {
+                    buff_len += max7456QueueRun(&spiBuff[buff_len], rowPos + start, len);
+                } else {
+                    for (int i = start; i < start + len; i++) {
+                        if (screenBuffer[rowPos + i] != shadowBuffer[rowPos + i]) {
+                            buff_len += max7456QueueChar(&spiBuff[buff_len], rowPos + i);
+                        }
+                    }
+                }
+                dirtyStart[row] += len;
             }
 
-            if (++pos >= maxScreenSize) {
-                pos = 0;
-                break;
+            if (dirtyStart[row] >= dirtyEnd[row]) {
+                row++;
             }
         }
 
@@ -672,7 +822,7 @@ static void max7456DrawScreenSlow(void)
     // The "escape" character 0xFF must be skipped as it causes the MAX7456 to exit auto-increment mode.
     max7456Send(MAX7456ADD_DMAH, 0);
     max7456Send(MAX7456ADD_DMAL, 0);
-    max7456Send(MAX7456ADD_DMM, displayMemoryModeReg | 1);
+    max7456Send(MAX7456ADD_DMM, displayMemoryModeReg | AUTO_INCREMENT);
 
     for (int xx = 0; xx < maxScreenSize; xx++) {
         if (screenBuffer[xx] == END_STRING) {
@@ -683,6 +833,7 @@ static void max7456DrawScreenSlow(void)
         }
         shadowBuffer[xx] = screenBuffer[xx];
     }
+    memset(dirtyEnd, 0, sizeof(dirtyEnd));
 
     max7456Send(MAX7456ADD_DMDI, END_STRING);
     max7456Send(MAX7456ADD_DMM, displayMemoryModeReg);
@@ -26,6 +26,7 @@
 #include "platform.h"
 #include "drivers/time.h"
 
+#include "drivers/dshot.h"
 #include "drivers/io.h"
 #include "pwm_output.h"
 #include "timer.h"
@@ -67,6 +68,9 @@ static bool isDshot = false;
 #ifdef USE_DSHOT_DMAR
 FAST_RAM_ZERO_INIT bool useBurstDshot = false;
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+FAST_RAM_ZERO_INIT bool useDshotTelemetry = false;
+#endif
 
 static void pwmOCConfig(TIM_TypeDef *tim, uint8_t channel, uint16_t value, uint8_t output)
 {
@@ -157,16 +161,6 @@ static FAST_CODE void pwmWriteDshot(uint8_t index, float value)
     pwmWriteDshotInt(index, lrintf(value));
 }
 
-static FAST_CODE uint8_t loadDmaBufferDshot(uint32_t *dmaBuffer, int stride, uint16_t packet)
-{
-    for (int i = 0; i < 16; i++) {
-        dmaBuffer[i * stride] = (packet & 0x8000) ? MOTOR_BIT_1 : MOTOR_BIT_0;  // MSB first
-        packet <<= 1;
-    }
-
-    return DSHOT_DMA_BUFFER_SIZE;
-}
-
 FAST_CODE static uint8_t loadDmaBufferProshot(uint32_t *dmaBuffer, int stride, uint16_t packet)
 {
     for (int i = 0; i < 4; i++) {
@@ -277,13 +271,23 @@ void motorDevInit(const motorDevConfig_t *motorConfig, uint16_t idlePulse, uint8
     case PWM_TYPE_DSHOT300:
     case PWM_TYPE_DSHOT150:
         pwmWrite = &pwmWriteDshot;
-        loadDmaBuffer = &loadDmaBufferDshot;
+        dshotBuildNibbleTable(MOTOR_BIT_0, MOTOR_BIT_1);
+        loadDmaBuffer = &dshotLoadBuffer;
         pwmCompleteWrite = &pwmCompleteDshotMotorUpdate;
         isDshot = true;
+#ifdef USE_DSHOT_TELEMETRY
+        useDshotTelemetry = motorConfig->useDshotTelemetry;
+#endif
 #ifdef USE_DSHOT_DMAR
         if (motorConfig->useBurstDshot) {
             useBurstDshot = true;
         }
+#ifdef USE_DSHOT_TELEMETRY
+        // the eRPM response is captured through each channel's own DMA stream
+        if (useDshotTelemetry) {
+            useBurstDshot = false;
+        }
+#endif
 #endif
         break;
 #endif
@@ -517,20 +521,13 @@ FAST_CODE_NOINLINE bool pwmDshotCommandOutputIsEnabled(uint8_t motorCount)
 
 FAST_CODE uint16_t prepareDshotPacket(motorDmaOutput_t *const motor)
 {
-    uint16_t packet = (motor->value << 1) | (motor->requestTelemetry ? 1 : 0);
+#ifdef USE_DSHOT_TELEMETRY
+    const uint16_t packet = dshotEncodePacket(motor->value, motor->requestTelemetry, motor->hasTelemetry);
+#else
+    const uint16_t packet = dshotEncodePacket(motor->value, motor->requestTelemetry, false);
+#endif
     motor->requestTelemetry = false;    // reset telemetry request to make sure it's triggered only once in a row
 
-    // compute checksum
-    int csum = 0;
-    int csum_data = packet;
-    for (int i = 0; i < 3; i++) {
-        csum ^=  csum_data;   // xor data by nibbles
-        csum_data >>= 4;
-    }
-    csum &= 0xf;
-    // append checksum
-    packet = (packet << 4) | csum;
-
     return packet;
 }
 #endif
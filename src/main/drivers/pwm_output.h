@@ -22,6 +22,7 @@
 
 #include "platform.h"
 
+#include "drivers/dshot.h"
 #include "drivers/io_types.h"
 #include "drivers/pwm_output_counts.h"
 #include "drivers/timer.h"
@@ -119,9 +120,16 @@ typedef struct {
     DMA_Stream_TypeDef *dmaBurstRef;
 #endif
     uint16_t dmaBurstLength;
+    uint16_t dmaBurstPackets[4];        // latest packet per timer channel, expanded together on update
+    uint8_t dmaBurstChannelMask;        // timer channels driving a motor
     uint32_t dmaBurstBuffer[DSHOT_DMA_BUFFER_SIZE * 4];
 #endif
     uint16_t timerDmaSources;
+#ifdef USE_DSHOT_TELEMETRY
+    uint16_t telemetryDmaSources;       // channels that capture the ESC response
+    volatile uint16_t capturePending;   // of those, the ones still sending their frame
+    volatile bool isInput;              // timer is free running for the capture
+#endif
 } motorDmaTimer_t;
 
 typedef struct {
@@ -139,6 +147,16 @@ typedef struct {
 #else
     uint8_t dmaBuffer[DSHOT_DMA_BUFFER_SIZE];
 #endif
+#ifdef USE_DSHOT_TELEMETRY
+    bool hasTelemetry;                  // bidirectional DShot on this channel, N channels cannot capture
+    volatile bool isInput;              // channel is capturing the ESC response
+    uint32_t dshotTelemetryValue;       // last valid eRPM
+    uint16_t dshotTelemetryErrors;      // responses that failed to decode
+    TIM_OCInitTypeDef ocInitStruct;
+    TIM_ICInitTypeDef icInitStruct;
+    DMA_InitTypeDef dmaInitStruct;
+    uint32_t dshotTelemetryBuffer[DSHOT_TELEMETRY_INPUT_LEN];
+#endif
 } motorDmaOutput_t;
 
 motorDmaOutput_t *getMotorDmaOutput(uint8_t index);
@@ -168,10 +186,14 @@ typedef struct motorDevConfig_s {
     uint8_t  motorPwmInversion;             // Active-High vs Active-Low. Useful for brushed FCs converted for brushless operation
     uint8_t  useUnsyncedPwm;
     uint8_t  useBurstDshot;
+    uint8_t  useDshotTelemetry;             // Bidirectional DShot, ESCs reply with eRPM on the signal line
     ioTag_t  ioTags[MAX_SUPPORTED_MOTORS];
 } motorDevConfig_t;
 
 extern bool useBurstDshot;
+#ifdef USE_DSHOT_TELEMETRY
+extern bool useDshotTelemetry;
+#endif
 
 void motorDevInit(const motorDevConfig_t *motorDevConfig, uint16_t idlePulse, uint8_t motorCount);
 
@@ -187,6 +209,9 @@ void servoDevInit(const servoDevConfig_t *servoDevConfig);
 void pwmServoConfig(const struct timerHardware_s *timerHardware, uint8_t servoIndex, uint16_t servoPwmRate, uint16_t servoCenterPulse);
 
 bool isMotorProtocolDshot(void);
+#ifdef USE_DSHOT_TELEMETRY
+uint32_t getDshotTelemetry(uint8_t index);    // eRPM reported by a bidirectional DShot ESC
+#endif
 
 #ifdef USE_DSHOT
 typedef uint8_t loadDmaBufferFn(uint32_t *dmaBuffer, int stride, uint16_t packet);  // function pointer used to encode a digital motor value into the DMA buffer representation
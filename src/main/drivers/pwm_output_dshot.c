@@ -36,6 +36,7 @@
 #include "stm32f30x.h"
 #endif
 #include "pwm_output.h"
+#include "drivers/dshot.h"
 #include "drivers/nvic.h"
 #include "drivers/time.h"
 #include "dma.h"
@@ -61,6 +62,67 @@ uint8_t getTimerIndex(TIM_TypeDef *timer)
     return dmaMotorTimerCount - 1;
 }
 
+#ifdef USE_DSHOT_TELEMETRY
+// The period belongs to the whole timer, so it is only switched once for all its channels.
+// ARR is preloaded, the update event loads the new period and restarts the counter.
+static void pwmDshotSetTimerDirectionOutput(motorDmaTimer_t *dmaMotorTimer, bool output)
+{
+    dmaMotorTimer->isInput = !output;
+    // free running counter so that edge captures are only limited by the counter width
+    TIM_SetAutoreload(dmaMotorTimer->timer, output ? MOTOR_BITLENGTH : 0xffffffff);
+    TIM_GenerateEvent(dmaMotorTimer->timer, TIM_EventSource_Update);
+}
+
+static void pwmDshotSetDirectionOutput(motorDmaOutput_t * const motor, bool output)
+{
+    const timerHardware_t *timerHardware = motor->timerHardware;
+    TIM_TypeDef *timer = timerHardware->tim;
+
+    DMA_DeInit(timerHardware->dmaRef);
+
+    motor->isInput = !output;
+    if (output) {
+        timerOCInit(timer, timerHardware->channel, &motor->ocInitStruct);
+        timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dmaBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = DSHOT_DMA_BUFFER_SIZE;
+    } else {
+        TIM_ICInit(timer, &motor->icInitStruct);
+        motor->dmaInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+        motor->dmaInitStruct.DMA_Memory0BaseAddr = (uint32_t)motor->dshotTelemetryBuffer;
+        motor->dmaInitStruct.DMA_BufferSize = DSHOT_TELEMETRY_INPUT_LEN;
+    }
+
+    DMA_Init(timerHardware->dmaRef, &motor->dmaInitStruct);
+    DMA_ITConfig(timerHardware->dmaRef, DMA_IT_TC, ENABLE);
+}
+
+// Decodes whatever the ESC sent since the last frame and returns the channel to output
+static void pwmDshotReadTelemetry(motorDmaOutput_t * const motor)
+{
+    const timerHardware_t *timerHardware = motor->timerHardware;
+
+    DMA_Cmd(timerHardware->dmaRef, DISABLE);
+    TIM_DMACmd(timerHardware->tim, motor->timerDmaSource, DISABLE);
+
+    const int edgeCount = DSHOT_TELEMETRY_INPUT_LEN - DMA_GetCurrDataCounter(timerHardware->dmaRef);
+    const uint32_t value = dshotDecodeTelemetryPacket(motor->dshotTelemetryBuffer, edgeCount);
+    if (value != DSHOT_TELEMETRY_INVALID) {
+        motor->dshotTelemetryValue = value;
+    } else {
+        motor->dshotTelemetryErrors++;
+    }
+
+    pwmDshotSetDirectionOutput(motor, true);
+}
+
+uint32_t getDshotTelemetry(uint8_t index)
+{
+    return dmaMotors[index].dshotTelemetryValue;
+}
+#endif
+
 void pwmWriteDshotInt(uint8_t index, uint16_t value)
 {
     motorDmaOutput_t *const motor = &dmaMotors[index];
@@ -69,6 +131,12 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value)
         return;
     }
 
+#ifdef USE_DSHOT_TELEMETRY
+    if (motor->isInput) {
+        pwmDshotReadTelemetry(motor);
+    }
+#endif
+
     /*If there is a command ready to go overwrite the value and send that instead*/
     if (pwmDshotCommandIsProcessing()) {
         value = pwmGetDshotCommand(index);
@@ -80,16 +148,15 @@ void pwmWriteDshotInt(uint8_t index, uint16_t value)
     motor->value = value;
 
     uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
+        // expanded for all channels of the timer at once in pwmCompleteDshotMotorUpdate()
+        motor->timer->dmaBurstPackets[timerLookupChannelIndex(motor->timerHardware->channel)] = packet;
     } else
 #endif
     {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+        const uint8_t bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
         motor->timer->timerDmaSources |= motor->timerDmaSource;
         DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, bufferSize);
         DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
@@ -110,6 +177,7 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
+            dshotLoadBurstBuffer(dmaMotorTimers[i].dmaBurstBuffer, dmaMotorTimers[i].dmaBurstPackets, dmaMotorTimers[i].dmaBurstChannelMask);
             DMA_SetCurrDataCounter(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
             DMA_Cmd(dmaMotorTimers[i].dmaBurstRef, ENABLE);
             TIM_DMAConfig(dmaMotorTimers[i].timer, TIM_DMABase_CCR1, TIM_DMABurstLength_4Transfers);
@@ -117,6 +185,12 @@ void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
         } else
 #endif
         {
+#ifdef USE_DSHOT_TELEMETRY
+            if (dmaMotorTimers[i].isInput) {
+                pwmDshotSetTimerDirectionOutput(&dmaMotorTimers[i], true);
+            }
+            dmaMotorTimers[i].capturePending = dmaMotorTimers[i].timerDmaSources & dmaMotorTimers[i].telemetryDmaSources;
+#endif
             TIM_SetCounter(dmaMotorTimers[i].timer, 0);
             TIM_DMACmd(dmaMotorTimers[i].timer, dmaMotorTimers[i].timerDmaSources, ENABLE);
             dmaMotorTimers[i].timerDmaSources = 0;
@@ -140,6 +214,21 @@ static void motor_DMA_IRQHandler(dmaChannelDescriptor_t *descriptor)
             TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, DISABLE);
         }
 
+#ifdef USE_DSHOT_TELEMETRY
+        // frame sent, listen for the eRPM response until the next frame is written
+        if (motor->hasTelemetry && !motor->isInput) {
+            pwmDshotSetDirectionOutput(motor, false);
+            DMA_SetCurrDataCounter(motor->timerHardware->dmaRef, DSHOT_TELEMETRY_INPUT_LEN);
+            DMA_Cmd(motor->timerHardware->dmaRef, ENABLE);
+            TIM_DMACmd(motor->timerHardware->tim, motor->timerDmaSource, ENABLE);
+            // the channels of a timer finish together, the last one switches the timer
+            motor->timer->capturePending &= ~motor->timerDmaSource;
+            if (!motor->timer->capturePending) {
+                pwmDshotSetTimerDirectionOutput(motor->timer, false);
+            }
+        }
+#endif
+
         DMA_CLEAR_FLAG(descriptor, DMA_IT_TCIF);
     }
 }
@@ -200,19 +289,39 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
         TIM_TimeBaseInit(timer, &TIM_TimeBaseStructure);
     }
 
+    bool inverted = output & TIMER_OUTPUT_INVERTED;
+#ifdef USE_DSHOT_TELEMETRY
+    // bidirectional DShot idles high and pulses low, the ESC answers on the same line.
+    // N channels cannot capture, their ESCs are left on normal DShot.
+    motor->hasTelemetry = useDshotTelemetry && !(output & TIMER_OUTPUT_N_CHANNEL);
+    motor->isInput = false;
+    inverted ^= motor->hasTelemetry;
+#endif
+
     TIM_OCStructInit(&TIM_OCInitStructure);
     TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;
     if (output & TIMER_OUTPUT_N_CHANNEL) {
         TIM_OCInitStructure.TIM_OutputNState = TIM_OutputNState_Enable;
         TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
-        TIM_OCInitStructure.TIM_OCNPolarity = (output & TIMER_OUTPUT_INVERTED) ? TIM_OCNPolarity_Low : TIM_OCNPolarity_High;
+        TIM_OCInitStructure.TIM_OCNPolarity = inverted ? TIM_OCNPolarity_Low : TIM_OCNPolarity_High;
     } else {
         TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
         TIM_OCInitStructure.TIM_OCIdleState = TIM_OCIdleState_Set;
-        TIM_OCInitStructure.TIM_OCPolarity =  (output & TIMER_OUTPUT_INVERTED) ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
+        TIM_OCInitStructure.TIM_OCPolarity =  inverted ? TIM_OCPolarity_Low : TIM_OCPolarity_High;
     }
     TIM_OCInitStructure.TIM_Pulse = 0;
 
+#ifdef USE_DSHOT_TELEMETRY
+    motor->ocInitStruct = TIM_OCInitStructure;
+
+    TIM_ICStructInit(&motor->icInitStruct);
+    motor->icInitStruct.TIM_Channel = timerHardware->channel;
+    motor->icInitStruct.TIM_ICPolarity = TIM_ICPolarity_BothEdge;
+    motor->icInitStruct.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    motor->icInitStruct.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    motor->icInitStruct.TIM_ICFilter = 2;
+#endif
+
     timerOCInit(timer, timerHardware->channel, &TIM_OCInitStructure);
     timerOCPreloadConfig(timer, timerHardware->channel, TIM_OCPreload_Enable);
 
@@ -233,6 +342,8 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
         motor->timer->dmaBurstRef = dmaRef;
+        motor->timer->dmaBurstChannelMask |= 1 << timerLookupChannelIndex(timerHardware->channel);
+        motor->timer->dmaBurstLength = DSHOT_DMA_BUFFER_SIZE * 4;
 
         if (!configureTimer) {
             motor->configured = true;
@@ -243,6 +354,13 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     {
         motor->timerDmaSource = timerDmaSource(timerHardware->channel);
         motor->timer->timerDmaSources &= ~motor->timerDmaSource;
+#ifdef USE_DSHOT_TELEMETRY
+        if (motor->hasTelemetry) {
+            motor->timer->telemetryDmaSources |= motor->timerDmaSource;
+        } else {
+            motor->timer->telemetryDmaSources &= ~motor->timerDmaSource;
+        }
+#endif
     }
 
     DMA_Cmd(dmaRef, DISABLE);
@@ -308,6 +426,10 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
     DMA_Init(dmaRef, &DMA_InitStructure);
     DMA_ITConfig(dmaRef, DMA_IT_TC, ENABLE);
 
+#ifdef USE_DSHOT_TELEMETRY
+    motor->dmaInitStruct = DMA_InitStructure;
+#endif
+
     motor->configured = true;
 }
 
@@ -29,6 +29,7 @@
 #include "drivers/io.h"
 #include "timer.h"
 #include "pwm_output.h"
+#include "drivers/dshot.h"
 #include "drivers/nvic.h"
 #include "drivers/time.h"
 #include "dma.h"
@@ -73,16 +74,15 @@ FAST_CODE void pwmWriteDshotInt(uint8_t index, uint16_t value)
     motor->value = value;
 
     uint16_t packet = prepareDshotPacket(motor);
-    uint8_t bufferSize;
 
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
-        bufferSize = loadDmaBuffer(&motor->timer->dmaBurstBuffer[timerLookupChannelIndex(motor->timerHardware->channel)], 4, packet);
-        motor->timer->dmaBurstLength = bufferSize * 4;
+        // expanded for all channels of the timer at once in pwmCompleteDshotMotorUpdate()
+        motor->timer->dmaBurstPackets[timerLookupChannelIndex(motor->timerHardware->channel)] = packet;
     } else
 #endif
     {
-        bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
+        const uint8_t bufferSize = loadDmaBuffer(motor->dmaBuffer, 1, packet);
         motor->timer->timerDmaSources |= motor->timerDmaSource;
         LL_EX_DMA_SetDataLength(motor->timerHardware->dmaRef, bufferSize);
         LL_EX_DMA_EnableStream(motor->timerHardware->dmaRef);
@@ -103,6 +103,7 @@ FAST_CODE void pwmCompleteDshotMotorUpdate(uint8_t motorCount)
     for (int i = 0; i < dmaMotorTimerCount; i++) {
 #ifdef USE_DSHOT_DMAR
         if (useBurstDshot) {
+            dshotLoadBurstBuffer(dmaMotorTimers[i].dmaBurstBuffer, dmaMotorTimers[i].dmaBurstPackets, dmaMotorTimers[i].dmaBurstChannelMask);
             LL_EX_DMA_SetDataLength(dmaMotorTimers[i].dmaBurstRef, dmaMotorTimers[i].dmaBurstLength);
             LL_EX_DMA_EnableStream(dmaMotorTimers[i].dmaBurstRef);
 
@@ -229,6 +230,8 @@ void pwmDshotMotorHardwareConfig(const timerHardware_t *timerHardware, uint8_t m
 #ifdef USE_DSHOT_DMAR
     if (useBurstDshot) {
         motor->timer->dmaBurstRef = dmaRef;
+        motor->timer->dmaBurstChannelMask |= 1 << timerLookupChannelIndex(timerHardware->channel);
+        motor->timer->dmaBurstLength = DSHOT_DMA_BUFFER_SIZE * 4;
 
         if (!configureTimer) {
             motor->configured = true;
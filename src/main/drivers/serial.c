@@ -107,6 +107,15 @@ void serialSetBaudRateCb(serialPort_t *serialPort, void (*cb)(serialPort_t *cont
     }
 }
 
+void serialSetRxFrameCb(serialPort_t *serialPort, serialReceiveFrameCallbackPtr cb)
+{
+    // If the underlying driver receives by DMA and can detect an idle line, then received
+    // bursts are handed to the frame callback instead of calling the byte callback per character.
+    if (serialPort->vTable->setRxFrameCb) {
+        serialPort->vTable->setRxFrameCb(serialPort, cb);
+    }
+}
+
 void serialWriteBufShim(void *instance, const uint8_t *data, int count)
 {
     serialWriteBuf((serialPort_t *)instance, data, count);
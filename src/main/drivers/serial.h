@@ -56,6 +56,7 @@ typedef enum {
 #define CTRL_LINE_STATE_RTS (1 << 1)
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
+typedef void (*serialReceiveFrameCallbackPtr)(const uint8_t *data, uint16_t length, void *rxCallbackData); // used by DMA serial drivers to return idle-line delimited bursts to app
 
 typedef struct serialPort_s {
 
@@ -76,6 +77,7 @@ typedef struct serialPort_s {
     uint32_t txBufferTail;
 
     serialReceiveCallbackPtr rxCallback;
+    serialReceiveFrameCallbackPtr rxFrameCallback;
     void *rxCallbackData;
 
     uint8_t identifier;
@@ -115,6 +117,8 @@ struct serialPortVTable {
     void (*setMode)(serialPort_t *instance, portMode_e mode);
     void (*setCtrlLineStateCb)(serialPort_t *instance, void (*cb)(void *instance, uint16_t ctrlLineState), void *context);
     void (*setBaudRateCb)(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+    // Optional, only implemented by ports that can receive by circular DMA with idle-line detection.
+    void (*setRxFrameCb)(serialPort_t *instance, serialReceiveFrameCallbackPtr cb);
 
     void (*writeBuf)(serialPort_t *instance, const void *data, int count);
     // Optional functions used to buffer large writes.
@@ -131,6 +135,7 @@ void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
 void serialSetBaudRateCb(serialPort_t *instance, void (*cb)(serialPort_t *context, uint32_t baud), serialPort_t *context);
+void serialSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb);
 bool isSerialTransmitBufferEmpty(const serialPort_t *instance);
 void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
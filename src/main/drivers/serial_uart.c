@@ -279,6 +279,7 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setRxFrameCb = uartSetRxFrameCb,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
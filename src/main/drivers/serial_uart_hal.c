@@ -140,6 +140,11 @@ void uartReconfigure(uartPort_t *uartPort)
 
             uartPort->rxDMAPos = __HAL_DMA_GET_COUNTER(&uartPort->rxDMAHandle);
 
+            if (uartPort->port.rxCallback) {
+                __HAL_UART_CLEAR_IDLEFLAG(&uartPort->Handle);
+                __HAL_UART_ENABLE_IT(&uartPort->Handle, UART_IT_IDLE);
+            }
+
         }
         else
         {
@@ -193,7 +198,8 @@ void uartReconfigure(uartPort_t *uartPort)
 
 serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr callback, void *callbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
 {
-    uartPort_t *s = serialUART(device, baudRate, mode, options);
+    // the receive callback is served from the idle line interrupt when receiving by DMA
+    uartPort_t *s = serialUART(device, baudRate, mode, options, callback && (mode & MODE_RX));
 
     if (!s) {
         return (serialPort_t *)s;
@@ -204,8 +210,9 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr callback, v
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with DMA-based RX the callbacks are invoked from the idle line interrupt
     s->port.rxCallback = callback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = callbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -367,6 +374,7 @@ const struct serialPortVTable uartVTable[] = {
         .setMode = uartSetMode,
         .setCtrlLineStateCb = NULL,
         .setBaudRateCb = NULL,
+        .setRxFrameCb = uartSetRxFrameCb,
         .writeBuf = NULL,
         .beginWrite = NULL,
         .endWrite = NULL,
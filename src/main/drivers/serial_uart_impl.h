@@ -169,8 +169,10 @@ void uartStartTxDMA(uartPort_t *s);
 void uartTryStartTxDMA(uartPort_t *s);
 #endif
 
-uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options);
+uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options, bool rxIdleIrq);
 
 void uartIrqHandler(uartPort_t *s);
+void uartSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb);
+void uartRxDmaDispatch(uartPort_t *s, uint32_t rxDMAHead);
 
 void uartReconfigure(uartPort_t *uartPort);
@@ -116,7 +116,8 @@ void uartReconfigure(uartPort_t *uartPort)
 
 serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback, void *rxCallbackData, uint32_t baudRate, portMode_e mode, portOptions_e options)
 {
-    uartPort_t *s = serialUART(device, baudRate, mode, options);
+    // the receive callback is served from the idle line interrupt when receiving by DMA
+    uartPort_t *s = serialUART(device, baudRate, mode, options, rxCallback && (mode & MODE_RX));
 
     if (!s)
         return (serialPort_t *)s;
@@ -126,8 +127,9 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // common serial initialisation code should move to serialPort::init()
     s->port.rxBufferHead = s->port.rxBufferTail = 0;
     s->port.txBufferHead = s->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with DMA-based RX the callbacks are invoked from the idle line interrupt
     s->port.rxCallback = rxCallback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -184,6 +186,9 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
             USART_DMACmd(s->USARTx, USART_DMAReq_Rx, ENABLE);
             s->rxDMAPos = DMA_GetCurrDataCounter(s->rxDMAChannel);
 #endif
+            if (rxCallback) {
+                USART_ITConfig(s->USARTx, USART_IT_IDLE, ENABLE);
+            }
         } else {
             USART_ClearITPendingBit(s->USARTx, USART_IT_RXNE);
             USART_ITConfig(s->USARTx, USART_IT_RXNE, ENABLE);
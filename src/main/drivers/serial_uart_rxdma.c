@@ -0,0 +1,65 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * UART DMA receive dispatch common to all MCUs.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#include "drivers/rcc.h"
+#include "drivers/serial.h"
+#include "drivers/serial_uart.h"
+#include "drivers/serial_uart_impl.h"
+
+void uartSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb)
+{
+    uartPort_t *s = (uartPort_t *)instance;
+    s->port.rxFrameCallback = cb;
+}
+
+// Hand everything the RX DMA has written since the last call to the receive callbacks.
+// Called from the USART idle-line interrupt, so a burst is normally one complete protocol frame.
+void uartRxDmaDispatch(uartPort_t *s, uint32_t rxDMAHead)
+{
+    // rxDMAPos and rxDMAHead count down from rxBufferSize, as the DMA transfer counter does
+    const uint32_t size = s->port.rxBufferSize;
+    const uint32_t head = (size - rxDMAHead) % size;
+    uint32_t tail = size - s->rxDMAPos;
+    const uint8_t *rxBuffer = (const uint8_t *)s->port.rxBuffer;
+
+    while (tail != head) {
+        // A burst that wraps around the end of the circular buffer is delivered in two parts
+        const uint32_t end = head > tail ? head : size;
+        if (s->port.rxFrameCallback) {
+            s->port.rxFrameCallback(&rxBuffer[tail], end - tail, s->port.rxCallbackData);
+        } else {
+            for (uint32_t i = tail; i < end; i++) {
+                s->port.rxCallback(rxBuffer[i], s->port.rxCallbackData);
+            }
+        }
+        tail = end % size;
+    }
+
+    s->rxDMAPos = size - tail;
+}
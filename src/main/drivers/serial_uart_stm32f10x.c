@@ -119,7 +119,7 @@ void uart_tx_dma_IRQHandler(dmaChannelDescriptor_t* descriptor)
 
 // XXX Should serialUART be consolidated?
 
-uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options)
+uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options, bool rxIdleIrq)
 {
     uartDevice_t *uartdev = uartDevmap[device];
     if (!uartdev) {
@@ -175,8 +175,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-    // RX/TX Interrupt
-    if (!hardware->rxDMAChannel || !hardware->txDMAChannel) {
+    // RX/TX Interrupt, also used for idle line detection when receiving by DMA
+    if (!hardware->rxDMAChannel || !hardware->txDMAChannel || rxIdleIrq) {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -204,7 +204,12 @@ void uartIrqHandler(uartPort_t *s)
             }
         }
     }
-    if (SR & USART_FLAG_TXE) {
+    if (s->rxDMAChannel && (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET)) {
+        // Reading SR then DR clears the idle line flag
+        (void)s->USARTx->DR;
+        uartRxDmaDispatch(s, s->rxDMAChannel->CNDTR);
+    }
+    if (SR & USART_FLAG_TXE && !s->txDMAChannel) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             s->USARTx->DR = s->port.txBuffer[s->port.txBufferTail++];
             if (s->port.txBufferTail >= s->port.txBufferSize) {
@@ -205,7 +205,7 @@ void serialUARTInitIO(IO_t txIO, IO_t rxIO, portMode_e mode, portOptions_e optio
 
 // XXX Should serialUART be consolidated?
 
-uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options)
+uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options, bool rxIdleIrq)
 {
     uartDevice_t *uartDev = uartDevmap[device];
     if (!uartDev) {
@@ -244,7 +244,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
 
     serialUARTInitIO(IOGetByTag(uartDev->tx), IOGetByTag(uartDev->rx), mode, options, hardware->af, device);
 
-    if (!s->rxDMAChannel || !s->txDMAChannel) {
+    // RX/TX Interrupt, also used for idle line detection when receiving by DMA
+    if (!s->rxDMAChannel || !s->txDMAChannel || rxIdleIrq) {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -272,6 +273,11 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (s->rxDMAChannel && (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET)) {
+        USART_ClearITPendingBit(s->USARTx, USART_IT_IDLE);
+        uartRxDmaDispatch(s, s->rxDMAChannel->CNDTR);
+    }
+
     if (!s->txDMAChannel && (ISR & USART_FLAG_TXE)) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail++]);
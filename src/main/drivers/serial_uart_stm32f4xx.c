@@ -197,7 +197,7 @@ void dmaIRQHandler(dmaChannelDescriptor_t* descriptor)
 
 // XXX Should serialUART be consolidated?
 
-uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options)
+uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options, bool rxIdleIrq)
 {
     uartDevice_t *uart = uartDevmap[device];
     if (!uart) return NULL;
@@ -256,7 +256,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-    if (!(s->rxDMAChannel)) {
+    // RX/TX Interrupt, also used for idle line detection when receiving by DMA
+    if (!(s->rxDMAChannel) || rxIdleIrq) {
         NVIC_InitTypeDef NVIC_InitStructure;
 
         NVIC_InitStructure.NVIC_IRQChannel = hardware->irqn;
@@ -280,6 +281,12 @@ void uartIrqHandler(uartPort_t *s)
         }
     }
 
+    if (s->rxDMAStream && (USART_GetITStatus(s->USARTx, USART_IT_IDLE) == SET)) {
+        // Reading SR then DR clears the idle line flag
+        (void)s->USARTx->DR;
+        uartRxDmaDispatch(s, s->rxDMAStream->NDTR);
+    }
+
     if (!s->txDMAStream && (USART_GetITStatus(s->USARTx, USART_IT_TXE) == SET)) {
         if (s->port.txBufferTail != s->port.txBufferHead) {
             USART_SendData(s->USARTx, s->port.txBuffer[s->port.txBufferTail]);
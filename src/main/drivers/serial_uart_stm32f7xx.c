@@ -247,7 +247,7 @@ void uartIrqHandler(uartPort_t *s)
 {
     UART_HandleTypeDef *huart = &s->Handle;
     /* UART in mode Receiver ---------------------------------------------------*/
-    if ((__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
+    if (!s->rxDMAStream && (__HAL_UART_GET_IT(huart, UART_IT_RXNE) != RESET)) {
         uint8_t rbyte = (uint8_t)(huart->Instance->RDR & (uint8_t) 0xff);
 
         if (s->port.rxCallback) {
@@ -264,6 +264,12 @@ void uartIrqHandler(uartPort_t *s)
         __HAL_UART_SEND_REQ(huart, UART_RXDATA_FLUSH_REQUEST);
     }
 
+    /* UART idle line detected while receiving by DMA ---------------------------*/
+    if (s->rxDMAStream && (__HAL_UART_GET_IT_SOURCE(huart, UART_IT_IDLE) != RESET) && (__HAL_UART_GET_IT(huart, UART_IT_IDLE) != RESET)) {
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+        uartRxDmaDispatch(s, __HAL_DMA_GET_COUNTER(huart->hdmarx));
+    }
+
     /* UART parity error interrupt occurred -------------------------------------*/
     if ((__HAL_UART_GET_IT(huart, UART_IT_PE) != RESET)) {
         __HAL_UART_CLEAR_IT(huart, UART_CLEAR_PEF);
@@ -330,7 +336,7 @@ void dmaIRQHandler(dmaChannelDescriptor_t* descriptor)
 
 // XXX Should serialUART be consolidated?
 
-uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options)
+uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode, portOptions_e options, bool rxIdleIrq)
 {
     uartDevice_t *uartdev = uartDevmap[device];
     if (!uartdev) {
@@ -396,7 +402,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-    if (!s->rxDMAChannel) {
+    // RX/TX Interrupt, also used for idle line detection when receiving by DMA
+    if (!s->rxDMAChannel || rxIdleIrq) {
         HAL_NVIC_SetPriority(hardware->rxIrq, NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
         HAL_NVIC_EnableIRQ(hardware->rxIrq);
     }
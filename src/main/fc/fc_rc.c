@@ -40,6 +40,7 @@
 #include "fc/fc_rc.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
+#include "fc/rc_prediction.h"
 #include "fc/runtime_config.h"
 
 #include "flight/failsafe.h"
@@ -70,6 +71,7 @@ static volatile uint32_t setpointRateInt[3];
 static float throttlePIDAttenuation;
 static bool reverseMotors = false;
 static applyRatesFn *applyRates;
+static applyRatesFn *applyRatesCurve;
 
 // static float rcCommandInterp[4] = { 0, 0, 0, 0 };
 // static float rcStepSize[4] = { 0, 0, 0, 0 };
@@ -81,6 +83,7 @@ volatile uint8_t skipInterpolate;
 volatile int16_t rcInterpolationStepCount;
 volatile uint16_t rxRefreshRate;
 volatile uint16_t currentRxRefreshRate;
+static FAST_RAM_ZERO_INIT uint16_t currentRxFrameAgeUs;
 
 #if defined(USE_TPA_CURVES)
 float throttleLookupKp[1024];
@@ -153,6 +156,12 @@ float getThrottlePIDAttenuationKd(void) {
 #define RC_SMOOTHING_RX_RATE_MAX_US             50000 // 50ms or 20hz
 
 static FAST_RAM_ZERO_INIT rcSmoothingFilter_t rcSmoothingData;
+
+#define RC_PREDICTION_MAX_JERK                  1000000.0f  // rcCommand units per second cubed
+
+static FAST_RAM_ZERO_INIT rcPredictor_t rcPredictors[PRIMARY_CHANNEL_COUNT];
+static FAST_RAM_ZERO_INIT float setpointRateDerivative[XYZ_AXIS_COUNT];
+static FAST_RAM_ZERO_INIT bool setpointRateDerivativeValid[XYZ_AXIS_COUNT];
 #endif // USE_RC_SMOOTHING_FILTER
 
 float getSetpointRate(int axis)
@@ -224,6 +233,68 @@ float applyRaceFlightRates(const int axis, float rcCommandf, const float rcComma
     return angleRate;
 }
 
+#if defined(USE_RATE_LOOKUP)
+#define RATE_LOOKUP_SEGMENTS  512   // segments covering stick deflection [0;1]
+#define RATE_LOOKUP_MAX_ERROR 0.1f  // deg/sec
+
+STATIC_UNIT_TESTED float rateLookup[XYZ_AXIS_COUNT][RATE_LOOKUP_SEGMENTS + 1];
+STATIC_UNIT_TESTED uint16_t rateLookupSegments[XYZ_AXIS_COUNT]; // segments that interpolate to within RATE_LOOKUP_MAX_ERROR of the curve
+static uint32_t rateLookupKey[XYZ_AXIS_COUNT];
+
+// All rate curves are odd functions so the table only covers positive deflection.
+static void buildRateLookupTable(int axis)
+{
+    for (int i = 0; i <= RATE_LOOKUP_SEGMENTS; i++) {
+        const float rcCommandf = (float)i / RATE_LOOKUP_SEGMENTS;
+        rateLookup[axis][i] = applyRatesCurve(axis, rcCommandf, rcCommandf);
+    }
+
+    // High super rates bend too sharply near full deflection to be interpolated, so only use the table
+    // up to the first segment that strays from the curve. The quarter points catch the super rate kink.
+    int segments = 0;
+    while (segments < RATE_LOOKUP_SEGMENTS) {
+        bool accurate = true;
+        for (int i = 1; i < 4 && accurate; i++) {
+            const float fraction = i / 4.0f;
+            const float rcCommandf = (segments + fraction) / RATE_LOOKUP_SEGMENTS;
+            const float curve = constrainf(applyRatesCurve(axis, rcCommandf, rcCommandf), -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+            const float interpolated = rateLookup[axis][segments] + (rateLookup[axis][segments + 1] - rateLookup[axis][segments]) * fraction;
+            accurate = fabsf(constrainf(interpolated, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT) - curve) <= RATE_LOOKUP_MAX_ERROR * 0.75f;
+        }
+        if (!accurate) {
+            break;
+        }
+        segments++;
+    }
+    rateLookupSegments[axis] = segments;
+}
+
+static void updateRateLookupTables(void)
+{
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        // only rebuild when the curve has changed, in-flight adjustments of other settings also end up here
+        const uint32_t key = (1U << 31) | (currentControlRateProfile->rates_type << 24) | (currentControlRateProfile->rcRates[axis] << 16)
+            | (currentControlRateProfile->rcExpo[axis] << 8) | currentControlRateProfile->rates[axis];
+        if (rateLookupKey[axis] != key) {
+            buildRateLookupTable(axis);
+            rateLookupKey[axis] = key;
+        }
+    }
+}
+
+STATIC_UNIT_TESTED float applyRatesLookup(const int axis, float rcCommandf, const float rcCommandfAbs)
+{
+    const float position = rcCommandfAbs * RATE_LOOKUP_SEGMENTS;
+    const int index = position;
+    if (index >= rateLookupSegments[axis]) {
+        return applyRatesCurve(axis, rcCommandf, rcCommandfAbs);
+    }
+
+    const float angleRate = rateLookup[axis][index] + (rateLookup[axis][index + 1] - rateLookup[axis][index]) * (position - index);
+    return (rcCommandf < 0) ? -angleRate : angleRate;
+}
+#endif // USE_RATE_LOOKUP
+
 static void calculateSetpointRate(int axis)
 {
     static volatile float angleRate;
@@ -277,8 +348,6 @@ static void scaleRcCommandToFpvCamAngle(void)
 
 static void checkForThrottleErrorResetState(uint16_t rxRefreshRate)
 {
-    currentRxRefreshRate = constrain(getTaskDeltaTime(TASK_RX),1000,20000);
-
     static int index;
     static int16_t rcCommandThrottlePrevious[THROTTLE_BUFFER_MAX];
 
@@ -302,6 +371,12 @@ static void checkForThrottleErrorResetState(uint16_t rxRefreshRate)
     }
 }
 
+// The next frame is due one frame interval after this one arrived, not after it was processed
+STATIC_UNIT_TESTED uint16_t rcInterpolationAutoRefreshRate(void)
+{
+    return currentRxRefreshRate - MIN(currentRxFrameAgeUs, currentRxRefreshRate / 2) + 1000; // Add slight overhead to prevent ramps
+}
+
 FAST_CODE uint8_t processRcInterpolation(void)
 {
     static FAST_RAM_ZERO_INIT float rcCommandInterp[4];
@@ -315,7 +390,7 @@ FAST_CODE uint8_t processRcInterpolation(void)
          // Set RC refresh rate for sampling and channels to filter
         switch (rxConfig()->rcInterpolation) {
         case RC_SMOOTHING_AUTO:
-            rxRefreshRate = currentRxRefreshRate + 1000; // Add slight overhead to prevent ramps
+            rxRefreshRate = rcInterpolationAutoRefreshRate();
             break;
         case RC_SMOOTHING_MANUAL:
             rxRefreshRate = 1000 * rxConfig()->rcInterpolationInterval;
@@ -613,6 +688,62 @@ FAST_CODE uint8_t processRcSmoothingFilter(void)
 
     return interpolationChannels;
 }
+
+FAST_CODE uint8_t processRcPrediction(void)
+{
+    static FAST_RAM_ZERO_INIT bool initialized;
+
+    if (!initialized) {
+        for (int i = 0; i < PRIMARY_CHANNEL_COUNT; i++) {
+            rcPredictorInit(&rcPredictors[i], RC_PREDICTION_MAX_JERK);
+        }
+        initialized = true;
+    }
+
+    const float dT = targetPidLooptime * 1e-6f;
+    for (int channel = 0; channel < PRIMARY_CHANNEL_COUNT; channel++) {
+        if ((1 << channel) & interpolationChannels) {
+            rcPredictor_t *predictor = &rcPredictors[channel];
+            if (isRXDataNew) {
+                rcPredictorAddSample(predictor, rcCommand[channel], currentRxRefreshRate * 1e-6f);
+                // the frame arrived some time before it was processed, catch the prediction up
+                rcPredictorApply(predictor, currentRxFrameAgeUs * 1e-6f);
+            }
+
+            const float predicted = rcPredictorApply(predictor, dT);
+            if (channel == THROTTLE) {
+                rcCommand[channel] = constrainf(predicted, PWM_RANGE_MIN, PWM_RANGE_MAX);
+            } else {
+                rcCommand[channel] = constrainf(predicted, -500.0f, 500.0f);
+            }
+        }
+    }
+
+    return interpolationChannels;
+}
+
+// Feed forward is calculated from the predicted stick slope carried through the rate
+// curve, instead of differencing a setpoint that only changes when a frame arrives.
+static void calculateSetpointRateDerivative(int axis)
+{
+    setpointRateDerivativeValid[axis] = false;
+
+    if (rxConfig()->rc_smoothing_type != RC_SMOOTHING_TYPE_PREDICTIVE || !((1 << axis) & interpolationChannels)) {
+        return;
+    }
+#ifdef USE_GPS_RESCUE
+    if ((axis == FD_YAW) && FLIGHT_MODE(GPS_RESCUE_MODE)) {
+        return;
+    }
+#endif
+
+    const float dT = targetPidLooptime * 1e-6f;
+    const float rcCommandf = constrainf((rcCommand[axis] + rcPredictorDerivative(&rcPredictors[axis]) * dT) / 500.0f, -1.0f, 1.0f);
+    const float angleRate = constrainf(applyRates(axis, rcCommandf, ABS(rcCommandf)), -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+
+    setpointRateDerivative[axis] = (angleRate - setpointRate[axis]) / dT;
+    setpointRateDerivativeValid[axis] = true;
+}
 #endif // USE_RC_SMOOTHING_FILTER
 
 FAST_CODE void processRcCommand(void)
@@ -628,6 +759,9 @@ FAST_CODE void processRcCommand(void)
     case RC_SMOOTHING_TYPE_FILTER:
         updatedChannel = processRcSmoothingFilter();
         break;
+    case RC_SMOOTHING_TYPE_PREDICTIVE:
+        updatedChannel = processRcPrediction();
+        break;
 #endif // USE_RC_SMOOTHING_FILTER
     case RC_SMOOTHING_TYPE_INTERPOLATION:
     default:
@@ -646,6 +780,9 @@ FAST_CODE void processRcCommand(void)
 #pragma GCC diagnostic pop
 #endif
             calculateSetpointRate(axis);
+#ifdef USE_RC_SMOOTHING_FILTER
+            calculateSetpointRateDerivative(axis);
+#endif
         }
 
         DEBUG_SET(DEBUG_RC_INTERPOLATION, 3, setpointRate[0]);
@@ -658,6 +795,10 @@ FAST_CODE void processRcCommand(void)
         // Scaling of AngleRate to camera angle (Mixing Roll and Yaw)
         if (rxConfig()->fpvCamAngleDegrees && IS_RC_MODE_ACTIVE(BOXFPVANGLEMIX) && !FLIGHT_MODE(HEADFREE_MODE)) {
             scaleRcCommandToFpvCamAngle();
+#ifdef USE_RC_SMOOTHING_FILTER
+            // the predicted derivatives are for the unmixed axes
+            memset(setpointRateDerivativeValid, 0, sizeof(setpointRateDerivativeValid));
+#endif
         }
 
         // HEADFREE_MODE in ACRO_MODE
@@ -672,6 +813,9 @@ FAST_CODE void processRcCommand(void)
             setpointRate[ROLL] = constrainf(vSetpointRate.x, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
             setpointRate[PITCH] = constrainf(vSetpointRate.y, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
             setpointRate[YAW] = constrainf(vSetpointRate.z, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT);
+#ifdef USE_RC_SMOOTHING_FILTER
+            memset(setpointRateDerivativeValid, 0, sizeof(setpointRateDerivativeValid));
+#endif
         }
 
         DEBUG_SET(DEBUG_ANGLERATE, ROLL, setpointRate[ROLL]);
@@ -684,8 +828,23 @@ FAST_CODE void processRcCommand(void)
     }
 }
 
+STATIC_UNIT_TESTED void updateRxRefreshRate(void)
+{
+    timeDelta_t frameAgeUs;
+    timeDelta_t frameDeltaUs = rxGetFrameDelta(&frameAgeUs);
+
+    if (!frameDeltaUs) {
+        // no frame timing available yet, fall back to the rx task interval
+        frameDeltaUs = getTaskDeltaTime(TASK_RX);
+        frameAgeUs = 0;
+    }
+    currentRxRefreshRate = constrain(frameDeltaUs, 1000, 20000);
+    currentRxFrameAgeUs = constrain(frameAgeUs, 0, currentRxRefreshRate);
+}
+
 FAST_CODE FAST_CODE_NOINLINE void updateRcCommands(void)
 {
+    updateRxRefreshRate();
     isRXDataNew = true;
     // PITCH & ROLL only dynamic PID adjustment,  depending on throttle value
     int32_t prop;
@@ -810,15 +969,22 @@ void initRcProcessing(void)
     switch (currentControlRateProfile->rates_type) {
     case RATES_TYPE_BETAFLIGHT:
     default:
-        applyRates = applyBetaflightRates;
+        applyRatesCurve = applyBetaflightRates;
 
         break;
     case RATES_TYPE_RACEFLIGHT:
-        applyRates = applyRaceFlightRates;
+        applyRatesCurve = applyRaceFlightRates;
 
         break;
     }
 
+#if defined(USE_RATE_LOOKUP)
+    updateRateLookupTables();
+    applyRates = applyRatesLookup;
+#else
+    applyRates = applyRatesCurve;
+#endif
+
     interpolationChannels = 0;
     switch (rxConfig()->rcInterpolationChannels) {
     case INTERPOLATION_CHANNELS_RPYT:
@@ -872,6 +1038,16 @@ int rcSmoothingGetValue(int whichValue)
     }
 }
 
+bool rcPredictionIsActive(int axis)
+{
+    return setpointRateDerivativeValid[axis];
+}
+
+float getSetpointRateDerivative(int axis)
+{
+    return setpointRateDerivative[axis];
+}
+
 bool rcSmoothingInitializationComplete(void) {
     return (rxConfig()->rc_smoothing_type != RC_SMOOTHING_TYPE_FILTER) || rcSmoothingData.filterInitialized;
 }
@@ -46,6 +46,8 @@ bool rcSmoothingIsEnabled(void);
 int rcSmoothingGetValue(int whichValue);
 bool rcSmoothingAutoCalculate(void);
 bool rcSmoothingInitializationComplete(void);
+bool rcPredictionIsActive(int axis);
+float getSetpointRateDerivative(int axis);
 #endif
 
 #if defined(USE_TPA_CURVES)
@@ -0,0 +1,119 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "fc/rc_prediction.h"
+
+#define RC_PREDICTION_MAX_EXTRAPOLATION 1.5f  // frame intervals to extrapolate before holding the prediction
+
+void rcPredictorInit(rcPredictor_t *predictor, float maxJerk)
+{
+    memset(predictor, 0, sizeof(rcPredictor_t));
+    predictor->maxJerk = maxJerk;
+}
+
+void rcPredictorAddSample(rcPredictor_t *predictor, float sample, float frameInterval)
+{
+    if (frameInterval <= 0.0f) {
+        return;
+    }
+
+    for (int i = RC_PREDICTION_HISTORY - 1; i > 0; i--) {
+        predictor->sample[i] = predictor->sample[i - 1];
+    }
+    for (int i = RC_PREDICTION_HISTORY - 2; i > 0; i--) {
+        predictor->sampleInterval[i] = predictor->sampleInterval[i - 1];
+    }
+    predictor->sample[0] = sample;
+    predictor->sampleInterval[0] = frameInterval;
+
+    if (predictor->sampleCount < RC_PREDICTION_HISTORY) {
+        predictor->sampleCount++;
+    }
+
+    if (predictor->sampleCount < 2) {
+        // nothing to extrapolate from yet
+        predictor->output = sample;
+        predictor->derivative = 0.0f;
+        predictor->frameInterval = frameInterval;
+        predictor->elapsed = 0.0f;
+        return;
+    }
+
+    // the backward difference is the slope half a frame ago
+    const float slope = (predictor->sample[0] - predictor->sample[1]) / predictor->sampleInterval[0];
+    if (predictor->sampleCount >= 3) {
+        const float previousSlope = (predictor->sample[1] - predictor->sample[2]) / predictor->sampleInterval[1];
+        const float accel = (slope - previousSlope) * 2.0f / (predictor->sampleInterval[0] + predictor->sampleInterval[1]);
+        const float maxAccelChange = predictor->maxJerk * frameInterval;
+        predictor->accel += constrainf(accel - predictor->accel, -maxAccelChange, maxAccelChange);
+    }
+    predictor->slope = slope + predictor->accel * predictor->sampleInterval[0] * 0.5f;
+
+    // continue from where the output is now and converge on the new trajectory over the next frame
+    predictor->correction = predictor->output - sample;
+    predictor->frameInterval = frameInterval;
+    predictor->elapsed = 0.0f;
+}
+
+float rcPredictorApply(rcPredictor_t *predictor, float dT)
+{
+    if (predictor->sampleCount < 2) {
+        return predictor->output;
+    }
+
+    const float frameInterval = predictor->frameInterval;
+    const float maxElapsed = frameInterval * RC_PREDICTION_MAX_EXTRAPOLATION;
+    predictor->elapsed = MIN(predictor->elapsed + dT, maxElapsed);
+    const float t = MIN(predictor->elapsed, frameInterval);
+
+    float correction = 0.0f;
+    if (t < frameInterval) {
+        // smoothstep the correction away so the output has no kinks at either end of the frame
+        const float u = t / frameInterval;
+        correction = predictor->correction * (1.0f - u * u * (3.0f - 2.0f * u));
+    }
+
+    predictor->output = predictor->sample[0] + (predictor->slope + 0.5f * predictor->accel * t) * t + correction;
+    // the correction only repairs the position, leave it out of the derivative so it is not amplified by feed forward
+    predictor->derivative = predictor->slope + predictor->accel * t;
+
+    if (predictor->elapsed > frameInterval) {
+        // the next frame is late, ease the prediction to a stop over the jitter allowance and hold it there
+        const float overrun = predictor->elapsed - frameInterval;
+        const float stopTime = maxElapsed - frameInterval;
+        predictor->output += predictor->derivative * (overrun - overrun * overrun / (2.0f * stopTime));
+        predictor->derivative *= 1.0f - overrun / stopTime;
+    }
+
+    return predictor->output;
+}
+
+float rcPredictorDerivative(const rcPredictor_t *predictor)
+{
+    return predictor->derivative;
+}
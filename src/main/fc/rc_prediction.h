@@ -0,0 +1,47 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#define RC_PREDICTION_HISTORY 3
+
+// Extrapolates an rc channel between rx frames. The slope and acceleration are
+// estimated from the last RC_PREDICTION_HISTORY frames, with the change in
+// acceleration per frame limited by maxJerk. When a frame arrives the error in
+// the prediction is spread over the following frame interval instead of being
+// applied as a step.
+typedef struct rcPredictor_s {
+    float sample[RC_PREDICTION_HISTORY];        // received values, newest first
+    float sampleInterval[RC_PREDICTION_HISTORY - 1]; // seconds between consecutive samples
+    uint8_t sampleCount;
+    float maxJerk;          // units per second cubed
+    float slope;            // units per second at the newest sample
+    float accel;            // units per second squared
+    float correction;       // prediction error still to be absorbed
+    float frameInterval;    // seconds
+    float elapsed;          // seconds since the newest sample
+    float output;
+    float derivative;       // units per second
+} rcPredictor_t;
+
+void rcPredictorInit(rcPredictor_t *predictor, float maxJerk);
+void rcPredictorAddSample(rcPredictor_t *predictor, float sample, float frameInterval);
+float rcPredictorApply(rcPredictor_t *predictor, float dT);
+float rcPredictorDerivative(const rcPredictor_t *predictor);
@@ -41,6 +41,7 @@
 #include "flight/imu.h"
 #include "flight/pid.h"
 #include "flight/position.h"
+#include "flight/position_estimator.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -243,6 +244,24 @@ void sensorUpdate()
         previousAltitude = rescueState.sensor.currentAltitude;
         previousTimeUs = currentTimeUs;
     }
+
+#ifdef USE_POSITION_ESTIMATOR
+    // the estimate is current on every call instead of as old as the last GPS fix
+    if (positionEstimatorIsValid(POSITION_NORTH) && positionEstimatorIsValid(POSITION_EAST)) {
+        const float north = positionEstimatorGetPosition(POSITION_NORTH);
+        const float east = positionEstimatorGetPosition(POSITION_EAST);
+        int16_t directionToHome = lrintf(atan2_approx(-east, -north) / RAD);
+        if (directionToHome < 0) {
+            directionToHome += 360;
+        }
+        rescueState.sensor.distanceToHome = sqrtf(sq(north) + sq(east)) / 100;
+        rescueState.sensor.directionToHome = directionToHome;
+        rescueState.sensor.groundSpeed = sqrtf(sq(positionEstimatorGetVelocity(POSITION_NORTH)) + sq(positionEstimatorGetVelocity(POSITION_EAST)));
+    }
+    if (positionEstimatorIsValid(POSITION_UP)) {
+        rescueState.sensor.zVelocity = positionEstimatorGetVelocity(POSITION_UP);
+    }
+#endif
 }
 
 void performSanityChecks()
@@ -420,6 +439,7 @@ void rescueAttainPosition()
 // Very similar to maghold function on betaflight/cleanflight
 void setBearing(int16_t desiredHeading)
 {
+    imuRefreshEulerAngles();
     float errorAngle = (attitude.values.yaw / 10.0f) - desiredHeading;
 
     // Determine the most efficient direction to rotate
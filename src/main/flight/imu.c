@@ -41,6 +41,7 @@
 #include "flight/imu.h"
 #include "flight/mixer.h"
 #include "flight/pid.h"
+#include "flight/position_estimator.h"
 
 #include "io/gps.h"
 #include "io/beeper.h"
@@ -94,15 +95,22 @@ quaternion qOffset = QUATERNION_INITIALIZE;
 
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
+// set when qAttitude moved on since attitude was last computed
+static bool eulerAnglesStale = false;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 0);
+// below this half rotation angle per update (radians) the rotation quaternion
+// comes from a Taylor series, its error is under 1e-10
+#define IMU_TAYLOR_HALF_ANGLE_MAX 0.05f
+
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 1);
 
 PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .dcm_kp = 7013,
     .dcm_ki = 13,
     .small_angle = 25,
     .accDeadband = {.xy = 40, .z= 40},
-    .acc_unarmedcal = 1
+    .acc_unarmedcal = 1,
+    .gyro_propagation = 1
 );
 
 
@@ -123,6 +131,7 @@ void imuConfigure(uint16_t throttle_correction_angle)
     imuRuntimeConfig.dcm_ki = imuConfig()->dcm_ki / 10000.0f;
     imuRuntimeConfig.acc_unarmedcal = imuConfig()->acc_unarmedcal;
     imuRuntimeConfig.small_angle = imuConfig()->small_angle;
+    imuRuntimeConfig.gyro_propagation = imuConfig()->gyro_propagation;
 
     fc_acc = calculateAccZLowPassFilterRCTimeConstant(5.0f); // Set to fix value
     throttleAngleScale = calculateThrottleAngleScale(throttle_correction_angle);
@@ -152,7 +161,7 @@ void imuResetAccelerationSum(void)
 
 #if defined(USE_ALT_HOLD)
 // rotate acc into Earth frame and calculate acceleration in it
-static void imuCalculateAcceleration(timeDelta_t deltaT)
+STATIC_UNIT_TESTED void imuCalculateAcceleration(timeDelta_t deltaT)
 {
     static float accZoffset = 0;
     static float accz_smooth = 0;
@@ -186,6 +195,16 @@ static void imuCalculateAcceleration(timeDelta_t deltaT)
     // sum up Values for later integration to get velocity and distance
     accTimeSum += deltaT;
     accSumCount++;
+
+#ifdef USE_POSITION_ESTIMATOR
+    const float accToCmss = 980.665f / acc.dev.acc_1G;
+    const float accelerationCmss[POSITION_AXIS_COUNT] = {
+        [POSITION_NORTH] = accel_ned.x * accToCmss,
+        [POSITION_EAST] = -accel_ned.y * accToCmss,     // the earth frame is north west up
+        [POSITION_UP] = accel_ned.z * accToCmss,
+    };
+    positionEstimatorPredict(accelerationCmss, dT);
+#endif
 }
 #endif // USE_ALT_HOLD
 
@@ -202,6 +221,52 @@ static float imuUseFastGains(void) {
         }
     }
 }
+
+STATIC_UNIT_TESTED void imuUpdateEulerAngles(void) {
+    quaternionProducts buffer;
+
+    if (FLIGHT_MODE(HEADFREE_MODE)) {
+        quaternionMultiply(&qOffset, &qAttitude, &qHeadfree);
+        quaternionComputeProducts(&qHeadfree, &buffer);
+    } else {
+        quaternionComputeProducts(&qAttitude, &buffer);
+    }
+
+    attitude.values.roll = lrintf(atan2_approx((+2.0f * (buffer.wx + buffer.yz)), (+1.0f - 2.0f * (buffer.xx + buffer.yy))) * (1800.0f / M_PIf));
+    attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(+2.0f * (buffer.wy - buffer.xz))) * (1800.0f / M_PIf));
+    attitude.values.yaw = lrintf((-atan2_approx((+2.0f * (buffer.wz + buffer.xy)), (+1.0f - 2.0f * (buffer.yy + buffer.zz))) * (1800.0f / M_PIf)));
+
+    if (attitude.values.yaw < 0) {
+        attitude.values.yaw += 3600;
+    }
+    eulerAnglesStale = false;
+}
+
+static void imuUpdateEulerAnglesIfStale(void)
+{
+    if (eulerAnglesStale) {
+        imuUpdateEulerAngles();
+    }
+}
+
+// Code reading attitude calls this first. The Euler angles cost three inverse
+// trig functions and are only computed when something reads them.
+void imuRefreshEulerAngles(void)
+{
+    IMU_LOCK;
+    imuUpdateEulerAnglesIfStale();
+    IMU_UNLOCK;
+}
+
+static void imuUpdateSmallAngleState(void)
+{
+    if (getCosTiltAngle() > smallAngleCosZ) {
+        ENABLE_STATE(SMALL_ANGLE);
+    } else {
+        DISABLE_STATE(SMALL_ANGLE);
+    }
+}
+
 #if defined(USE_MAG) || defined(USE_GPS)
 static void applyVectorError(float ez_ef, quaternion *vError){
     // Rotate mag error vector back to BF and accumulate
@@ -230,6 +295,7 @@ static void applySensorCorrection(quaternion *vError){
         // In case of a fixed-wing aircraft we can use GPS course over ground to correct heading
         if(!STATE(FIXED_WING))
         {
+            imuUpdateEulerAnglesIfStale();
             float tiltDirection = atan2_approx(attitude.values.roll, attitude.values.pitch); // For applying correction to heading based on craft tilt in 2d space
             courseOverGround += tiltDirection;
 
@@ -276,7 +342,27 @@ static void applySensorCorrection(quaternion *vError){
 #endif
 }
 
-static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError) {
+// Rotation quaternion of turning at rate vGyro, of modulus vGyroModulus, for dt.
+// Small rotations, the usual case at the attitude task rate, use the Taylor
+// series of cos and sin(x)/x, which also saves dividing by the modulus.
+static void imuRotationQuaternion(const quaternion *vGyro, float vGyroModulus, float dt, quaternion *qRotation)
+{
+    const float halfAngle = 0.5f * vGyroModulus * dt;
+    float scale;
+    if (halfAngle < IMU_TAYLOR_HALF_ANGLE_MAX) {
+        const float halfAngleSq = halfAngle * halfAngle;
+        qRotation->w = 1.0f - halfAngleSq * (1.0f / 2.0f - halfAngleSq * (1.0f / 24.0f));
+        scale = (1.0f - halfAngleSq * (1.0f / 6.0f - halfAngleSq * (1.0f / 120.0f))) * 0.5f * dt;
+    } else {
+        qRotation->w = cos_approx(halfAngle);
+        scale = sin_approx(halfAngle) / vGyroModulus;
+    }
+    qRotation->x = vGyro->x * scale;
+    qRotation->y = vGyro->y * scale;
+    qRotation->z = vGyro->z * scale;
+}
+
+STATIC_UNIT_TESTED void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError) {
     quaternion vKpKi = VECTOR_INITIALIZE;
     static quaternion vIntegralFB = VECTOR_INITIALIZE;
     quaternion qBuff, qDiff;
@@ -304,10 +390,7 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
     const float vGyroModulus = quaternionModulus(vGyro);
     // reduce gyro noise integration integrate only above vGyroStdDevModulus
     if (vGyroModulus > vGyroStdDevModulus) {
-        qDiff.w = cosf(vGyroModulus * 0.5f * dt);
-        qDiff.x = sinf(vGyroModulus * 0.5f * dt) * (vGyro->x / vGyroModulus);
-        qDiff.y = sinf(vGyroModulus * 0.5f * dt) * (vGyro->y / vGyroModulus);
-        qDiff.z = sinf(vGyroModulus * 0.5f * dt) * (vGyro->z / vGyroModulus);
+        imuRotationQuaternion(vGyro, vGyroModulus, dt, &qDiff);
         quaternionMultiply(&qAttitude, &qDiff, &qAttitude);
     }
 
@@ -326,6 +409,7 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
 
     // compute caching products
     quaternionComputeProducts(&qAttitude, &qpAttitude);
+    eulerAnglesStale = true;
 
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU0, lrintf(vGyroModulus * 1000));
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU1, lrintf(vKpKiModulus * 1000));
@@ -333,30 +417,6 @@ static void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError)
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU3, lrintf(vGyroStdDevModulus * 1000));
 }
 
-STATIC_UNIT_TESTED void imuUpdateEulerAngles(void) {
-    quaternionProducts buffer;
-
-    if (FLIGHT_MODE(HEADFREE_MODE)) {
-        quaternionMultiply(&qOffset, &qAttitude, &qHeadfree);
-        quaternionComputeProducts(&qHeadfree, &buffer);
-    } else {
-        quaternionComputeProducts(&qAttitude, &buffer);
-    }
-
-    attitude.values.roll = lrintf(atan2_approx((+2.0f * (buffer.wx + buffer.yz)), (+1.0f - 2.0f * (buffer.xx + buffer.yy))) * (1800.0f / M_PIf));
-    attitude.values.pitch = lrintf(((0.5f * M_PIf) - acos_approx(+2.0f * (buffer.wy - buffer.xz))) * (1800.0f / M_PIf));
-    attitude.values.yaw = lrintf((-atan2_approx((+2.0f * (buffer.wz + buffer.xy)), (+1.0f - 2.0f * (buffer.yy + buffer.zz))) * (1800.0f / M_PIf)));
-
-    if (attitude.values.yaw < 0) {
-        attitude.values.yaw += 3600;
-    }
-
-    if (getCosTiltAngle() > smallAngleCosZ) {
-        ENABLE_STATE(SMALL_ANGLE);
-    } else {
-        DISABLE_STATE(SMALL_ANGLE);
-    }
-}
 static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
 {
     static timeUs_t previousIMUUpdateTime;
@@ -375,6 +435,12 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
     quaternion vGyroAverage;
     quaternion vAccAverage;
     gyroGetAverage(&vGyroAverage);
+    if (imuRuntimeConfig.gyro_propagation) {
+        // imuPropagateAttitude() already turned qAttitude by the gyro, only the
+        // corrections are applied here
+        quaternionInitVector(&vGyroAverage);
+        quaternionNormalize(&qAttitude);
+    }
     accGetAverage(&vAccAverage);
     DEBUG_SET(DEBUG_IMU, DEBUG_IMU2, lrintf((quaternionModulus(&vAccAverage)/ acc.dev.acc_1G) * 1000));
     if (accIsHealthy(&vAccAverage)) {
@@ -382,7 +448,7 @@ static void imuCalculateEstimatedAttitude(timeUs_t currentTimeUs)
     }
     applySensorCorrection(&vError);
     imuMahonyAHRSupdate(deltaT * 1e-6f, &vGyroAverage, &vError);
-    imuUpdateEulerAngles();
+    imuUpdateSmallAngleState();
 #endif
 
 #if defined(USE_ALT_HOLD)
@@ -410,6 +476,33 @@ void imuUpdateAttitude(timeUs_t currentTimeUs)
     }
 }
 
+// Turns qAttitude by the filtered gyro every PID loop, so the level modes act
+// on an attitude as recent as the rates they control. The accelerometer, mag
+// and GPS corrections stay in the attitude task.
+void imuPropagateAttitude(float dt)
+{
+    if (!imuRuntimeConfig.gyro_propagation || !sensors(SENSOR_ACC) || !acc.isAccelUpdatedAtLeastOnce) {
+        return;
+    }
+
+    quaternion vGyro;
+    vGyro.w = 0;
+    vGyro.x = DEGREES_TO_RADIANS(gyro.gyroADCf[X]);
+    vGyro.y = DEGREES_TO_RADIANS(gyro.gyroADCf[Y]);
+    vGyro.z = DEGREES_TO_RADIANS(gyro.gyroADCf[Z]);
+
+    const float vGyroModulus = quaternionModulus(&vGyro);
+    if (vGyroModulus > vGyroStdDevModulus) {
+        IMU_LOCK;
+        quaternion qDiff;
+        imuRotationQuaternion(&vGyro, vGyroModulus, dt, &qDiff);
+        quaternionMultiply(&qAttitude, &qDiff, &qAttitude);
+        quaternionComputeProducts(&qAttitude, &qpAttitude);
+        eulerAnglesStale = true;
+        IMU_UNLOCK;
+    }
+}
+
 float getCosTiltAngle(void) {
     return (1.0f - 2.0f * (qpAttitude.xx + qpAttitude.yy));
 }
@@ -449,7 +542,9 @@ void imuSetAttitudeQuat(float w, float x, float y, float z) {
     qAttitude.y = y;
     qAttitude.z = z;
 
+    quaternionComputeProducts(&qAttitude, &qpAttitude);
     imuUpdateEulerAngles();
+    imuUpdateSmallAngleState();
 
     IMU_UNLOCK;
 }
@@ -47,7 +47,7 @@ typedef union {
 } attitudeEulerAngles_t;
 #define EULER_INITIALIZE  { { 0, 0, 0 } }
 
-extern attitudeEulerAngles_t attitude;
+extern attitudeEulerAngles_t attitude;   // call imuRefreshEulerAngles() before reading
 extern quaternion qHeadfree;
 extern quaternion qAttitude;
 
@@ -62,6 +62,7 @@ typedef struct imuConfig_s {
     uint8_t small_angle;
     uint8_t acc_unarmedcal;                 // turn automatic acc compensation on/off
     accDeadband_t accDeadband;
+    uint8_t gyro_propagation;               // integrate the gyro in the PID loop, correct in the attitude task
 } imuConfig_t;
 
 PG_DECLARE(imuConfig_t, imuConfig);
@@ -72,6 +73,7 @@ typedef struct imuRuntimeConfig_s {
     uint8_t acc_unarmedcal;
     uint8_t small_angle;
     accDeadband_t accDeadband;
+    bool gyro_propagation;
 } imuRuntimeConfig_t;
 
 enum {
@@ -85,6 +87,8 @@ void imuConfigure(uint16_t throttle_correction_angle);
 
 float getCosTiltAngle(void);
 void imuUpdateAttitude(timeUs_t currentTimeUs);
+void imuPropagateAttitude(float dt);
+void imuRefreshEulerAngles(void);
 int16_t calculateThrottleAngleCorrection(uint8_t throttle_correction_value);
 
 void imuResetAccelerationSum(void);
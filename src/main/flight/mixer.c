@@ -64,7 +64,7 @@
 #include "sensors/battery.h"
 #include "sensors/gyro.h"
 
-PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(mixerConfig_t, mixerConfig, PG_MIXER_CONFIG, 2);
 
 #ifndef TARGET_DEFAULT_MIXER
 #define TARGET_DEFAULT_MIXER    MIXER_QUADX
@@ -73,9 +73,11 @@ PG_RESET_TEMPLATE(mixerConfig_t, mixerConfig,
     .mixerMode = TARGET_DEFAULT_MIXER,
     .yaw_motors_reversed = false,
     .crashflip_motor_percent = 0,
+    .saturation = MIXER_SATURATION_SCALE,
+    .thrust_linear = 0,
 );
 
-PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 1);
+PG_REGISTER_WITH_RESET_FN(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 2);
 
 void pgResetFn_motorConfig(motorConfig_t *motorConfig)
 {
@@ -128,6 +130,33 @@ static motorMixer_t currentMixer[MAX_SUPPORTED_MOTORS];
 
 static FAST_RAM_ZERO_INIT int throttleAngleCorrection;
 
+// steps of the bisection that fits yaw into the motor range, 1/256 resolution
+#define MIXER_YAW_FIT_ITERATIONS 8
+// an axis is saturated when the motors deliver less than this share of its demand
+#define MIXER_AXIS_SATURATION_TOLERANCE 0.02f
+
+// The current mix as an allocation matrix, one row per axis so the loops over
+// the motors walk contiguous memory, and its pseudo-inverse that maps motor
+// outputs back to the axis demand they deliver.
+typedef struct mixerAllocation_s {
+    float axis[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS];
+    float inverse[XYZ_AXIS_COUNT][MAX_SUPPORTED_MOTORS];
+    float throttle[MAX_SUPPORTED_MOTORS];
+    bool valid;
+} mixerAllocation_t;
+
+// Thrust is modelled as (1 - k) * output + k * output^2. The table holds the
+// output giving each of THRUST_LINEAR_SEGMENTS + 1 evenly spaced thrusts.
+#define THRUST_LINEAR_SEGMENTS 32
+
+static FAST_RAM_ZERO_INIT float thrustLinearTable[THRUST_LINEAR_SEGMENTS + 1];
+static FAST_RAM_ZERO_INIT float thrustLinearK;
+static FAST_RAM_ZERO_INIT bool thrustLinearEnabled;
+
+static FAST_RAM_ZERO_INIT mixerAllocation_t mixerAllocation;
+static FAST_RAM_ZERO_INIT bool usePriorityAllocation;
+static FAST_RAM_ZERO_INIT bool axisSaturated[XYZ_AXIS_COUNT];
+
 
 static const motorMixer_t mixerQuadX[] = {
     { 1.0f, -1.0f,  1.0f, -1.0f },          // REAR_R
@@ -365,6 +394,10 @@ bool mixerIsOutputSaturated(int axis, float errorRate)
         return mixerTricopterIsServoSaturated(errorRate);
     }
 
+    if (usePriorityAllocation) {
+        return axisSaturated[axis];
+    }
+
     return motorMixRange >= 1.0f;
 }
 
@@ -410,16 +443,120 @@ void initEscEndpoints(void)
     rcCommandThrottleRange = PWM_RANGE_MAX - rxConfig()->mincheck;
 }
 
+static void mixerInitThrustLinearization(uint8_t thrustLinearPercent)
+{
+    thrustLinearK = thrustLinearPercent / 100.0f;
+    thrustLinearEnabled = thrustLinearPercent > 0;
+    if (!thrustLinearEnabled) {
+        return;
+    }
+
+    // solve the thrust model for the output, once per table entry
+    const float linear = 1.0f - thrustLinearK;
+    for (int i = 0; i <= THRUST_LINEAR_SEGMENTS; i++) {
+        const float thrust = (float)i / THRUST_LINEAR_SEGMENTS;
+        thrustLinearTable[i] = (sqrtf(linear * linear + 4.0f * thrustLinearK * thrust) - linear) / (2.0f * thrustLinearK);
+    }
+    thrustLinearTable[THRUST_LINEAR_SEGMENTS] = 1.0f;
+}
+
+// Motor output that delivers the given share of full thrust. Values outside
+// 0..1 are passed through, they are clipped to the motor range later.
+STATIC_UNIT_TESTED FAST_CODE float mixerLinearizeThrust(float thrust)
+{
+    if (!thrustLinearEnabled || thrust <= 0.0f || thrust >= 1.0f) {
+        return thrust;
+    }
+    const float position = thrust * THRUST_LINEAR_SEGMENTS;
+    const int index = (int)position;
+    const float fraction = position - index;
+    return thrustLinearTable[index] + fraction * (thrustLinearTable[index + 1] - thrustLinearTable[index]);
+}
+
+// Inverse of mixerLinearizeThrust, the share of full thrust a motor output delivers
+STATIC_UNIT_TESTED float mixerMotorThrust(float output)
+{
+    if (!thrustLinearEnabled) {
+        return output;
+    }
+    return output * ((1.0f - thrustLinearK) + thrustLinearK * output);
+}
+
 void mixerInit(mixerMode_e mixerMode)
 {
     currentMixerMode = mixerMode;
 
+    mixerInitThrustLinearization(mixerConfig()->thrust_linear);
     initEscEndpoints();
     if (mixerIsTricopter()) {
         mixerTricopterInit();
     }
 }
 
+// Fills mixerAllocation from currentMixer. The pseudo-inverse is
+// (A * A')^-1 * A, for a matrix A with one row per axis. Axes the motors
+// do not act on, like tricopter yaw, are left out of the inverse.
+static void mixerCalculateAllocation(void)
+{
+    mixerAllocation_t *allocation = &mixerAllocation;
+    memset(allocation, 0, sizeof(*allocation));
+
+    for (int i = 0; i < motorCount; i++) {
+        allocation->axis[FD_ROLL][i] = currentMixer[i].roll;
+        allocation->axis[FD_PITCH][i] = currentMixer[i].pitch;
+        allocation->axis[FD_YAW][i] = currentMixer[i].yaw;
+        allocation->throttle[i] = currentMixer[i].throttle;
+    }
+
+    usePriorityAllocation = false;
+
+    float gram[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    for (int a = 0; a < XYZ_AXIS_COUNT; a++) {
+        for (int b = 0; b < XYZ_AXIS_COUNT; b++) {
+            float sum = 0.0f;
+            for (int i = 0; i < motorCount; i++) {
+                sum += allocation->axis[a][i] * allocation->axis[b][i];
+            }
+            gram[a][b] = sum;
+        }
+    }
+    for (int a = 0; a < XYZ_AXIS_COUNT; a++) {
+        if (gram[a][a] < 1e-6f) {
+            // no authority on this axis, an identity row keeps the rest invertible
+            gram[a][a] = 1.0f;
+        }
+    }
+
+    const float det =
+        gram[0][0] * (gram[1][1] * gram[2][2] - gram[1][2] * gram[2][1]) -
+        gram[0][1] * (gram[1][0] * gram[2][2] - gram[1][2] * gram[2][0]) +
+        gram[0][2] * (gram[1][0] * gram[2][1] - gram[1][1] * gram[2][0]);
+    if (fabsf(det) < 1e-6f) {
+        return;
+    }
+
+    float gramInverse[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+    for (int a = 0; a < XYZ_AXIS_COUNT; a++) {
+        for (int b = 0; b < XYZ_AXIS_COUNT; b++) {
+            // cofactor of gram[b][a], the adjugate is the transposed cofactor matrix
+            const int r0 = (b + 1) % 3, r1 = (b + 2) % 3;
+            const int c0 = (a + 1) % 3, c1 = (a + 2) % 3;
+            gramInverse[a][b] = (gram[r0][c0] * gram[r1][c1] - gram[r0][c1] * gram[r1][c0]) / det;
+        }
+    }
+
+    for (int a = 0; a < XYZ_AXIS_COUNT; a++) {
+        for (int i = 0; i < motorCount; i++) {
+            allocation->inverse[a][i] =
+                gramInverse[a][FD_ROLL] * allocation->axis[FD_ROLL][i] +
+                gramInverse[a][FD_PITCH] * allocation->axis[FD_PITCH][i] +
+                gramInverse[a][FD_YAW] * allocation->axis[FD_YAW][i];
+        }
+    }
+    allocation->valid = true;
+    usePriorityAllocation = mixerConfig()->saturation == MIXER_SATURATION_PRIORITY;
+}
+
 #ifndef USE_QUAD_MIXER_ONLY
 
 void mixerConfigureOutput(void)
@@ -447,6 +584,7 @@ void mixerConfigureOutput(void)
                 currentMixer[i] = mixers[currentMixerMode].motor[i];
         }
     }
+    mixerCalculateAllocation();
     mixerResetDisarmedMotors();
 }
 
@@ -472,6 +610,7 @@ void mixerConfigureOutput(void)
     for (int i = 0; i < motorCount; i++) {
         currentMixer[i] = mixerQuadX[i];
     }
+    mixerCalculateAllocation();
     mixerResetDisarmedMotors();
 }
 #endif // USE_QUAD_MIXER_ONLY
@@ -705,7 +844,8 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS])
     // Now add in the desired throttle, but keep in a range that doesn't clip adjusted
     // roll/pitch/yaw. This could move throttle down, but also up for those low throttle flips.
     for (int i = 0; i < motorCount; i++) {
-        float motorOutput = motorOutputMin + (motorOutputRange * (motorOutputMixSign * motorMix[i] + throttle * currentMixer[i].throttle));
+        const float thrust = motorOutputMixSign * motorMix[i] + throttle * currentMixer[i].throttle;
+        float motorOutput = motorOutputMin + motorOutputRange * mixerLinearizeThrust(thrust);
         if (mixerIsTricopter()) {
             motorOutput += mixerTricopterMotorCorrection(i);
         }
@@ -736,6 +876,88 @@ static void applyMixToMotors(float motorMix[MAX_SUPPORTED_MOTORS])
     }
 }
 
+// Range of rollPitch + yawScale * yaw over the motors, zero included as in the scaled mix
+static FAST_CODE float mixRangeWithYaw(const float *rollPitch, const float *yaw, float yawScale)
+{
+    float mixMin = 0.0f, mixMax = 0.0f;
+    for (int i = 0; i < motorCount; i++) {
+        const float mix = rollPitch[i] + yawScale * yaw[i];
+        mixMin = fminf(mixMin, mix);
+        mixMax = fmaxf(mixMax, mix);
+    }
+    return mixMax - mixMin;
+}
+
+// Fits the demand into the motor range giving roll and pitch priority over
+// yaw. Roll and pitch are scaled down together only if they alone do not fit,
+// then yaw gets what is left. The mix range is convex in the yaw scale, so a
+// bisection with a fixed number of steps finds the largest yaw that fits.
+// Throttle comes last and is placed by the caller. Returns the range of the
+// demand before fitting.
+static FAST_CODE float mixerAllocatePriority(const float demand[XYZ_AXIS_COUNT], float motorMix[MAX_SUPPORTED_MOTORS], float *mixMin, float *mixMax)
+{
+    const mixerAllocation_t *allocation = &mixerAllocation;
+    float rollPitch[MAX_SUPPORTED_MOTORS];
+    float yaw[MAX_SUPPORTED_MOTORS];
+    float rollPitchMin = 0.0f, rollPitchMax = 0.0f;
+    for (int i = 0; i < motorCount; i++) {
+        rollPitch[i] = demand[FD_ROLL] * allocation->axis[FD_ROLL][i] + demand[FD_PITCH] * allocation->axis[FD_PITCH][i];
+        yaw[i] = demand[FD_YAW] * allocation->axis[FD_YAW][i];
+        rollPitchMin = fminf(rollPitchMin, rollPitch[i]);
+        rollPitchMax = fmaxf(rollPitchMax, rollPitch[i]);
+    }
+
+    const float demandRange = mixRangeWithYaw(rollPitch, yaw, 1.0f);
+    const float rollPitchRange = rollPitchMax - rollPitchMin;
+    float rollPitchScale = 1.0f;
+    float yawScale = 1.0f;
+    if (rollPitchRange > 1.0f) {
+        rollPitchScale = 1.0f / rollPitchRange;
+        yawScale = 0.0f;
+    } else if (demandRange > 1.0f) {
+        float low = 0.0f, high = 1.0f;
+        for (int n = 0; n < MIXER_YAW_FIT_ITERATIONS; n++) {
+            const float mid = (low + high) * 0.5f;
+            if (mixRangeWithYaw(rollPitch, yaw, mid) > 1.0f) {
+                high = mid;
+            } else {
+                low = mid;
+            }
+        }
+        yawScale = low;
+    }
+
+    *mixMin = 0.0f;
+    *mixMax = 0.0f;
+    for (int i = 0; i < motorCount; i++) {
+        const float mix = rollPitchScale * rollPitch[i] + yawScale * yaw[i];
+        *mixMin = fminf(*mixMin, mix);
+        *mixMax = fmaxf(*mixMax, mix);
+        motorMix[i] = mix;
+    }
+
+    return demandRange;
+}
+
+// Maps the motor outputs, after clipping to the motor range, back through the
+// pseudo-inverse and marks the axes that get less than they asked for.
+static FAST_CODE void mixerUpdateAxisSaturation(const float demand[XYZ_AXIS_COUNT], const float motorMix[MAX_SUPPORTED_MOTORS])
+{
+    const mixerAllocation_t *allocation = &mixerAllocation;
+    float delivered[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < motorCount; i++) {
+        const float throttleShare = throttle * allocation->throttle[i];
+        const float mix = motorOutputMixSign * motorMix[i];
+        const float output = motorOutputMixSign * (constrainf(mix + throttleShare, 0.0f, 1.0f) - throttleShare);
+        delivered[FD_ROLL] += allocation->inverse[FD_ROLL][i] * output;
+        delivered[FD_PITCH] += allocation->inverse[FD_PITCH][i] * output;
+        delivered[FD_YAW] += allocation->inverse[FD_YAW][i] * output;
+    }
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        axisSaturated[axis] = fabsf(delivered[axis] - demand[axis]) > fabsf(demand[axis]) * MIXER_AXIS_SATURATION_TOLERANCE + 0.001f;
+    }
+}
+
 float applyThrottleLimit(float throttle)
 {
     if (currentControlRateProfile->throttle_limit_percent < 100) {
@@ -792,20 +1014,30 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     // Find roll/pitch/yaw desired output
     float motorMix[MAX_SUPPORTED_MOTORS];
     float motorMixMax = 0, motorMixMin = 0;
-    for (int i = 0; i < motorCount; i++) {
-        float mix =
-            scaledAxisPidRoll  * currentMixer[i].roll +
-            scaledAxisPidPitch * currentMixer[i].pitch +
-            scaledAxisPidYaw   * currentMixer[i].yaw;
+    const float demand[XYZ_AXIS_COUNT] = {
+        scaledAxisPidRoll * vbatCompensationFactor,
+        scaledAxisPidPitch * vbatCompensationFactor,
+        scaledAxisPidYaw * vbatCompensationFactor,
+    };
+    if (usePriorityAllocation) {
+        motorMixRange = mixerAllocatePriority(demand, motorMix, &motorMixMin, &motorMixMax);
+    } else {
+        for (int i = 0; i < motorCount; i++) {
+            float mix =
+                scaledAxisPidRoll  * currentMixer[i].roll +
+                scaledAxisPidPitch * currentMixer[i].pitch +
+                scaledAxisPidYaw   * currentMixer[i].yaw;
 
-        mix *= vbatCompensationFactor;  // Add voltage compensation
+            mix *= vbatCompensationFactor;  // Add voltage compensation
 
-        if (mix > motorMixMax) {
-            motorMixMax = mix;
-        } else if (mix < motorMixMin) {
-            motorMixMin = mix;
+            if (mix > motorMixMax) {
+                motorMixMax = mix;
+            } else if (mix < motorMixMin) {
+                motorMixMin = mix;
+            }
+            motorMix[i] = mix;
         }
-        motorMix[i] = mix;
+        motorMixRange = motorMixMax - motorMixMin;
     }
 
         pidUpdateAntiGravityThrottleFilter(throttle);
@@ -825,8 +1057,18 @@ FAST_CODE_NOINLINE void mixTable(timeUs_t currentTimeUs, uint8_t vbatPidCompensa
     }
 #endif
 
-    motorMixRange = motorMixMax - motorMixMin;
-    if (motorMixRange > 1.0f) {
+    // The mix and the saturation logic work in thrust, which the motor
+    // outputs are linearised to. The throttle stick keeps commanding motor
+    // output, so it is converted to the thrust that output gives.
+    throttle = mixerMotorThrust(throttle);
+
+    if (usePriorityAllocation) {
+        // the mix already fits, throttle goes where it leaves the most room
+        if (isAirmodeActive() || throttle > 0.5f) {
+            throttle = constrainf(throttle, -motorMixMin, 1.0f - motorMixMax);
+        }
+        mixerUpdateAxisSaturation(demand, motorMix);
+    } else if (motorMixRange > 1.0f) {
         for (int i = 0; i < motorCount; i++) {
             motorMix[i] /= motorMixRange;
         }
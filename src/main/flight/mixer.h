@@ -87,10 +87,17 @@ typedef struct mixer_s {
     const motorMixer_t *motor;
 } mixer_t;
 
+typedef enum {
+    MIXER_SATURATION_SCALE = 0,     // scale roll, pitch and yaw down together
+    MIXER_SATURATION_PRIORITY,      // keep roll and pitch, then yaw, then throttle
+} mixerSaturation_e;
+
 typedef struct mixerConfig_s {
     uint8_t mixerMode;
     bool yaw_motors_reversed;
     uint8_t crashflip_motor_percent;
+    uint8_t saturation;             // how a demand beyond the motor range is fitted, see mixerSaturation_e
+    uint8_t thrust_linear;          // percentage of motor thrust that is quadratic in the output, 0 to disable linearisation
 } mixerConfig_t;
 
 PG_DECLARE(mixerConfig_t, mixerConfig);
@@ -83,7 +83,7 @@ static FAST_RAM_ZERO_INIT uint16_t itermAcceleratorGain;
 static FAST_RAM float antiGravityOsdCutoff = 1.0f;
 static FAST_RAM_ZERO_INIT bool antiGravityEnabled;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 2);
+PG_REGISTER_WITH_RESET_TEMPLATE(pidConfig_t, pidConfig, PG_PID_CONFIG, 3);
 
 #ifdef STM32F10X
 #define PID_PROCESS_DENOM_DEFAULT       1
@@ -114,11 +114,13 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
     .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
     .runaway_takeoff_prevention = false,
     .runaway_takeoff_deactivate_throttle = 25,  // throttle level % needed to accumulate deactivation time
-    .runaway_takeoff_deactivate_delay = 500     // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .runaway_takeoff_deactivate_delay = 500,    // Accumulated time (in milliseconds) before deactivation in successful takeoff
+    .dterm_jitter_threshold = 0,
 );
 #else
 PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
-    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT
+    .pid_process_denom = PID_PROCESS_DENOM_DEFAULT,
+    .dterm_jitter_threshold = 0,
 );
 #endif
 
@@ -129,7 +131,7 @@ PG_RESET_TEMPLATE(pidConfig_t, pidConfig,
 
 #define ANTI_GRAVITY_THROTTLE_FILTER_CUTOFF 15  // The anti gravity throttle highpass filter cutoff
 
-PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, MAX_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 5);
+PG_REGISTER_ARRAY_WITH_RESET_FN(pidProfile_t, MAX_PROFILE_COUNT, pidProfiles, PG_PID_PROFILE, 6);
 
 void resetPidProfile(pidProfile_t *pidProfile)
 {
@@ -190,6 +192,7 @@ void resetPidProfile(pidProfile_t *pidProfile)
         .abs_control_limit = 90,
         .abs_control_error_limit = 20,
         .antiGravityMode = ANTI_GRAVITY_SMOOTH,
+        .dterm_iterm_denom = 1,
     );
 }
 
@@ -233,12 +236,63 @@ typedef union dtermLowpass_u {
     biquadFilter_t biquadFilter;
 } dtermLowpass_t;
 
-static FAST_RAM filterApplyFnPtr dtermNotchApplyFn = nullFilterApply;
-static FAST_RAM_ZERO_INIT biquadFilter_t dtermNotch[3];
-static FAST_RAM filterApplyFnPtr dtermLowpassApplyFn = nullFilterApply;
-static FAST_RAM_ZERO_INIT dtermLowpass_t dtermLowpass[3];
+typedef struct pidCoefficient_s {
+    float Kp;
+    float Ki;
+    float Kd;
+    float Kf;
+} pidCoefficient_t;
+
+// Everything the controller keeps per axis, so one axis is a single
+// contiguous block and the loop over the axes walks memory in order.
+typedef struct pidAxisState_s {
+    pidCoefficient_t coefficient;
+    float maxVelocity;
+    float previousSetpoint;         // acceleration limit
+    float previousPidSetpoint;      // feed forward
+    float previousGyroRate;         // buttered D term, derivative of measurement
+    float previousGyroRateDterm;    // classic D term, derivative of filtered measurement
+    biquadFilter_t dtermNotch;
+    dtermLowpass_t dtermLowpass;
+#if defined(USE_ITERM_RELAX)
+    pt1Filter_t windupLpf;
+#endif
+#if defined(USE_ABSOLUTE_CONTROL)
+    float axisError;
+#endif
+    float gyroRateSum;              // gyro samples since the last I and D update
+    float gyroRateSlow;             // their average, what the I and D terms see
+} pidAxisState_t;
+
+// The I and D terms run at the PID loop rate divided by slowTermsDenom, the
+// P and F terms every loop. The D filters, I term relax and absolute control
+// are set up for the slower rate and use slowDT and slowFrequency. The D term
+// derivative uses dtermFrequency, which is slowFrequency unless the jitter
+// correction has replaced it with the measured gyro sample rate.
+typedef struct pidState_s {
+    pidAxisState_t axis[XYZ_AXIS_COUNT];
+    bool butteredPids;
+    bool dtermNotchEnabled;
+    bool dtermLowpassEnabled;
+    uint8_t dtermLowpassType;
+    uint8_t slowTermsDenom;
+    uint8_t slowTermsCount;
+    float slowDT;
+    float slowFrequency;
+    float slowScale;                // 1 / slowTermsDenom, averages gyroRateSum
+    float dtermFrequency;
+#ifdef USE_GYRO_JITTER_STATS
+    uint8_t jitterThreshold;        // percent, 0 when the correction is off
+    bool jitterCorrected;
+    uint16_t dtermLowpassHz;
+    float dtermLowpassK;            // PT1 gain at slowDT
+    timeUs_t lastSlowSampleTimeUs;
+#endif
+} pidState_t;
+
+static FAST_RAM_ZERO_INIT pidState_t pidState;
+
 #if defined(USE_ITERM_RELAX)
-static FAST_RAM_ZERO_INIT pt1Filter_t windupLpf[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT uint8_t itermRelax;
 static FAST_RAM_ZERO_INIT uint8_t itermRelaxType;
 static FAST_RAM_ZERO_INIT uint8_t itermRelaxCutoff;
@@ -257,9 +311,28 @@ static FAST_RAM_ZERO_INIT pt1Filter_t antiGravityThrottleLpf;
 void pidInitFilters(const pidProfile_t *pidProfile)
 {
     BUILD_BUG_ON(FD_YAW != 2); // ensure yaw axis is 2
-    dtermNotchApplyFn = nullFilterApply;
-    dtermLowpassApplyFn = nullFilterApply;
-    const uint32_t pidFrequencyNyquist = pidFrequency / 2; // No rounding needed
+    pidState.dtermNotchEnabled = false;
+    pidState.dtermLowpassEnabled = false;
+
+    pidState.slowTermsDenom = constrain(pidProfile->dterm_iterm_denom, 1, 8);
+    pidState.slowTermsCount = 0;
+    pidState.slowDT = dT * pidState.slowTermsDenom;
+    pidState.slowFrequency = pidFrequency / pidState.slowTermsDenom;
+    pidState.slowScale = 1.0f / pidState.slowTermsDenom;
+    pidState.dtermFrequency = pidState.slowFrequency;
+#ifdef USE_GYRO_JITTER_STATS
+    pidState.jitterThreshold = pidConfig()->dterm_jitter_threshold;
+    pidState.jitterCorrected = false;
+    pidState.dtermLowpassHz = pidProfile->dterm_lowpass_hz;
+    pidState.dtermLowpassK = pt1FilterGain(pidProfile->dterm_lowpass_hz, pidState.slowDT);
+    pidState.lastSlowSampleTimeUs = 0;
+#endif
+    const uint32_t slowLooptime = targetPidLooptime * pidState.slowTermsDenom;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidState.axis[axis].gyroRateSum = 0.0f;
+    }
+
+    const uint32_t pidFrequencyNyquist = pidState.slowFrequency / 2; // No rounding needed
 
     r_weight = (float) pidProfile->r_weight / 100.0f;
 
@@ -275,10 +348,10 @@ void pidInitFilters(const pidProfile_t *pidProfile)
     }
 
     if (dTermNotchHz != 0 && pidProfile->dterm_notch_cutoff != 0) {
-        dtermNotchApplyFn = (filterApplyFnPtr)biquadFilterApply;
+        pidState.dtermNotchEnabled = true;
         const float notchQ = filterGetNotchQ(dTermNotchHz, pidProfile->dterm_notch_cutoff);
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-            biquadFilterInit(&dtermNotch[axis], dTermNotchHz, targetPidLooptime, notchQ, FILTER_NOTCH);
+            biquadFilterInit(&pidState.axis[axis].dtermNotch, dTermNotchHz, slowLooptime, notchQ, FILTER_NOTCH);
         }
     }
 
@@ -286,18 +359,18 @@ void pidInitFilters(const pidProfile_t *pidProfile)
 
     if (pidProfile->dterm_lowpass_hz && pidProfile->dterm_lowpass_hz <= pidFrequencyNyquist)
     {
+        pidState.dtermLowpassEnabled = true;
+        pidState.dtermLowpassType = pidProfile->dterm_filter_type == FILTER_PT1 ? FILTER_PT1 : FILTER_BIQUAD;
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++)
         {
-            switch (pidProfile->dterm_filter_type)
+            switch (pidState.dtermLowpassType)
             {
             case FILTER_PT1:
-                    dtermLowpassApplyFn = (filterApplyFnPtr)pt1FilterApply;
-                    pt1FilterInit(&dtermLowpass[axis].pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass_hz, dT));
+                    pt1FilterInit(&pidState.axis[axis].dtermLowpass.pt1Filter, pt1FilterGain(pidProfile->dterm_lowpass_hz, pidState.slowDT));
                 break;
             case FILTER_BIQUAD:
             default:
-                    dtermLowpassApplyFn = (filterApplyFnPtr)biquadFilterApply;
-                    biquadFilterInitLPF(&dtermLowpass[axis].biquadFilter, pidProfile->dterm_lowpass_hz, targetPidLooptime);
+                    biquadFilterInitLPF(&pidState.axis[axis].dtermLowpass.biquadFilter, pidProfile->dterm_lowpass_hz, slowLooptime);
                 break;
             }
         }
@@ -308,7 +381,7 @@ void pidInitFilters(const pidProfile_t *pidProfile)
 #if defined(USE_ITERM_RELAX)
     if (itermRelax) {
         for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
-            pt1FilterInit(&windupLpf[i], pt1FilterGain(itermRelaxCutoff, dT));
+            pt1FilterInit(&pidState.axis[i].windupLpf, pt1FilterGain(itermRelaxCutoff, pidState.slowDT));
         }
     }
 #endif
@@ -352,17 +425,7 @@ void pidUpdateSetpointDerivativeLpf(uint16_t filterCutoff)
 }
 #endif // USE_RC_SMOOTHING_FILTER
 
-typedef struct pidCoefficient_s {
-    float Kp;
-    float Ki;
-    float Kd;
-    float Kf;
-} pidCoefficient_t;
-
-static FAST_RAM_ZERO_INIT pidCoefficient_t pidCoefficient[XYZ_AXIS_COUNT];
-static FAST_RAM_ZERO_INIT float maxVelocity[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float feedForwardTransition;
-static FAST_RAM_ZERO_INIT pidControllerFn activePidController;
 static FAST_RAM_ZERO_INIT float levelGain, horizonGain, horizonTransition, horizonCutoffDegrees, horizonFactorRatio;
 static FAST_RAM_ZERO_INIT float ITermWindupPointInv;
 static FAST_RAM_ZERO_INIT uint8_t horizonTiltExpertMode;
@@ -385,7 +448,6 @@ static FAST_RAM_ZERO_INIT bool itermRotation;
 static FAST_RAM_ZERO_INIT bool smartFeedforward;
 #endif
 #if defined(USE_ABSOLUTE_CONTROL)
-static FAST_RAM_ZERO_INIT float axisError[XYZ_AXIS_COUNT];
 static FAST_RAM_ZERO_INIT float acGain;
 static FAST_RAM_ZERO_INIT float acLimit;
 static FAST_RAM_ZERO_INIT float acErrorLimit;
@@ -396,14 +458,11 @@ void pidResetITerm(void)
     for (int axis = 0; axis < 3; axis++) {
         pidData[axis].I = 0.0f;
 #if defined(USE_ABSOLUTE_CONTROL)
-        axisError[axis] = 0.0f;
+        pidState.axis[axis].axisError = 0.0f;
 #endif
     }
 }
 
-float butteredPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint);
-float classicPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint);
-
 #ifdef USE_ACRO_TRAINER
 static FAST_RAM_ZERO_INIT float acroTrainerAngleLimit;
 static FAST_RAM_ZERO_INIT float acroTrainerLookaheadTime;
@@ -428,10 +487,11 @@ void pidInitConfig(const pidProfile_t *pidProfile)
         feedForwardTransition = 100.0f / pidProfile->feedForwardTransition;
     }
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
-        pidCoefficient[axis].Kp = PTERM_SCALE * pidProfile->pid[axis].P;
-        pidCoefficient[axis].Ki = ITERM_SCALE * pidProfile->pid[axis].I;
-        pidCoefficient[axis].Kd = DTERM_SCALE * pidProfile->pid[axis].D;
-        pidCoefficient[axis].Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
+        pidCoefficient_t *coefficient = &pidState.axis[axis].coefficient;
+        coefficient->Kp = PTERM_SCALE * pidProfile->pid[axis].P;
+        coefficient->Ki = ITERM_SCALE * pidProfile->pid[axis].I;
+        coefficient->Kd = DTERM_SCALE * pidProfile->pid[axis].D;
+        coefficient->Kf = FEEDFORWARD_SCALE * (pidProfile->pid[axis].F / 100.0f);
     }
 
     levelGain = pidProfile->pid[PID_LEVEL].P / 10.0f;
@@ -440,8 +500,8 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     horizonTiltExpertMode = pidProfile->horizon_tilt_expert_mode;
     horizonCutoffDegrees = (175 - pidProfile->horizon_tilt_effect) * 1.8f;
     horizonFactorRatio = (100 - pidProfile->horizon_tilt_effect) * 0.01f;
-    maxVelocity[FD_ROLL] = maxVelocity[FD_PITCH] = pidProfile->rateAccelLimit * 100 * dT;
-    maxVelocity[FD_YAW] = pidProfile->yawRateAccelLimit * 100 * dT;
+    pidState.axis[FD_ROLL].maxVelocity = pidState.axis[FD_PITCH].maxVelocity = pidProfile->rateAccelLimit * 100 * dT;
+    pidState.axis[FD_YAW].maxVelocity = pidProfile->yawRateAccelLimit * 100 * dT;
     const float ITermWindupPoint = (float)pidProfile->itermWindupPointPercent / 100.0f;
     ITermWindupPointInv = 1.0f / (1.0f - ITermWindupPoint);
     itermAcceleratorGain = pidProfile->itermAcceleratorGain;
@@ -479,7 +539,7 @@ void pidInitConfig(const pidProfile_t *pidProfile)
     itermRelaxCutoff = pidProfile->iterm_relax_cutoff;
 #endif
 
-    activePidController = (pidProfile->buttered_pids ? butteredPids : classicPids);
+    pidState.butteredPids = pidProfile->buttered_pids;
 #ifdef USE_ACRO_TRAINER
     acroTrainerAngleLimit = pidProfile->acro_trainer_angle_limit;
     acroTrainerLookaheadTime = (float)pidProfile->acro_trainer_lookahead_ms / 1000.0f;
@@ -595,16 +655,15 @@ static float pidLevel(int axis, const pidProfile_t *pidProfile, const rollAndPit
     return currentPidSetpoint;
 }
 
-static float accelerationLimit(int axis, float currentPidSetpoint)
+static float accelerationLimit(pidAxisState_t *axisState, float currentPidSetpoint)
 {
-    static float previousSetpoint[XYZ_AXIS_COUNT];
-    const float currentVelocity = currentPidSetpoint - previousSetpoint[axis];
+    const float currentVelocity = currentPidSetpoint - axisState->previousSetpoint;
 
-    if (ABS(currentVelocity) > maxVelocity[axis]) {
-        currentPidSetpoint = (currentVelocity > 0) ? previousSetpoint[axis] + maxVelocity[axis] : previousSetpoint[axis] - maxVelocity[axis];
+    if (ABS(currentVelocity) > axisState->maxVelocity) {
+        currentPidSetpoint = (currentVelocity > 0) ? axisState->previousSetpoint + axisState->maxVelocity : axisState->previousSetpoint - axisState->maxVelocity;
     }
 
-    previousSetpoint[axis] = currentPidSetpoint;
+    axisState->previousSetpoint = currentPidSetpoint;
     return currentPidSetpoint;
 }
 
@@ -699,14 +758,21 @@ static void rotateITermAndAxisError()
         || acGain > 0
 #endif
         ) {
-        const float gyroToAngle = dT * RAD;
+        const float gyroToAngle = pidState.slowDT * RAD;
         float rotationRads[XYZ_AXIS_COUNT];
         for (int i = FD_ROLL; i <= FD_YAW; i++) {
-            rotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
+            rotationRads[i] = pidState.axis[i].gyroRateSlow * gyroToAngle;
         }
 #if defined(USE_ABSOLUTE_CONTROL)
         if (acGain > 0) {
-            rotateVector(axisError, rotationRads);
+            float v[XYZ_AXIS_COUNT];
+            for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+                v[i] = pidState.axis[i].axisError;
+            }
+            rotateVector(v, rotationRads);
+            for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+                pidState.axis[i].axisError = v[i];
+            }
         }
 #endif
         if (itermRotation) {
@@ -836,24 +902,72 @@ void FAST_CODE applySmartFeedforward(int axis)
 }
 #endif // USE_SMART_FEEDFORWARD
 
-static FAST_RAM_ZERO_INIT float previousRateError[3];
 static FAST_RAM_ZERO_INIT timeUs_t crashDetectedAtUs;
 //static FAST_RAM_ZERO_INIT timeUs_t previousTimeUs;
 
 #define SIGN(x) ((x > 0.0f) - (x < 0.0f))
 
-// Butterflight pid controller which uses measurement instead of error rate to calculate D
-FAST_CODE float butteredPids(const pidProfile_t *pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint)
+#ifdef USE_GYRO_JITTER_STATS
+// When the gyro samples the D term sees are further apart or closer together
+// than slowDT by more than the threshold, the derivative and the PT1 lowpass
+// use the measured interval so the timing error does not show up as D term
+// noise. The interval is clamped to half and twice slowDT: one lost sample
+// is still corrected, longer gaps are taken as two intervals.
+static FAST_CODE void pidUpdateJitterCorrection(void)
+{
+    const timeDelta_t intervalUs = cmpTimeUs(gyro.sampleTimeUs, pidState.lastSlowSampleTimeUs);
+    const bool haveInterval = pidState.lastSlowSampleTimeUs && intervalUs > 0;
+    pidState.lastSlowSampleTimeUs = gyro.sampleTimeUs;
+
+    const float slowDTUs = pidState.slowDT * 1e6f;
+    if (haveInterval && fabsf(intervalUs - slowDTUs) * 100 > pidState.jitterThreshold * slowDTUs) {
+        const float measuredDT = constrainf(intervalUs * 1e-6f, 0.5f * pidState.slowDT, 2.0f * pidState.slowDT);
+        pidState.dtermFrequency = 1.0f / measuredDT;
+        if (pidState.dtermLowpassEnabled && pidState.dtermLowpassType == FILTER_PT1) {
+            const float k = pt1FilterGain(pidState.dtermLowpassHz, measuredDT);
+            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+                pidState.axis[axis].dtermLowpass.pt1Filter.k = k;
+            }
+        }
+        pidState.jitterCorrected = true;
+        DEBUG_SET(DEBUG_GYRO_JITTER, 3, lrintf(measuredDT * 1e6f));
+    } else if (pidState.jitterCorrected) {
+        pidState.dtermFrequency = pidState.slowFrequency;
+        if (pidState.dtermLowpassEnabled && pidState.dtermLowpassType == FILTER_PT1) {
+            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+                pidState.axis[axis].dtermLowpass.pt1Filter.k = pidState.dtermLowpassK;
+            }
+        }
+        pidState.jitterCorrected = false;
+        DEBUG_SET(DEBUG_GYRO_JITTER, 3, 0);
+    }
+}
+#endif
+
+// The D term filters are applied directly, the filter type is the same for
+// all axes so the branches are predicted and nothing is called through a pointer.
+static inline float dtermNotchApply(pidAxisState_t *axisState, float input)
 {
-    (void) iDT;
-    (void)(currentPidSetpoint);
-    // -----calculate P component
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate);
+    if (!pidState.dtermNotchEnabled) {
+        return input;
+    }
+    return biquadFilterApplyInline(&axisState->dtermNotch, input);
+}
 
-    // -----calculate I component
-    //float iterm = constrainf(pidData[axis].I + (pidCoefficient[axis].Ki * errorRate) * dynCi, -itermLimit, itermLimit);
-    float iterm    = pidData[axis].I;
-    float ITermNew = pidCoefficient[axis].Ki * errorRate * dynCi;
+static inline float dtermLowpassApply(pidAxisState_t *axisState, float input)
+{
+    if (!pidState.dtermLowpassEnabled) {
+        return input;
+    }
+    if (pidState.dtermLowpassType == FILTER_PT1) {
+        return pt1FilterApplyInline(&axisState->dtermLowpass.pt1Filter, input);
+    }
+    return biquadFilterApplyInline(&axisState->dtermLowpass.biquadFilter, input);
+}
+
+// I term increment, limited where it would unwind the accumulated I term too quickly
+static inline float itermIncrement(const pidProfile_t *pidProfile, float iterm, float ITermNew)
+{
     if (ITermNew != 0.0f)
     {
         if (SIGN(iterm) != SIGN(ITermNew))
@@ -865,38 +979,58 @@ FAST_CODE float butteredPids(const pidProfile_t *pidProfile, int axis, float err
         	}
         }
     }
+    return ITermNew;
+}
+
+// P term, common to both controllers and run every loop
+static inline float pidProportional(const pidAxisState_t *axisState, float errorRate)
+{
+#ifdef USE_TPA_CURVES
+    return (axisState->coefficient.Kp * errorRate) * getThrottlePIDAttenuationKp();
+#else
+    return (axisState->coefficient.Kp * errorRate) * getThrottlePIDAttenuation();
+#endif
+}
+
+// Butterflight pid controller which uses measurement instead of error rate to calculate D.
+// Updates the I and D terms, returns the D term delta for crash detection.
+static FAST_CODE float butteredPids(const pidProfile_t *pidProfile, int axis, pidAxisState_t *axisState, float errorRate, float dynCi)
+{
+    pidAxisData_t *axisData = &pidData[axis];
+    const pidCoefficient_t *coefficient = &axisState->coefficient;
+
+    // -----calculate I component
+    float iterm = axisData->I;
+    const float ITermNew = itermIncrement(pidProfile, iterm, coefficient->Ki * errorRate * dynCi);
 
     iterm = constrainf(iterm + ITermNew, -itermLimit, itermLimit);
-    if (!mixerIsOutputSaturated(axis, errorRate) || ABS(iterm) < ABS(pidData[axis].I)) {
+    if (!mixerIsOutputSaturated(axis, errorRate) || ABS(iterm) < ABS(axisData->I)) {
         // Only increase ITerm if output is not saturated
-        pidData[axis].I = iterm;
+        axisData->I = iterm;
     }
 
     // use measurement and apply filters. mmmm gimme that butter.
-    float dDelta = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], -((gyro.gyroADCf[axis] - previousRateError[axis]) * pidFrequency));
-    previousRateError[axis] = gyro.gyroADCf[axis];
-    pidData[axis].D = (pidCoefficient[axis].Kd * dDelta);
+    const float gyroRate = axisState->gyroRateSlow;
+    float dDelta = dtermLowpassApply(axisState, -((gyroRate - axisState->previousGyroRate) * pidState.dtermFrequency));
+    axisState->previousGyroRate = gyroRate;
+    axisData->D = (coefficient->Kd * dDelta);
 
 #if defined(USE_TPA_CURVES)
-    pidData[axis].P = pidData[axis].P * getThrottlePIDAttenuationKp();
-    pidData[axis].I = pidData[axis].I * getThrottlePIDAttenuationKi();
-    pidData[axis].D = pidData[axis].D * getThrottlePIDAttenuationKd();
+    axisData->I = axisData->I * getThrottlePIDAttenuationKi();
+    axisData->D = axisData->D * getThrottlePIDAttenuationKd();
 #else
-    pidData[axis].P = pidData[axis].P * getThrottlePIDAttenuation();
-    pidData[axis].D = pidData[axis].D * getThrottlePIDAttenuation();
+    axisData->D = axisData->D * getThrottlePIDAttenuation();
 #endif
     return dDelta;
 }
 
 // Betaflight pid controller, which will be maintained in the future with additional features specialised for current (mini) multirotor usage.
 // Based on 2DOF reference design (matlab)
-
-FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, float errorRate, float dynCi, float iDT, float currentPidSetpoint)
+// Updates the I and D terms, returns the D term delta for crash detection.
+static FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, pidAxisState_t *axisState, float errorRate, float dynCi, float currentPidSetpoint)
 {
-    UNUSED(iDT);
-    UNUSED(currentPidSetpoint);
-    float gyroRateDterm[XYZ_AXIS_COUNT];
-    static float previousGyroRateDterm[XYZ_AXIS_COUNT];
+    pidAxisData_t *axisData = &pidData[axis];
+    const pidCoefficient_t *coefficient = &axisState->coefficient;
 
     rotateITermAndAxisError();
     // --------low-level gyro-based PID based on 2DOF PID controller. ----------
@@ -908,13 +1042,13 @@ FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, float erro
     float acErrorRate;
 #endif
 
-        const float gyroRate = gyro.gyroADCf[axis];
-        float ITerm = pidData[axis].I;
-        float itermErrorRate = errorRate;
+    const float gyroRate = axisState->gyroRateSlow;
+    const float ITerm = axisData->I;
+    float itermErrorRate = errorRate;
 
 #if defined(USE_ITERM_RELAX)
     if (itermRelax && (axis < FD_YAW || itermRelax == ITERM_RELAX_RPY || itermRelax == ITERM_RELAX_RPY_INC)) {
-        const float setpointLpf = pt1FilterApply(&windupLpf[axis], currentPidSetpoint);
+        const float setpointLpf = pt1FilterApply(&axisState->windupLpf, currentPidSetpoint);
         const float setpointHpf = fabsf(currentPidSetpoint - setpointLpf);
         const float itermRelaxFactor = 1 - setpointHpf / ITERM_RELAX_SETPOINT_THRESHOLD;
 
@@ -941,13 +1075,13 @@ FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, float erro
         if (gyroRate >= gminac && gyroRate <= gmaxac) {
             float acErrorRate1 = gmaxac - gyroRate;
             float acErrorRate2 = gminac - gyroRate;
-            if (acErrorRate1 * axisError[axis] < 0) {
+            if (acErrorRate1 * axisState->axisError < 0) {
                 acErrorRate = acErrorRate1;
             } else {
                 acErrorRate = acErrorRate2;
             }
-            if (fabsf(acErrorRate * dT) > fabsf(axisError[axis]) ) {
-                acErrorRate = -axisError[axis] / dT;
+            if (fabsf(acErrorRate * pidState.slowDT) > fabsf(axisState->axisError) ) {
+                acErrorRate = -axisState->axisError / pidState.slowDT;
             }
         } else {
             acErrorRate = (gyroRate > gmaxac ? gmaxac : gminac ) - gyroRate;
@@ -963,100 +1097,109 @@ FAST_CODE float classicPids(const pidProfile_t* pidProfile, int axis, float erro
 
 #if defined(USE_ABSOLUTE_CONTROL)
     if (acGain > 0 && isAirmodeActivated()) {
-        axisError[axis] = constrainf(axisError[axis] + acErrorRate * dT, -acErrorLimit, acErrorLimit);
-        acCorrection = constrainf(axisError[axis] * acGain, -acLimit, acLimit);
+        axisState->axisError = constrainf(axisState->axisError + acErrorRate * pidState.slowDT, -acErrorLimit, acErrorLimit);
+        acCorrection = constrainf(axisState->axisError * acGain, -acLimit, acLimit);
         currentPidSetpoint += acCorrection;
         itermErrorRate += acCorrection;
         if (axis == FD_ROLL) {
-            DEBUG_SET(DEBUG_ITERM_RELAX, 3, lrintf(axisError[axis] * 10));
+            DEBUG_SET(DEBUG_ITERM_RELAX, 3, lrintf(axisState->axisError * 10));
         }
     }
-#endif
-
-        // -----calculate P component and add Dynamic Part based on stick input
-#ifdef USE_TPA_CURVES
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate) * getThrottlePIDAttenuationKp();
 #else
-    pidData[axis].P = (pidCoefficient[axis].Kp * errorRate) * getThrottlePIDAttenuation();
+    UNUSED(currentPidSetpoint);
 #endif
+
     // -----calculate I component
-   // const float ITermNew = constrainf(ITerm + pidCoefficient[axis].Ki * itermErrorRate * dynCi, -itermLimit, itermLimit);
-    float ITermNew = pidCoefficient[axis].Ki * itermErrorRate * dynCi;
-    if (ITermNew != 0.0f)
-    {
-        if (SIGN(ITerm) != SIGN(ITermNew))
-        {
-        	const float newVal = ITermNew * (float)pidProfile->i_decay;
-        	if (fabs(ITerm) > fabs(newVal))
-        	{
-        		ITermNew = newVal;
-        	}
-        }
-    }
+    float ITermNew = itermIncrement(pidProfile, ITerm, coefficient->Ki * itermErrorRate * dynCi);
     ITermNew = constrainf(ITerm + ITermNew, -itermLimit, itermLimit);
 
     const bool outputSaturated = mixerIsOutputSaturated(axis, errorRate);
     if (outputSaturated == false || ABS(ITermNew) < ABS(ITerm)) {
         // Only increase ITerm if output is not saturated
 #ifdef USE_TPA_CURVES
-        pidData[axis].I = ITermNew * getThrottlePIDAttenuationKi();
+        axisData->I = ITermNew * getThrottlePIDAttenuationKi();
 #else
-        pidData[axis].I = ITermNew;
+        axisData->I = ITermNew;
 #endif
     }
 
     // -----calculate D component
-    gyroRateDterm[axis] = dtermNotchApplyFn((filter_t *) &dtermNotch[axis], gyroRate);
-    gyroRateDterm[axis] = dtermLowpassApplyFn((filter_t *) &dtermLowpass[axis], gyroRateDterm[axis]);
-    const float delta = - (gyroRateDterm[axis] - previousGyroRateDterm[axis]) * pidFrequency;
-    if (pidCoefficient[axis].Kd > 0) {
+    const float gyroRateDterm = dtermLowpassApply(axisState, dtermNotchApply(axisState, gyroRate));
+    const float delta = - (gyroRateDterm - axisState->previousGyroRateDterm) * pidState.dtermFrequency;
+    if (coefficient->Kd > 0) {
 
-        // Divide rate change by dT to get differential (ie dr/dt).
-        // dT is fixed and calculated from the target PID loop time
+        // Divide rate change by slowDT to get differential (ie dr/dt).
+        // slowDT is fixed and calculated from the target PID loop time
         // This is done to avoid DTerm spikes that occur with dynamically
         // calculated deltaT whenever another task causes the PID
-        // loop execution to be delayed.
+        // loop execution to be delayed. The jitter correction goes by
+        // when the gyro took its samples instead, not when the loop ran.
 
 #ifdef USE_TPA_CURVES
-        pidData[axis].D = pidCoefficient[axis].Kd * delta * getThrottlePIDAttenuationKd();
+        axisData->D = coefficient->Kd * delta * getThrottlePIDAttenuationKd();
 #else
-        pidData[axis].D = pidCoefficient[axis].Kd * delta * getThrottlePIDAttenuation();
+        axisData->D = coefficient->Kd * delta * getThrottlePIDAttenuation();
 #endif
     } else {
-        pidData[axis].D = 0;
+        axisData->D = 0;
     }
-    previousGyroRateDterm[axis] = gyroRateDterm[axis];
+    axisState->previousGyroRateDterm = gyroRateDterm;
     return delta;
 }
 
 void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *angleTrim, timeUs_t currentTimeUs)
 {
-    static float previousPidSetpoint[XYZ_AXIS_COUNT];
-
-//    const float deltaT = (currentTimeUs - previousTimeUs) * 0.000001f;
-//    previousTimeUs = currentTimeUs;
-    // calculate actual deltaT in seconds
-//    const float iDT = 1.0f/deltaT; //divide once
-    // calculate actual deltaT in seconds
-    // Dynamic i component,
-    if ((antiGravityMode == ANTI_GRAVITY_SMOOTH) && antiGravityEnabled) {
-        itermAccelerator = 1 + fabsf(antiGravityThrottleHpf) * 0.01f * (itermAcceleratorGain - 1000);
-        DEBUG_SET(DEBUG_ANTI_GRAVITY, 1, lrintf(antiGravityThrottleHpf * 1000));
+    // The gyro is averaged over the slow interval, so the I and D terms
+    // do not alias noise above their own Nyquist frequency.
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidState.axis[axis].gyroRateSum += gyro.gyroADCf[axis];
     }
-    DEBUG_SET(DEBUG_ANTI_GRAVITY, 0, lrintf(itermAccelerator * 1000));
+    const bool slowTermsDue = ++pidState.slowTermsCount >= pidState.slowTermsDenom;
+    float dynCi = 0.0f;
+    if (slowTermsDue) {
+        pidState.slowTermsCount = 0;
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            pidState.axis[axis].gyroRateSlow = pidState.axis[axis].gyroRateSum * pidState.slowScale;
+            pidState.axis[axis].gyroRateSum = 0.0f;
+        }
+#ifdef USE_GYRO_JITTER_STATS
+        if (pidState.jitterThreshold) {
+            pidUpdateJitterCorrection();
+        }
+#endif
 
+        // Dynamic i component,
+        if ((antiGravityMode == ANTI_GRAVITY_SMOOTH) && antiGravityEnabled) {
+            itermAccelerator = 1 + fabsf(antiGravityThrottleHpf) * 0.01f * (itermAcceleratorGain - 1000);
+            DEBUG_SET(DEBUG_ANTI_GRAVITY, 1, lrintf(antiGravityThrottleHpf * 1000));
+        }
+        DEBUG_SET(DEBUG_ANTI_GRAVITY, 0, lrintf(itermAccelerator * 1000));
 
-    // gradually scale back integration when above windup point
-    const float dynCi = constrainf((1.0f - getMotorMixRange()) * ITermWindupPointInv, 0.0f, 1.0f)
-        * dT * itermAccelerator;
+        // gradually scale back integration when above windup point
+        dynCi = constrainf((1.0f - getMotorMixRange()) * ITermWindupPointInv, 0.0f, 1.0f)
+            * pidState.slowDT * itermAccelerator;
+    }
     float errorRate;
     float currentPidSetpoint;
 
+    // the attitude is only brought up to date when a mode levels on it, crash recovery
+    // can start part way through the axis loop below so it counts whenever it is enabled
+    bool levelling = FLIGHT_MODE(ANGLE_MODE | HORIZON_MODE | GPS_RESCUE_MODE) || pidProfile->crash_recovery || inCrashRecoveryMode;
+#ifdef USE_ACRO_TRAINER
+    levelling = levelling || acroTrainerActive;
+#endif
+    if (levelling) {
+        imuRefreshEulerAngles();
+    }
+
     // ----------PID controller----------
     for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        pidAxisState_t *axisState = &pidState.axis[axis];
+        pidAxisData_t *axisData = &pidData[axis];
+
         currentPidSetpoint = getSetpointRate(axis);
-        if (maxVelocity[axis]) {
-            currentPidSetpoint = accelerationLimit(axis, currentPidSetpoint);
+        if (axisState->maxVelocity) {
+            currentPidSetpoint = accelerationLimit(axisState, currentPidSetpoint);
         }
         // Yaw control is GYRO based, direct sticks control is applied to rate PID
         if ((FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE) || FLIGHT_MODE(GPS_RESCUE_MODE)) && axis != FD_YAW) {
@@ -1084,60 +1227,73 @@ void pidController(const pidProfile_t *pidProfile, const rollAndPitchTrims_t *an
             pidProfile->crash_recovery, angleTrim, axis, currentTimeUs, errorRate,
             &currentPidSetpoint, &errorRate);
 
-        float dDelta = activePidController(pidProfile, axis, errorRate, dynCi, 0.0f, currentPidSetpoint);
+        axisData->P = pidProportional(axisState, errorRate);
 
+        // I and D hold their values between slow updates
+        if (slowTermsDue) {
+            // error against the averaged gyro, same as errorRate when not decimating
+            const float slowErrorRate = errorRate + (gyro.gyroADCf[axis] - axisState->gyroRateSlow);
+            const float dDelta = pidState.butteredPids
+                ? butteredPids(pidProfile, axis, axisState, slowErrorRate, dynCi)
+                : classicPids(pidProfile, axis, axisState, slowErrorRate, dynCi, currentPidSetpoint);
 
-        detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, dDelta, errorRate);
+            detectAndSetCrashRecovery(pidProfile->crash_recovery, axis, currentTimeUs, dDelta, slowErrorRate);
+        }
 
         // -----calculate feedforward component
         // Only enable feedforward for rate mode
-        const float feedforwardGain = flightModeFlags ? 0.0f : pidCoefficient[axis].Kf;
+        const float feedforwardGain = flightModeFlags ? 0.0f : axisState->coefficient.Kf;
 
         if (feedforwardGain > 0) {
 
             // no transition if feedForwardTransition == 0
             float transition = feedForwardTransition > 0 ? MIN(1.f, getRcDeflectionAbs(axis) * feedForwardTransition) : 1;
 
-            float pidSetpointDelta = currentPidSetpoint - previousPidSetpoint[axis];
+            float pidSetpointDelta = currentPidSetpoint - axisState->previousPidSetpoint;
 
 #ifdef USE_RC_SMOOTHING_FILTER
-            pidSetpointDelta = applyRcSmoothingDerivativeFilter(axis, pidSetpointDelta);
+            if (rcPredictionIsActive(axis)) {
+                // the predicted setpoint derivative is already smooth, no need to filter it
+                pidSetpointDelta = getSetpointRateDerivative(axis) * dT;
+            } else {
+                pidSetpointDelta = applyRcSmoothingDerivativeFilter(axis, pidSetpointDelta);
+            }
 #endif // USE_RC_SMOOTHING_FILTER
 
 
-            pidData[axis].F = feedforwardGain * transition * pidSetpointDelta * pidFrequency;
+            axisData->F = feedforwardGain * transition * pidSetpointDelta * pidFrequency;
 
 #if defined(USE_SMART_FEEDFORWARD)
             applySmartFeedforward(axis);
 #endif
         } else {
-            pidData[axis].F = 0;
+            axisData->F = 0;
         }
-        previousPidSetpoint[axis] = currentPidSetpoint;
+        axisState->previousPidSetpoint = currentPidSetpoint;
 
 #ifdef USE_YAW_SPIN_RECOVERY
         if (gyroYawSpinDetected()) {
-            pidData[axis].I = 0;  // in yaw spin always disable I
+            axisData->I = 0;  // in yaw spin always disable I
             if (axis <= FD_PITCH)  {
                 // zero PIDs on pitch and roll leaving yaw P to correct spin
-                pidData[axis].P = 0;
-                pidData[axis].D = 0;
-                pidData[axis].F = 0;
+                axisData->P = 0;
+                axisData->D = 0;
+                axisData->F = 0;
             }
         }
 #endif // USE_YAW_SPIN_RECOVERY
     // Disable PID control if at zero throttle or if gyro overflow detected
     // This may look very innefficient, but it is done on purpose to always show real CPU usage as in flight
         if (!pidStabilisationEnabled || gyroOverflowDetected()) {
-            pidData[axis].P = 0;
-            pidData[axis].I = 0;
-            pidData[axis].D = 0;
-            pidData[axis].F = 0;
+            axisData->P = 0;
+            axisData->I = 0;
+            axisData->D = 0;
+            axisData->F = 0;
 
-            pidData[axis].Sum = 0;
+            axisData->Sum = 0;
         }
         // calculating the PID sum
-        pidData[axis].Sum = pidData[axis].P + pidData[axis].I + pidData[axis].D + pidData[axis].F;
+        axisData->Sum = axisData->P + axisData->I + axisData->D + axisData->F;
     }
 }
 
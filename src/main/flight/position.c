@@ -30,6 +30,7 @@
 #include "fc/runtime_config.h"
 
 #include "flight/position.h"
+#include "flight/position_estimator.h"
 #include "flight/imu.h"
 #include "flight/pid.h"
 
@@ -92,8 +93,14 @@ if (sensors(SENSOR_GPS) && STATE(GPS_FIX)) {
         baroAltOffset = baroAlt;
         gpsAltOffset = gpsAlt;
         altitudeOffsetSet = true;
+#ifdef USE_POSITION_ESTIMATOR
+        positionEstimatorResetAxis(POSITION_UP);
+#endif
     } else if (!ARMING_FLAG(ARMED) && altitudeOffsetSet) {
         altitudeOffsetSet = false;
+#ifdef USE_POSITION_ESTIMATOR
+        positionEstimatorResetAxis(POSITION_UP);
+#endif
     }
     baroAlt -= baroAltOffset;
     gpsAlt -= gpsAltOffset;
@@ -106,6 +113,25 @@ if (sensors(SENSOR_GPS) && STATE(GPS_FIX)) {
         estimatedAltitude = baroAlt;
     }
     
+#ifdef USE_POSITION_ESTIMATOR
+#ifdef USE_BARO
+    // the altitude task runs faster than the baro samples, each sample is fused once
+    static uint16_t lastBaroSampleCount;
+    if (haveBaroAlt && baroGetSampleCount() != lastBaroSampleCount) {
+        positionEstimatorUpdatePosition(POSITION_UP, POSITION_SOURCE_BARO, baroAlt);
+    }
+    lastBaroSampleCount = baroGetSampleCount();
+#endif
+#ifdef USE_GPS
+    // GPS altitude is only relative to the baro one once both offsets are taken at arming
+    static uint8_t lastGpsUpdate;
+    if (haveGpsAlt && GPS_update != lastGpsUpdate && (altitudeOffsetSet || !haveBaroAlt)) {
+        positionEstimatorUpdatePosition(POSITION_UP, POSITION_SOURCE_GPS, gpsAlt);
+    }
+    lastGpsUpdate = GPS_update;
+#endif
+#endif
+
     DEBUG_SET(DEBUG_ALTITUDE, 0, (int32_t)(100 * gpsTrust));
     DEBUG_SET(DEBUG_ALTITUDE, 1, baroAlt);
     DEBUG_SET(DEBUG_ALTITUDE, 2, gpsAlt);
@@ -119,11 +145,21 @@ bool isAltitudeOffset(void)
 
 int32_t getEstimatedAltitude(void)
 {
+#ifdef USE_POSITION_ESTIMATOR
+    if (positionEstimatorIsValid(POSITION_UP)) {
+        return lrintf(positionEstimatorGetPosition(POSITION_UP));
+    }
+#endif
     return estimatedAltitude;
 }
 
-// This should be removed or fixed, but it would require changing a lot of other things to get rid of.
+// vertical speed in cm/s
 int16_t getEstimatedVario(void)
 {
+#ifdef USE_POSITION_ESTIMATOR
+    if (positionEstimatorIsValid(POSITION_UP)) {
+        return constrain(lrintf(positionEstimatorGetVelocity(POSITION_UP)), INT16_MIN, INT16_MAX);
+    }
+#endif
     return 0;
 }
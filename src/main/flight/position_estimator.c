@@ -0,0 +1,224 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Kalman filter for the position and velocity of the craft.
+ *
+ * Each earth frame axis carries position, velocity and an accelerometer bias.
+ * The earth frame acceleration from the IMU drives the prediction at attitude
+ * task rate. GPS and baro measurements correct it when they arrive. With
+ * the acceleration as a known input the model is linear, so the filter is
+ * a plain Kalman filter. The axes do not couple, so three 3x3 covariances
+ * replace a 9x9 one.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_POSITION_ESTIMATOR
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+
+#include "flight/position_estimator.h"
+
+#define STATE_POSITION 0
+#define STATE_VELOCITY 1
+#define STATE_ACC_BIAS 2
+#define STATE_COUNT    3
+
+#define ACC_NOISE_CMSS              50.0f   // vibration and attitude error on the earth frame acceleration
+#define ACC_BIAS_DRIFT_CMSS         5.0f    // bias random walk per sqrt(s)
+#define INITIAL_VELOCITY_STDDEV     100.0f
+#define INITIAL_ACC_BIAS_STDDEV     50.0f
+#define INNOVATION_GATE_SIGMA       5.0f
+#define REJECTIONS_BEFORE_RESET     10
+#define MEASUREMENT_TIMEOUT_S       1.0f
+
+typedef struct positionSourceNoise_s {
+    float positionStdDev;
+    float velocityStdDev;
+    float latency;                          // s, position measurements are compared against the state this far back
+} positionSourceNoise_t;
+
+static const positionSourceNoise_t sourceNoise[POSITION_SOURCE_COUNT] = {
+    [POSITION_SOURCE_GPS]  = { .positionStdDev = 250.0f, .velocityStdDev = 50.0f, .latency = 0.1f },
+    [POSITION_SOURCE_BARO] = { .positionStdDev = 100.0f, .velocityStdDev = 0.0f,  .latency = 0.0f },
+};
+
+typedef struct positionAxisState_s {
+    float x[STATE_COUNT];
+    float P[STATE_COUNT][STATE_COUNT];
+    float timeSinceUpdate;
+    uint8_t rejectCount;
+    bool initialized;
+} positionAxisState_t;
+
+static positionAxisState_t axisState[POSITION_AXIS_COUNT];
+
+void positionEstimatorResetAxis(positionAxis_e axis)
+{
+    memset(&axisState[axis], 0, sizeof(axisState[axis]));
+}
+
+static void initializeAxis(positionAxisState_t *state, float position, float positionStdDev)
+{
+    memset(state, 0, sizeof(*state));
+    state->x[STATE_POSITION] = position;
+    state->P[STATE_POSITION][STATE_POSITION] = sq(positionStdDev);
+    state->P[STATE_VELOCITY][STATE_VELOCITY] = sq(INITIAL_VELOCITY_STDDEV);
+    state->P[STATE_ACC_BIAS][STATE_ACC_BIAS] = sq(INITIAL_ACC_BIAS_STDDEV);
+    state->initialized = true;
+}
+
+static void predictAxis(positionAxisState_t *state, float acceleration, float dT)
+{
+    const float a = acceleration - state->x[STATE_ACC_BIAS];
+    state->x[STATE_POSITION] += (state->x[STATE_VELOCITY] + 0.5f * a * dT) * dT;
+    state->x[STATE_VELOCITY] += a * dT;
+
+    // P = F * P * F' + Q, with F = [1 dT -dT^2/2; 0 1 -dT; 0 0 1]
+    const float F[STATE_COUNT][STATE_COUNT] = {
+        { 1.0f, dT,   -0.5f * dT * dT },
+        { 0.0f, 1.0f, -dT },
+        { 0.0f, 0.0f, 1.0f },
+    };
+    float FP[STATE_COUNT][STATE_COUNT];
+    for (int i = 0; i < STATE_COUNT; i++) {
+        for (int j = 0; j < STATE_COUNT; j++) {
+            FP[i][j] = F[i][0] * state->P[0][j] + F[i][1] * state->P[1][j] + F[i][2] * state->P[2][j];
+        }
+    }
+    for (int i = 0; i < STATE_COUNT; i++) {
+        for (int j = i; j < STATE_COUNT; j++) {
+            state->P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2];
+            state->P[j][i] = state->P[i][j];
+        }
+    }
+
+    // acceleration noise enters position and velocity, the bias drifts slowly
+    const float accVariance = sq(ACC_NOISE_CMSS);
+    state->P[0][0] += accVariance * 0.25f * sq(dT) * sq(dT);
+    state->P[0][1] += accVariance * 0.5f * sq(dT) * dT;
+    state->P[1][0] = state->P[0][1];
+    state->P[1][1] += accVariance * sq(dT);
+    state->P[2][2] += sq(ACC_BIAS_DRIFT_CMSS) * dT;
+
+    state->timeSinceUpdate += dT;
+}
+
+// Scalar measurement z = h * x with variance r. Returns false when the
+// innovation is rejected as an outlier.
+static bool updateAxis(positionAxisState_t *state, const float h[STATE_COUNT], float z, float r)
+{
+    float Ph[STATE_COUNT];
+    float predicted = 0.0f;
+    float S = r;
+    for (int i = 0; i < STATE_COUNT; i++) {
+        Ph[i] = state->P[i][0] * h[0] + state->P[i][1] * h[1] + state->P[i][2] * h[2];
+        predicted += h[i] * state->x[i];
+        S += h[i] * Ph[i];
+    }
+
+    const float innovation = z - predicted;
+    if (sq(innovation) > sq(INNOVATION_GATE_SIGMA) * S) {
+        state->rejectCount++;
+        return false;
+    }
+    state->rejectCount = 0;
+
+    float K[STATE_COUNT];
+    for (int i = 0; i < STATE_COUNT; i++) {
+        K[i] = Ph[i] / S;
+        state->x[i] += K[i] * innovation;
+    }
+    for (int i = 0; i < STATE_COUNT; i++) {
+        for (int j = 0; j < STATE_COUNT; j++) {
+            state->P[i][j] -= K[i] * Ph[j];
+        }
+    }
+
+    state->timeSinceUpdate = 0.0f;
+    return true;
+}
+
+void positionEstimatorPredict(const float accelerationCmss[POSITION_AXIS_COUNT], float dT)
+{
+    for (int axis = 0; axis < POSITION_AXIS_COUNT; axis++) {
+        if (axisState[axis].initialized) {
+            predictAxis(&axisState[axis], accelerationCmss[axis], dT);
+        }
+    }
+
+    DEBUG_SET(DEBUG_POSITION_ESTIMATOR, 0, lrintf(axisState[POSITION_UP].x[STATE_POSITION]));
+    DEBUG_SET(DEBUG_POSITION_ESTIMATOR, 1, lrintf(axisState[POSITION_UP].x[STATE_VELOCITY]));
+    DEBUG_SET(DEBUG_POSITION_ESTIMATOR, 2, lrintf(axisState[POSITION_NORTH].x[STATE_VELOCITY]));
+    DEBUG_SET(DEBUG_POSITION_ESTIMATOR, 3, lrintf(axisState[POSITION_EAST].x[STATE_VELOCITY]));
+}
+
+bool positionEstimatorUpdatePosition(positionAxis_e axis, positionSource_e source, float positionCm)
+{
+    positionAxisState_t *state = &axisState[axis];
+    const positionSourceNoise_t *noise = &sourceNoise[source];
+
+    // an axis that keeps rejecting a source starts over from it, e.g. after a GPS glitch outlasted the gate
+    if (!state->initialized || state->rejectCount >= REJECTIONS_BEFORE_RESET) {
+        initializeAxis(state, positionCm, noise->positionStdDev);
+        return true;
+    }
+
+    // the measurement describes where the craft was 'latency' seconds ago
+    const float h[STATE_COUNT] = { 1.0f, -noise->latency, 0.0f };
+    return updateAxis(state, h, positionCm, sq(noise->positionStdDev));
+}
+
+bool positionEstimatorUpdateVelocity(positionAxis_e axis, positionSource_e source, float velocityCms)
+{
+    positionAxisState_t *state = &axisState[axis];
+
+    if (!state->initialized) {
+        return false;
+    }
+
+    const float h[STATE_COUNT] = { 0.0f, 1.0f, 0.0f };
+    return updateAxis(state, h, velocityCms, sq(sourceNoise[source].velocityStdDev));
+}
+
+bool positionEstimatorIsValid(positionAxis_e axis)
+{
+    return axisState[axis].initialized && axisState[axis].timeSinceUpdate < MEASUREMENT_TIMEOUT_S;
+}
+
+float positionEstimatorGetPosition(positionAxis_e axis)
+{
+    return axisState[axis].x[STATE_POSITION];
+}
+
+float positionEstimatorGetVelocity(positionAxis_e axis)
+{
+    return axisState[axis].x[STATE_VELOCITY];
+}
+
+#endif // USE_POSITION_ESTIMATOR
@@ -0,0 +1,47 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// Position and velocity estimate in cm and cm/s, relative to the GPS home
+// point horizontally and to the arming altitude vertically.
+typedef enum {
+    POSITION_NORTH = 0,
+    POSITION_EAST,
+    POSITION_UP,
+    POSITION_AXIS_COUNT
+} positionAxis_e;
+
+typedef enum {
+    POSITION_SOURCE_GPS = 0,
+    POSITION_SOURCE_BARO,
+    POSITION_SOURCE_COUNT
+} positionSource_e;
+
+void positionEstimatorResetAxis(positionAxis_e axis);
+void positionEstimatorPredict(const float accelerationCmss[POSITION_AXIS_COUNT], float dT);
+bool positionEstimatorUpdatePosition(positionAxis_e axis, positionSource_e source, float positionCm);
+bool positionEstimatorUpdateVelocity(positionAxis_e axis, positionSource_e source, float velocityCms);
+
+bool positionEstimatorIsValid(positionAxis_e axis);
+float positionEstimatorGetPosition(positionAxis_e axis);
+float positionEstimatorGetVelocity(positionAxis_e axis);
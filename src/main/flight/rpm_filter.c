@@ -0,0 +1,160 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_RPM_FILTER
+
+#include "build/debug.h"
+
+#include "common/axis.h"
+#include "common/filter.h"
+#include "common/maths.h"
+
+#include "drivers/pwm_output.h"
+
+#include "flight/mixer.h"
+#include "flight/rpm_filter.h"
+
+#include "pg/pg.h"
+#include "pg/pg_ids.h"
+
+#define RPM_FILTER_MAX_FREQUENCY_RATIO 0.48f   // highest notch relative to the sample rate, just below Nyquist
+
+PG_REGISTER_WITH_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig, PG_RPM_FILTER_CONFIG, 0);
+
+PG_RESET_TEMPLATE(rpmFilterConfig_t, rpmFilterConfig,
+    .gyro_rpm_notch_harmonics = 3,
+    .gyro_rpm_notch_min = 100,
+    .gyro_rpm_notch_q = 500,
+    .rpm_lpf = 150,
+);
+
+static FAST_RAM_ZERO_INIT uint8_t numHarmonics;
+static FAST_RAM_ZERO_INIT uint8_t numMotors;
+static FAST_RAM_ZERO_INIT uint32_t looptimeUs;
+static FAST_RAM_ZERO_INIT float minHz;
+static FAST_RAM_ZERO_INIT float maxHz;
+static FAST_RAM_ZERO_INIT float notchQ;
+static FAST_RAM_ZERO_INIT float erpmToHz;
+static FAST_RAM_ZERO_INIT uint8_t updateMotor;     // notch moved by the next update
+static FAST_RAM_ZERO_INIT uint8_t updateHarmonic;
+
+static FAST_RAM_ZERO_INIT pt1Filter_t motorHzFilter[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT float motorHz[MAX_SUPPORTED_MOTORS];
+static FAST_RAM_ZERO_INIT biquadFilter_t notchFilter[RPM_FILTER_BANK_COUNT][RPM_FILTER_HARMONICS_MAX][MAX_SUPPORTED_MOTORS][XYZ_AXIS_COUNT];
+
+void rpmFilterInit(const rpmFilterConfig_t *config, uint32_t targetLooptimeUs)
+{
+    numHarmonics = 0;
+    if (config->gyro_rpm_notch_harmonics == 0 || !motorConfig()->dev.useDshotTelemetry || motorConfig()->motorPoleCount < 2) {
+        return;
+    }
+
+    numHarmonics = MIN(config->gyro_rpm_notch_harmonics, RPM_FILTER_HARMONICS_MAX);
+    numMotors = MIN(getMotorCount(), MAX_SUPPORTED_MOTORS);
+    looptimeUs = targetLooptimeUs;
+    minHz = config->gyro_rpm_notch_min;
+    maxHz = RPM_FILTER_MAX_FREQUENCY_RATIO * 1e6f / looptimeUs;
+    notchQ = config->gyro_rpm_notch_q / 100.0f;
+    // eRPM counts every pole pair of the motor once per revolution
+    erpmToHz = 1.0f / (60.0f * (motorConfig()->motorPoleCount / 2));
+    updateMotor = 0;
+    updateHarmonic = 0;
+
+    const float lpfGain = pt1FilterGain(config->rpm_lpf, looptimeUs * 1e-6f);
+    for (int motor = 0; motor < numMotors; motor++) {
+        pt1FilterInit(&motorHzFilter[motor], lpfGain);
+        motorHz[motor] = 0.0f;
+        for (int bank = 0; bank < RPM_FILTER_BANK_COUNT; bank++) {
+            for (int harmonic = 0; harmonic < numHarmonics; harmonic++) {
+                for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                    biquadFilterInit(&notchFilter[bank][harmonic][motor][axis], minHz * (harmonic + 1), looptimeUs, notchQ, FILTER_NOTCH);
+                }
+            }
+        }
+    }
+}
+
+bool isRpmFilterEnabled(void)
+{
+    return numHarmonics > 0;
+}
+
+// Smooths every motor frequency and moves one notch onto it per call, so
+// rebuilding the notch coefficients costs one biquad update per loop. Each
+// notch follows its motor within motors times harmonics loops. All axes and
+// banks of a notch share its coefficients.
+FAST_CODE_NOINLINE void rpmFilterUpdate(void)
+{
+    for (int motor = 0; motor < numMotors; motor++) {
+        motorHz[motor] = pt1FilterApply(&motorHzFilter[motor], getDshotTelemetry(motor) * erpmToHz);
+        if (motor < 4) {
+            DEBUG_SET(DEBUG_RPM_FILTER, motor, lrintf(motorHz[motor]));
+        }
+    }
+
+    if (!numHarmonics) {
+        return;
+    }
+
+    const float frequency = constrainf(motorHz[updateMotor] * (updateHarmonic + 1), minHz, maxHz);
+    biquadFilter_t *source = &notchFilter[0][updateHarmonic][updateMotor][X];
+    biquadFilterUpdate(source, frequency, looptimeUs, notchQ, FILTER_NOTCH);
+    for (int bank = 0; bank < RPM_FILTER_BANK_COUNT; bank++) {
+        biquadFilter_t *notch = notchFilter[bank][updateHarmonic][updateMotor];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            notch[axis].b0 = source->b0;
+            notch[axis].b1 = source->b1;
+            notch[axis].b2 = source->b2;
+            notch[axis].a1 = source->a1;
+            notch[axis].a2 = source->a2;
+        }
+    }
+
+    if (++updateMotor >= numMotors) {
+        updateMotor = 0;
+        if (++updateHarmonic >= numHarmonics) {
+            updateHarmonic = 0;
+        }
+    }
+}
+
+// Each gyro sensor filters through its own bank of notch states
+FAST_CODE float rpmFilterGyro(int bank, int axis, float value)
+{
+    for (int harmonic = 0; harmonic < numHarmonics; harmonic++) {
+        for (int motor = 0; motor < numMotors; motor++) {
+            // DF1 keeps its state consistent while the coefficients move
+            value = biquadFilterApplyDF1(&notchFilter[bank][harmonic][motor][axis], value);
+        }
+    }
+    return value;
+}
+
+float rpmFilterGetMotorFrequency(int motorIndex)
+{
+    return motorHz[motorIndex];
+}
+#endif
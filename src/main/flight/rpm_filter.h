@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pg/pg.h"
+
+#define RPM_FILTER_HARMONICS_MAX 3
+#ifdef USE_DUAL_GYRO
+#define RPM_FILTER_BANK_COUNT 2     // notch states per gyro sensor, the coefficients are shared
+#else
+#define RPM_FILTER_BANK_COUNT 1
+#endif
+
+typedef struct rpmFilterConfig_s {
+    uint8_t  gyro_rpm_notch_harmonics;  // notches per motor on the fundamental and its harmonics, 0 disables the filter
+    uint8_t  gyro_rpm_notch_min;        // lowest notch frequency in Hz, notches of slower motors stay here
+    uint16_t gyro_rpm_notch_q;          // notch Q * 100
+    uint16_t rpm_lpf;                   // cutoff in Hz of the smoothing applied to each motor frequency
+} rpmFilterConfig_t;
+
+PG_DECLARE(rpmFilterConfig_t, rpmFilterConfig);
+
+void rpmFilterInit(const rpmFilterConfig_t *config, uint32_t looptimeUs);
+bool isRpmFilterEnabled(void);
+void rpmFilterUpdate(void);
+float rpmFilterGyro(int bank, int axis, float value);
+float rpmFilterGetMotorFrequency(int motorIndex);
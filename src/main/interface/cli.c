@@ -61,6 +61,7 @@ extern uint8_t __config_end;
 #include "drivers/accgyro/accgyro.h"
 #ifdef USE_GYRO_IMUF9001
 #include "drivers/accgyro/accgyro_imuf9001.h"
+#include "drivers/accgyro/accgyro_imuf9001_link.h"
 #endif
 #include "drivers/adc.h"
 #include "drivers/buf_writer.h"
@@ -158,6 +159,7 @@ extern uint8_t __config_end;
 #include "sensors/compass.h"
 #include "sensors/esc_sensor.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_jitter.h"
 #include "sensors/sensors.h"
 
 #include "telemetry/frsky_hub.h"
@@ -2957,6 +2959,18 @@ static void cliImufFlashBin(char *cmdline)
         cliWriter = NULL;
     }
 }
+
+#ifdef USE_IMUF_LIVE_UPDATE
+static void cliImufApply(char *cmdline)
+{
+    UNUSED(cmdline);
+    if (imufRequestFilterUpdate()) {
+        cliPrintLine("Filter settings sent to the IMU-F");
+    } else {
+        cliPrintLine("The IMU-F cannot take them now, they apply after save and reboot");
+    }
+}
+#endif
 #endif
 
 #ifdef MSP_OVER_CLI
@@ -3044,11 +3058,12 @@ static void cliPrintGyroRegisters(uint8_t whichSensor)
 static void cliDumpGyroRegisters(char *cmdline)
 {
 #ifdef USE_DUAL_GYRO
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    const bool bothGyros = gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH || gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_FUSED;
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_1) || bothGyros) {
         cliPrintLinef("\r\n# Gyro 1");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_1);
     }
-    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || (gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_BOTH)) {
+    if ((gyroConfig()->gyro_to_use == GYRO_CONFIG_USE_GYRO_2) || bothGyros) {
         cliPrintLinef("\r\n# Gyro 2");
         cliPrintGyroRegisters(GYRO_CONFIG_USE_GYRO_2);
     }
@@ -3059,6 +3074,34 @@ static void cliDumpGyroRegisters(char *cmdline)
 }
 #endif
 
+#ifdef USE_GYRO_JITTER_STATS
+static void cliGyroJitter(char *cmdline)
+{
+    if (strcasecmp(cmdline, "reset") == 0) {
+        gyroResetJitterStats();
+        cliPrintLine("Gyro jitter statistics reset");
+        return;
+    }
+
+    const gyroJitterStats_t *stats = gyroGetJitterStats();
+    cliPrintLinef("# expected %dus, %d samples", stats->expectedIntervalUs, stats->sampleCount);
+    if (!stats->sampleCount) {
+        return;
+    }
+    cliPrintLinef("# interval min %dus max %dus mean %dus, mean deviation %dus",
+        stats->minIntervalUs, stats->maxIntervalUs, gyroJitterMeanIntervalUs(stats), gyroJitterMeanDeviationUs(stats));
+    cliPrintLinef("# latency max %dus mean %dus", stats->maxLatencyUs, gyroJitterMeanLatencyUs(stats));
+    for (int i = 0; i < GYRO_JITTER_BUCKET_COUNT; i++) {
+        if (i < GYRO_JITTER_BUCKET_COUNT - 1) {
+            cliPrintf("# deviation  < %3d%%", gyroJitterBucketEdge(i));
+        } else {
+            cliPrintf("# deviation >= %3d%%", gyroJitterBucketEdge(i - 1));
+        }
+        cliPrintLinef(" %9d", stats->histogram[i]);
+    }
+}
+#endif
+
 
 static int parseOutputIndex(char *pch, bool allowAllEscs) {
     int outputIndex = atoi(pch);
@@ -4305,6 +4348,9 @@ static void cliRcSmoothing(char *cmdline)
                 cliPrintLine("manual)");
             }
         }
+    } else if (rxConfig()->rc_smoothing_type == RC_SMOOTHING_TYPE_PREDICTIVE) {
+        cliPrintLine("PREDICTIVE");
+        cliPrintLinef("# Detected RX frame interval: %dus", currentRxRefreshRate);
     } else {
         cliPrintLine("INTERPOLATION");
     }
@@ -5042,6 +5088,9 @@ const clicmd_t cmdTable[] = {
     CLI_COMMAND_DEF("imufbootloader", NULL, NULL, cliImufBootloaderMode),
     CLI_COMMAND_DEF("imufloadbin", NULL, NULL, cliImufLoadBin),
     CLI_COMMAND_DEF("imufflashbin", NULL, NULL, cliImufFlashBin),
+#ifdef USE_IMUF_LIVE_UPDATE
+    CLI_COMMAND_DEF("imufapply", "send imu-f filter settings without a reboot", NULL, cliImufApply),
+#endif
 #endif
 #ifdef MSP_OVER_CLI
     CLI_COMMAND_DEF("msp", NULL, NULL, cliMsp),
@@ -5072,6 +5121,9 @@ const clicmd_t cmdTable[] = {
 #if defined(USE_GYRO_REGISTER_DUMP) && !defined(SIMULATOR_BUILD)
     CLI_COMMAND_DEF("gyroregisters", "dump gyro config registers contents", NULL, cliDumpGyroRegisters),
 #endif
+#ifdef USE_GYRO_JITTER_STATS
+    CLI_COMMAND_DEF("gyrojitter", "show gyro sample jitter", "[reset]", cliGyroJitter),
+#endif
 #ifdef USE_GYRO_IMUF9001
     CLI_COMMAND_DEF("reportimuferrors", "report imu-f comm errors", NULL, cliReportImufErrors),
 #endif
@@ -5151,8 +5203,11 @@ const clicmd_t cmdTable[] = {
 static void cliReportImufErrors(char *cmdline)
 {
     UNUSED(cmdline);
-    cliPrintf("Current Comm Errors: %lu", crcErrorCount);
-    cliPrintLinefeed();
+    cliPrintLinef("Current Comm Errors: %u", imufLink.stats.crcErrors);
+    cliPrintLinef("Frames: %u, Lost: %u", imufLink.stats.frames, imufLink.stats.overruns);
+#ifdef USE_IMUF_LIVE_UPDATE
+    cliPrintLinef("Filter Updates: %u, Last Sequence: %u", imufLink.stats.updatesSent, imufLink.stats.updateSequence);
+#endif
 }
 #endif
 
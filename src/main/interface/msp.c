@@ -81,6 +81,7 @@
 
 #include "io/asyncfatfs/asyncfatfs.h"
 #include "io/beeper.h"
+#include "io/displayport_msp.h"
 #include "io/flashfs.h"
 #include "io/gimbal.h"
 #include "io/gps.h"
@@ -120,6 +121,7 @@
 #include "sensors/esc_sensor.h"
 #include "sensors/compass.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_jitter.h"
 #include "sensors/rangefinder.h"
 #include "sensors/sensors.h"
 
@@ -920,6 +922,7 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 
     case MSP_ATTITUDE:
+        imuRefreshEulerAngles();
         sbufWriteU16(dst, attitude.values.roll);
         sbufWriteU16(dst, attitude.values.pitch);
         sbufWriteU16(dst, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
@@ -1303,6 +1306,26 @@ bool mspProcessOutCommand(uint8_t cmdMSP, sbuf_t *dst)
         break;
 #endif
 
+#ifdef USE_GYRO_JITTER_STATS
+    case MSP_GYRO_JITTER: {
+        const gyroJitterStats_t *stats = gyroGetJitterStats();
+        sbufWriteU16(dst, stats->expectedIntervalUs);
+        sbufWriteU32(dst, stats->sampleCount);
+        sbufWriteU16(dst, stats->sampleCount ? stats->minIntervalUs : 0);
+        sbufWriteU16(dst, stats->maxIntervalUs);
+        sbufWriteU16(dst, gyroJitterMeanIntervalUs(stats));
+        sbufWriteU16(dst, gyroJitterMeanDeviationUs(stats));
+        sbufWriteU16(dst, stats->maxLatencyUs);
+        sbufWriteU16(dst, gyroJitterMeanLatencyUs(stats));
+        sbufWriteU8(dst, GYRO_JITTER_BUCKET_COUNT);
+        for (int i = 0; i < GYRO_JITTER_BUCKET_COUNT; i++) {
+            sbufWriteU8(dst, gyroJitterBucketEdge(i));  // upper edge in percent, 0 for the last bucket
+            sbufWriteU32(dst, stats->histogram[i]);
+        }
+        break;
+    }
+#endif
+
     case MSP_PID_ADVANCED:
         sbufWriteU16(dst, 0);
         sbufWriteU16(dst, 0);
@@ -1867,6 +1890,8 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
         gyroConfigMutable()->imuf_roll_lpf_cutoff_hz = sbufReadU16(src);
         gyroConfigMutable()->imuf_pitch_lpf_cutoff_hz = sbufReadU16(src);
         gyroConfigMutable()->imuf_yaw_lpf_cutoff_hz = sbufReadU16(src);
+        // the filters change at once where the IMU-F takes them live, the mode needs a reboot
+        imufRequestFilterUpdate();
         break;
 #endif
 
@@ -2330,6 +2355,16 @@ mspResult_e mspProcessInCommand(uint8_t cmdMSP, sbuf_t *src)
         break;
 #endif
 #endif // USE_BOARD_INFO
+#ifdef USE_MSP_DISPLAYPORT
+    case MSP_DISPLAYPORT:
+        // sent by displayport v2 capable remotes
+        if (dataSize >= 1 && sbufReadU8(src) == MSP_DP_KEYFRAME_REQUEST) {
+            displayPortMspRequestKeyframe();
+        } else {
+            return MSP_RESULT_ERROR;
+        }
+        break;
+#endif
     default:
         // we do not know how to handle the (valid) message, indicate error MSP $M!
         return MSP_RESULT_ERROR;
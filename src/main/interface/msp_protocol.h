@@ -337,3 +337,4 @@
 #define MSP_IMUF_CONFIG          227    //out message
 #define MSP_SET_IMUF_CONFIG      228    //in message
 #define MSP_IMUF_INFO            229    //out message
+#define MSP_GYRO_JITTER          230    //out message         Gyro sample interval statistics and jitter histogram
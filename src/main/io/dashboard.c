@@ -507,6 +507,7 @@ static void showSensorsPage(void)
     }
 #endif
 
+    imuRefreshEulerAngles();
     tfp_sprintf(lineBuffer, format, "I&H", attitude.values.roll, attitude.values.pitch, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
     padLineBuffer();
     i2c_OLED_set_line(bus, rowIndex++);
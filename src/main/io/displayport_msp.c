@@ -27,6 +27,7 @@
 
 #ifdef USE_MSP_DISPLAYPORT
 
+#include "common/maths.h"
 #include "common/utils.h"
 
 #include "pg/pg.h"
@@ -46,6 +47,38 @@ PG_REGISTER(displayPortProfile_t, displayPortProfileMsp, PG_DISPLAY_PORT_MSP_CON
 
 static displayPort_t mspDisplayPort;
 
+// Set when anything was sent since the last draw command, there is no point
+// asking the remote side to redraw an unchanged screen
+static bool screenDirty;
+
+// Displayport v2
+//
+// Writes always land in a local framebuffer. Once the remote side sends
+// MSP_DP_KEYFRAME_REQUEST they are no longer sent one by one, drawScreen compares it against a shadow of what the
+// remote side has and sends only the changed cells, as spans batched into
+// MSP_DP_WRITE_SPANS frames:
+//
+//   span:  row, col, cell count, tokens covering cell count cells
+//   token: 0x00-0x7f  (n - 1), followed by n literal cells
+//          0x80-0xff  0x80 | (n - 1), followed by one cell repeated n times
+//
+// A keyframe is a clear followed by spans for all non blank cells.
+
+#define MSP_DP_MAX_ROWS             16
+#define MSP_DP_MAX_COLS             30
+#define MSP_DP_MAX_FRAME_SIZE       64  // payload, keeps each frame short on a shared 115200 baud link
+#define MSP_DP_FRAME_OVERHEAD       6   // $M> size cmd crc
+#define MSP_DP_SPAN_HEADER_SIZE     3
+#define MSP_DP_TOKEN_MAX_CELLS      128
+#define MSP_DP_MIN_REPEAT           3   // shorter repeats are cheaper as literals
+#define MSP_DP_SPAN_MAX_GAP         3   // unchanged cells resent to avoid a new span header
+
+static bool useV2;
+static bool keyframePending;
+static bool frameBufferDirty;
+static uint8_t frameBuffer[MSP_DP_MAX_ROWS][MSP_DP_MAX_COLS];
+static uint8_t shadowBuffer[MSP_DP_MAX_ROWS][MSP_DP_MAX_COLS];
+
 #ifdef USE_CLI
 extern uint8_t cliMode;
 #endif
@@ -65,7 +98,7 @@ static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len
 
 static int heartbeat(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 0 };
+    uint8_t subcmd[] = { MSP_DP_HEARTBEAT };
 
     // heartbeat is used to:
     // a) ensure display is not released by MW OSD software
@@ -80,21 +113,155 @@ static int grab(displayPort_t *displayPort)
 
 static int release(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 1 };
+    uint8_t subcmd[] = { MSP_DP_RELEASE };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static int clearScreen(displayPort_t *displayPort)
+static int sendClearScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 2 };
+    uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
 
+    screenDirty = true;
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
+static int clearScreen(displayPort_t *displayPort)
+{
+    memset(frameBuffer, ' ', sizeof(frameBuffer));
+    frameBufferDirty = true;
+
+    if (useV2) {
+        return 0;
+    }
+
+    return sendClearScreen(displayPort);
+}
+
+// Appends the run-length encoded cells of one span, returns the new frame
+// length or 0 if the span does not fit into the frame.
+static int encodeSpan(uint8_t *frame, int len, uint8_t row, uint8_t col, const uint8_t *cells, int count)
+{
+    if (len + MSP_DP_SPAN_HEADER_SIZE > MSP_DP_MAX_FRAME_SIZE) {
+        return 0;
+    }
+    frame[len++] = row;
+    frame[len++] = col;
+    frame[len++] = count;
+
+    int i = 0;
+    while (i < count) {
+        int repeat = 1;
+        while (i + repeat < count && repeat < MSP_DP_TOKEN_MAX_CELLS && cells[i + repeat] == cells[i]) {
+            repeat++;
+        }
+
+        if (repeat >= MSP_DP_MIN_REPEAT) {
+            if (len + 2 > MSP_DP_MAX_FRAME_SIZE) {
+                return 0;
+            }
+            frame[len++] = 0x80 | (repeat - 1);
+            frame[len++] = cells[i];
+            i += repeat;
+            continue;
+        }
+
+        // literal cells up to the next repeat worth encoding
+        int literal = 1;
+        while (i + literal < count && literal < MSP_DP_TOKEN_MAX_CELLS) {
+            const uint8_t *next = &cells[i + literal];
+            if (i + literal + MSP_DP_MIN_REPEAT <= count && next[0] == next[1] && next[0] == next[2]) {
+                break;
+            }
+            literal++;
+        }
+        if (len + 1 + literal > MSP_DP_MAX_FRAME_SIZE) {
+            return 0;
+        }
+        frame[len++] = literal - 1;
+        memcpy(&frame[len], &cells[i], literal);
+        len += literal;
+        i += literal;
+    }
+
+    return len;
+}
+
+static void drawScreenV2(displayPort_t *displayPort)
+{
+    if (keyframePending) {
+        sendClearScreen(displayPort);
+        memset(shadowBuffer, ' ', sizeof(shadowBuffer));
+        keyframePending = false;
+        frameBufferDirty = true;
+    }
+
+    if (!frameBufferDirty) {
+        return;
+    }
+
+    uint8_t frame[MSP_DP_MAX_FRAME_SIZE];
+    int frameLen = 0;
+    bool complete = true;
+
+    for (int row = 0; row < MSP_DP_MAX_ROWS && complete; row++) {
+        int col = 0;
+        while (col < MSP_DP_MAX_COLS) {
+            if (frameBuffer[row][col] == shadowBuffer[row][col]) {
+                col++;
+                continue;
+            }
+
+            // extend the span to the last changed cell, bridging short gaps
+            int end = col + 1;
+            for (int i = end; i < MSP_DP_MAX_COLS && i - end < MSP_DP_SPAN_MAX_GAP; i++) {
+                if (frameBuffer[row][i] != shadowBuffer[row][i]) {
+                    end = i + 1;
+                }
+            }
+
+            if (frameLen == 0) {
+                if (displayTxBytesFree(displayPort) < MSP_DP_MAX_FRAME_SIZE + MSP_DP_FRAME_OVERHEAD) {
+                    // retry on the next draw, the shadow still holds what was not sent
+                    complete = false;
+                    break;
+                }
+                frame[frameLen++] = MSP_DP_WRITE_SPANS;
+            }
+
+            int newLen = encodeSpan(frame, frameLen, row, col, &frameBuffer[row][col], end - col);
+            if (!newLen) {
+                // frame full, send it and start the next one with this span
+                output(displayPort, MSP_DISPLAYPORT, frame, frameLen);
+                screenDirty = true;
+                frameLen = 0;
+                continue;
+            }
+            frameLen = newLen;
+            memcpy(&shadowBuffer[row][col], &frameBuffer[row][col], end - col);
+            col = end;
+        }
+    }
+
+    if (frameLen > 1) {
+        output(displayPort, MSP_DISPLAYPORT, frame, frameLen);
+        screenDirty = true;
+    }
+    frameBufferDirty = !complete;
+}
+
 static int drawScreen(displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { 4 };
+    uint8_t subcmd[] = { MSP_DP_DRAW_SCREEN };
+
+    if (useV2) {
+        drawScreenV2(displayPort);
+    }
+
+    if (!screenDirty) {
+        return 0;
+    }
+    screenDirty = false;
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
@@ -113,12 +280,22 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, con
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
 
-    buf[0] = 3;
+    if (row < MSP_DP_MAX_ROWS && col < MSP_DP_MAX_COLS) {
+        memcpy(&frameBuffer[row][col], string, MIN(len, MSP_DP_MAX_COLS - col));
+        frameBufferDirty = true;
+    }
+
+    if (useV2) {
+        return 0;
+    }
+
+    buf[0] = MSP_DP_WRITE_STRING;
     buf[1] = row;
     buf[2] = col;
     buf[3] = 0;
     memcpy(&buf[4], string, len);
 
+    screenDirty = true;
     return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
 }
 
@@ -147,6 +324,7 @@ static void resync(displayPort_t *displayPort)
 {
     displayPort->rows = 13 + displayPortProfileMsp()->rowAdjust; // XXX Will reflect NTSC/PAL in the future
     displayPort->cols = 30 + displayPortProfileMsp()->colAdjust;
+    screenDirty = true;
     drawScreen(displayPort);
 }
 
@@ -171,6 +349,12 @@ static const displayPortVTable_t mspDisplayPortVTable = {
     .txBytesFree = txBytesFree
 };
 
+void displayPortMspRequestKeyframe(void)
+{
+    useV2 = true;
+    keyframePending = true;
+}
+
 displayPort_t *displayPortMspInit(void)
 {
     displayInit(&mspDisplayPort, &mspDisplayPortVTable);
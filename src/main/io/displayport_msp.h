@@ -23,7 +23,21 @@
 #include "pg/pg.h"
 #include "drivers/display.h"
 
+// MSP_DISPLAYPORT sub commands
+typedef enum {
+    MSP_DP_HEARTBEAT = 0,
+    MSP_DP_RELEASE = 1,
+    MSP_DP_CLEAR_SCREEN = 2,
+    MSP_DP_WRITE_STRING = 3,
+    MSP_DP_DRAW_SCREEN = 4,
+    // v2: run-length encoded spans of changed cells, see displayport_msp.c
+    MSP_DP_WRITE_SPANS = 5,
+    // v2, sent by the remote side: switch to v2 and resend the whole screen
+    MSP_DP_KEYFRAME_REQUEST = 6,
+} mspDisplayPortCommand_e;
+
 PG_DECLARE(displayPortProfile_t, displayPortProfileMsp);
 
 struct displayPort_s;
 struct displayPort_s *displayPortMspInit(void);
+void displayPortMspRequestKeyframe(void);
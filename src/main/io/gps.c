@@ -32,7 +32,6 @@
 #include "build/debug.h"
 
 #include "common/axis.h"
-#include "common/gps_conversion.h"
 #include "common/maths.h"
 #include "common/utils.h"
 
@@ -53,6 +52,7 @@
 #include "flight/imu.h"
 #include "flight/pid.h"
 #include "flight/gps_rescue.h"
+#include "flight/position_estimator.h"
 
 #include "sensors/sensors.h"
 
@@ -61,11 +61,14 @@
 #define LOG_SKIPPED      '>'
 #define LOG_NMEA_GGA     'g'
 #define LOG_NMEA_RMC     'r'
+#define LOG_NMEA_GSA     'a'
+#define LOG_NMEA_GSV     'v'
 #define LOG_UBLOX_SOL    'O'
 #define LOG_UBLOX_STATUS 'S'
 #define LOG_UBLOX_SVINFO 'I'
 #define LOG_UBLOX_POSLLH 'P'
 #define LOG_UBLOX_VELNED 'V'
+#define LOG_UBLOX_PVT    'T'
 
 #define GPS_SV_MAXSATS   16
 
@@ -166,18 +169,32 @@ static const uint8_t ubloxInit[] = {
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x00, 0x00, 0xFA, 0x0F,           // GGA: Global positioning system fix data
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x02, 0x00, 0xFC, 0x13,           // GSA: GNSS DOP and Active Satellites
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x04, 0x00, 0xFE, 0x17,           // RMC: Recommended Minimum data
+};
 
-    // Enable UBLOX messages
+// Legacy message set, position, fix and velocity arrive in separate messages
+static const uint8_t ubloxLegacyMessages[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x00, 0x12, 0x50,           // disable PVT MSG
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x01, 0x0E, 0x47,           // set POSLLH MSG rate
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x03, 0x01, 0x0F, 0x49,           // set STATUS MSG rate
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x01, 0x12, 0x4F,           // set SOL MSG rate
     //0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x30, 0x01, 0x3C, 0xA3,           // set SVINFO MSG rate (every cycle - high bandwidth)
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x30, 0x05, 0x40, 0xA7,           // set SVINFO MSG rate (evey 5 cycles - low bandwidth)
     0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x12, 0x01, 0x1E, 0x67,           // set VELNED MSG rate
+};
 
-    0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8, 0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A,             // set rate to 5Hz (measurement period: 200ms, navigation rate: 1 cycle)
+// NAV-PVT carries a complete, self-consistent fix in one message (u-blox 7 and later)
+static const uint8_t ubloxPvtMessages[] = {
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x02, 0x00, 0x0D, 0x46,           // disable POSLLH MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x03, 0x00, 0x0E, 0x48,           // disable STATUS MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x00, 0x11, 0x4E,           // disable SOL MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x12, 0x00, 0x1D, 0x66,           // disable VELNED MSG
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x30, 0x05, 0x40, 0xA7,           // set SVINFO MSG rate (evey 5 cycles - low bandwidth)
+    0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51,           // set PVT MSG rate
 };
 
+// CFG-RATE is built at run time from gps_update_rate_hz
+#define UBLOX_CFG_RATE_LENGTH 14
+
 // UBlox 6 Protocol documentation - GPS.G6-SW-10018-F
 // SBAS Configuration Settings Desciption, Page 4/210
 // 31.21 CFG-SBAS (0x06 0x16), Page 142/210
@@ -233,14 +250,16 @@ typedef enum {
 gpsData_t gpsData;
 
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 0);
+PG_REGISTER_WITH_RESET_TEMPLATE(gpsConfig_t, gpsConfig, PG_GPS_CONFIG, 1);
 
 PG_RESET_TEMPLATE(gpsConfig_t, gpsConfig,
     .provider = GPS_NMEA,
     .sbasMode = SBAS_AUTO,
     .autoConfig = GPS_AUTOCONFIG_ON,
     .autoBaud = GPS_AUTOBAUD_OFF,
-    .gps_ublox_use_galileo = false
+    .gps_ublox_use_galileo = false,
+    .gps_ublox_use_pvt = false,
+    .gps_update_rate_hz = 5
 );
 
 static void shiftPacketLog(void)
@@ -364,6 +383,42 @@ void gpsInitNmea(void)
 #endif // USE_GPS_NMEA
 
 #ifdef USE_GPS_UBLOX
+// Queue as much of a configuration message as the transmit buffer takes,
+// returns true once the whole message has been queued
+static bool ubloxSendConfig(const uint8_t *message, uint32_t length)
+{
+    const uint32_t count = MIN(length - gpsData.state_position, serialTxBytesFree(gpsPort));
+
+    serialWriteBuf(gpsPort, message + gpsData.state_position, count);
+    gpsData.state_position += count;
+
+    if (gpsData.state_position < length) {
+        return false;
+    }
+    gpsData.state_position = 0;
+    return true;
+}
+
+static void ubloxBuildRateMessage(uint8_t *message, uint16_t measurementPeriodMs)
+{
+    const uint8_t header[] = { 0xB5, 0x62, 0x06, 0x08, 0x06, 0x00 };
+    memcpy(message, header, sizeof(header));
+    message[6] = measurementPeriodMs & 0xFF;
+    message[7] = measurementPeriodMs >> 8;
+    message[8] = 0x01; // navigation rate: 1 cycle
+    message[9] = 0x00;
+    message[10] = 0x01; // time reference: GPS
+    message[11] = 0x00;
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (int i = 2; i < UBLOX_CFG_RATE_LENGTH - 2; i++) {
+        ck_a += message[i];
+        ck_b += ck_a;
+    }
+    message[12] = ck_a;
+    message[13] = ck_b;
+}
+
 void gpsInitUblox(void)
 {
     uint32_t now;
@@ -418,35 +473,39 @@ void gpsInitUblox(void)
             }
 
             if (gpsData.messageState == GPS_MESSAGE_STATE_INIT) {
+                if (ubloxSendConfig(ubloxInit, sizeof(ubloxInit))) {
+                    gpsData.messageState++;
+                }
+            }
 
-                if (gpsData.state_position < sizeof(ubloxInit)) {
-                    serialWrite(gpsPort, ubloxInit[gpsData.state_position]);
-                    gpsData.state_position++;
-                } else {
-                    gpsData.state_position = 0;
+            if (gpsData.messageState == GPS_MESSAGE_STATE_MESSAGES) {
+                const bool sent = gpsConfig()->gps_ublox_use_pvt
+                    ? ubloxSendConfig(ubloxPvtMessages, sizeof(ubloxPvtMessages))
+                    : ubloxSendConfig(ubloxLegacyMessages, sizeof(ubloxLegacyMessages));
+                if (sent) {
+                    gpsData.messageState++;
+                }
+            }
+
+            if (gpsData.messageState == GPS_MESSAGE_STATE_RATE) {
+                uint8_t rateMessage[UBLOX_CFG_RATE_LENGTH];
+                ubloxBuildRateMessage(rateMessage, 1000 / gpsConfig()->gps_update_rate_hz);
+                if (ubloxSendConfig(rateMessage, sizeof(rateMessage))) {
                     gpsData.messageState++;
                 }
             }
 
             if (gpsData.messageState == GPS_MESSAGE_STATE_SBAS) {
-                if (gpsData.state_position < UBLOX_SBAS_PREFIX_LENGTH) {
-                    serialWrite(gpsPort, ubloxSbasPrefix[gpsData.state_position]);
-                    gpsData.state_position++;
-                } else if (gpsData.state_position < UBLOX_SBAS_PREFIX_LENGTH + UBLOX_SBAS_MESSAGE_LENGTH) {
-                    serialWrite(gpsPort, ubloxSbas[gpsConfig()->sbasMode].message[gpsData.state_position - UBLOX_SBAS_PREFIX_LENGTH]);
-                    gpsData.state_position++;
-                } else {
-                    gpsData.state_position = 0;
+                uint8_t sbasMessage[UBLOX_SBAS_PREFIX_LENGTH + UBLOX_SBAS_MESSAGE_LENGTH];
+                memcpy(sbasMessage, ubloxSbasPrefix, UBLOX_SBAS_PREFIX_LENGTH);
+                memcpy(sbasMessage + UBLOX_SBAS_PREFIX_LENGTH, ubloxSbas[gpsConfig()->sbasMode].message, UBLOX_SBAS_MESSAGE_LENGTH);
+                if (ubloxSendConfig(sbasMessage, sizeof(sbasMessage))) {
                     gpsData.messageState++;
                 }
             }
 
             if (gpsData.messageState == GPS_MESSAGE_STATE_GALILEO) {
-                if ((gpsConfig()->gps_ublox_use_galileo) && (gpsData.state_position < sizeof(ubloxGalileoInit))) {
-                    serialWrite(gpsPort, ubloxGalileoInit[gpsData.state_position]);
-                    gpsData.state_position++;
-                } else {
-                    gpsData.state_position = 0;
+                if (!gpsConfig()->gps_ublox_use_galileo || ubloxSendConfig(ubloxGalileoInit, sizeof(ubloxGalileoInit))) {
                     gpsData.messageState++;
                 }
             }
@@ -596,6 +655,7 @@ bool gpsNewFrame(uint8_t c)
 #define FRAME_GGA  1
 #define FRAME_RMC  2
 #define FRAME_GSV  3
+#define FRAME_GSA  4
 
 
 // This code is used for parsing NMEA data
@@ -638,36 +698,22 @@ static uint32_t GPS_coord_to_degrees(char *coordinateString)
 }
 */
 
-// helper functions
 #ifdef USE_GPS_NMEA
-static uint32_t grab_fields(char *src, uint8_t mult)
-{                               // convert string to uint32
-    uint32_t i;
-    uint32_t tmp = 0;
-    int isneg = 0;
-    for (i = 0; src[i] != 0; i++) {
-        if ((i == 0) && (src[0] == '-')) { // detect negative sign
-            isneg = 1;
-            continue; // jump to next character if the first one was a negative sign
-        }
-        if (src[i] == '.') {
-            i++;
-            if (mult == 0) {
-                break;
-            } else {
-                src[i + mult] = 0;
-            }
-        }
-        tmp *= 10;
-        if (src[i] >= '0' && src[i] <= '9') {
-            tmp += src[i] - '0';
-        }
-        if (i >= 15) {
-            return 0; // out of bounds
-        }
-    }
-    return isneg ? -tmp : tmp;    // handle negative altitudes
-}
+// Fields are converted to fixed point while their characters arrive, so a
+// sentence is looked at exactly once. Fractional digits beyond
+// NMEA_MAX_FRACTION_DIGITS are dropped, which truncates like the old
+// string based conversion did.
+#define NMEA_MAX_FRACTION_DIGITS 4
+
+#define NMEA_SENTENCE_TYPE(a, b, c) (((uint32_t)(a) << 16) | ((uint32_t)(b) << 8) | (uint32_t)(c))
+
+typedef struct nmeaField_s {
+    uint32_t value;                 // digits of the field without the decimal point
+    int8_t fractionDigits;          // digits after the decimal point, -1 when there is no decimal point
+    bool negative;
+    uint8_t length;
+    char firstChar;
+} nmeaField_t;
 
 typedef struct gpsDataNmea_s {
     int32_t latitude;
@@ -679,36 +725,120 @@ typedef struct gpsDataNmea_s {
     uint16_t ground_course;
     uint32_t time;
     uint32_t date;
+    bool fix;
 } gpsDataNmea_t;
 
+// value of the field with exactly 'decimals' digits after the decimal point
+static uint32_t nmeaFieldScaled(const nmeaField_t *field, int8_t decimals)
+{
+    uint32_t value = field->value;
+    int8_t digits = MAX(field->fractionDigits, 0);
+
+    for (; digits < decimals; digits++) {
+        value *= 10;
+    }
+    for (; digits > decimals; digits--) {
+        value /= 10;
+    }
+    return value;
+}
+
+static int32_t nmeaFieldSigned(const nmeaField_t *field, int8_t decimals)
+{
+    const int32_t value = nmeaFieldScaled(field, decimals);
+    return field->negative ? -value : value;
+}
+
+// dddmm.mmmm to degrees * 10^7, see GPS_coord_to_degrees()
+static int32_t nmeaFieldCoordinate(const nmeaField_t *field)
+{
+    const uint32_t minutes = nmeaFieldScaled(field, 4);    // degrees * 10^6 + minutes * 10^4
+
+    return (minutes / 1000000) * 10000000UL + (minutes % 1000000) * 100 / 6;
+}
+
+static void nmeaFieldAddChar(nmeaField_t *field, char c)
+{
+    if (field->length == 0) {
+        field->firstChar = c;
+    }
+    field->length++;
+
+    if (c >= '0' && c <= '9') {
+        if (field->fractionDigits < 0) {
+            field->value = field->value * 10 + (c - '0');
+        } else if (field->fractionDigits < NMEA_MAX_FRACTION_DIGITS) {
+            field->value = field->value * 10 + (c - '0');
+            field->fractionDigits++;
+        }
+    } else if (c == '.') {
+        field->fractionDigits = 0;
+    } else if (c == '-') {
+        field->negative = true;
+    }
+}
+
+static void nmeaFieldReset(nmeaField_t *field)
+{
+    field->value = 0;
+    field->fractionDigits = -1;
+    field->negative = false;
+    field->length = 0;
+    field->firstChar = 0;
+}
+
+static uint8_t nmeaHexValue(char c)
+{
+    return (c >= 'A') ? c - 'A' + 10 : c - '0';
+}
+
 static bool gpsNewFrameNMEA(char c)
 {
     static gpsDataNmea_t gps_Msg;
+    static nmeaField_t field;
 
     uint8_t frameOK = 0;
-    static uint8_t param = 0, offset = 0, parity = 0;
-    static char string[15];
-    static uint8_t checksum_param, gps_frame = NO_FRAME;
+    static uint8_t param = 0, parity = 0;
+    static uint8_t checksum_param, checksum, checksumDigits, gps_frame = NO_FRAME;
+    static uint32_t sentenceType;
+    static uint16_t talker;
+    // GSV sentences of all constellations share the satellite table, a cycle
+    // starts over with the first GSV sentence of the talker that began the last one
+    static uint16_t svCycleTalker;
     static uint8_t svMessageNum = 0;
-    uint8_t svSatNum = 0, svPacketIdx = 0, svSatParam = 0;
+    static uint8_t svSlotCount;
+    static int8_t svSlot = -1;
 
     switch (c) {
         case '$':
             param = 0;
-            offset = 0;
             parity = 0;
+            checksum_param = 0;
+            sentenceType = 0;
+            talker = 0;
+            nmeaFieldReset(&field);
             break;
         case ',':
         case '*':
-            string[offset] = 0;
             if (param == 0) {       //frame identification
                 gps_frame = NO_FRAME;
-                if (string[0] == 'G' && string[1] == 'P' && string[2] == 'G' && string[3] == 'G' && string[4] == 'A')
-                    gps_frame = FRAME_GGA;
-                if (string[0] == 'G' && string[1] == 'P' && string[2] == 'R' && string[3] == 'M' && string[4] == 'C')
-                    gps_frame = FRAME_RMC;
-                if (string[0] == 'G' && string[1] == 'P' && string[2] == 'G' && string[3] == 'S' && string[4] == 'V')
-                    gps_frame = FRAME_GSV;
+                // GP, GN (combined), GL, GA, GB... talkers
+                if (field.length == 5 && (talker >> 8) == 'G') {
+                    switch (sentenceType) {
+                        case NMEA_SENTENCE_TYPE('G', 'G', 'A'):
+                            gps_frame = FRAME_GGA;
+                            break;
+                        case NMEA_SENTENCE_TYPE('R', 'M', 'C'):
+                            gps_frame = FRAME_RMC;
+                            break;
+                        case NMEA_SENTENCE_TYPE('G', 'S', 'A'):
+                            gps_frame = FRAME_GSA;
+                            break;
+                        case NMEA_SENTENCE_TYPE('G', 'S', 'V'):
+                            gps_frame = FRAME_GSV;
+                            break;
+                    }
+                }
             }
 
             switch (gps_frame) {
@@ -717,53 +847,54 @@ static bool gpsNewFrameNMEA(char c)
             //          case 1:             // Time information
             //              break;
                         case 2:
-                            gps_Msg.latitude = GPS_coord_to_degrees(string);
+                            gps_Msg.latitude = nmeaFieldCoordinate(&field);
                             break;
                         case 3:
-                            if (string[0] == 'S')
+                            if (field.firstChar == 'S')
                                 gps_Msg.latitude *= -1;
                             break;
                         case 4:
-                            gps_Msg.longitude = GPS_coord_to_degrees(string);
+                            gps_Msg.longitude = nmeaFieldCoordinate(&field);
                             break;
                         case 5:
-                            if (string[0] == 'W')
+                            if (field.firstChar == 'W')
                                 gps_Msg.longitude *= -1;
                             break;
                         case 6:
-                            if (string[0] > '0') {
-                                ENABLE_STATE(GPS_FIX);
-                            } else {
-                                DISABLE_STATE(GPS_FIX);
-                            }
+                            gps_Msg.fix = field.firstChar > '0';
                             break;
                         case 7:
-                            gps_Msg.numSat = grab_fields(string, 0);
+                            gps_Msg.numSat = nmeaFieldScaled(&field, 0);
                             break;
                         case 8:
-                            gps_Msg.hdop = grab_fields(string, 1) * 100;          // hdop
+                            gps_Msg.hdop = nmeaFieldScaled(&field, 2);          // hdop * 100
                             break;
                         case 9:
-                            gps_Msg.altitude = grab_fields(string, 1) * 10;     // altitude in centimeters. Note: NMEA delivers altitude with 1 or 3 decimals. It's safer to cut at 0.1m and multiply by 10
+                            gps_Msg.altitude = nmeaFieldSigned(&field, 2);      // altitude in centimeters
                             break;
                     }
                     break;
                 case FRAME_RMC:        //************* GPRMC FRAME parsing
                     switch (param) {
                         case 1:
-                            gps_Msg.time = grab_fields(string, 2); // UTC time hhmmss.ss
+                            gps_Msg.time = nmeaFieldScaled(&field, 2); // UTC time hhmmss.ss
                             break;
                         case 7:
-                            gps_Msg.speed = ((grab_fields(string, 1) * 5144L) / 1000L);    // speed in cm/s added by Mis
+                            gps_Msg.speed = (nmeaFieldScaled(&field, 2) * 5144L) / 10000L;    // knots * 100 to cm/s
                             break;
                         case 8:
-                            gps_Msg.ground_course = (grab_fields(string, 1));      // ground course deg * 10
+                            gps_Msg.ground_course = nmeaFieldScaled(&field, 1);      // ground course deg * 10
                             break;
                         case 9:
-                            gps_Msg.date = grab_fields(string, 0); // date dd/mm/yy
+                            gps_Msg.date = nmeaFieldScaled(&field, 0); // date dd/mm/yy
                             break;
                     }
                     break;
+                case FRAME_GSA:
+                    if (param == 16 && field.length) {
+                        gps_Msg.hdop = nmeaFieldScaled(&field, 2);
+                    }
+                    break;
                 case FRAME_GSV:
                     switch (param) {
                       /*case 1:
@@ -771,72 +902,78 @@ static bool gpsNewFrameNMEA(char c)
                             break; */
                         case 2:
                             // Message number
-                            svMessageNum = grab_fields(string, 0);
+                            svMessageNum = nmeaFieldScaled(&field, 0);
+                            if (svMessageNum == 1 && (talker == svCycleTalker || !svCycleTalker)) {
+                                svCycleTalker = talker;
+                                svSlotCount = 0;
+                            }
                             break;
-                        case 3:
+                      /*case 3:
                             // Total number of SVs visible
-                            GPS_numCh = grab_fields(string, 0);
-                            break;
+                            break; */
                     }
                     if (param < 4)
                         break;
 
-                    svPacketIdx = (param - 4) / 4 + 1; // satellite number in packet, 1-4
-                    svSatNum    = svPacketIdx + (4 * (svMessageNum - 1)); // global satellite number
-                    svSatParam  = param - 3 - (4 * (svPacketIdx - 1)); // parameter number for satellite
-
-                    if (svSatNum > GPS_SV_MAXSATS)
-                        break;
-
-                    switch (svSatParam) {
-                        case 1:
-                            // SV PRN number
-                            GPS_svinfo_chn[svSatNum - 1]  = svSatNum;
-                            GPS_svinfo_svid[svSatNum - 1] = grab_fields(string, 0);
+                    switch ((param - 4) % 4) {
+                        case 0:
+                            // SV PRN number, NMEA 4.10 appends a signal id that is followed by '*'
+                            svSlot = -1;
+                            if (c == ',' && field.length && svSlotCount < GPS_SV_MAXSATS) {
+                                svSlot = svSlotCount++;
+                                GPS_svinfo_chn[svSlot] = svSlot + 1;
+                                GPS_svinfo_svid[svSlot] = nmeaFieldScaled(&field, 0);
+                                GPS_svinfo_cno[svSlot] = 0;
+                                GPS_svinfo_quality[svSlot] = 0; // only used by ublox
+                                GPS_numCh = svSlotCount;
+                            }
                             break;
-                      /*case 2:
+                      /*case 1:
                             // Elevation, in degrees, 90 maximum
                             break;
-                        case 3:
+                        case 2:
                             // Azimuth, degrees from True North, 000 through 359
                             break; */
-                        case 4:
+                        case 3:
                             // SNR, 00 through 99 dB (null when not tracking)
-                            GPS_svinfo_cno[svSatNum - 1] = grab_fields(string, 0);
-                            GPS_svinfo_quality[svSatNum - 1] = 0; // only used by ublox
+                            if (svSlot >= 0) {
+                                GPS_svinfo_cno[svSlot] = nmeaFieldScaled(&field, 0);
+                            }
                             break;
                     }
-
-                    GPS_svInfoReceivedCount++;
-
                     break;
             }
 
             param++;
-            offset = 0;
-            if (c == '*')
+            nmeaFieldReset(&field);
+            if (c == '*') {
                 checksum_param = 1;
-            else
+                checksum = 0;
+                checksumDigits = 0;
+            } else {
                 parity ^= c;
+            }
             break;
         case '\r':
         case '\n':
             if (checksum_param) {   //parity checksum
                 shiftPacketLog();
-                uint8_t checksum = 16 * ((string[0] >= 'A') ? string[0] - 'A' + 10 : string[0] - '0') + ((string[1] >= 'A') ? string[1] - 'A' + 10 : string[1] - '0');
-                if (checksum == parity) {
+                if (checksumDigits == 2 && checksum == parity) {
                     *gpsPacketLogChar = LOG_IGNORED;
                     GPS_packetCount++;
                     switch (gps_frame) {
                     case FRAME_GGA:
                       *gpsPacketLogChar = LOG_NMEA_GGA;
                       frameOK = 1;
-                      if (STATE(GPS_FIX)) {
+                      if (gps_Msg.fix) {
+                            ENABLE_STATE(GPS_FIX);
                             gpsSol.llh.lat = gps_Msg.latitude;
                             gpsSol.llh.lon = gps_Msg.longitude;
                             gpsSol.numSat = gps_Msg.numSat;
                             gpsSol.llh.alt = gps_Msg.altitude;
                             gpsSol.hdop = gps_Msg.hdop;
+                        } else {
+                            DISABLE_STATE(GPS_FIX);
                         }
                         break;
                     case FRAME_RMC:
@@ -853,11 +990,21 @@ static bool gpsNewFrameNMEA(char c)
                             temp_time.hours = (gps_Msg.time / 1000000) % 100;
                             temp_time.minutes = (gps_Msg.time / 10000) % 100;
                             temp_time.seconds = (gps_Msg.time / 100) % 100;
-                            temp_time.millis = (gps_Msg.time & 100) * 10;
+                            temp_time.millis = (gps_Msg.time % 100) * 10;
                             rtcSetDateTime(&temp_time);
                         }
 #endif
                         break;
+                    case FRAME_GSA:
+                        *gpsPacketLogChar = LOG_NMEA_GSA;
+                        if (STATE(GPS_FIX)) {
+                            gpsSol.hdop = gps_Msg.hdop;
+                        }
+                        break;
+                    case FRAME_GSV:
+                        *gpsPacketLogChar = LOG_NMEA_GSV;
+                        GPS_svInfoReceivedCount++;
+                        break;
                     } // end switch
                 } else {
                     *gpsPacketLogChar = LOG_ERROR;
@@ -866,10 +1013,20 @@ static bool gpsNewFrameNMEA(char c)
             checksum_param = 0;
             break;
         default:
-            if (offset < 15)
-                string[offset++] = c;
-            if (!checksum_param)
-                parity ^= c;
+            if (checksum_param) {
+                checksum = (checksum << 4) | nmeaHexValue(c);
+                checksumDigits++;
+                break;
+            }
+            parity ^= c;
+            if (param == 0 && field.length < 5) {
+                if (field.length < 2) {
+                    talker = (talker << 8) | (uint8_t)c;
+                } else {
+                    sentenceType = (sentenceType << 8) | (uint8_t)c;
+                }
+            }
+            nmeaFieldAddChar(&field, c);
     }
     return frameOK;
 }
@@ -956,6 +1113,45 @@ typedef struct {
     ubx_nav_svinfo_channel channel[16];         // 16 satellites * 12 byte
 } ubx_nav_svinfo;
 
+typedef struct {
+    uint32_t time;              // GPS msToW
+    uint16_t year;              // UTC
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t valid;
+    uint32_t time_accuracy;
+    int32_t nano;
+    uint8_t fix_type;
+    uint8_t fix_status;
+    uint8_t flags2;
+    uint8_t satellites;
+    int32_t longitude;
+    int32_t latitude;
+    int32_t altitude_ellipsoid;
+    int32_t altitude_msl;
+    uint32_t horizontal_accuracy;
+    uint32_t vertical_accuracy;
+    int32_t ned_north;
+    int32_t ned_east;
+    int32_t ned_down;
+    int32_t speed_2d;           // mm/s
+    int32_t heading_2d;         // heading of motion, deg * 100000
+    uint32_t speed_accuracy;
+    uint32_t heading_accuracy;
+    uint16_t position_DOP;
+    uint8_t flags3;
+    uint8_t reserved[5];
+    int32_t heading_vehicle;    // u-blox 8 and later
+    int16_t magnetic_declination;
+    uint16_t magnetic_declination_accuracy;
+} ubx_nav_pvt;
+
+// u-blox 7 sends NAV-PVT without the trailing heading_vehicle and magnetic declination fields
+#define UBLOX_NAV_PVT_MIN_LENGTH 84
+
 enum {
     PREAMBLE1 = 0xb5,
     PREAMBLE2 = 0x62,
@@ -967,6 +1163,7 @@ enum {
     MSG_POSLLH = 0x2,
     MSG_STATUS = 0x3,
     MSG_SOL = 0x6,
+    MSG_PVT = 0x7,
     MSG_VELNED = 0x12,
     MSG_SVINFO = 0x30,
     MSG_CFG_PRT = 0x00,
@@ -990,6 +1187,11 @@ enum {
     NAV_STATUS_TIME_SECOND_VALID = 8
 } ubx_nav_status_bits;
 
+enum {
+    NAV_PVT_VALID_DATE = 1,
+    NAV_PVT_VALID_TIME = 2
+} ubx_nav_pvt_valid_bits;
+
 // Packet checksum accumulators
 static uint8_t _ck_a;
 static uint8_t _ck_b;
@@ -1034,6 +1236,7 @@ static union {
     ubx_nav_solution solution;
     ubx_nav_velned velned;
     ubx_nav_svinfo svinfo;
+    ubx_nav_pvt pvt;
     uint8_t bytes[UBLOX_PAYLOAD_SIZE];
 } _buffer;
 
@@ -1109,6 +1312,43 @@ static bool UBLOX_parse_gps(void)
         }
         GPS_svInfoReceivedCount++;
         break;
+    case MSG_PVT:
+        if (_payload_length < UBLOX_NAV_PVT_MIN_LENGTH) {
+            return false;
+        }
+        *gpsPacketLogChar = LOG_UBLOX_PVT;
+        next_fix = (_buffer.pvt.fix_status & NAV_STATUS_FIX_VALID) && (_buffer.pvt.fix_type == FIX_3D);
+        if (next_fix) {
+            ENABLE_STATE(GPS_FIX);
+        } else {
+            DISABLE_STATE(GPS_FIX);
+        }
+        gpsSol.llh.lon = _buffer.pvt.longitude;
+        gpsSol.llh.lat = _buffer.pvt.latitude;
+        gpsSol.llh.alt = _buffer.pvt.altitude_msl / 10;  //alt in cm
+        gpsSol.numSat = _buffer.pvt.satellites;
+        gpsSol.hdop = _buffer.pvt.position_DOP;
+        gpsSol.groundSpeed = _buffer.pvt.speed_2d / 10;    // mm/s to cm/s
+        gpsSol.groundCourse = (uint16_t) (_buffer.pvt.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+#ifdef USE_RTC_TIME
+        //set clock, when gps time is available
+        if (!rtcHasTime() && (_buffer.pvt.valid & NAV_PVT_VALID_DATE) && (_buffer.pvt.valid & NAV_PVT_VALID_TIME)) {
+            dateTime_t dt = {
+                .year = _buffer.pvt.year,
+                .month = _buffer.pvt.month,
+                .day = _buffer.pvt.day,
+                .hours = _buffer.pvt.hour,
+                .minutes = _buffer.pvt.min,
+                .seconds = _buffer.pvt.sec,
+                .millis = _buffer.pvt.nano > 0 ? _buffer.pvt.nano / 1000000 : 0,
+            };
+            rtcSetDateTime(&dt);
+        }
+#endif
+        // position and velocity come from the same navigation epoch
+        _new_position = true;
+        _new_speed = true;
+        break;
     default:
         return false;
     }
@@ -1159,7 +1399,8 @@ static bool gpsNewFrameUBLOX(uint8_t data)
             _step++;
             _ck_b += (_ck_a += data);       // checksum byte
             _payload_length += (uint16_t)(data << 8);
-            if (_payload_length > UBLOX_PAYLOAD_SIZE) {
+            // only NAV messages are parsed, everything else is just checksummed
+            if (_payload_length > UBLOX_PAYLOAD_SIZE || _class != CLASS_NAV) {
                 _skip_packet = true;
             }
             _payload_counter = 0;   // prepare to receive payload
@@ -1169,7 +1410,7 @@ static bool gpsNewFrameUBLOX(uint8_t data)
             break;
         case 6:
             _ck_b += (_ck_a += data);       // checksum byte
-            if (_payload_counter < UBLOX_PAYLOAD_SIZE) {
+            if (!_skip_packet) {
                 _buffer.bytes[_payload_counter] = data;
             }
             if (++_payload_counter >= _payload_length) {
@@ -1254,6 +1495,11 @@ void GPS_reset_home_position(void)
         GPS_calc_longitude_scaling(gpsSol.llh.lat); // need an initial value for distance and bearing calc
         // Set ground altitude
         ENABLE_STATE(GPS_FIX_HOME);
+#ifdef USE_POSITION_ESTIMATOR
+        // horizontal position is relative to home
+        positionEstimatorResetAxis(POSITION_NORTH);
+        positionEstimatorResetAxis(POSITION_EAST);
+#endif
     }
 }
 
@@ -1366,6 +1612,18 @@ void onGpsNewData(void)
     // calculate the current velocity based on gps coordinates continously to get a valid speed at the moment when we start navigating
     GPS_calc_velocity();
 
+#ifdef USE_POSITION_ESTIMATOR
+    if (STATE(GPS_FIX_HOME)) {
+        const float north = (gpsSol.llh.lat - GPS_home[LAT]) * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS;
+        const float east = (gpsSol.llh.lon - GPS_home[LON]) * GPS_scaleLonDown * DISTANCE_BETWEEN_TWO_LONGITUDE_POINTS_AT_EQUATOR_IN_HUNDREDS_OF_KILOMETERS;
+        const float course = DECIDEGREES_TO_RADIANS(gpsSol.groundCourse);
+        positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, north);
+        positionEstimatorUpdatePosition(POSITION_EAST, POSITION_SOURCE_GPS, east);
+        positionEstimatorUpdateVelocity(POSITION_NORTH, POSITION_SOURCE_GPS, gpsSol.groundSpeed * cos_approx(course));
+        positionEstimatorUpdateVelocity(POSITION_EAST, POSITION_SOURCE_GPS, gpsSol.groundSpeed * sin_approx(course));
+    }
+#endif
+
 #ifdef USE_GPS_RESCUE
     rescueNewGpsData();
 #endif
@@ -73,6 +73,8 @@ typedef struct gpsConfig_s {
     gpsAutoConfig_e autoConfig;
     gpsAutoBaud_e autoBaud;
     uint8_t gps_ublox_use_galileo;
+    uint8_t gps_ublox_use_pvt;      // replace POSLLH/STATUS/SOL/VELNED with NAV-PVT
+    uint8_t gps_update_rate_hz;
 } gpsConfig_t;
 
 PG_DECLARE(gpsConfig_t, gpsConfig);
@@ -100,6 +102,8 @@ typedef struct gpsSolutionData_s {
 typedef enum {
     GPS_MESSAGE_STATE_IDLE = 0,
     GPS_MESSAGE_STATE_INIT,
+    GPS_MESSAGE_STATE_MESSAGES,
+    GPS_MESSAGE_STATE_RATE,
     GPS_MESSAGE_STATE_SBAS,
     GPS_MESSAGE_STATE_GALILEO,
     GPS_MESSAGE_STATE_ENTRY_COUNT
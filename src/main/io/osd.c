@@ -54,6 +54,9 @@
 
 #include "config/feature.h"
 
+#ifdef USE_GYRO_IMUF9001
+#include "drivers/accgyro/accgyro_imuf9001_link.h"
+#endif
 #include "drivers/display.h"
 #include "drivers/flash.h"
 #include "drivers/max7456_symbols.h"
@@ -152,9 +155,34 @@ static escSensorData_t *escDataCombined;
 #endif
 
 #define AH_SYMBOL_COUNT 9
+#define AH_COLUMN_COUNT 9 // x = -4..4 around the element position
+#define AH_ROW_COUNT 10   // 82 sub-row steps of AH_SYMBOL_COUNT each
 #define AH_SIDEBAR_WIDTH_POS 7
 #define AH_SIDEBAR_HEIGHT_POS 3
 
+// Incremental drawing
+//
+// Every element remembers the cells it last put on screen, so a refresh only
+// rewrites elements whose text or position changed and blanks the cells an
+// element no longer covers, instead of clearing and redrawing everything.
+// The display port in turn only sends the spans that actually changed.
+
+typedef struct osdElementCache_s {
+    int8_t x;       // bounding box of the cells on screen, w == 0 when none
+    int8_t y;
+    uint8_t w;
+    uint8_t h;
+    bool stale;     // cells may have been overwritten, redraw even if unchanged
+    char text[OSD_ELEMENT_BUFFER_LENGTH]; // artificial horizon: one row step (+1) per column
+} osdElementCache_t;
+
+static osdElementCache_t osdElementCache[OSD_ITEM_COUNT];
+static uint8_t osdElementCacheClearCount;
+
+static uint32_t visitedBits[(OSD_ITEM_COUNT + 31)/32];
+#define SET_VISITED(item) (visitedBits[(item) / 32] |= (1 << ((item) % 32)))
+#define IS_VISITED(item) (visitedBits[(item) / 32] & (1 << ((item) % 32)))
+
 static const char compassBar[] = {
   SYM_HEADING_W,
   SYM_HEADING_LINE, SYM_HEADING_DIVIDED_LINE, SYM_HEADING_LINE,
@@ -203,7 +231,7 @@ static const uint8_t osdElementDisplayOrder[] = {
     OSD_ANTI_GRAVITY
 };
 
-PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 3);
+PG_REGISTER_WITH_RESET_FN(osdConfig_t, osdConfig, PG_OSD_CONFIG, 4);
 
 /**
  * Gets the correct altitude symbol for the current unit system
@@ -449,12 +477,187 @@ bool osdWarnGetState(uint8_t warningIndex)
     return osdConfig()->enabledWarnings & (1 << warningIndex);
 }
 
+static void osdResetElementCache(void)
+{
+    memset(osdElementCache, 0, sizeof(osdElementCache));
+    osdElementCacheClearCount = osdDisplayPort->clearCount;
+}
+
+// Cells inside the given box were written, or blanked. Elements still to be
+// drawn in this refresh that overlap them must be redrawn to stay on top; if
+// cells were blanked the elements already drawn underneath are repaired on
+// the next refresh.
+static void osdElementTouched(uint8_t item, int x, int y, int w, int h, bool blanked)
+{
+    for (unsigned i = 0; i < OSD_ITEM_COUNT; i++) {
+        osdElementCache_t *other = &osdElementCache[i];
+        if (i == item || !other->w || (!blanked && IS_VISITED(i))) {
+            continue;
+        }
+        if (x < other->x + other->w && other->x < x + w && y < other->y + other->h && other->y < y + h) {
+            other->stale = true;
+        }
+    }
+}
+
+static void osdWriteBlanks(uint8_t item, int x, int y, int count)
+{
+    char blanks[OSD_ELEMENT_BUFFER_LENGTH];
+
+    count = MIN(count, OSD_ELEMENT_BUFFER_LENGTH - 1);
+    memset(blanks, SYM_BLANK, count);
+    blanks[count] = '\0';
+    displayWrite(osdDisplayPort, x, y, blanks);
+    osdElementTouched(item, x, y, count, 1, true);
+}
+
+static void osdWriteHorizonSidebars(int x, int y, bool blank)
+{
+    const int8_t hudwidth = AH_SIDEBAR_WIDTH_POS;
+    const int8_t hudheight = AH_SIDEBAR_HEIGHT_POS;
+    for (int dy = -hudheight; dy <= hudheight; dy++) {
+        displayWriteChar(osdDisplayPort, x - hudwidth, y + dy, blank ? SYM_BLANK : SYM_AH_DECORATION);
+        displayWriteChar(osdDisplayPort, x + hudwidth, y + dy, blank ? SYM_BLANK : SYM_AH_DECORATION);
+    }
+
+    // AH level indicators
+    displayWriteChar(osdDisplayPort, x - hudwidth + 1, y, blank ? SYM_BLANK : SYM_AH_LEFT);
+    displayWriteChar(osdDisplayPort, x + hudwidth - 1, y, blank ? SYM_BLANK : SYM_AH_RIGHT);
+}
+
+static void osdEraseElement(uint8_t item)
+{
+    osdElementCache_t *cache = &osdElementCache[item];
+
+    if (!cache->w) {
+        return;
+    }
+
+    switch (item) {
+    case OSD_ARTIFICIAL_HORIZON:
+        for (int i = 0; i < AH_COLUMN_COUNT; i++) {
+            if (cache->text[i]) {
+                displayWriteChar(osdDisplayPort, cache->x + i, cache->y + (cache->text[i] - 1) / AH_SYMBOL_COUNT, SYM_BLANK);
+            }
+        }
+        osdElementTouched(item, cache->x, cache->y, cache->w, cache->h, true);
+        break;
+
+    case OSD_HORIZON_SIDEBARS:
+        osdWriteHorizonSidebars(cache->x + AH_SIDEBAR_WIDTH_POS, cache->y + AH_SIDEBAR_HEIGHT_POS, true);
+        osdElementTouched(item, cache->x, cache->y, cache->w, cache->h, true);
+        break;
+
+    default:
+        osdWriteBlanks(item, cache->x, cache->y, cache->w);
+        break;
+    }
+
+    memset(cache, 0, sizeof(*cache));
+}
+
+static void osdElementWrite(uint8_t item, uint8_t x, uint8_t y, const char *text)
+{
+    osdElementCache_t *cache = &osdElementCache[item];
+    const int len = strlen(text);
+
+    if (cache->w && (cache->x != x || cache->y != y)) {
+        osdEraseElement(item);
+    }
+
+    if (!cache->stale && cache->w == len && !strcmp(cache->text, text)) {
+        return;
+    }
+
+    if (cache->w > len) {
+        // new text is shorter, blank the tail of the old one
+        osdWriteBlanks(item, x + len, y, cache->w - len);
+    }
+
+    if (len) {
+        displayWrite(osdDisplayPort, x, y, text);
+        osdElementTouched(item, x, y, len, 1, false);
+    }
+
+    cache->x = x;
+    cache->y = y;
+    cache->w = len;
+    cache->h = 1;
+    cache->stale = false;
+    strcpy(cache->text, text);
+}
+
+// columns[i] is 0 when column i is off screen, otherwise its row step + 1
+static void osdDrawHorizon(uint8_t item, int x, int y, const char *columns)
+{
+    osdElementCache_t *cache = &osdElementCache[item];
+    const int left = x - AH_COLUMN_COUNT / 2;
+
+    if (cache->w && (cache->x != left || cache->y != y)) {
+        osdEraseElement(item);
+    }
+
+    const bool redraw = cache->stale || !cache->w;
+    for (int i = 0; i < AH_COLUMN_COUNT; i++) {
+        const char previous = cache->text[i];
+        if (!redraw && previous == columns[i]) {
+            continue;
+        }
+        if (previous && (!columns[i] || (previous - 1) / AH_SYMBOL_COUNT != (columns[i] - 1) / AH_SYMBOL_COUNT)) {
+            const int row = y + (previous - 1) / AH_SYMBOL_COUNT;
+            displayWriteChar(osdDisplayPort, left + i, row, SYM_BLANK);
+            osdElementTouched(item, left + i, row, 1, 1, true);
+        }
+        if (columns[i]) {
+            const int row = y + (columns[i] - 1) / AH_SYMBOL_COUNT;
+            displayWriteChar(osdDisplayPort, left + i, row, SYM_AH_BAR9_0 + ((columns[i] - 1) % AH_SYMBOL_COUNT));
+            osdElementTouched(item, left + i, row, 1, 1, false);
+        }
+    }
+
+    cache->x = left;
+    cache->y = y;
+    cache->w = AH_COLUMN_COUNT;
+    cache->h = AH_ROW_COUNT;
+    cache->stale = false;
+    memcpy(cache->text, columns, AH_COLUMN_COUNT);
+}
+
+static void osdDrawHorizonSidebars(uint8_t item, int x, int y)
+{
+    osdElementCache_t *cache = &osdElementCache[item];
+    const int left = x - AH_SIDEBAR_WIDTH_POS;
+    const int top = y - AH_SIDEBAR_HEIGHT_POS;
+
+    if (cache->w && (cache->x != left || cache->y != top)) {
+        osdEraseElement(item);
+    }
+
+    if (cache->w && !cache->stale) {
+        return;
+    }
+
+    osdWriteHorizonSidebars(x, y, false);
+
+    cache->x = left;
+    cache->y = top;
+    cache->w = 2 * AH_SIDEBAR_WIDTH_POS + 1;
+    cache->h = 2 * AH_SIDEBAR_HEIGHT_POS + 1;
+    cache->stale = false;
+    osdElementTouched(item, cache->x, cache->y, cache->w, cache->h, false);
+}
+
 static bool osdDrawSingleElement(uint8_t item)
 {
+    SET_VISITED(item);
+
     if (!VISIBLE(osdConfig()->item_pos[item]) || BLINK(item)) {
+        osdEraseElement(item);
         return false;
     }
 
+    imuRefreshEulerAngles();
+
     uint8_t elemPosX = OSD_X(osdConfig()->item_pos[item]);
     uint8_t elemPosY = OSD_Y(osdConfig()->item_pos[item]);
     char buff[OSD_ELEMENT_BUFFER_LENGTH] = "";
@@ -635,9 +838,6 @@ static bool osdDrawSingleElement(uint8_t item)
         }
 
     case OSD_CRAFT_NAME:
-        // This does not strictly support iterative updating if the craft name changes at run time. But since the craft name is not supposed to be changing this should not matter, and blanking the entire length of the craft name string on update will make it impossible to configure elements to be displayed on the right hand side of the craft name.
-        //TODO: When iterative updating is implemented, change this so the craft name is only printed once whenever the OSD 'flight' screen is entered.
-
         if (strlen(pilotConfig()->name) == 0) {
             strcpy(buff, "CRAFT_NAME");
         } else {
@@ -696,32 +896,20 @@ static bool osdDrawSingleElement(uint8_t item)
             }
             pitchAngle -= 41; // 41 = 4 * AH_SYMBOL_COUNT + 5
 
+            char columns[AH_COLUMN_COUNT];
             for (int x = -4; x <= 4; x++) {
                 const int y = ((-rollAngle * x) / 64) - pitchAngle;
-                if (y >= 0 && y <= 81) {
-                    displayWriteChar(osdDisplayPort, elemPosX + x, elemPosY + (y / AH_SYMBOL_COUNT), (SYM_AH_BAR9_0 + (y % AH_SYMBOL_COUNT)));
-                }
+                columns[x + 4] = (y >= 0 && y <= 81) ? y + 1 : 0;
             }
+            osdDrawHorizon(item, elemPosX, elemPosY, columns);
 
             return true;
         }
 
     case OSD_HORIZON_SIDEBARS:
-        {
-            // Draw AH sides
-            const int8_t hudwidth = AH_SIDEBAR_WIDTH_POS;
-            const int8_t hudheight = AH_SIDEBAR_HEIGHT_POS;
-            for (int y = -hudheight; y <= hudheight; y++) {
-                displayWriteChar(osdDisplayPort, elemPosX - hudwidth, elemPosY + y, SYM_AH_DECORATION);
-                displayWriteChar(osdDisplayPort, elemPosX + hudwidth, elemPosY + y, SYM_AH_DECORATION);
-            }
+        osdDrawHorizonSidebars(item, elemPosX, elemPosY);
 
-            // AH level indicators
-            displayWriteChar(osdDisplayPort, elemPosX - hudwidth + 1, elemPosY, SYM_AH_LEFT);
-            displayWriteChar(osdDisplayPort, elemPosX + hudwidth - 1, elemPosY, SYM_AH_RIGHT);
-
-            return true;
-        }
+        return true;
 
     case OSD_G_FORCE:
         {
@@ -1023,24 +1211,24 @@ static bool osdDrawSingleElement(uint8_t item)
         break;
 #endif
 
+#ifdef USE_GYRO_IMUF9001
+    case OSD_IMUF_ERRORS:
+        // frames lost on the way from the IMU-F, to crc errors or late transfers
+        tfp_sprintf(buff, "IMUF %5u", MIN(imufLink.stats.crcErrors + imufLink.stats.overruns, 99999U));
+        break;
+#endif
+
     default:
         return false;
     }
 
-    displayWrite(osdDisplayPort, elemPosX, elemPosY, buff);
+    osdElementWrite(item, elemPosX, elemPosY, buff);
 
     return true;
 }
 
-static void osdDrawElements(void)
+static void osdDrawVisibleElements(void)
 {
-    displayClearScreen(osdDisplayPort);
-
-    // Hide OSD when OSDSW mode is active
-    if (IS_RC_MODE_ACTIVE(BOXOSD)) {
-        return;
-    }
-
     if (sensors(SENSOR_ACC)) {
         osdDrawSingleElement(OSD_ARTIFICIAL_HORIZON);
         osdDrawSingleElement(OSD_G_FORCE);
@@ -1080,6 +1268,33 @@ static void osdDrawElements(void)
 #ifdef USE_ADC_INTERNAL
     osdDrawSingleElement(OSD_CORE_TEMPERATURE);
 #endif
+
+#ifdef USE_GYRO_IMUF9001
+    osdDrawSingleElement(OSD_IMUF_ERRORS);
+#endif
+}
+
+static void osdDrawElements(void)
+{
+    if (osdDisplayPort->clearCount != osdElementCacheClearCount) {
+        // the screen was cleared, or grabbed and handed back with the CMS menu still on it;
+        // clear it so that none of our cells, or anyone else's, are left
+        displayClearScreen(osdDisplayPort);
+        osdResetElementCache();
+    }
+    memset(visitedBits, 0, sizeof(visitedBits));
+
+    // Hide OSD when OSDSW mode is active
+    if (!IS_RC_MODE_ACTIVE(BOXOSD)) {
+        osdDrawVisibleElements();
+    }
+
+    // Blank whatever was drawn last time but not this time
+    for (unsigned i = 0; i < OSD_ITEM_COUNT; i++) {
+        if (!IS_VISITED(i)) {
+            osdEraseElement(i);
+        }
+    }
 }
 
 void pgResetFn_osdConfig(osdConfig_t *osdConfig)
@@ -96,6 +96,7 @@ typedef enum {
     OSD_CORE_TEMPERATURE,
     OSD_ANTI_GRAVITY,
     OSD_G_FORCE,
+    OSD_IMUF_ERRORS,
     OSD_ITEM_COUNT // MUST BE LAST
 } osd_items_e;
 
@@ -62,8 +62,11 @@ STATIC_UNIT_TESTED uint32_t crsfChannelData[CRSF_MAX_CHANNEL];
 
 static serialPort_t *serialPort;
 static uint32_t crsfFrameStartAtUs = 0;
+static timeUs_t crsfFrameDoneAtUs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 static uint8_t telemetryBuf[CRSF_FRAME_SIZE_MAX];
 static uint8_t telemetryBufLen = 0;
+static volatile uint8_t linkFrameCount = 0;
 
 /*
  * CRSF protocol
@@ -124,13 +127,9 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCRC(void)
     return crc;
 }
 
-// Receive ISR callback, called back from serial port
-STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
+static void crsfDataReceiveByte(uint8_t c, uint32_t currentTimeUs)
 {
-    UNUSED(data);
-
     static uint8_t crsfFramePosition = 0;
-    const uint32_t currentTimeUs = micros();
 
 #ifdef DEBUG_CRSF_PACKETS
     debug[2] = currentTimeUs - crsfFrameStartAtUs;
@@ -150,10 +149,12 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     const int fullFrameLength = crsfFramePosition < 3 ? 5 : crsfFrame.frame.frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH;
 
     if (crsfFramePosition < fullFrameLength) {
-        crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
+        crsfFrame.bytes[crsfFramePosition++] = c;
         crsfFrameDone = crsfFramePosition < fullFrameLength ? false : true;
         if (crsfFrameDone) {
             crsfFramePosition = 0;
+            crsfFrameDoneAtUs = currentTimeUs;
+            linkFrameCount++;
             if (crsfFrame.frame.type != CRSF_FRAMETYPE_RC_CHANNELS_PACKED) {
                 const uint8_t crc = crsfFrameCRC();
                 if (crc == crsfFrame.bytes[fullFrameLength - 1]) {
@@ -188,6 +189,25 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     }
 }
 
+// Receive ISR callback, called back from serial port
+STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    crsfDataReceiveByte(c, micros());
+}
+
+// Receive DMA idle line callback, called back from serial port with all bytes received since the line went idle
+STATIC_UNIT_TESTED void crsfFrameReceive(const uint8_t *data, uint16_t length, void *callbackData)
+{
+    UNUSED(callbackData);
+
+    const uint32_t currentTimeUs = micros();
+    for (int ii = 0; ii < length; ++ii) {
+        crsfDataReceiveByte(data[ii], currentTimeUs);
+    }
+}
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     UNUSED(rxRuntimeConfig);
@@ -200,6 +220,7 @@ STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
             if (crc != crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]) {
                 return RX_FRAME_PENDING;
             }
+            lastRcFrameTimeUs = crsfFrameDoneAtUs;
             // unpack the RC channels
             const crsfPayloadRcChannelsPacked_t* const rcChannels = (crsfPayloadRcChannelsPacked_t*)&crsfFrame.frame.payload;
             crsfChannelData[0] = rcChannels->chan0;
@@ -224,6 +245,11 @@ STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
     return RX_FRAME_PENDING;
 }
 
+STATIC_UNIT_TESTED timeUs_t crsfFrameTimeUs(void)
+{
+    return lastRcFrameTimeUs;
+}
+
 STATIC_UNIT_TESTED uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan)
 {
     UNUSED(rxRuntimeConfig);
@@ -254,6 +280,12 @@ void crsfRxSendTelemetryData(void)
     }
 }
 
+// Every frame from the master opens one slot for a reply, counting them measures the telemetry rate of the link
+uint8_t crsfRxLinkFrameCount(void)
+{
+    return linkFrameCount;
+}
+
 bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
 {
     for (int ii = 0; ii < CRSF_MAX_CHANNEL; ++ii) {
@@ -265,6 +297,7 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
 
     rxRuntimeConfig->rcReadRawFn = crsfReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = crsfFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = crsfFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -280,6 +313,10 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
 
+    if (serialPort) {
+        serialSetRxFrameCb(serialPort, crsfFrameReceive);
+    }
+
     return serialPort != NULL;
 }
 
@@ -42,6 +42,7 @@ typedef union crsfFrame_u {
 
 void crsfRxWriteTelemetryData(const void *data, int len);
 void crsfRxSendTelemetryData(void);
+uint8_t crsfRxLinkFrameCount(void);
 
 struct rxConfig_s;
 struct rxRuntimeConfig_s;
@@ -130,6 +130,7 @@ static const smartPortPayload_t emptySmartPortFrame = { .frameId = 0, .valueId =
 typedef struct fportBuffer_s {
     uint8_t data[BUFFER_SIZE];
     uint8_t length;
+    timeUs_t frameTimeUs;
 } fportBuffer_t;
 
 static fportBuffer_t rxBuffer[NUM_RX_BUFFERS];
@@ -144,6 +145,7 @@ static volatile uint8_t framePosition = 0;
 
 static smartPortPayload_t *mspPayload = NULL;
 static timeUs_t lastRcFrameReceivedMs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 
 static serialPort_t *fportPort;
 #ifdef USE_TELEMETRY_SMARTPORT
@@ -159,33 +161,25 @@ static void reportFrameError(uint8_t errorReason) {
     DEBUG_SET(DEBUG_FPORT, DEBUG_FPORT_FRAME_LAST_ERROR, errorReason);
 }
 
-// Receive ISR callback
-static void fportDataReceive(uint16_t c, void *data)
+static void fportDataReceiveByte(uint8_t val, timeUs_t currentTimeUs)
 {
-    UNUSED(data);
-
     static timeUs_t frameStartAt = 0;
     static bool escapedCharacter = false;
     static timeUs_t lastFrameReceivedUs = 0;
     static bool telemetryFrame = false;
 
-    const timeUs_t currentTimeUs = micros();
-
-    clearToSend = false;
-
     if (framePosition > 1 && cmpTimeUs(currentTimeUs, frameStartAt) > FPORT_TIME_NEEDED_PER_FRAME_US + 500) {
         reportFrameError(DEBUG_FPORT_ERROR_TIMEOUT);
 
         framePosition = 0;
      }
 
-    uint8_t val = (uint8_t)c;
-
     if (val == FPORT_FRAME_MARKER) {
         if (framePosition > 1) {
             const uint8_t nextWriteIndex = (rxBufferWriteIndex + 1) % NUM_RX_BUFFERS;
             if (nextWriteIndex != rxBufferReadIndex) {
                 rxBuffer[rxBufferWriteIndex].length = framePosition - 1;
+                rxBuffer[rxBufferWriteIndex].frameTimeUs = currentTimeUs;
                 rxBufferWriteIndex = nextWriteIndex;
             }
 
@@ -228,6 +222,30 @@ static void fportDataReceive(uint16_t c, void *data)
     }
 }
 
+// Receive ISR callback
+static void fportDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    clearToSend = false;
+
+    fportDataReceiveByte(c, micros());
+}
+
+// Receive DMA idle line callback
+static void fportFrameReceive(const uint8_t *data, uint16_t length, void *callbackData)
+{
+    UNUSED(callbackData);
+
+    const timeUs_t currentTimeUs = micros();
+
+    clearToSend = false;
+
+    for (int i = 0; i < length; i++) {
+        fportDataReceiveByte(data[i], currentTimeUs);
+    }
+}
+
 #if defined(USE_TELEMETRY_SMARTPORT)
 static void smartPortWriteFrameFport(const smartPortPayload_t *payload)
 {
@@ -252,6 +270,11 @@ static bool checkChecksum(uint8_t *data, uint8_t length)
     return checksum == FPORT_CRC_VALUE;
 }
 
+static timeUs_t fportFrameTimeUs(void)
+{
+    return lastRcFrameTimeUs;
+}
+
 static uint8_t fportFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
 #ifdef USE_TELEMETRY_SMARTPORT
@@ -285,6 +308,7 @@ static uint8_t fportFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
                         setRssi(scaleRange(frame->data.controlData.rssi, 0, 100, 0, RSSI_MAX_VALUE), RSSI_SOURCE_RX_PROTOCOL);
 
                         lastRcFrameReceivedMs = millis();
+                        lastRcFrameTimeUs = rxBuffer[rxBufferReadIndex].frameTimeUs;
                     }
 
                     break;
@@ -399,6 +423,7 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     rxRuntimeConfig->rxRefreshRate = 11000;
 
     rxRuntimeConfig->rcFrameStatusFn = fportFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = fportFrameTimeUs;
     rxRuntimeConfig->rcProcessFrameFn = fportProcessFrame;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
@@ -416,6 +441,8 @@ bool fportRxInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     );
 
     if (fportPort) {
+        serialSetRxFrameCb(fportPort, fportFrameReceive);
+
 #if defined(USE_TELEMETRY_SMARTPORT)
         telemetryEnabled = initSmartPortTelemetryExternal(smartPortWriteFrameFport);
 #endif
@@ -70,6 +70,8 @@ static uint8_t rxBytesToIgnore;
 static uint16_t ibusChecksum;
 
 static bool ibusFrameDone = false;
+static timeUs_t ibusFrameDoneAtUs = 0;
+static timeUs_t lastRcFrameTimeUs = 0;
 static uint32_t ibusChannelData[IBUS_MAX_CHANNEL];
 
 static uint8_t ibus[IBUS_BUFFSIZE] = { 0, };
@@ -81,17 +83,11 @@ static bool isValidIa6bIbusPacketLength(uint8_t length)
 }
 
 
-// Receive ISR callback
-static void ibusDataReceive(uint16_t c, void *data)
+static void ibusDataReceiveByte(uint8_t c, uint32_t ibusTime)
 {
-    UNUSED(data);
-
-    uint32_t ibusTime;
     static uint32_t ibusTimeLast;
     static uint8_t ibusFramePosition;
 
-    ibusTime = micros();
-
     if ((ibusTime - ibusTimeLast) > IBUS_FRAME_GAP) {
         ibusFramePosition = 0;
         rxBytesToIgnore = 0;
@@ -120,15 +116,34 @@ static void ibusDataReceive(uint16_t c, void *data)
         }
     }
 
-    ibus[ibusFramePosition] = (uint8_t)c;
+    ibus[ibusFramePosition] = c;
 
     if (ibusFramePosition == ibusFrameSize - 1) {
         ibusFrameDone = true;
+        ibusFrameDoneAtUs = ibusTime;
     } else {
         ibusFramePosition++;
     }
 }
 
+// Receive ISR callback
+static void ibusDataReceive(uint16_t c, void *data)
+{
+    UNUSED(data);
+
+    ibusDataReceiveByte(c, micros());
+}
+
+// Receive DMA idle line callback
+static void ibusFrameReceive(const uint8_t *data, uint16_t length, void *callbackData)
+{
+    UNUSED(callbackData);
+
+    const uint32_t ibusTime = micros();
+    for (int i = 0; i < length; i++) {
+        ibusDataReceiveByte(data[i], ibusTime);
+    }
+}
 
 static bool isChecksumOkIa6(void)
 {
@@ -177,6 +192,7 @@ static uint8_t ibusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
     if (checksumIsOk()) {
         if (ibusModel == IBUS_MODEL_IA6 || ibusSyncByte == 0x20) {
             updateChannelData();
+            lastRcFrameTimeUs = ibusFrameDoneAtUs;
             frameStatus = RX_FRAME_COMPLETE;
         }
         else
@@ -191,6 +207,11 @@ static uint8_t ibusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 }
 
 
+static timeUs_t ibusFrameTimeUs(void)
+{
+    return lastRcFrameTimeUs;
+}
+
 static uint16_t ibusReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan)
 {
     UNUSED(rxRuntimeConfig);
@@ -208,6 +229,7 @@ bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
 
     rxRuntimeConfig->rcReadRawFn = ibusReadRawRC;
     rxRuntimeConfig->rcFrameStatusFn = ibusFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = ibusFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -232,6 +254,10 @@ bool ibusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0) | (rxConfig->halfDuplex || portShared ? SERIAL_BIDIR : 0)
         );
 
+    if (ibusPort) {
+        serialSetRxFrameCb(ibusPort, ibusFrameReceive);
+    }
+
 #if defined(USE_TELEMETRY) && defined(USE_TELEMETRY_IBUS)
     if (portShared) {
         initSharedIbusTelemetry(ibusPort);
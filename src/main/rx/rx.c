@@ -94,6 +94,9 @@ static uint32_t needRxSignalMaxDelayUs;
 static uint32_t suspendRxSignalUntil = 0;
 static uint8_t  skipRxSamples = 0;
 
+static timeUs_t lastRxFrameTimeUs = 0;
+static timeDelta_t rxFrameDeltaUs = 0;
+
 static int16_t rcRaw[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];     // interval [1000;2000]
 uint32_t rcInvalidPulsPeriod[MAX_SUPPORTED_RC_CHANNEL_COUNT];
@@ -240,6 +243,7 @@ void rxInit(void)
     rxRuntimeConfig.rcReadRawFn = nullReadRawRC;
     rxRuntimeConfig.rcFrameStatusFn = nullFrameStatus;
     rxRuntimeConfig.rcProcessFrameFn = nullProcessFrame;
+    rxRuntimeConfig.rcFrameTimeUsFn = NULL;
     rcSampleIndex = 0;
     needRxSignalMaxDelayUs = DELAY_10_HZ;
 
@@ -274,6 +278,7 @@ void rxInit(void)
             featureClear(FEATURE_RX_SERIAL);
             rxRuntimeConfig.rcReadRawFn = nullReadRawRC;
             rxRuntimeConfig.rcFrameStatusFn = nullFrameStatus;
+            rxRuntimeConfig.rcFrameTimeUsFn = NULL;
         }
     }
 #endif
@@ -292,6 +297,7 @@ void rxInit(void)
             featureClear(FEATURE_RX_SPI);
             rxRuntimeConfig.rcReadRawFn = nullReadRawRC;
             rxRuntimeConfig.rcFrameStatusFn = nullFrameStatus;
+            rxRuntimeConfig.rcFrameTimeUsFn = NULL;
         }
     }
 #endif
@@ -346,6 +352,19 @@ void resumeRxPwmPpmSignal(void)
 #endif
 }
 
+// Record the arrival time of a validated frame. Receivers that timestamp frames in their
+// serial receive callback report the time the frame came off the wire, so the interval
+// between frames excludes the latency of the task that polled them.
+static void rxUpdateFrameTime(timeUs_t currentTimeUs)
+{
+    const timeUs_t frameTimeUs = rxRuntimeConfig.rcFrameTimeUsFn ? rxRuntimeConfig.rcFrameTimeUsFn() : currentTimeUs;
+
+    if (lastRxFrameTimeUs) {
+        rxFrameDeltaUs = cmpTimeUs(frameTimeUs, lastRxFrameTimeUs);
+    }
+    lastRxFrameTimeUs = frameTimeUs;
+}
+
 bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
 {
     UNUSED(currentDeltaTime);
@@ -396,6 +415,9 @@ bool rxUpdateCheck(timeUs_t currentTimeUs, timeDelta_t currentDeltaTime)
 
     if (signalReceived) {
         rxSignalReceived = true;
+        if (useDataDrivenProcessing) {
+            rxUpdateFrameTime(currentTimeUs);
+        }
     } else if (currentTimeUs >= needRxSignalBefore) {
         rxSignalReceived = false;
     }
@@ -701,6 +723,16 @@ uint16_t rxGetRefreshRate(void)
     return rxRuntimeConfig.rxRefreshRate;
 }
 
+// Returns the interval between the last two validated frames and optionally the time
+// elapsed since the last one arrived, or 0 if fewer than two frames have been received.
+timeDelta_t rxGetFrameDelta(timeDelta_t *frameAgeUs)
+{
+    if (frameAgeUs) {
+        *frameAgeUs = lastRxFrameTimeUs ? cmpTimeUs(micros(), lastRxFrameTimeUs) : 0;
+    }
+    return rxFrameDeltaUs;
+}
+
 bool isRssiConfigured(void)
 {
     return rssiSource != RSSI_SOURCE_NONE;
@@ -102,19 +102,15 @@ typedef union sbusFrame_u {
 typedef struct sbusFrameData_s {
     sbusFrame_t frame;
     uint32_t startAtUs;
+    timeUs_t doneAtUs;
     uint16_t stateFlags;
     uint8_t position;
     bool done;
 } sbusFrameData_t;
 
 
-// Receive ISR callback
-static void sbusDataReceive(uint16_t c, void *data)
+static void sbusDataReceiveByte(sbusFrameData_t *sbusFrameData, uint8_t c, uint32_t nowUs)
 {
-    sbusFrameData_t *sbusFrameData = data;
-
-    const uint32_t nowUs = micros();
-
     const int32_t sbusFrameTime = nowUs - sbusFrameData->startAtUs;
 
     if (sbusFrameTime > (long)(SBUS_TIME_NEEDED_PER_FRAME + 500)) {
@@ -129,16 +125,39 @@ static void sbusDataReceive(uint16_t c, void *data)
     }
 
     if (sbusFrameData->position < SBUS_FRAME_SIZE) {
-        sbusFrameData->frame.bytes[sbusFrameData->position++] = (uint8_t)c;
+        sbusFrameData->frame.bytes[sbusFrameData->position++] = c;
         if (sbusFrameData->position < SBUS_FRAME_SIZE) {
             sbusFrameData->done = false;
         } else {
             sbusFrameData->done = true;
+            sbusFrameData->doneAtUs = nowUs;
             DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_FRAME_TIME, sbusFrameTime);
         }
     }
 }
 
+// Receive ISR callback
+static void sbusDataReceive(uint16_t c, void *data)
+{
+    sbusDataReceiveByte(data, c, micros());
+}
+
+// Receive DMA idle line callback
+static void sbusFrameReceive(const uint8_t *data, uint16_t length, void *callbackData)
+{
+    const uint32_t nowUs = micros();
+    for (int i = 0; i < length; i++) {
+        sbusDataReceiveByte(callbackData, data[i], nowUs);
+    }
+}
+
+static timeUs_t lastRcFrameTimeUs = 0;
+
+static timeUs_t sbusFrameTimeUs(void)
+{
+    return lastRcFrameTimeUs;
+}
+
 static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 {
     sbusFrameData_t *sbusFrameData = rxRuntimeConfig->frameData;
@@ -160,6 +179,8 @@ static uint8_t sbusFrameStatus(rxRuntimeConfig_t *rxRuntimeConfig)
 
     DEBUG_SET(DEBUG_SBUS, DEBUG_SBUS_STATE_FLAGS, sbusFrameData->stateFlags);
 
+    lastRcFrameTimeUs = sbusFrameData->doneAtUs;
+
     return sbusChannelsDecode(rxRuntimeConfig, &sbusFrameData->frame.frame.channels);
 }
 
@@ -176,6 +197,7 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
     rxRuntimeConfig->rxRefreshRate = 11000;
 
     rxRuntimeConfig->rcFrameStatusFn = sbusFrameStatus;
+    rxRuntimeConfig->rcFrameTimeUsFn = sbusFrameTimeUs;
 
     const serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_RX_SERIAL);
     if (!portConfig) {
@@ -197,6 +219,10 @@ bool sbusInit(const rxConfig_t *rxConfig, rxRuntimeConfig_t *rxRuntimeConfig)
         SBUS_PORT_OPTIONS | (rxConfig->serialrx_inverted ? 0 : SERIAL_INVERTED) | (rxConfig->halfDuplex ? SERIAL_BIDIR : 0)
         );
 
+    if (sBusPort) {
+        serialSetRxFrameCb(sBusPort, sbusFrameReceive);
+    }
+
     if (rxConfig->rssi_src_frame_errors) {
         rssiSource = RSSI_SOURCE_FRAME_ERRORS;
     }
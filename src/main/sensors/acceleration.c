@@ -38,6 +38,7 @@
 
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/accgyro/accgyro_fake.h"
+#include "drivers/accgyro/accgyro_fifo.h"
 #include "drivers/accgyro/accgyro_mpu.h"
 #include "drivers/accgyro/accgyro_mpu3050.h"
 #include "drivers/accgyro/accgyro_mpu6050.h"
@@ -374,6 +375,22 @@ bool accInit(void)
     }
     acc.dev.acc_1G = 256; // set default
     acc.dev.initFn(&acc.dev); // driver initialisation
+#ifdef USE_GYRO_FIFO
+    switch (detectedSensors[SENSOR_INDEX_ACC]) {
+    case ACC_MPU6000:
+    case ACC_ICM20602:
+    case ACC_ICM20689:
+    case ACC_BMI160:
+        if (gyroSensorFifo()) {
+            // the acc samples come with the gyro burst reads instead of reads of their own
+            gyroFifoAttachAcc(gyroSensorFifo());
+            acc.dev.readFn = gyroFifoAccRead;
+        }
+        break;
+    default:
+        break;
+    }
+#endif
     // set the acc sampling interval according to the gyro sampling interval
     if (accLpfCutHz)
     {
@@ -145,6 +145,7 @@ static int32_t baroTemperature = 0;
 static int32_t baroGroundAltitude = 0;
 static int32_t baroGroundPressure = 8*101325;
 static uint32_t baroPressureSum = 0;
+static uint16_t baroSampleCount = 0;          // pressure samples taken, wraps
 
 bool baroDetect(baroDev_t *dev, baroSensor_e baroHardwareToUse)
 {
@@ -343,12 +344,19 @@ uint32_t baroUpdate(void)
             baro.baroPressure = baroPressure;
             baro.baroTemperature = baroTemperature;
             baroPressureSum = recalculateBarometerTotal(barometerConfig()->baro_sample_count, baroPressureSum, baroPressure);
+            baroSampleCount++;
             state = BAROMETER_NEEDS_SAMPLES;
             return baro.dev.ut_delay;
         break;
     }
 }
 
+// changes whenever a new pressure sample has been taken
+uint16_t baroGetSampleCount(void)
+{
+    return baroSampleCount;
+}
+
 int32_t baroCalculateAltitude(void)
 {
     int32_t BaroAlt_tmp;
@@ -65,4 +65,5 @@ void baroSetCalibrationCycles(uint16_t calibrationCyclesRequired);
 uint32_t baroUpdate(void);
 bool isBaroReady(void);
 int32_t baroCalculateAltitude(void);
+uint16_t baroGetSampleCount(void);
 void performBaroCalibrationCycle(void);
@@ -201,6 +201,17 @@ static void escSensorDataReceive(uint16_t c, void *data)
     buffer[bufferPosition++] = (uint8_t)c;
 }
 
+// Receive DMA idle line callback
+static void escSensorFrameReceive(const uint8_t *data, uint16_t length, void *callbackData)
+{
+    UNUSED(callbackData);
+
+    const uint8_t count = MIN(length, bufferSize - bufferPosition);
+    for (int i = 0; i < count; i++) {
+        buffer[bufferPosition++] = data[i];
+    }
+}
+
 bool escSensorInit(void)
 {
     serialPortConfig_t *portConfig = findSerialPortConfig(FUNCTION_ESC_SENSOR);
@@ -212,6 +223,9 @@ bool escSensorInit(void)
 
     // Initialize serial port
     escSensorPort = openSerialPort(portConfig->identifier, FUNCTION_ESC_SENSOR, escSensorDataReceive, NULL, ESC_SENSOR_BAUDRATE, MODE_RX, options);
+    if (escSensorPort) {
+        serialSetRxFrameCb(escSensorPort, escSensorFrameReceive);
+    }
 
     for (int i = 0; i < MAX_SUPPORTED_MOTORS; i = i + 1) {
         escSensorData[i].dataAge = ESC_DATA_INVALID;
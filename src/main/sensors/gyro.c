@@ -39,6 +39,7 @@
 
 #include "drivers/accgyro/accgyro.h"
 #include "drivers/accgyro/accgyro_fake.h"
+#include "drivers/accgyro/accgyro_fifo.h"
 #include "drivers/accgyro/accgyro_mpu.h"
 #include "drivers/accgyro/accgyro_mpu3050.h"
 #include "drivers/accgyro/accgyro_mpu6050.h"
@@ -73,6 +74,7 @@
 
 #include "fc/config.h"
 #include "fc/runtime_config.h"
+#include "flight/rpm_filter.h"
 
 #include "io/beeper.h"
 #include "io/statusindicator.h"
@@ -81,6 +83,8 @@
 
 #include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
+#include "sensors/gyro_fusion.h"
+#include "sensors/gyro_jitter.h"
 #ifdef USE_GYRO_DATA_ANALYSE
 #include "sensors/gyroanalyse.h"
 #endif
@@ -123,6 +127,17 @@ float FAST_RAM_ZERO_INIT vGyroStdDevModulus;
 
 static FAST_RAM_ZERO_INIT int16_t gyroSensorTemperature;
 
+#ifdef USE_GYRO_JITTER_STATS
+static FAST_RAM_ZERO_INIT gyroJitterStats_t gyroJitter;
+#endif
+
+#ifdef USE_GYRO_FUSION
+// gyros that disagree by more than this are not both right
+#define GYRO_FUSION_OUTLIER_DPS 200.0f
+
+static FAST_RAM_ZERO_INIT gyroFusion_t gyroFusion;
+#endif
+
 static bool gyroHasOverflowProtection = true;
 
 typedef struct gyroCalibration_s {
@@ -142,6 +157,7 @@ typedef union gyroLowpassFilter_u {
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    timeUs_t sampleTimeUs;      // stamp of the sample being filtered, 0 without a data ready interrupt
 
     // lowpass gyro soft filter
     filterApplyFnPtr lowpassFilterApplyFn;
@@ -172,13 +188,32 @@ typedef struct gyroSensor_s {
 #ifdef USE_GYRO_DATA_ANALYSE
     gyroAnalyseState_t gyroAnalyseState;
 #endif
+
+#ifdef USE_GYRO_FIFO
+    bool fifoActive;
+    gyroFifo_t fifo;
+#endif
+#ifdef USE_RPM_FILTER
+    uint8_t rpmFilterBank;
+#endif
 } gyroSensor_t;
 
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor1;
+#ifdef USE_RPM_FILTER
+static FAST_RAM_ZERO_INIT bool rpmFilterActive;
+#endif
 #ifdef USE_DUAL_GYRO
 STATIC_UNIT_TESTED FAST_RAM_ZERO_INIT gyroSensor_t gyroSensor2;
 #endif
 
+#ifdef USE_DUAL_GYRO
+// both sensors are read when they are averaged or fused
+static bool gyroUsesBothSensors(void)
+{
+    return gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH || gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED;
+}
+#endif
+
 #ifdef UNIT_TEST
 STATIC_UNIT_TESTED gyroSensor_t * const gyroSensorPtr = &gyroSensor1;
 STATIC_UNIT_TESTED gyroDev_t * const gyroDevPtr = &gyroSensor1.gyroDev;
@@ -203,7 +238,7 @@ static void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int typ
 #define GYRO_OVERFLOW_TRIGGER_THRESHOLD 31980  // 97.5% full scale (1950dps for 2000dps gyro)
 #define GYRO_OVERFLOW_RESET_THRESHOLD 30340    // 92.5% full scale (1850dps for 2000dps gyro)
 
-PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 4);
+PG_REGISTER_WITH_RESET_TEMPLATE(gyroConfig_t, gyroConfig, PG_GYRO_CONFIG, 5);
 
 #ifndef GYRO_CONFIG_USE_GYRO_DEFAULT
 #define GYRO_CONFIG_USE_GYRO_DEFAULT GYRO_CONFIG_USE_GYRO_1
@@ -258,6 +293,7 @@ PG_RESET_TEMPLATE(gyroConfig_t, gyroConfig,
     .gyro_high_fsr = false,
     .gyro_use_32khz = false,
     .gyro_to_use = GYRO_CONFIG_USE_GYRO_DEFAULT,
+    .gyro_use_fifo = false,
     .gyro_soft_notch_hz_1 = 0,
     .gyro_soft_notch_cutoff_1 = 0,
     .gyro_soft_notch_hz_2 = 0,
@@ -287,6 +323,31 @@ const busDevice_t *gyroSensorBus(void)
 #endif
 }
 
+#ifdef USE_GYRO_FIFO
+// FIFO of the gyro that shares its device with the acc, NULL when it is not in use
+gyroFifo_t *gyroSensorFifo(void)
+{
+#ifdef USE_DUAL_GYRO
+    gyroSensor_t *gyroSensor = gyroToUse == GYRO_CONFIG_USE_GYRO_2 ? &gyroSensor2 : &gyroSensor1;
+#else
+    gyroSensor_t *gyroSensor = &gyroSensor1;
+#endif
+    return gyroSensor->fifoActive ? &gyroSensor->fifo : NULL;
+}
+#endif
+
+#ifdef USE_GYRO_JITTER_STATS
+const gyroJitterStats_t *gyroGetJitterStats(void)
+{
+    return &gyroJitter;
+}
+
+void gyroResetJitterStats(void)
+{
+    gyroJitterReset(&gyroJitter);
+}
+#endif
+
 #ifdef USE_GYRO_REGISTER_DUMP
 const busDevice_t *gyroSensorBusByDevice(uint8_t whichSensor)
 {
@@ -510,6 +571,27 @@ STATIC_UNIT_TESTED gyroSensor_e gyroDetect(gyroDev_t *dev)
     return gyroHardware;
 }
 
+#ifdef USE_GYRO_FIFO
+static bool gyroUseFifo(const gyroDev_t *gyroDev)
+{
+    if (!gyroConfig()->gyro_use_fifo || gyroDev->fifoFormat == GYRO_FIFO_NONE) {
+        return false;
+    }
+#ifdef USE_GYRO_FUSION
+    // fusion takes one sample of each gyro at a time
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        return false;
+    }
+#endif
+    // the BMI160 always samples at 3.2kHz, the FIFO only matches the loop when the rate says so
+    if (gyroDev->fifoFormat == GYRO_FIFO_BMI160 && gyroDev->gyroRateKHz != GYRO_RATE_3200_Hz) {
+        return false;
+    }
+    // leave room for the samples of a late loop
+    return (gyroDev->mpuDividerDrops + 1) * 2 <= GYRO_FIFO_MAX_SAMPLES;
+}
+#endif
+
 static bool gyroInitSensor(gyroSensor_t *gyroSensor)
 {
     gyroSensor->gyroDev.gyro_high_fsr = gyroConfig()->gyro_high_fsr;
@@ -545,9 +627,23 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor)
 
     // Must set gyro targetLooptime before gyroDev.init and initialisation of filters
     gyro.targetLooptime = gyroSetSampleRate(&gyroSensor->gyroDev, gyroConfig()->gyro_hardware_lpf, gyroConfig()->gyro_sync_denom, gyroConfig()->gyro_use_32khz);
+    gyro.sampleLooptime = gyro.targetLooptime;
+#ifdef USE_GYRO_FIFO
+    gyroSensor->fifoActive = gyroUseFifo(&gyroSensor->gyroDev);
+    if (gyroSensor->fifoActive) {
+        // the sensor queues every sample and each loop drains the ones taken since the last
+        gyroSensor->gyroDev.mpuDividerDrops = 0;
+        gyro.sampleLooptime = lrintf(gyroSensor->gyroDev.gyroRateKHz);
+    }
+#endif
     gyroSensor->gyroDev.hardware_lpf = gyroConfig()->gyro_hardware_lpf;
     gyroSensor->gyroDev.hardware_32khz_lpf = gyroConfig()->gyro_32khz_hardware_lpf;
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
+#ifdef USE_GYRO_FIFO
+    if (gyroSensor->fifoActive) {
+        gyroFifoInit(&gyroSensor->fifo, &gyroSensor->gyroDev);
+    }
+#endif
 
 
 #ifndef USE_GYRO_IMUF9001
@@ -589,7 +685,7 @@ static bool gyroInitSensor(gyroSensor_t *gyroSensor)
     gyroInitSensorFilters(gyroSensor);
 
 #ifdef USE_GYRO_DATA_ANALYSE
-    gyroDataAnalyseStateInit(&gyroSensor->gyroAnalyseState, gyro.targetLooptime);
+    gyroDataAnalyseStateInit(&gyroSensor->gyroAnalyseState, gyro.sampleLooptime);
 #endif
 
 #endif //USE_GYRO_IMUF9001
@@ -621,9 +717,14 @@ bool gyroInit(void)
     bool ret = false;
     memset(&gyro, 0, sizeof(gyro));
     gyroToUse = gyroConfig()->gyro_to_use;
+#if defined(USE_DUAL_GYRO) && !defined(USE_GYRO_FUSION)
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        gyroToUse = GYRO_CONFIG_USE_GYRO_BOTH;
+    }
+#endif
 
 #if defined(USE_DUAL_GYRO) && defined(GYRO_1_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroUsesBothSensors()) {
         gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_1_CS_PIN));
         IOInit(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(0));
         IOHi(gyroSensor1.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
@@ -632,7 +733,7 @@ bool gyroInit(void)
 #endif
 
 #if defined(USE_DUAL_GYRO) && defined(GYRO_2_CS_PIN)
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroUsesBothSensors()) {
         gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin = IOGetByTag(IO_TAG(GYRO_2_CS_PIN));
         IOInit(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin, OWNER_MPU_CS, RESOURCE_INDEX(1));
         IOHi(gyroSensor2.gyroDev.bus.busdev_u.spi.csnPin); // Ensure device is disabled, important when two devices are on the same bus.
@@ -657,7 +758,7 @@ bool gyroInit(void)
 #endif
     gyroSensor1.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor1.gyroDev.bus, GYRO_1_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyroUsesBothSensors()) {
         ret = gyroInitSensor(&gyroSensor1);
         if (!ret) {
             return false; // TODO handle failure of first gyro detection better. - Perhaps update the config to use second gyro then indicate a new failure mode and reboot.
@@ -685,7 +786,10 @@ bool gyroInit(void)
 #endif
     gyroSensor2.gyroDev.bus.bustype = BUSTYPE_SPI;
     spiBusSetInstance(&gyroSensor2.gyroDev.bus, GYRO_2_SPI_INSTANCE);
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+#ifdef USE_RPM_FILTER
+    gyroSensor2.rpmFilterBank = 1;
+#endif
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyroUsesBothSensors()) {
         ret = gyroInitSensor(&gyroSensor2);
         if (!ret) {
             return false; // TODO handle failure of second gyro detection better. - Perhaps update the config to use first gyro then indicate a new failure mode and reboot.
@@ -696,8 +800,8 @@ bool gyroInit(void)
 
 #ifdef USE_DUAL_GYRO
     // Only allow using both gyros simultaneously if they are the same hardware type.
-    // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
-    if (gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
+    // If the user selected "BOTH" or "FUSED" and they are not the same type, then reset to using only the first gyro.
+    if (gyroUsesBothSensors()) {
         if (gyroSensor1.gyroDev.gyroHardware != gyroSensor2.gyroDev.gyroHardware) {
             gyroToUse = GYRO_CONFIG_USE_GYRO_1;
             gyroConfigMutable()->gyro_to_use = GYRO_CONFIG_USE_GYRO_1;
@@ -707,6 +811,20 @@ bool gyroInit(void)
         }
     }
 #endif // USE_DUAL_GYRO
+
+#ifdef USE_GYRO_FUSION
+    if (gyroToUse == GYRO_CONFIG_USE_GYRO_FUSED) {
+        // both gyros are the same type, their samples are fused in the units of the first
+        gyroFusionInit(&gyroFusion, gyro.sampleLooptime, GYRO_FUSION_OUTLIER_DPS / gyroSensor1.gyroDev.scale);
+    }
+#endif
+#ifdef USE_RPM_FILTER
+    rpmFilterInit(rpmFilterConfig(), gyro.targetLooptime);
+    rpmFilterActive = isRpmFilterEnabled();
+#endif
+#ifdef USE_GYRO_JITTER_STATS
+    gyroJitterInit(&gyroJitter, gyro.targetLooptime);
+#endif
     return ret;
 }
 
@@ -732,8 +850,8 @@ void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint
     }
 
     // Establish some common constants
-    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
-    const float gyroDt = gyro.targetLooptime * 1e-6f;
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.sampleLooptime;
+    const float gyroDt = gyro.sampleLooptime * 1e-6f;
 
     // Gain could be calculated a little later as it is specific to the pt1/bqrcf2/fkf branches
     const float gain = pt1FilterGain(lpfHz, gyroDt);
@@ -754,7 +872,7 @@ void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint
         case FILTER_BIQUAD:
             *lowpassFilterApplyFn = (filterApplyFnPtr) biquadFilterApply;
             for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-                biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz, gyro.targetLooptime);
+                biquadFilterInitLPF(&lowpassFilter[axis].biquadFilterState, lpfHz, gyro.sampleLooptime);
             }
             break;
         case FILTER_KALMAN:
@@ -769,7 +887,7 @@ void gyroInitLowpassFilterLpf(gyroSensor_t *gyroSensor, int slot, int type, uint
 
 static uint16_t calculateNyquistAdjustedNotchHz(uint16_t notchHz, uint16_t notchCutoffHz)
 {
-    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.targetLooptime;
+    const uint32_t gyroFrequencyNyquist = 1000000 / 2 / gyro.sampleLooptime;
     if (notchHz > gyroFrequencyNyquist) {
         if (notchCutoffHz < gyroFrequencyNyquist) {
             notchHz = gyroFrequencyNyquist;
@@ -800,7 +918,7 @@ static void gyroInitFilterNotch1(gyroSensor_t *gyroSensor, uint16_t notchHz, uin
         gyroSensor->notchFilter1ApplyFn = (filterApplyFnPtr)biquadFilterApply;
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter1[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            biquadFilterInit(&gyroSensor->notchFilter1[axis], notchHz, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
         }
     }
 }
@@ -815,7 +933,7 @@ static void gyroInitFilterNotch2(gyroSensor_t *gyroSensor, uint16_t notchHz, uin
         gyroSensor->notchFilter2ApplyFn = (filterApplyFnPtr)biquadFilterApply;
         const float notchQ = filterGetNotchQ(notchHz, notchCutoffHz);
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilter2[axis], notchHz, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            biquadFilterInit(&gyroSensor->notchFilter2[axis], notchHz, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
         }
     }
 }
@@ -834,7 +952,7 @@ static void gyroInitFilterDynamicNotch(gyroSensor_t *gyroSensor)
         gyroSensor->notchFilterDynApplyFn = (filterApplyFnPtr)biquadFilterApplyDF1; // must be this function, not DF2
         const float notchQ = filterGetNotchQ(400, 390); //just any init value
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
-            biquadFilterInit(&gyroSensor->notchFilterDyn[axis], 400, gyro.targetLooptime, notchQ, FILTER_NOTCH);
+            biquadFilterInit(&gyroSensor->notchFilterDyn[axis], 400, gyro.sampleLooptime, notchQ, FILTER_NOTCH);
         }
     }
 }
@@ -874,6 +992,10 @@ void gyroInitFilters(void)
 #ifdef USE_DUAL_GYRO
     gyroInitSensorFilters(&gyroSensor2);
 #endif
+#ifdef USE_RPM_FILTER
+    rpmFilterInit(rpmFilterConfig(), gyro.targetLooptime);
+    rpmFilterActive = isRpmFilterEnabled();
+#endif
 }
 #endif //USE_GYRO_IMUF9001
 
@@ -893,7 +1015,8 @@ FAST_CODE bool isGyroCalibrationComplete(void)
         case GYRO_CONFIG_USE_GYRO_2: {
             return isGyroSensorCalibrationComplete(&gyroSensor2);
         }
-        case GYRO_CONFIG_USE_GYRO_BOTH: {
+        case GYRO_CONFIG_USE_GYRO_BOTH:
+        case GYRO_CONFIG_USE_GYRO_FUSED: {
             return isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2);
         }
     }
@@ -909,7 +1032,7 @@ static bool isOnFinalGyroCalibrationCycle(const gyroCalibration_t *gyroCalibrati
 
 static int32_t gyroCalculateCalibratingCycles(void)
 {
-    return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.targetLooptime;
+    return (gyroConfig()->gyroCalibrationDuration * 10000) / gyro.sampleLooptime;
 }
 
 static bool isOnFirstGyroCalibrationCycle(const gyroCalibration_t *gyroCalibration)
@@ -1121,15 +1244,102 @@ static FAST_CODE void checkForYawSpin(gyroSensor_t *gyroSensor, timeUs_t current
 #undef GYRO_FILTER_DEBUG_SET
 #endif
 
+static FAST_CODE void gyroProcessSensorSample(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs);
+
+#ifndef USE_GYRO_IMUF9001
+// Removes the zero offset from the raw sample and aligns it, false while
+// the sensor is still calibrating
+static FAST_CODE bool gyroAlignSensorSample(gyroSensor_t *gyroSensor)
+{
+    if (!isGyroSensorCalibrationComplete(gyroSensor)) {
+        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+        return false;
+    }
+
+    // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
+#if defined(USE_GYRO_SLEW_LIMITER)
+    gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
+    gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
+    gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
+#else
+    gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
+    gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
+    gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
+#endif
+
+    alignSensors(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
+    return true;
+}
+#endif
+
+#ifdef USE_GYRO_FIFO
+static FAST_CODE void gyroUpdateSensorFifo(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs)
+{
+    const uint8_t sampleCount = gyroFifoDrain(&gyroSensor->fifo);
+    DEBUG_SET(DEBUG_GYRO_FIFO, 0, sampleCount);
+    DEBUG_SET(DEBUG_GYRO_FIFO, 1, gyroSensor->fifo.overflowCount);
+
+    // every sample goes through the filters in the order it was taken
+    for (int i = 0; i < sampleCount; i++) {
+        const gyroFifoSample_t *sample = &gyroSensor->fifo.samples[i];
+        if (sample->hasGyro) {
+            gyroSensor->gyroDev.gyroADCRaw[X] = sample->gyro[X];
+            gyroSensor->gyroDev.gyroADCRaw[Y] = sample->gyro[Y];
+            gyroSensor->gyroDev.gyroADCRaw[Z] = sample->gyro[Z];
+            gyroProcessSensorSample(gyroSensor, currentTimeUs);
+        }
+    }
+}
+#endif
+
+#if !defined(USE_DMA_SPI_DEVICE) || defined(USE_GYRO_IMUF9001) || defined(USE_GYRO_FUSION)
+// The data ready interrupt can stamp the next sample while this one is read and
+// filtered, so the stamp is latched before the read
+static FAST_CODE bool gyroSensorRead(gyroSensor_t *gyroSensor)
+{
+#ifdef USE_GYRO_IMUF9001
+    // the IMU-F read hands back the stamp of the frame it takes
+    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+        return false;
+    }
+    gyroSensor->sampleTimeUs = gyroSensor->gyroDev.sampleTimeUs;
+#else
+    const timeUs_t sampleTimeUs = gyroSensor->gyroDev.sampleTimeUs;
+    if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+        return false;
+    }
+    gyroSensor->sampleTimeUs = sampleTimeUs;
+#endif
+    return true;
+}
+#endif
+
 static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs)
 {
-    #ifndef USE_DMA_SPI_DEVICE
-        if (!gyroSensor->gyroDev.readFn(&gyroSensor->gyroDev)) {
+#ifdef USE_GYRO_FIFO
+    if (gyroSensor->fifoActive) {
+        gyroSensor->sampleTimeUs = gyroSensor->gyroDev.sampleTimeUs;
+        gyroSensor->gyroDev.dataReady = false;
+        gyroUpdateSensorFifo(gyroSensor, currentTimeUs);
         return;
     }
+#endif
+    #if !defined(USE_DMA_SPI_DEVICE) || defined(USE_GYRO_IMUF9001)
+        // the IMU-F frame arrives by DMA, the read takes it from the link
+        if (!gyroSensorRead(gyroSensor)) {
+        return;
+    }
+    #else
+    // the DMA completion stamps the raw data it brings in
+    gyroSensor->sampleTimeUs = gyroSensor->gyroDev.sampleTimeUs;
     #endif
     gyroSensor->gyroDev.dataReady = false;
 
+    gyroProcessSensorSample(gyroSensor, currentTimeUs);
+}
+
+static FAST_CODE void gyroProcessSensorSample(gyroSensor_t* gyroSensor, timeUs_t currentTimeUs)
+{
     const timeDelta_t sampleDeltaUs = currentTimeUs - accumulationLastTimeSampledUs;
     accumulationLastTimeSampledUs = currentTimeUs;
     accumulatedMeasurementTimeUs += sampleDeltaUs;
@@ -1152,22 +1362,7 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
         // still calibrating, so no need to further process gyro data
     }
 #else
-    if (isGyroSensorCalibrationComplete(gyroSensor)) {
-        // move 16-bit gyro data into 32-bit variables to avoid overflows in calculations
-
-#if defined(USE_GYRO_SLEW_LIMITER)
-        gyroSensor->gyroDev.gyroADC[X] = gyroSlewLimiter(gyroSensor, X) - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSlewLimiter(gyroSensor, Y) - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSlewLimiter(gyroSensor, Z) - gyroSensor->gyroDev.gyroZero[Z];
-#else
-        gyroSensor->gyroDev.gyroADC[X] = gyroSensor->gyroDev.gyroADCRaw[X] - gyroSensor->gyroDev.gyroZero[X];
-        gyroSensor->gyroDev.gyroADC[Y] = gyroSensor->gyroDev.gyroADCRaw[Y] - gyroSensor->gyroDev.gyroZero[Y];
-        gyroSensor->gyroDev.gyroADC[Z] = gyroSensor->gyroDev.gyroADCRaw[Z] - gyroSensor->gyroDev.gyroZero[Z];
-#endif
-
-        alignSensors(gyroSensor->gyroDev.gyroADC, gyroSensor->gyroDev.gyroAlign);
-    } else {
-        performGyroCalibration(gyroSensor, gyroConfig()->gyroMovementCalibrationThreshold);
+    if (!gyroAlignSensorSample(gyroSensor)) {
         // still calibrating, so no need to further process gyro data
         return;
     }
@@ -1209,6 +1404,74 @@ static FAST_CODE_NOINLINE void gyroUpdateSensor(gyroSensor_t* gyroSensor, timeUs
 #endif
 }
 
+#ifdef USE_GYRO_FUSION
+// Both gyros are calibrated, aligned and checked for overflow on their own,
+// then fused and run through the filters of the first gyro only
+static FAST_CODE_NOINLINE void gyroUpdateSensorsFused(timeUs_t currentTimeUs)
+{
+    const bool read1 = gyroSensorRead(&gyroSensor1);
+    const bool read2 = gyroSensorRead(&gyroSensor2);
+    if (!read1 && !read2) {
+        return;
+    }
+    gyroSensor1.gyroDev.dataReady = false;
+    gyroSensor2.gyroDev.dataReady = false;
+
+    const bool aligned1 = gyroAlignSensorSample(&gyroSensor1);
+    const bool aligned2 = gyroAlignSensorSample(&gyroSensor2);
+    if (!aligned1 || !aligned2) {
+        return;
+    }
+
+#ifdef USE_GYRO_OVERFLOW_CHECK
+    if (gyroConfig()->checkOverflow && !gyroHasOverflowProtection) {
+        // checked on the unfiltered samples, the filters only see the fused one
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyroSensor1.gyroDev.gyroADCf[axis] = gyroSensor1.gyroDev.gyroADC[axis] * gyroSensor1.gyroDev.scale;
+            gyroSensor2.gyroDev.gyroADCf[axis] = gyroSensor2.gyroDev.gyroADC[axis] * gyroSensor2.gyroDev.scale;
+        }
+        checkForOverflow(&gyroSensor1, currentTimeUs);
+        checkForOverflow(&gyroSensor2, currentTimeUs);
+    }
+#endif
+
+    DEBUG_SET(DEBUG_GYRO_FUSION, 3, lrintf((gyroSensor1.gyroDev.gyroADC[X] - gyroSensor2.gyroDev.gyroADC[X]) * gyroSensor1.gyroDev.scale));
+
+    float fused[XYZ_AXIS_COUNT];
+    gyroFusionUpdate(&gyroFusion, gyroSensor1.gyroDev.gyroADC, gyroSensor2.gyroDev.gyroADC,
+        !read1 || gyroSensor1.overflowDetected, !read2 || gyroSensor2.overflowDetected, fused);
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyroSensor1.gyroDev.gyroADC[axis] = fused[axis];
+    }
+
+    DEBUG_SET(DEBUG_GYRO_FUSION, 0, lrintf(gyroFusion.sensor[0].weight * 1000));
+    DEBUG_SET(DEBUG_GYRO_FUSION, 1, gyroFusion.sensor[0].faults);
+    DEBUG_SET(DEBUG_GYRO_FUSION, 2, gyroFusion.sensor[1].faults);
+
+    if (gyroDebugMode == DEBUG_NONE) {
+        filterGyro(&gyroSensor1);
+    } else {
+        filterGyroDebug(&gyroSensor1);
+    }
+
+#ifdef USE_YAW_SPIN_RECOVERY
+    if (gyroConfig()->yaw_spin_recovery) {
+        checkForYawSpin(&gyroSensor1, currentTimeUs);
+    }
+#endif
+
+#ifdef USE_GYRO_DATA_ANALYSE
+    if (isDynamicFilterActive()) {
+        gyroDataAnalyse(&gyroSensor1.gyroAnalyseState, gyroSensor1.notchFilterDyn);
+    }
+#endif
+
+#if (!defined(USE_GYRO_OVERFLOW_CHECK) && !defined(USE_YAW_SPIN_RECOVERY))
+    UNUSED(currentTimeUs);
+#endif
+}
+#endif
+
 #ifdef USE_DMA_SPI_DEVICE
 FAST_CODE_NOINLINE void gyroDmaSpiFinishRead(void)
 {
@@ -1224,16 +1487,30 @@ FAST_CODE_NOINLINE void gyroDmaSpiStartRead(void)
 }
 #endif
 
+// Drivers with a data ready interrupt stamp each sample as it is signalled,
+// the others are taken to be sampled when they are read
+static FAST_CODE timeUs_t gyroSensorSampleTimeUs(const gyroSensor_t *gyroSensor, timeUs_t currentTimeUs)
+{
+    return gyroSensor->sampleTimeUs ? gyroSensor->sampleTimeUs : currentTimeUs;
+}
+
 FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
 {
     const timeDelta_t sampleDeltaUs = currentTimeUs - accumulationLastTimeSampledUs;
     accumulationLastTimeSampledUs = currentTimeUs;
     accumulatedMeasurementTimeUs += sampleDeltaUs;
 
+#ifdef USE_RPM_FILTER
+    if (rpmFilterActive) {
+        rpmFilterUpdate();
+    }
+#endif
+
 #ifdef USE_DUAL_GYRO
     switch (gyroToUse) {
     case GYRO_CONFIG_USE_GYRO_1:
         gyroUpdateSensor(&gyroSensor1, currentTimeUs);
+        gyro.sampleTimeUs = gyroSensorSampleTimeUs(&gyroSensor1, currentTimeUs);
         if (isGyroSensorCalibrationComplete(&gyroSensor1)) {
             gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
             gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
@@ -1254,6 +1531,7 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
         break;
     case GYRO_CONFIG_USE_GYRO_2:
         gyroUpdateSensor(&gyroSensor2, currentTimeUs);
+        gyro.sampleTimeUs = gyroSensorSampleTimeUs(&gyroSensor2, currentTimeUs);
         if (isGyroSensorCalibrationComplete(&gyroSensor2)) {
             gyro.gyroADCf[X] = gyroSensor2.gyroDev.gyroADCf[X];
             gyro.gyroADCf[Y] = gyroSensor2.gyroDev.gyroADCf[Y];
@@ -1275,6 +1553,7 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
     case GYRO_CONFIG_USE_GYRO_BOTH:
         gyroUpdateSensor(&gyroSensor1, currentTimeUs);
         gyroUpdateSensor(&gyroSensor2, currentTimeUs);
+        gyro.sampleTimeUs = gyroSensorSampleTimeUs(&gyroSensor1, currentTimeUs);
         if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
             gyro.gyroADCf[X] = (gyroSensor1.gyroDev.gyroADCf[X] + gyroSensor2.gyroDev.gyroADCf[X]) * 0.5f;
             gyro.gyroADCf[Y] = (gyroSensor1.gyroDev.gyroADCf[Y] + gyroSensor2.gyroDev.gyroADCf[Y]) * 0.5f;
@@ -1301,9 +1580,28 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 1, lrintf(gyroSensor1.gyroDev.gyroADCf[Y] - gyroSensor2.gyroDev.gyroADCf[Y]));
         DEBUG_SET(DEBUG_DUAL_GYRO_DIFF, 2, lrintf(gyroSensor1.gyroDev.gyroADCf[Z] - gyroSensor2.gyroDev.gyroADCf[Z]));
         break;
+#ifdef USE_GYRO_FUSION
+    case GYRO_CONFIG_USE_GYRO_FUSED:
+        gyroUpdateSensorsFused(currentTimeUs);
+        gyro.sampleTimeUs = gyroSensorSampleTimeUs(&gyroSensor1, currentTimeUs);
+        if (isGyroSensorCalibrationComplete(&gyroSensor1) && isGyroSensorCalibrationComplete(&gyroSensor2)) {
+            gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
+            gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
+            gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
+#ifdef USE_GYRO_OVERFLOW_CHECK
+            // a single overflowing gyro is left out of the fusion
+            overflowDetected = gyroSensor1.overflowDetected && gyroSensor2.overflowDetected;
+#endif
+#ifdef USE_YAW_SPIN_RECOVERY
+            yawSpinDetected = gyroSensor1.yawSpinDetected;
+#endif
+        }
+        break;
+#endif
     }
 #else
     gyroUpdateSensor(&gyroSensor1, currentTimeUs);
+    gyro.sampleTimeUs = gyroSensorSampleTimeUs(&gyroSensor1, currentTimeUs);
     gyro.gyroADCf[X] = gyroSensor1.gyroDev.gyroADCf[X];
     gyro.gyroADCf[Y] = gyroSensor1.gyroDev.gyroADCf[Y];
     gyro.gyroADCf[Z] = gyroSensor1.gyroDev.gyroADCf[Z];
@@ -1316,6 +1614,24 @@ FAST_CODE_NOINLINE void gyroUpdate(timeUs_t currentTimeUs)
 #endif
 #endif
 
+#if defined(USE_RPM_FILTER) && defined(USE_GYRO_IMUF9001)
+    // the IMU-F sends filtered samples, the notches can only follow its filters
+    if (rpmFilterActive) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            gyro.gyroADCf[axis] = rpmFilterGyro(0, axis, gyro.gyroADCf[axis]);
+        }
+    }
+#endif
+
+#ifdef USE_GYRO_JITTER_STATS
+    const uint32_t sampleIntervalUs = gyroJitterUpdate(&gyroJitter, gyro.sampleTimeUs, currentTimeUs);
+    if (sampleIntervalUs) {
+        DEBUG_SET(DEBUG_GYRO_JITTER, 0, sampleIntervalUs);
+        DEBUG_SET(DEBUG_GYRO_JITTER, 1, cmpTimeUs(currentTimeUs, gyro.sampleTimeUs));
+        DEBUG_SET(DEBUG_GYRO_JITTER, 2, (int32_t)sampleIntervalUs - (int32_t)gyro.targetLooptime);
+    }
+#endif
+
     if (!overflowDetected) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             // integrate using trapezium rule to avoid bias
@@ -1364,6 +1680,7 @@ void gyroReadTemperature(void)
         break;
 
     case GYRO_CONFIG_USE_GYRO_BOTH:
+    case GYRO_CONFIG_USE_GYRO_FUSED:
         gyroSensorTemperature = MAX(gyroReadSensorTemperature(gyroSensor1), gyroReadSensorTemperature(gyroSensor2));
         break;
 #endif // USE_MULTI_GYRO
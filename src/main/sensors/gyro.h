@@ -50,6 +50,8 @@ extern float vGyroStdDevModulus;
 
 typedef struct gyro_s {
     uint32_t targetLooptime;
+    uint32_t sampleLooptime;    // interval of the samples run through the gyro filters
+    timeUs_t sampleTimeUs;      // when the sensor took the sample in gyroADCf
     float gyroADCf[XYZ_AXIS_COUNT];
 } gyro_t;
 
@@ -64,6 +66,7 @@ typedef enum {
 #define GYRO_CONFIG_USE_GYRO_1      0
 #define GYRO_CONFIG_USE_GYRO_2      1
 #define GYRO_CONFIG_USE_GYRO_BOTH   2
+#define GYRO_CONFIG_USE_GYRO_FUSED  3   // both, combined before filtering
 
 typedef enum {
     FILTER_LOWPASS = 0,
@@ -90,6 +93,7 @@ typedef struct gyroConfig_s {
     uint8_t  gyro_high_fsr;
     uint8_t  gyro_use_32khz;
     uint8_t  gyro_to_use;
+    uint8_t  gyro_use_fifo;
 
     uint16_t gyro_lowpass_hz;
     uint16_t gyro_lowpass2_hz;
@@ -145,6 +149,11 @@ struct mpuConfiguration_s;
 const struct mpuConfiguration_s *gyroMpuConfiguration(void);
 struct mpuDetectionResult_s;
 const struct mpuDetectionResult_s *gyroMpuDetectionResult(void);
+struct gyroFifo_s;
+struct gyroFifo_s *gyroSensorFifo(void);
+struct gyroJitterStats_s;
+const struct gyroJitterStats_s *gyroGetJitterStats(void);
+void gyroResetJitterStats(void);
 void gyroStartCalibration(bool isFirstArmingCalibration);
 bool isFirstArmingGyroCalibrationRunning(void);
 bool isGyroCalibrationComplete(void);
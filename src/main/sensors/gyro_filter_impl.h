@@ -16,6 +16,13 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(gyroSensor_t *gyroSensor)
         }
 #endif
 
+#ifdef USE_RPM_FILTER
+        // ahead of the lowpass filters, so their phase lag does not reach the notches
+        if (rpmFilterActive) {
+            gyroADCf = rpmFilterGyro(gyroSensor->rpmFilterBank, axis, gyroADCf);
+        }
+#endif
+
         // apply static notch filters and software lowpass filters
         gyroADCf = gyroSensor->lowpass2FilterApplyFn((filter_t *)&gyroSensor->lowpass2Filter[axis], gyroADCf);
         gyroADCf = gyroSensor->lowpassFilterApplyFn((filter_t *)&gyroSensor->lowpassFilter[axis], gyroADCf);
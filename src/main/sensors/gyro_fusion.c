@@ -0,0 +1,152 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_FUSION
+
+#include "common/maths.h"
+
+#include "sensors/gyro_fusion.h"
+
+#define GYRO_FUSION_VARIANCE_TIME_CONSTANT_US   100000  // noise estimate settles in about 0.1s
+#define GYRO_FUSION_STUCK_TIME_US               20000   // a working gyro never repeats itself for this long
+#define GYRO_FUSION_OUTLIER_HOLD_TIME_US        100000  // an outlier has to agree again for this long
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t sampleLooptimeUs, float outlierThreshold)
+{
+    memset(fusion, 0, sizeof(*fusion));
+    fusion->varianceGain = (float)sampleLooptimeUs / (GYRO_FUSION_VARIANCE_TIME_CONSTANT_US + sampleLooptimeUs);
+    fusion->outlierThreshold = outlierThreshold;
+    fusion->stuckSamples = MAX(GYRO_FUSION_STUCK_TIME_US / sampleLooptimeUs, 2U);
+    fusion->outlierHoldSamples = MAX(GYRO_FUSION_OUTLIER_HOLD_TIME_US / sampleLooptimeUs, 1U);
+    for (int i = 0; i < GYRO_FUSION_SENSOR_COUNT; i++) {
+        fusion->sensor[i].weight = 1.0f / GYRO_FUSION_SENSOR_COUNT;
+    }
+}
+
+// Largest second difference over the axes, the error of a straight line
+// prediction from the last two samples. Also feeds the noise estimate.
+static float updateNoise(const gyroFusion_t *fusion, gyroFusionSensor_t *sensor, const float *sample)
+{
+    bool unchanged = true;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        unchanged = unchanged && sample[axis] == sensor->previous[0][axis];
+    }
+    sensor->unchangedCount = unchanged ? MIN(sensor->unchangedCount + 1, fusion->stuckSamples) : 0;
+
+    float maxError = 0.0f;
+    if (sensor->sampleCount >= 2 && !unchanged) {
+        float squareSum = 0.0f;
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const float error = sample[axis] - 2.0f * sensor->previous[0][axis] + sensor->previous[1][axis];
+            squareSum += sq(error);
+            maxError = MAX(maxError, fabsf(error));
+        }
+        sensor->variance += fusion->varianceGain * (squareSum - sensor->variance);
+    } else if (sensor->sampleCount < 2) {
+        sensor->sampleCount++;
+    }
+
+    memcpy(sensor->previous[1], sensor->previous[0], sizeof(sensor->previous[1]));
+    memcpy(sensor->previous[0], sample, sizeof(sensor->previous[0]));
+
+    return maxError;
+}
+
+static bool sensorsDisagree(const gyroFusion_t *fusion, const float *sample1, const float *sample2)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        if (fabsf(sample1[axis] - sample2[axis]) > fusion->outlierThreshold) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void gyroFusionUpdate(gyroFusion_t *fusion, const float *sample1, const float *sample2, bool fault1, bool fault2, float *fused)
+{
+    const float *samples[GYRO_FUSION_SENSOR_COUNT] = { sample1, sample2 };
+    const bool reported[GYRO_FUSION_SENSOR_COUNT] = { fault1, fault2 };
+    float predictionError[GYRO_FUSION_SENSOR_COUNT];
+    uint8_t faults[GYRO_FUSION_SENSOR_COUNT];
+
+    for (int i = 0; i < GYRO_FUSION_SENSOR_COUNT; i++) {
+        gyroFusionSensor_t *sensor = &fusion->sensor[i];
+        predictionError[i] = updateNoise(fusion, sensor, samples[i]);
+        faults[i] = (reported[i] ? GYRO_FUSION_FAULT_REPORTED : 0)
+            | (sensor->unchangedCount >= fusion->stuckSamples ? GYRO_FUSION_FAULT_STUCK : 0);
+    }
+
+    // a disagreement explained by a known fault needs no culprit, one that
+    // goes on keeps the current outlier out, a new one is blamed on the
+    // sensor that moved least like a real gyro
+    gyroFusionSensor_t *first = &fusion->sensor[0];
+    gyroFusionSensor_t *second = &fusion->sensor[1];
+    if (faults[0] || faults[1] || !sensorsDisagree(fusion, sample1, sample2)) {
+        first->outlierHold = first->outlierHold ? first->outlierHold - 1 : 0;
+        second->outlierHold = second->outlierHold ? second->outlierHold - 1 : 0;
+    } else if (first->outlierHold) {
+        first->outlierHold = fusion->outlierHoldSamples;
+    } else if (second->outlierHold) {
+        second->outlierHold = fusion->outlierHoldSamples;
+    } else {
+        gyroFusionSensor_t *outlier = predictionError[0] >= predictionError[1] ? first : second;
+        outlier->outlierHold = fusion->outlierHoldSamples;
+    }
+
+    for (int i = 0; i < GYRO_FUSION_SENSOR_COUNT; i++) {
+        gyroFusionSensor_t *sensor = &fusion->sensor[i];
+        if (sensor->outlierHold) {
+            faults[i] |= GYRO_FUSION_FAULT_OUTLIER;
+        }
+        if (faults[i] && !sensor->faults) {
+            sensor->dropCount++;
+        }
+        sensor->faults = faults[i];
+    }
+
+    if (!first->faults && !second->faults) {
+        // inverse variance weighting
+        const float varianceSum = first->variance + second->variance;
+        first->weight = varianceSum > 0.0f ? second->variance / varianceSum : 0.5f;
+    } else if (!first->faults || !second->faults) {
+        first->weight = first->faults ? 0.0f : 1.0f;
+    } else {
+        // nothing better to go by
+        first->weight = 0.5f;
+    }
+    second->weight = 1.0f - first->weight;
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        fused[axis] = first->weight * sample1[axis] + second->weight * sample2[axis];
+    }
+}
+
+bool gyroFusionSensorHealthy(const gyroFusion_t *fusion, int sensor)
+{
+    return !fusion->sensor[sensor].faults;
+}
+#endif
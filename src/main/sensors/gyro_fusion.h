@@ -0,0 +1,67 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fusion of two gyros before filtering. Each sample is weighted by the
+ * inverse of the sensor's noise variance, estimated from the second
+ * difference of its samples: the motion of the craft is common to both
+ * sensors and mostly cancels out of it, the sensor noise does not. A sensor
+ * that is reported faulty, stops changing or jumps away from the other is
+ * dropped until it has behaved for a while.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+
+#define GYRO_FUSION_SENSOR_COUNT 2
+
+typedef enum {
+    GYRO_FUSION_OK = 0,
+    GYRO_FUSION_FAULT_REPORTED = (1 << 0),  // by the caller, gyro overflow
+    GYRO_FUSION_FAULT_STUCK = (1 << 1),     // same sample on all axes for too long
+    GYRO_FUSION_FAULT_OUTLIER = (1 << 2),   // jumped away from the other sensor
+} gyroFusionFault_e;
+
+typedef struct gyroFusionSensor_s {
+    float previous[2][XYZ_AXIS_COUNT];  // the last two samples
+    float variance;                     // mean square of the second difference
+    float weight;
+    uint16_t unchangedCount;
+    uint16_t outlierHold;               // samples left before an outlier is trusted again
+    uint8_t faults;                     // gyroFusionFault_e
+    uint8_t sampleCount;                // up to the two needed for a second difference
+    uint16_t dropCount;                 // times the sensor was dropped
+} gyroFusionSensor_t;
+
+typedef struct gyroFusion_s {
+    gyroFusionSensor_t sensor[GYRO_FUSION_SENSOR_COUNT];
+    float varianceGain;
+    float outlierThreshold;     // disagreement between the sensors, in sample units
+    uint16_t stuckSamples;
+    uint16_t outlierHoldSamples;
+} gyroFusion_t;
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t sampleLooptimeUs, float outlierThreshold);
+void gyroFusionUpdate(gyroFusion_t *fusion, const float *sample1, const float *sample2, bool fault1, bool fault2, float *fused);
+bool gyroFusionSensorHealthy(const gyroFusion_t *fusion, int sensor);
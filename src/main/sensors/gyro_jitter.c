@@ -0,0 +1,110 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_GYRO_JITTER_STATS
+
+#include "common/maths.h"
+
+#include "sensors/gyro_jitter.h"
+
+static const uint8_t bucketEdges[GYRO_JITTER_BUCKET_COUNT - 1] = GYRO_JITTER_BUCKET_EDGES;
+
+void gyroJitterInit(gyroJitterStats_t *stats, uint32_t expectedIntervalUs)
+{
+    stats->expectedIntervalUs = expectedIntervalUs;
+    stats->lastSampleTimeUs = 0;
+    gyroJitterReset(stats);
+}
+
+// Clears the statistics but keeps the last timestamp, so the next sample
+// still yields an interval
+void gyroJitterReset(gyroJitterStats_t *stats)
+{
+    stats->sampleCount = 0;
+    stats->minIntervalUs = UINT32_MAX;
+    stats->maxIntervalUs = 0;
+    stats->intervalSumUs = 0;
+    stats->deviationSumUs = 0;
+    stats->maxLatencyUs = 0;
+    stats->latencySumUs = 0;
+    memset(stats->histogram, 0, sizeof(stats->histogram));
+}
+
+// Takes the timestamp of the sample the loop is about to use and returns its
+// interval to the previous one, 0 if there is no new sample.
+uint32_t gyroJitterUpdate(gyroJitterStats_t *stats, timeUs_t sampleTimeUs, timeUs_t currentTimeUs)
+{
+    if (stats->lastSampleTimeUs == 0 || sampleTimeUs == stats->lastSampleTimeUs) {
+        stats->lastSampleTimeUs = sampleTimeUs;
+        return 0;
+    }
+
+    const timeDelta_t intervalUs = cmpTimeUs(sampleTimeUs, stats->lastSampleTimeUs);
+    stats->lastSampleTimeUs = sampleTimeUs;
+    if (intervalUs <= 0) {
+        return 0;
+    }
+
+    const timeDelta_t latencyUs = MAX(cmpTimeUs(currentTimeUs, sampleTimeUs), 0);
+    const uint32_t deviationUs = ABS(intervalUs - (timeDelta_t)stats->expectedIntervalUs);
+
+    stats->sampleCount++;
+    stats->minIntervalUs = MIN(stats->minIntervalUs, (uint32_t)intervalUs);
+    stats->maxIntervalUs = MAX(stats->maxIntervalUs, (uint32_t)intervalUs);
+    stats->intervalSumUs += intervalUs;
+    stats->deviationSumUs += deviationUs;
+    stats->maxLatencyUs = MAX(stats->maxLatencyUs, (uint32_t)latencyUs);
+    stats->latencySumUs += latencyUs;
+
+    int bucket = 0;
+    while (bucket < GYRO_JITTER_BUCKET_COUNT - 1 && deviationUs * 100 >= bucketEdges[bucket] * stats->expectedIntervalUs) {
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+
+    return intervalUs;
+}
+
+uint32_t gyroJitterMeanIntervalUs(const gyroJitterStats_t *stats)
+{
+    return stats->sampleCount ? stats->intervalSumUs / stats->sampleCount : 0;
+}
+
+uint32_t gyroJitterMeanDeviationUs(const gyroJitterStats_t *stats)
+{
+    return stats->sampleCount ? stats->deviationSumUs / stats->sampleCount : 0;
+}
+
+uint32_t gyroJitterMeanLatencyUs(const gyroJitterStats_t *stats)
+{
+    return stats->sampleCount ? stats->latencySumUs / stats->sampleCount : 0;
+}
+
+uint8_t gyroJitterBucketEdge(int bucket)
+{
+    return bucket < GYRO_JITTER_BUCKET_COUNT - 1 ? bucketEdges[bucket] : 0;
+}
+#endif
@@ -0,0 +1,53 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define GYRO_JITTER_BUCKET_COUNT 8
+
+// upper edges of the histogram buckets, in percent of the expected interval;
+// the last bucket takes everything from 100% up
+#define GYRO_JITTER_BUCKET_EDGES { 1, 2, 5, 10, 20, 50, 100 }
+
+typedef struct gyroJitterStats_s {
+    uint32_t expectedIntervalUs;
+    timeUs_t lastSampleTimeUs;
+    uint32_t sampleCount;               // intervals measured since the last reset
+    uint32_t minIntervalUs;
+    uint32_t maxIntervalUs;
+    uint64_t intervalSumUs;
+    uint64_t deviationSumUs;            // sum of |interval - expected|
+    uint32_t maxLatencyUs;              // sample taken until it was used by the loop
+    uint64_t latencySumUs;
+    uint32_t histogram[GYRO_JITTER_BUCKET_COUNT];
+} gyroJitterStats_t;
+
+void gyroJitterInit(gyroJitterStats_t *stats, uint32_t expectedIntervalUs);
+void gyroJitterReset(gyroJitterStats_t *stats);
+uint32_t gyroJitterUpdate(gyroJitterStats_t *stats, timeUs_t sampleTimeUs, timeUs_t currentTimeUs);
+
+uint32_t gyroJitterMeanIntervalUs(const gyroJitterStats_t *stats);
+uint32_t gyroJitterMeanDeviationUs(const gyroJitterStats_t *stats);
+uint32_t gyroJitterMeanLatencyUs(const gyroJitterStats_t *stats);
+uint8_t gyroJitterBucketEdge(int bucket);
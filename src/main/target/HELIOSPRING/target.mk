@@ -5,4 +5,5 @@ FEATURES       += VCP ONBOARDFLASH
 TARGET_SRC = stm32f4xx_crc.c \
              drivers/dma_spi.c \
              drivers/accgyro/accgyro_imuf9001.c \
+             drivers/accgyro/accgyro_imuf9001_link.c \
              drivers/max7456.c
\ No newline at end of file
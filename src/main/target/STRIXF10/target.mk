@@ -3,4 +3,5 @@ F7X2RE_TARGETS  += $(TARGET)
 
  TARGET_SRC = drivers/dma_spi_hal.c \
               drivers/accgyro/accgyro_imuf9001.c \
+              drivers/accgyro/accgyro_imuf9001_link.c \
               drivers/max7456.c
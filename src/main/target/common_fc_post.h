@@ -34,6 +34,10 @@
 #undef USE_ESC_SENSOR
 #endif
 
+#ifndef USE_DSHOT_TELEMETRY
+#undef USE_RPM_FILTER
+#endif
+
 // XXX Followup implicit dependencies among DASHBOARD, display_xxx and USE_I2C.
 // XXX This should eventually be cleaned up.
 #ifndef USE_I2C
@@ -134,6 +138,16 @@
 #define ENABLE_DSHOT_DMAR false
 #endif
 
+// FIFO burst reads need a gyro that supports them, the DMA gyro read replaces them
+#if defined(USE_DMA_SPI_DEVICE) || !(defined(USE_GYRO_SPI_MPU6000) || defined(USE_GYRO_SPI_ICM20689) || defined(USE_ACCGYRO_BMI160))
+#undef USE_GYRO_FIFO
+#endif
+
+// gyro fusion reads both gyros itself, the IMU-F and DMA gyro reads do not allow that
+#if !defined(USE_DUAL_GYRO) || defined(USE_GYRO_IMUF9001) || defined(USE_DMA_SPI_DEVICE)
+#undef USE_GYRO_FUSION
+#endif
+
 // Some target doesn't define USE_ADC which USE_ADC_INTERNAL depends on
 #ifndef USE_ADC
 #undef USE_ADC_INTERNAL
@@ -36,7 +36,7 @@
 
 #ifdef STM32F1
 #define MINIMAL_CLI
-// Using RX DMA disables the use of receive callbacks
+// Receive callbacks on RX DMA ports are invoked from the idle line interrupt
 #define USE_UART1_RX_DMA
 #define USE_UART1_TX_DMA
 #endif
@@ -53,8 +53,11 @@
 #define USE_FAST_RAM
 #endif
 #define USE_DSHOT
+#define USE_DSHOT_TELEMETRY
+#define USE_RPM_FILTER
 #define I2C3_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
+#define USE_GYRO_FIFO
 #define USE_ADC
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
@@ -74,6 +77,7 @@
 #define I2C3_OVERCLOCK true
 #define I2C4_OVERCLOCK true
 #define USE_GYRO_DATA_ANALYSE
+#define USE_GYRO_FIFO
 #define USE_OVERCLOCK
 #define USE_ADC_INTERNAL
 #define USE_USB_CDC_HID
@@ -191,6 +195,8 @@
 #define USE_THROTTLE_BOOST
 #define USE_RC_SMOOTHING_FILTER
 #define USE_ITERM_RELAX
+#define USE_GYRO_JITTER_STATS
+#define USE_GYRO_FUSION
 
 #ifdef USE_SERIALRX_SPEKTRUM
 #define USE_SPEKTRUM_BIND
@@ -214,6 +220,7 @@
 #define USE_GPS_NMEA
 #define USE_GPS_UBLOX
 #define USE_GPS_RESCUE
+#define USE_POSITION_ESTIMATOR
 #define USE_OSD
 #define USE_OSD_OVER_MSP_DISPLAYPORT
 #define USE_OSD_ADJUSTMENTS
@@ -227,4 +234,5 @@
 #define USE_SIGNATURE
 #define USE_ABSOLUTE_CONTROL
 #define USE_TPA_CURVES
+#define USE_RATE_LOOKUP
 #endif
@@ -49,8 +49,10 @@
 #include "fc/runtime_config.h"
 
 #include "flight/imu.h"
+#include "flight/position.h"
 
 #include "interface/crsf_protocol.h"
+#include "interface/msp.h"
 
 #include "io/displayport_crsf.h"
 #include "io/gps.h"
@@ -64,8 +66,9 @@
 #include "telemetry/telemetry.h"
 #include "telemetry/crsf.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/telemetry_scheduler.h"
 
-#define CRSF_CYCLETIME_US                   100000 // 100ms, 10 Hz
+#define CRSF_TELEMETRY_BYTES_PER_SECOND     500
 #define CRSF_DEVICEINFO_VERSION             0x01
 #define CRSF_DEVICEINFO_PARAMETER_COUNT     0
 
@@ -102,27 +105,42 @@ bool bufferCrsfMspFrame(uint8_t *frameStart, int frameLength)
     }
 }
 
-bool handleCrsfMspFrameBuffer(uint8_t payloadSize, mspResponseFnPtr responseFn)
+// Replies to several requests may be outstanding, each is serialised from its
+// own buffer straight into the outgoing frames.
+#define CRSF_MSP_REPLY_WINDOW 4
+
+typedef struct crsfMspReply_s {
+    mspPacket_t packet;
+    uint8_t buffer[CRSF_MSP_TX_BUF_SIZE];
+} crsfMspReply_t;
+
+static crsfMspReply_t mspReplies[CRSF_MSP_REPLY_WINDOW];
+static uint8_t mspReplyHead;
+static uint8_t mspReplyCount;
+static uint8_t mspLinkFrameCount;
+
+// Processes buffered request frames while the window has room for their
+// replies, returns true if frames are left over for later.
+static bool processCrsfMspRequests(void)
 {
-    bool requestHandled = false;
-    if (!mspRxBuffer.len) {
-        return false;
-    }
     int pos = 0;
-    while (true) {
+    while (pos < mspRxBuffer.len && mspReplyCount < CRSF_MSP_REPLY_WINDOW) {
         const int mspFrameLength = mspRxBuffer.bytes[pos];
-        if (handleMspFrame(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, NULL)) {
-            requestHandled |= sendMspReply(payloadSize, responseFn);
+        crsfMspReply_t *reply = &mspReplies[(mspReplyHead + mspReplyCount) % CRSF_MSP_REPLY_WINDOW];
+        if (handleMspFrameWithReply(&mspRxBuffer.bytes[CRSF_MSP_LENGTH_OFFSET + pos], mspFrameLength, &reply->packet, reply->buffer, sizeof(reply->buffer))) {
+            mspReplyCount++;
         }
         pos += CRSF_MSP_LENGTH_OFFSET + mspFrameLength;
-        ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
-            if (pos >= mspRxBuffer.len) {
-                mspRxBuffer.len = 0;
-                return requestHandled;
-            }
-        }
     }
-    return requestHandled;
+
+    bool framesLeft;
+    ATOMIC_BLOCK(NVIC_PRIO_SERIALUART1) {
+        // frames may have been appended in the meantime
+        mspRxBuffer.len -= pos;
+        memmove(mspRxBuffer.bytes, mspRxBuffer.bytes + pos, mspRxBuffer.len);
+        framesLeft = mspRxBuffer.len > 0;
+    }
+    return framesLeft;
 }
 #endif
 
@@ -187,6 +205,19 @@ void crsfFrameGps(sbuf_t *dst)
     sbufWriteU8(dst, gpsSol.numSat);
 }
 
+/*
+0x07 Vario sensor
+Payload:
+int16_t     Vertical speed ( cm/s )
+*/
+void crsfFrameVarioSensor(sbuf_t *dst)
+{
+    // use sbufWrite since CRC does not include frame length
+    sbufWriteU8(dst, CRSF_FRAME_VARIO_SENSOR_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
+    sbufWriteU8(dst, CRSF_FRAMETYPE_VARIO_SENSOR);
+    sbufWriteU16BigEndian(dst, getEstimatedVario());
+}
+
 /*
 0x08 Battery sensor
 Payload:
@@ -245,6 +276,7 @@ void crsfFrameAttitude(sbuf_t *dst)
 {
      sbufWriteU8(dst, CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC);
      sbufWriteU8(dst, CRSF_FRAMETYPE_ATTITUDE);
+     imuRefreshEulerAngles();
      sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.pitch));
      sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.roll));
      sbufWriteU16BigEndian(dst, DECIDEGREES_TO_RADIANS10000(attitude.values.yaw));
@@ -342,20 +374,14 @@ static void crsfFrameDisplayPortClear(sbuf_t *dst)
 
 #endif
 
-#define BV(x)  (1 << (x)) // bit value
-
-// schedule array to decide how often each type of frame is sent
-typedef enum {
-    CRSF_FRAME_START_INDEX = 0,
-    CRSF_FRAME_ATTITUDE_INDEX = CRSF_FRAME_START_INDEX,
-    CRSF_FRAME_BATTERY_SENSOR_INDEX,
-    CRSF_FRAME_FLIGHT_MODE_INDEX,
-    CRSF_FRAME_GPS_INDEX,
-    CRSF_SCHEDULE_COUNT_MAX
-} crsfFrameTypeIndex_e;
+// the telemetry frame types sent, scheduled by how often each one needs refreshing
+#define CRSF_SENSOR_COUNT_MAX 5
+#define CRSF_FRAME_SIZE(payloadSize) (CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH + CRSF_FRAME_LENGTH_TYPE_CRC + (payloadSize))
+#define CRSF_FLIGHT_MODE_PAYLOAD_SIZE_MAX 5 // longest flight mode text plus its terminator
 
-static uint8_t crsfScheduleCount;
-static uint8_t crsfSchedule[CRSF_SCHEDULE_COUNT_MAX];
+static telemetrySensor_t crsfSensors[CRSF_SENSOR_COUNT_MAX];
+static telemetryScheduler_t crsfScheduler;
+static uint32_t crsfTelemetryBudget;
 
 #if defined(USE_MSP_OVER_TELEMETRY)
 
@@ -366,8 +392,9 @@ void crsfScheduleMspResponse(void)
     mspReplyPending = true;
 }
 
-void crsfSendMspResponse(uint8_t *payload)
+static void crsfSendMspReplyChunk(void)
 {
+    crsfMspReply_t *reply = &mspReplies[mspReplyHead];
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
@@ -376,44 +403,81 @@ void crsfSendMspResponse(uint8_t *payload)
     sbufWriteU8(dst, CRSF_FRAMETYPE_MSP_RESP);
     sbufWriteU8(dst, CRSF_ADDRESS_RADIO_TRANSMITTER);
     sbufWriteU8(dst, CRSF_ADDRESS_FLIGHT_CONTROLLER);
-    sbufWriteData(dst, payload, CRSF_FRAME_TX_MSP_FRAME_SIZE);
+
+    sbuf_t chunkBuf;
+    sbuf_t *chunk = sbufInit(&chunkBuf, sbufPtr(dst), sbufPtr(dst) + CRSF_FRAME_TX_MSP_FRAME_SIZE);
+    if (!writeMspReplyChunk(chunk, &reply->packet, reply->buffer)) {
+        mspReplyHead = (mspReplyHead + 1) % CRSF_MSP_REPLY_WINDOW;
+        mspReplyCount--;
+    }
+    sbufAdvance(dst, CRSF_FRAME_TX_MSP_FRAME_SIZE);
     crsfFinalize(dst);
 }
+
+// The link gives one reply slot per frame received, an idle link does not
+// save up more slots than there are replies in the window.
+static bool crsfMspReplySlotAvailable(void)
+{
+    const uint8_t linkFrameCount = crsfRxLinkFrameCount();
+    const uint8_t slots = linkFrameCount - mspLinkFrameCount;
+    if (slots == 0) {
+        return false;
+    }
+    if (slots > CRSF_MSP_REPLY_WINDOW) {
+        mspLinkFrameCount = linkFrameCount - CRSF_MSP_REPLY_WINDOW;
+    }
+    mspLinkFrameCount++;
+    return true;
+}
 #endif
 
-static void processCrsf(void)
+static int32_t crsfSensorValue(uint16_t frameType)
 {
-    static uint8_t crsfScheduleIndex = 0;
+    switch (frameType) {
+    case CRSF_FRAMETYPE_VARIO_SENSOR:
+        return getEstimatedVario();
+    case CRSF_FRAMETYPE_BATTERY_SENSOR:
+        return getBatteryVoltage();
+    case CRSF_FRAMETYPE_FLIGHT_MODE:
+        return (flightModeFlags << 1) | isAirmodeActive();
+    default:
+        return 0;
+    }
+}
 
-    const uint8_t currentSchedule = crsfSchedule[crsfScheduleIndex];
+static void processCrsf(timeUs_t currentTimeUs)
+{
+    telemetrySensor_t *sensor = telemetrySchedulerNext(&crsfScheduler, currentTimeUs, crsfTelemetryBudget, false);
+    if (!sensor) {
+        return;
+    }
+    telemetrySchedulerSent(&crsfScheduler, sensor, currentTimeUs);
+    crsfTelemetryBudget -= sensor->size;
 
     sbuf_t crsfPayloadBuf;
     sbuf_t *dst = &crsfPayloadBuf;
 
-    if (currentSchedule & BV(CRSF_FRAME_ATTITUDE_INDEX)) {
-        crsfInitializeFrame(dst);
+    crsfInitializeFrame(dst);
+    switch (sensor->id) {
+    case CRSF_FRAMETYPE_ATTITUDE:
         crsfFrameAttitude(dst);
-        crsfFinalize(dst);
-    }
-    if (currentSchedule & BV(CRSF_FRAME_BATTERY_SENSOR_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAMETYPE_VARIO_SENSOR:
+        crsfFrameVarioSensor(dst);
+        break;
+    case CRSF_FRAMETYPE_BATTERY_SENSOR:
         crsfFrameBatterySensor(dst);
-        crsfFinalize(dst);
-    }
-
-    if (currentSchedule & BV(CRSF_FRAME_FLIGHT_MODE_INDEX)) {
-        crsfInitializeFrame(dst);
+        break;
+    case CRSF_FRAMETYPE_FLIGHT_MODE:
         crsfFrameFlightMode(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #ifdef USE_GPS
-    if (currentSchedule & BV(CRSF_FRAME_GPS_INDEX)) {
-        crsfInitializeFrame(dst);
+    case CRSF_FRAMETYPE_GPS:
         crsfFrameGps(dst);
-        crsfFinalize(dst);
-    }
+        break;
 #endif
-    crsfScheduleIndex = (crsfScheduleIndex + 1) % crsfScheduleCount;
+    }
+    crsfFinalize(dst);
 }
 
 void crsfScheduleDeviceInfoResponse(void)
@@ -435,26 +499,33 @@ void initCrsfTelemetry(void)
     deviceInfoReplyPending = false;
 #if defined(USE_MSP_OVER_TELEMETRY)
     mspReplyPending = false;
+    mspReplyHead = 0;
+    mspReplyCount = 0;
+    mspLinkFrameCount = crsfRxLinkFrameCount();
 #endif
 
 #if defined(USE_CMS) && defined(USE_CRSF_CMS_TELEMETRY)
     cmsDisplayPortRegister(displayPortCrsfInit());
 #endif
 
-    int index = 0;
+    telemetrySchedulerInit(&crsfScheduler, crsfSensors, CRSF_SENSOR_COUNT_MAX, crsfSensorValue);
     if (sensors(SENSOR_ACC)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_ATTITUDE_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, CRSF_FRAME_SIZE(CRSF_FRAME_ATTITUDE_PAYLOAD_SIZE));
+    }
+    if (sensors(SENSOR_BARO)) {
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_VARIO_SENSOR, TELEMETRY_SENSOR_VARIO, CRSF_FRAME_SIZE(CRSF_FRAME_VARIO_SENSOR_PAYLOAD_SIZE));
     }
     if (isBatteryVoltageConfigured() || isAmperageConfigured()) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_BATTERY_SENSOR_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_BATTERY_SENSOR, TELEMETRY_SENSOR_BATTERY, CRSF_FRAME_SIZE(CRSF_FRAME_BATTERY_SENSOR_PAYLOAD_SIZE));
     }
-    crsfSchedule[index++] = BV(CRSF_FRAME_FLIGHT_MODE_INDEX);
+    telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_FLIGHT_MODE, TELEMETRY_SENSOR_FLIGHT_MODE, CRSF_FRAME_SIZE(CRSF_FLIGHT_MODE_PAYLOAD_SIZE_MAX));
+#ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        crsfSchedule[index++] = BV(CRSF_FRAME_GPS_INDEX);
+        telemetrySchedulerAdd(&crsfScheduler, CRSF_FRAMETYPE_GPS, TELEMETRY_SENSOR_GPS, CRSF_FRAME_SIZE(CRSF_FRAME_GPS_PAYLOAD_SIZE));
     }
-    crsfScheduleCount = (uint8_t)index;
-
- }
+#endif
+    crsfTelemetryBudget = 0;
+}
 
 bool checkCrsfTelemetryState(void)
 {
@@ -504,7 +575,10 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     // Send ad-hoc response frames as soon as possible
 #if defined(USE_MSP_OVER_TELEMETRY)
     if (mspReplyPending) {
-        mspReplyPending = handleCrsfMspFrameBuffer(CRSF_FRAME_TX_MSP_FRAME_SIZE, &crsfSendMspResponse);
+        mspReplyPending = processCrsfMspRequests();
+    }
+    if (mspReplyCount && crsfMspReplySlotAvailable()) {
+        crsfSendMspReplyChunk();
         crsfLastCycleTime = currentTimeUs; // reset telemetry timing due to ad-hoc request
         return;
     }
@@ -545,12 +619,19 @@ void handleCrsfTelemetry(timeUs_t currentTimeUs)
     }
 #endif
 
-    // Actual telemetry data only needs to be sent at a low frequency, ie 10Hz
-    // Spread out scheduled frames evenly so each frame is sent at the same frequency.
-    if (currentTimeUs >= crsfLastCycleTime + (CRSF_CYCLETIME_US / crsfScheduleCount)) {
+    // The link carries a limited number of telemetry bytes per second, the scheduler
+    // spends them on whichever frame is due, fast changing values first.
+    const uint32_t elapsedUs = constrain(cmpTimeUs(currentTimeUs, crsfLastCycleTime), 0, 1000000);
+    const uint32_t earnedBytes = elapsedUs * CRSF_TELEMETRY_BYTES_PER_SECOND / 1000000;
+    crsfTelemetryBudget += earnedBytes;
+    if (crsfTelemetryBudget >= CRSF_FRAME_SIZE_MAX) {
+        // an idle link does not save up more than one frame
+        crsfTelemetryBudget = CRSF_FRAME_SIZE_MAX;
         crsfLastCycleTime = currentTimeUs;
-        processCrsf();
+    } else {
+        crsfLastCycleTime += earnedBytes * 1000000 / CRSF_TELEMETRY_BYTES_PER_SECOND;
     }
+    processCrsf(currentTimeUs);
 }
 
 int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
@@ -564,6 +645,9 @@ int getCrsfFrame(uint8_t *frame, crsfFrameType_e frameType)
     case CRSF_FRAMETYPE_ATTITUDE:
         crsfFrameAttitude(sbuf);
         break;
+    case CRSF_FRAMETYPE_VARIO_SENSOR:
+        crsfFrameVarioSensor(sbuf);
+        break;
     case CRSF_FRAMETYPE_BATTERY_SENSOR:
         crsfFrameBatterySensor(sbuf);
         break;
@@ -453,6 +453,7 @@ static void sendFakeLatLongThatAllowsHeadingDisplay(void)
 
 static void sendHeading(void)
 {
+    imuRefreshEulerAngles();
     frSkyHubWriteFrame(ID_COURSE_BP, DECIDEGREES_TO_DEGREES(attitude.values.yaw));
     frSkyHubWriteFrame(ID_COURSE_AP, 0);
 }
@@ -86,16 +86,15 @@
 
 #include "telemetry/hott.h"
 #include "telemetry/telemetry.h"
+#include "telemetry/telemetry_scheduler.h"
 
 //#define HOTT_DEBUG
 
-#define HOTT_MESSAGE_PREPARATION_FREQUENCY_5_HZ ((1000 * 1000) / 5)
 #define HOTT_RX_SCHEDULE 4000
 #define HOTT_TX_DELAY_US 3000
 #define MILLISECONDS_IN_A_SECOND 1000
 
 static uint32_t lastHoTTRequestCheckAt = 0;
-static uint32_t lastMessagesPreparedAt = 0;
 static uint32_t lastHottAlarmSoundTime = 0;
 
 static bool hottIsSending = false;
@@ -118,6 +117,21 @@ static portSharing_e hottPortSharing;
 static HOTT_GPS_MSG_t hottGPSMessage;
 static HOTT_EAM_MSG_t hottEAMMessage;
 
+// groups of message fields, refreshed at the rate of the values they carry
+typedef enum {
+    HOTT_FIELDS_EAM_BATTERY = 0,
+    HOTT_FIELDS_EAM_ALTITUDE,
+    HOTT_FIELDS_EAM_CLIMBRATE,
+    HOTT_FIELDS_GPS,
+    HOTT_FIELDS_COUNT
+} hottFields_e;
+
+// the messages sit in memory until requested, refreshing a field costs no link time
+#define HOTT_FIELDS_BUDGET 1
+
+static telemetrySensor_t hottSensors[HOTT_FIELDS_COUNT];
+static telemetryScheduler_t hottScheduler;
+
 static void initialiseEAMMessage(HOTT_EAM_MSG_t *msg, size_t size)
 {
     memset(msg, 0, size);
@@ -280,7 +294,7 @@ static inline void hottEAMUpdateClimbrate(HOTT_EAM_MSG_t *hottEAMMessage)
     hottEAMMessage->climbrate3s = 120 + (vario / 100);
 }
 
-void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
+static void hottEAMUpdateBatteryFields(HOTT_EAM_MSG_t *hottEAMMessage)
 {
     // Reset alarms
     hottEAMMessage->warning_beeps = 0x0;
@@ -289,10 +303,40 @@ void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
     hottEAMUpdateBattery(hottEAMMessage);
     hottEAMUpdateCurrentMeter(hottEAMMessage);
     hottEAMUpdateBatteryDrawnCapacity(hottEAMMessage);
+}
+
+void hottPrepareEAMResponse(HOTT_EAM_MSG_t *hottEAMMessage)
+{
+    hottEAMUpdateBatteryFields(hottEAMMessage);
     hottEAMUpdateAltitude(hottEAMMessage);
     hottEAMUpdateClimbrate(hottEAMMessage);
 }
 
+static int32_t hottFieldsValue(uint16_t fields)
+{
+    switch (fields) {
+    case HOTT_FIELDS_EAM_BATTERY:
+        return getBatteryVoltage();
+    case HOTT_FIELDS_EAM_ALTITUDE:
+        return getEstimatedAltitude();
+    case HOTT_FIELDS_EAM_CLIMBRATE:
+        return getEstimatedVario();
+    default:
+        return 0;
+    }
+}
+
+static void initialiseScheduler(void)
+{
+    telemetrySchedulerInit(&hottScheduler, hottSensors, HOTT_FIELDS_COUNT, hottFieldsValue);
+    telemetrySchedulerAdd(&hottScheduler, HOTT_FIELDS_EAM_BATTERY, TELEMETRY_SENSOR_BATTERY, HOTT_FIELDS_BUDGET);
+    telemetrySchedulerAdd(&hottScheduler, HOTT_FIELDS_EAM_ALTITUDE, TELEMETRY_SENSOR_ALTITUDE, HOTT_FIELDS_BUDGET);
+    telemetrySchedulerAdd(&hottScheduler, HOTT_FIELDS_EAM_CLIMBRATE, TELEMETRY_SENSOR_VARIO, HOTT_FIELDS_BUDGET);
+#ifdef USE_GPS
+    telemetrySchedulerAdd(&hottScheduler, HOTT_FIELDS_GPS, TELEMETRY_SENSOR_GPS, HOTT_FIELDS_BUDGET);
+#endif
+}
+
 static void hottSerialWrite(uint8_t c)
 {
     static uint8_t serialWrites = 0;
@@ -318,6 +362,7 @@ void initHoTTTelemetry(void)
     hottPortSharing = determinePortSharing(portConfig, FUNCTION_TELEMETRY_HOTT);
 
     initialiseMessages();
+    initialiseScheduler();
 }
 
 static void flushHottRxBuffer(void)
@@ -413,11 +458,28 @@ static inline void hottSendEAMResponse(void)
     hottSendResponse((uint8_t *)&hottEAMMessage, sizeof(hottEAMMessage));
 }
 
-static void hottPrepareMessages(void) {
-    hottPrepareEAMResponse(&hottEAMMessage);
+static void hottPrepareMessages(timeUs_t currentTimeUs)
+{
+    telemetrySensor_t *fields;
+    while ((fields = telemetrySchedulerNext(&hottScheduler, currentTimeUs, HOTT_FIELDS_BUDGET, false))) {
+        switch (fields->id) {
+        case HOTT_FIELDS_EAM_BATTERY:
+            hottEAMUpdateBatteryFields(&hottEAMMessage);
+            break;
+        case HOTT_FIELDS_EAM_ALTITUDE:
+            hottEAMUpdateAltitude(&hottEAMMessage);
+            break;
+        case HOTT_FIELDS_EAM_CLIMBRATE:
+            hottEAMUpdateClimbrate(&hottEAMMessage);
+            break;
 #ifdef USE_GPS
-    hottPrepareGPSResponse(&hottGPSMessage);
+        case HOTT_FIELDS_GPS:
+            hottPrepareGPSResponse(&hottGPSMessage);
+            break;
 #endif
+        }
+        telemetrySchedulerSent(&hottScheduler, fields, currentTimeUs);
+    }
 }
 
 static void processBinaryModeRequest(uint8_t address)
@@ -524,11 +586,6 @@ static void hottSendTelemetryData(void) {
     hottSerialWrite(*hottMsg++);
 }
 
-static inline bool shouldPrepareHoTTMessages(uint32_t currentMicros)
-{
-    return currentMicros - lastMessagesPreparedAt >= HOTT_MESSAGE_PREPARATION_FREQUENCY_5_HZ;
-}
-
 static inline bool shouldCheckForHoTTRequest(void)
 {
     if (hottIsSending) {
@@ -560,9 +617,9 @@ void handleHoTTTelemetry(timeUs_t currentTimeUs)
         return;
     }
 
-    if (shouldPrepareHoTTMessages(currentTimeUs)) {
-        hottPrepareMessages();
-        lastMessagesPreparedAt = currentTimeUs;
+    // a message being sent is left alone so its multi byte values stay consistent
+    if (!hottIsSending) {
+        hottPrepareMessages(currentTimeUs);
     }
 
     if (shouldCheckForHoTTRequest()) {
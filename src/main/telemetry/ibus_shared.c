@@ -407,6 +407,7 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
         case IBUS_SENSOR_TYPE_ROLL:
         case IBUS_SENSOR_TYPE_PITCH:
         case IBUS_SENSOR_TYPE_YAW:
+            imuRefreshEulerAngles();
             value.int16 = attitude.raw[sensorType - IBUS_SENSOR_TYPE_ROLL] *10;
             break;
         case IBUS_SENSOR_TYPE_ARMED:
@@ -414,6 +415,7 @@ static void setValue(uint8_t* bufferPtr, uint8_t sensorType, uint8_t length)
             break;
 #if defined(USE_TELEMETRY_IBUS_EXTENDED)
         case IBUS_SENSOR_TYPE_CMP_HEAD:
+            imuRefreshEulerAngles();
             value.uint16 = DECIDEGREES_TO_DEGREES(attitude.values.yaw);
             break;
         case IBUS_SENSOR_TYPE_VERTICAL_SPEED:
@@ -247,14 +247,17 @@ int32_t getSensorValue(uint8_t sensor)
         break;
 
     case EX_ROLL_ANGLE:
+        imuRefreshEulerAngles();
         return attitude.values.roll;
         break;
 
     case EX_PITCH_ANGLE:
+        imuRefreshEulerAngles();
         return attitude.values.pitch;
         break;
 
     case EX_HEADING:
+        imuRefreshEulerAngles();
         return attitude.values.yaw;
         break;
 
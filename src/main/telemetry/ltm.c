@@ -209,6 +209,7 @@ static void ltm_sframe(void)
 static void ltm_aframe(void)
 {
     ltm_initialise_packet('A');
+    imuRefreshEulerAngles();
     ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.pitch));
     ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.roll));
     ltm_serialise_16(DECIDEGREES_TO_DEGREES(attitude.values.yaw));
@@ -289,6 +289,7 @@ void mavlinkSendRCChannelsAndRSSI(void)
 #if defined(USE_GPS)
 void mavlinkSendPosition(void)
 {
+    imuRefreshEulerAngles();
     uint16_t msgLength;
     uint8_t gpsFixType = 0;
 
@@ -373,6 +374,7 @@ void mavlinkSendPosition(void)
 
 void mavlinkSendAttitude(void)
 {
+    imuRefreshEulerAngles();
     uint16_t msgLength;
     mavlink_msg_attitude_pack(0, 200, &mavMsg,
         // time_boot_ms Timestamp (milliseconds since system boot)
@@ -395,6 +397,7 @@ void mavlinkSendAttitude(void)
 
 void mavlinkSendHUDAndHeartbeat(void)
 {
+    imuRefreshEulerAngles();
     uint16_t msgLength;
     float mavAltitude = 0;
     float mavGroundSpeed = 0;
@@ -73,43 +73,47 @@ void initSharedMsp(void)
     mspPackage.responsePacket->buf.end = mspPackage.responseBuffer;
 }
 
-static void processMspPacket(void)
+static uint8_t mspStarted = 0;
+static uint8_t lastSeq = 0;
+static uint8_t replySeq = 0;
+
+static void processMspPacket(mspPacket_t *reply, uint8_t *replyBuffer, int replyBufferSize)
 {
-    mspPackage.responsePacket->cmd = 0;
-    mspPackage.responsePacket->result = 0;
-    mspPackage.responsePacket->buf.end = mspPackage.responseBuffer;
+    reply->cmd = 0;
+    reply->result = 0;
+    reply->buf.ptr = replyBuffer;
+    reply->buf.end = replyBuffer + replyBufferSize;
 
     mspPostProcessFnPtr mspPostProcessFn = NULL;
-    if (mspFcProcessCommand(mspPackage.requestPacket, mspPackage.responsePacket, &mspPostProcessFn) == MSP_RESULT_ERROR) {
-        sbufWriteU8(&mspPackage.responsePacket->buf, TELEMETRY_MSP_ERROR);
+    if (mspFcProcessCommand(mspPackage.requestPacket, reply, &mspPostProcessFn) == MSP_RESULT_ERROR) {
+        sbufWriteU8(&reply->buf, TELEMETRY_MSP_ERROR);
     }
     if (mspPostProcessFn) {
         mspPostProcessFn(NULL);
     }
 
-    sbufSwitchToReader(&mspPackage.responsePacket->buf, mspPackage.responseBuffer);
+    sbufSwitchToReader(&reply->buf, replyBuffer);
 }
 
-void sendMspErrorResponse(uint8_t error, int16_t cmd)
+static void writeMspErrorResponse(mspPacket_t *reply, uint8_t *replyBuffer, uint8_t error, int16_t cmd)
 {
-    mspPackage.responsePacket->cmd = cmd;
-    mspPackage.responsePacket->result = 0;
-    mspPackage.responsePacket->buf.end = mspPackage.responseBuffer;
+    reply->cmd = cmd;
+    reply->buf.ptr = replyBuffer;
 
-    sbufWriteU8(&mspPackage.responsePacket->buf, error);
-    mspPackage.responsePacket->result = TELEMETRY_MSP_RES_ERROR;
-    sbufSwitchToReader(&mspPackage.responsePacket->buf, mspPackage.responseBuffer);
+    sbufWriteU8(&reply->buf, error);
+    reply->result = TELEMETRY_MSP_RES_ERROR;
+    sbufSwitchToReader(&reply->buf, replyBuffer);
 }
 
-bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse)
+void sendMspErrorResponse(uint8_t error, int16_t cmd)
 {
-    static uint8_t mspStarted = 0;
-    static uint8_t lastSeq = 0;
-
-    if (sbufBytesRemaining(&mspPackage.responsePacket->buf) > 0) {
-        mspStarted = 0;
-    }
+    writeMspErrorResponse(mspPackage.responsePacket, mspPackage.responseBuffer, error, cmd);
+}
 
+// Collects the frames of a request, once it is complete it is processed and
+// its reply written to the given packet. Returns true when a reply is ready.
+static bool receiveMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse, mspPacket_t *reply, uint8_t *replyBuffer, int replyBufferSize)
+{
     if (mspStarted == 0) {
         initSharedMsp();
     }
@@ -122,7 +126,7 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
     const uint8_t version = (header & TELEMETRY_MSP_VER_MASK) >> TELEMETRY_MSP_VER_SHIFT;
 
     if (version != TELEMETRY_MSP_VERSION) {
-        sendMspErrorResponse(TELEMETRY_MSP_VER_MISMATCH, 0);
+        writeMspErrorResponse(reply, replyBuffer, TELEMETRY_MSP_VER_MISMATCH, 0);
         return true;
     }
 
@@ -148,19 +152,15 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
 
     const uint8_t bufferBytesRemaining = sbufBytesRemaining(rxBuf);
     const uint8_t frameBytesRemaining = sbufBytesRemaining(frameBuf);
-    uint8_t payload[frameBytesRemaining];
 
     if (bufferBytesRemaining >= frameBytesRemaining) {
-        sbufReadData(frameBuf, payload, frameBytesRemaining);
-        sbufAdvance(frameBuf, frameBytesRemaining);
-        sbufWriteData(rxBuf, payload, frameBytesRemaining);
+        sbufWriteData(rxBuf, sbufPtr(frameBuf), frameBytesRemaining);
         lastSeq = seqNumber;
 
         return false;
     } else {
-        sbufReadData(frameBuf, payload, bufferBytesRemaining);
+        sbufWriteData(rxBuf, sbufPtr(frameBuf), bufferBytesRemaining);
         sbufAdvance(frameBuf, bufferBytesRemaining);
-        sbufWriteData(rxBuf, payload, bufferBytesRemaining);
         sbufSwitchToReader(rxBuf, mspPackage.requestBuffer);
         while (sbufBytesRemaining(rxBuf)) {
             checksum ^= sbufReadU8(rxBuf);
@@ -168,7 +168,7 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
 
         if (checksum != *frameBuf->ptr) {
             mspStarted = 0;
-            sendMspErrorResponse(TELEMETRY_MSP_CRC_ERROR, packet->cmd);
+            writeMspErrorResponse(reply, replyBuffer, TELEMETRY_MSP_CRC_ERROR, packet->cmd);
             return true;
         }
     }
@@ -177,75 +177,86 @@ bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeRe
     if (packet->cmd == MSP_EEPROM_WRITE && skipsBeforeResponse) {
         *skipsBeforeResponse = TELEMETRY_REQUEST_SKIPS_AFTER_EEPROMWRITE;
     }
-    
+
     mspStarted = 0;
     sbufSwitchToReader(rxBuf, mspPackage.requestBuffer);
-    processMspPacket();
+    processMspPacket(reply, replyBuffer, replyBufferSize);
     return true;
 }
 
-bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse)
 {
-    static uint8_t checksum = 0;
-    static uint8_t seq = 0;
+    // a new request abandons the reply still being sent
+    if (sbufBytesRemaining(&mspPackage.responsePacket->buf) > 0) {
+        mspStarted = 0;
+    }
 
-    uint8_t payloadOut[payloadSize];
-    sbuf_t payload;
-    sbuf_t *payloadBuf = sbufInit(&payload, payloadOut, payloadOut + payloadSize);
-    sbuf_t *txBuf = &mspPackage.responsePacket->buf;
+    return receiveMspFrame(frameStart, frameLength, skipsBeforeResponse, mspPackage.responsePacket, mspPackage.responseBuffer, sizeof(mspTxBuffer));
+}
+
+bool handleMspFrameWithReply(uint8_t *frameStart, int frameLength, mspPacket_t *reply, uint8_t *replyBuffer, int replyBufferSize)
+{
+    return receiveMspFrame(frameStart, frameLength, NULL, reply, replyBuffer, replyBufferSize);
+}
+
+bool writeMspReplyChunk(sbuf_t *dst, mspPacket_t *reply, uint8_t *replyBuffer)
+{
+    sbuf_t *txBuf = &reply->buf;
 
     // detect first reply packet
-    if (txBuf->ptr == mspPackage.responseBuffer) {
+    if (txBuf->ptr == replyBuffer) {
 
         // header
-        uint8_t head = TELEMETRY_MSP_START_FLAG | (seq++ & TELEMETRY_MSP_SEQ_MASK);
-        if (mspPackage.responsePacket->result < 0) {
+        uint8_t head = TELEMETRY_MSP_START_FLAG | (replySeq++ & TELEMETRY_MSP_SEQ_MASK);
+        if (reply->result < 0) {
             head |= TELEMETRY_MSP_ERROR_FLAG;
         }
-        sbufWriteU8(payloadBuf, head);
+        sbufWriteU8(dst, head);
 
         uint8_t size = sbufBytesRemaining(txBuf);
-        sbufWriteU8(payloadBuf, size);
+        sbufWriteU8(dst, size);
     } else {
         // header
-        sbufWriteU8(payloadBuf, (seq++ & TELEMETRY_MSP_SEQ_MASK));
+        sbufWriteU8(dst, (replySeq++ & TELEMETRY_MSP_SEQ_MASK));
     }
 
     const uint8_t bufferBytesRemaining = sbufBytesRemaining(txBuf);
-    const uint8_t payloadBytesRemaining = sbufBytesRemaining(payloadBuf);
-    uint8_t frame[payloadBytesRemaining];
+    const uint8_t payloadBytesRemaining = sbufBytesRemaining(dst);
 
     if (bufferBytesRemaining >= payloadBytesRemaining) {
-
-        sbufReadData(txBuf, frame, payloadBytesRemaining);
+        sbufWriteData(dst, sbufPtr(txBuf), payloadBytesRemaining);
         sbufAdvance(txBuf, payloadBytesRemaining);
-        sbufWriteData(payloadBuf, frame, payloadBytesRemaining);
-        responseFn(payloadOut);
 
         return true;
+    }
 
-    } else {
-
-        sbufReadData(txBuf, frame, bufferBytesRemaining);
-        sbufAdvance(txBuf, bufferBytesRemaining);
-        sbufWriteData(payloadBuf, frame, bufferBytesRemaining);
-        sbufSwitchToReader(txBuf, mspPackage.responseBuffer);
+    sbufWriteData(dst, sbufPtr(txBuf), bufferBytesRemaining);
+    sbufAdvance(txBuf, bufferBytesRemaining);
+    sbufSwitchToReader(txBuf, replyBuffer);
 
-        checksum = sbufBytesRemaining(txBuf) ^ mspPackage.responsePacket->cmd;
+    uint8_t replyChecksum = sbufBytesRemaining(txBuf) ^ reply->cmd;
+    while (sbufBytesRemaining(txBuf)) {
+        replyChecksum ^= sbufReadU8(txBuf);
+    }
+    sbufWriteU8(dst, replyChecksum);
 
-        while (sbufBytesRemaining(txBuf)) {
-            checksum ^= sbufReadU8(txBuf);
-        }
-        sbufWriteU8(payloadBuf, checksum);
+    while (sbufBytesRemaining(dst)) {
+        sbufWriteU8(dst, 0);
+    }
 
-        while (sbufBytesRemaining(payloadBuf)>1) {
-            sbufWriteU8(payloadBuf, 0);
-        }
+    return false;
+}
 
-    }
+bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn)
+{
+    uint8_t payloadOut[payloadSize];
+    sbuf_t payload;
+    sbuf_t *payloadBuf = sbufInit(&payload, payloadOut, payloadOut + payloadSize);
 
+    const bool replyPending = writeMspReplyChunk(payloadBuf, mspPackage.responsePacket, mspPackage.responseBuffer);
     responseFn(payloadOut);
-    return false;
+
+    return replyPending;
 }
 
 #endif
@@ -48,3 +48,5 @@ typedef union mspTxBuffer_u {
 void initSharedMsp(void);
 bool handleMspFrame(uint8_t *frameStart, int frameLength, uint8_t *skipsBeforeResponse);
 bool sendMspReply(uint8_t payloadSize, mspResponseFnPtr responseFn);
+bool handleMspFrameWithReply(uint8_t *frameStart, int frameLength, struct mspPacket_s *reply, uint8_t *replyBuffer, int replyBufferSize);
+bool writeMspReplyChunk(sbuf_t *dst, struct mspPacket_s *reply, uint8_t *replyBuffer);
@@ -79,6 +79,7 @@
 #include "telemetry/telemetry.h"
 #include "telemetry/smartport.h"
 #include "telemetry/msp_shared.h"
+#include "telemetry/telemetry_scheduler.h"
 
 #define SMARTPORT_MIN_TELEMETRY_RESPONSE_DELAY_US 500
 
@@ -147,32 +148,28 @@ enum
 // if adding more sensors then increase this value
 #define MAX_DATAIDS 17
 
-static uint16_t frSkyDataIdTable[MAX_DATAIDS];
-
 #ifdef USE_ESC_SENSOR
-// number of sensors to send between sending the ESC sensors
-#define ESC_SENSOR_PERIOD 7
+// the combined ESC values followed by one set per motor
+#define MAX_ESC_DATAID_SETS 9
 
-static uint16_t frSkyEscDataIdTable[] = {
+static const uint16_t frSkyEscDataIdTable[] = {
     FSSP_DATAID_CURRENT   ,
     FSSP_DATAID_RPM       ,
     FSSP_DATAID_VFAS      ,
     FSSP_DATAID_TEMP
 };
-#endif
 
-typedef struct frSkyTableInfo_s {
-    uint16_t * table;
-    uint8_t size;
-    uint8_t index;
-} frSkyTableInfo_t;
+#define ESC_DATAID_COUNT ARRAYLEN(frSkyEscDataIdTable)
+#define MAX_SENSORS (MAX_DATAIDS + ESC_DATAID_COUNT * MAX_ESC_DATAID_SETS)
+#else
+#define MAX_SENSORS MAX_DATAIDS
+#endif
 
-static frSkyTableInfo_t frSkyDataIdTableInfo = { frSkyDataIdTable, 0, 0 };
-#ifdef USE_ESC_SENSOR
-#define ESC_DATAID_COUNT ( sizeof(frSkyEscDataIdTable) / sizeof(uint16_t) )
+// every poll of our sensor id carries exactly one frame
+#define SMARTPORT_FRAME_BUDGET 1
 
-static frSkyTableInfo_t frSkyEscDataIdTableInfo = {frSkyEscDataIdTable, ESC_DATAID_COUNT, 0};
-#endif
+static telemetrySensor_t smartPortSensors[MAX_SENSORS];
+static telemetryScheduler_t smartPortScheduler;
 
 #define SMARTPORT_BAUD 57600
 #define SMARTPORT_UART_MODE MODE_RXTX
@@ -322,24 +319,52 @@ static bool reportExtendedEscSensors(void) {
 }
 #endif
 
-#define ADD_SENSOR(dataId) frSkyDataIdTableInfo.table[frSkyDataIdTableInfo.index++] = dataId
+static int32_t smartPortSensorValue(uint16_t id)
+{
+    switch (id) {
+    case FSSP_DATAID_VFAS:
+    case FSSP_DATAID_A4:
+        return getBatteryVoltage();
+    case FSSP_DATAID_CURRENT:
+        return getAmperage() / 100;
+    case FSSP_DATAID_FUEL:
+        return getMAhDrawn() / 10;
+    case FSSP_DATAID_HEADING:
+        imuRefreshEulerAngles();
+        return attitude.values.yaw;
+    case FSSP_DATAID_ALTITUDE:
+        return getEstimatedAltitude();
+    case FSSP_DATAID_VARIO:
+        return getEstimatedVario();
+    case FSSP_DATAID_T1:
+        return flightModeFlags | (armingFlags << 16);
+#ifdef USE_GPS
+    case FSSP_DATAID_T2:
+        return gpsSol.numSat | (stateFlags << 8);
+#endif
+    default:
+        return 0;
+    }
+}
+
+#define ADD_SENSOR(dataId, sensorClass) telemetrySchedulerAdd(&smartPortScheduler, dataId, sensorClass, SMARTPORT_FRAME_BUDGET)
 
 static void initSmartPortSensors(void)
 {
-    frSkyDataIdTableInfo.index = 0;
+    telemetrySchedulerInit(&smartPortScheduler, smartPortSensors, ARRAYLEN(smartPortSensors), smartPortSensorValue);
 
-    ADD_SENSOR(FSSP_DATAID_T1);
-    ADD_SENSOR(FSSP_DATAID_T2);
+    ADD_SENSOR(FSSP_DATAID_T1, TELEMETRY_SENSOR_STATUS);
+    ADD_SENSOR(FSSP_DATAID_T2, TELEMETRY_SENSOR_STATUS);
 
     if (isBatteryVoltageConfigured()) {
 #ifdef USE_ESC_SENSOR
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_VFAS);
+            ADD_SENSOR(FSSP_DATAID_VFAS, TELEMETRY_SENSOR_BATTERY);
         }
 
-        ADD_SENSOR(FSSP_DATAID_A4);
+        ADD_SENSOR(FSSP_DATAID_A4, TELEMETRY_SENSOR_BATTERY);
     }
 
     if (isAmperageConfigured()) {
@@ -347,42 +372,43 @@ static void initSmartPortSensors(void)
         if (!reportExtendedEscSensors())
 #endif
         {
-            ADD_SENSOR(FSSP_DATAID_CURRENT);
+            ADD_SENSOR(FSSP_DATAID_CURRENT, TELEMETRY_SENSOR_BATTERY);
         }
 
-        ADD_SENSOR(FSSP_DATAID_FUEL);
+        ADD_SENSOR(FSSP_DATAID_FUEL, TELEMETRY_SENSOR_BATTERY);
     }
 
     if (sensors(SENSOR_ACC)) {
-        ADD_SENSOR(FSSP_DATAID_HEADING);
-        ADD_SENSOR(FSSP_DATAID_ACCX);
-        ADD_SENSOR(FSSP_DATAID_ACCY);
-        ADD_SENSOR(FSSP_DATAID_ACCZ);
+        ADD_SENSOR(FSSP_DATAID_HEADING, TELEMETRY_SENSOR_ATTITUDE);
+        ADD_SENSOR(FSSP_DATAID_ACCX, TELEMETRY_SENSOR_ACCELERATION);
+        ADD_SENSOR(FSSP_DATAID_ACCY, TELEMETRY_SENSOR_ACCELERATION);
+        ADD_SENSOR(FSSP_DATAID_ACCZ, TELEMETRY_SENSOR_ACCELERATION);
     }
 
     if (sensors(SENSOR_BARO)) {
-        ADD_SENSOR(FSSP_DATAID_ALTITUDE);
-        ADD_SENSOR(FSSP_DATAID_VARIO);
+        ADD_SENSOR(FSSP_DATAID_ALTITUDE, TELEMETRY_SENSOR_ALTITUDE);
+        ADD_SENSOR(FSSP_DATAID_VARIO, TELEMETRY_SENSOR_VARIO);
     }
 
 #ifdef USE_GPS
     if (feature(FEATURE_GPS)) {
-        ADD_SENSOR(FSSP_DATAID_SPEED);
-        ADD_SENSOR(FSSP_DATAID_LATLONG);
-        ADD_SENSOR(FSSP_DATAID_LATLONG); // twice (one for lat, one for long)
-        ADD_SENSOR(FSSP_DATAID_HOME_DIST);
-        ADD_SENSOR(FSSP_DATAID_GPS_ALT);
+        ADD_SENSOR(FSSP_DATAID_SPEED, TELEMETRY_SENSOR_GPS);
+        ADD_SENSOR(FSSP_DATAID_LATLONG, TELEMETRY_SENSOR_GPS);
+        ADD_SENSOR(FSSP_DATAID_LATLONG, TELEMETRY_SENSOR_GPS); // twice (one for lat, one for long)
+        ADD_SENSOR(FSSP_DATAID_HOME_DIST, TELEMETRY_SENSOR_GPS);
+        ADD_SENSOR(FSSP_DATAID_GPS_ALT, TELEMETRY_SENSOR_GPS);
     }
 #endif
 
-    frSkyDataIdTableInfo.size = frSkyDataIdTableInfo.index;
-    frSkyDataIdTableInfo.index = 0;
-
 #ifdef USE_ESC_SENSOR
     if (reportExtendedEscSensors()) {
-        frSkyEscDataIdTableInfo.size = ESC_DATAID_COUNT;
-    } else {
-        frSkyEscDataIdTableInfo.size = 0;
+        // each motor and ESC_SENSOR_COMBINED
+        const int escDataIdSets = MIN(getMotorCount() + 1, MAX_ESC_DATAID_SETS);
+        for (int offset = 0; offset < escDataIdSets; offset++) {
+            for (unsigned i = 0; i < ESC_DATAID_COUNT; i++) {
+                ADD_SENSOR(frSkyEscDataIdTable[i] + offset, TELEMETRY_SENSOR_ESC);
+            }
+        }
     }
 #endif
 }
@@ -462,12 +488,11 @@ static void smartPortSendMspResponse(uint8_t *data) {
 
 void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clearToSend, const timeUs_t *requestTimeout)
 {
-    static uint8_t smartPortIdCycleCnt = 0;
     static uint8_t t1Cnt = 0;
     static uint8_t t2Cnt = 0;
     static uint8_t skipRequests = 0;
-#ifdef USE_ESC_SENSOR
-    static uint8_t smartPortIdOffset = 0;
+#ifdef USE_GPS
+    static bool sendLongitude = false;
 #endif
 
 #if defined(USE_MSP_OVER_TELEMETRY)
@@ -514,40 +539,16 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
         }
 #endif
 
-        // we can send back any data we want, our tables keep track of the order and frequency of each data type we send
-        frSkyTableInfo_t * tableInfo = &frSkyDataIdTableInfo;
+        // we can send back any data we want, the scheduler picks the most urgent sensor for this slot
+        const timeUs_t currentTimeUs = micros();
+        telemetrySensor_t *sensor = telemetrySchedulerNext(&smartPortScheduler, currentTimeUs, SMARTPORT_FRAME_BUDGET, true);
+        if (!sensor) {
+            *clearToSend = false;
 
-#ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            // send ESC sensors
-            tableInfo = &frSkyEscDataIdTableInfo;
-            if (tableInfo->index == tableInfo->size) { // end of ESC table, return to other sensors
-                tableInfo->index = 0;
-                smartPortIdCycleCnt = 0;
-                smartPortIdOffset++;
-                if (smartPortIdOffset == getMotorCount() + 1) { // each motor and ESC_SENSOR_COMBINED
-                    smartPortIdOffset = 0;
-                }
-            }
-        }
-        if (smartPortIdCycleCnt < ESC_SENSOR_PERIOD) {
-            // send other sensors
-            tableInfo = &frSkyDataIdTableInfo;
-#endif
-            if (tableInfo->index == tableInfo->size) { // end of table reached, loop back
-                tableInfo->index = 0;
-            }
-#ifdef USE_ESC_SENSOR
-        }
-#endif
-        uint16_t id = tableInfo->table[tableInfo->index];
-#ifdef USE_ESC_SENSOR
-        if (smartPortIdCycleCnt >= ESC_SENSOR_PERIOD) {
-            id += smartPortIdOffset;
+            return;
         }
-#endif
-        smartPortIdCycleCnt++;
-        tableInfo->index++;
+        const uint16_t id = sensor->id;
+        telemetrySchedulerSent(&smartPortScheduler, sensor, currentTimeUs);
 
         int32_t tmpi;
         uint32_t tmp2 = 0;
@@ -659,6 +660,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 *clearToSend = false;
                 break;
             case FSSP_DATAID_HEADING    :
+                imuRefreshEulerAngles();
                 smartPortSendPackage(id, attitude.values.yaw * 10); // given in 10*deg, requested in 10000 = 100 deg
                 *clearToSend = false;
                 break;
@@ -783,8 +785,8 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                     uint32_t tmpui = 0;
                     // the same ID is sent twice, one for longitude, one for latitude
                     // the MSB of the sent uint32_t helps FrSky keep track
-                    // the even/odd bit of our counter helps us keep track
-                    if (tableInfo->index & 1) {
+                    sendLongitude = !sendLongitude;
+                    if (sendLongitude) {
                         tmpui = abs(gpsSol.llh.lon);  // now we have unsigned value and one bit to spare
                         tmpui = (tmpui + tmpui / 2) / 25 | 0x80000000;  // 6/100 = 1.5/25, division by power of 2 is fast
                         if (gpsSol.llh.lon < 0) tmpui |= 0x40000000;
@@ -819,7 +821,7 @@ void processSmartPortTelemetry(smartPortPayload_t *payload, volatile bool *clear
                 break;
             default:
                 break;
-                // if nothing is sent, hasRequest isn't cleared, we already incremented the counter, just loop back to the start
+                // if nothing is sent, hasRequest isn't cleared, the sensor is marked as sent, just loop back to the start
         }
     }
 }
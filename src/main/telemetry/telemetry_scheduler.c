@@ -0,0 +1,143 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_TELEMETRY
+
+#include "common/maths.h"
+
+#include "telemetry/telemetry_scheduler.h"
+
+// longest wait taken into account, keeps the urgency arithmetic in range
+#define MAX_ELAPSED_MS 60000
+
+typedef struct telemetrySensorRate_s {
+    uint16_t minIntervalMs;     // fastest refresh while the value keeps moving
+    uint16_t maxIntervalMs;     // slowest refresh of a value that does not move
+    uint16_t changeThreshold;   // change that makes the value due early, 0 for a fixed rate
+    uint8_t priority;
+} telemetrySensorRate_t;
+
+static const telemetrySensorRate_t sensorRates[TELEMETRY_SENSOR_CLASS_COUNT] = {
+    [TELEMETRY_SENSOR_ATTITUDE]     = {  50,   50,  0, 4 },
+    [TELEMETRY_SENSOR_VARIO]        = {  50,  200, 10, 4 },
+    [TELEMETRY_SENSOR_ALTITUDE]     = { 100,  500, 10, 3 },
+    [TELEMETRY_SENSOR_ACCELERATION] = { 200,  200,  0, 1 },
+    [TELEMETRY_SENSOR_FLIGHT_MODE]  = {  50, 1000,  1, 3 },
+    [TELEMETRY_SENSOR_BATTERY]      = { 200, 1000,  1, 2 },
+    [TELEMETRY_SENSOR_GPS]          = { 200,  200,  0, 2 },
+    [TELEMETRY_SENSOR_ESC]          = { 500,  500,  0, 1 },
+    [TELEMETRY_SENSOR_STATUS]       = { 100, 1000,  1, 2 },
+};
+
+void telemetrySchedulerInit(telemetryScheduler_t *scheduler, telemetrySensor_t *sensors, uint8_t capacity, telemetrySensorValueFn *valueFn)
+{
+    memset(sensors, 0, capacity * sizeof(telemetrySensor_t));
+    scheduler->sensors = sensors;
+    scheduler->count = 0;
+    scheduler->capacity = capacity;
+    scheduler->valueFn = valueFn;
+}
+
+bool telemetrySchedulerAdd(telemetryScheduler_t *scheduler, uint16_t id, telemetrySensorClass_e sensorClass, uint8_t size)
+{
+    if (scheduler->count >= scheduler->capacity) {
+        return false;
+    }
+
+    telemetrySensor_t *sensor = &scheduler->sensors[scheduler->count++];
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->id = id;
+    sensor->sensorClass = sensorClass;
+    sensor->size = size;
+
+    return true;
+}
+
+// Urgency of a sensor in 1/256 of its current refresh interval, weighted by
+// its priority. A sensor is due once its urgency reaches its priority * 256;
+// low priority sensors that keep losing out grow more urgent until they win.
+static uint32_t sensorUrgency(const telemetryScheduler_t *scheduler, const telemetrySensor_t *sensor, timeUs_t currentTimeUs, bool *due)
+{
+    const telemetrySensorRate_t *rate = &sensorRates[sensor->sensorClass];
+
+    if (!sensor->sent) {
+        *due = true;
+        return MAX_ELAPSED_MS * 256 / rate->minIntervalMs * rate->priority;
+    }
+
+    const uint32_t elapsedMs = MIN(cmpTimeUs(currentTimeUs, sensor->lastSentAt) / 1000, MAX_ELAPSED_MS);
+    uint16_t intervalMs = rate->maxIntervalMs;
+    if (rate->changeThreshold && elapsedMs >= rate->minIntervalMs && elapsedMs < rate->maxIntervalMs && scheduler->valueFn) {
+        if ((uint32_t)ABS(scheduler->valueFn(sensor->id) - sensor->lastValue) >= rate->changeThreshold) {
+            intervalMs = rate->minIntervalMs;
+        }
+    }
+
+    *due = elapsedMs >= intervalMs;
+    return elapsedMs * 256 / intervalMs * rate->priority;
+}
+
+// Returns the most urgent due sensor that fits the budget. With fillIdle the
+// most urgent sensor is returned even if none is due, for links where an
+// unused slot is wasted.
+telemetrySensor_t *telemetrySchedulerNext(telemetryScheduler_t *scheduler, timeUs_t currentTimeUs, unsigned budget, bool fillIdle)
+{
+    telemetrySensor_t *best = NULL;
+    bool bestDue = false;
+    uint32_t bestUrgency = 0;
+
+    for (int i = 0; i < scheduler->count; i++) {
+        telemetrySensor_t *sensor = &scheduler->sensors[i];
+        if (sensor->size > budget) {
+            continue;
+        }
+
+        bool due;
+        const uint32_t urgency = sensorUrgency(scheduler, sensor, currentTimeUs, &due);
+        if (!due && (bestDue || !fillIdle)) {
+            continue;
+        }
+        if (!best || (due && !bestDue) || urgency > bestUrgency) {
+            best = sensor;
+            bestDue = due;
+            bestUrgency = urgency;
+        }
+    }
+
+    return best;
+}
+
+void telemetrySchedulerSent(telemetryScheduler_t *scheduler, telemetrySensor_t *sensor, timeUs_t currentTimeUs)
+{
+    sensor->lastSentAt = currentTimeUs;
+    sensor->sent = true;
+    if (sensorRates[sensor->sensorClass].changeThreshold && scheduler->valueFn) {
+        sensor->lastValue = scheduler->valueFn(sensor->id);
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The telemetry scheduler decides which sensor a protocol backend sends
+ * next. Every sensor belongs to a class that sets how often it is refreshed
+ * and how much its value has to move before it is worth sending early, so
+ * all protocols share one refresh policy instead of cycling through their
+ * own lists.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/time.h"
+
+typedef enum {
+    TELEMETRY_SENSOR_ATTITUDE = 0,  // decidegrees
+    TELEMETRY_SENSOR_VARIO,         // cm/s
+    TELEMETRY_SENSOR_ALTITUDE,      // cm
+    TELEMETRY_SENSOR_ACCELERATION,
+    TELEMETRY_SENSOR_FLIGHT_MODE,   // any change
+    TELEMETRY_SENSOR_BATTERY,       // 0.1V, 1A or 10mAh
+    TELEMETRY_SENSOR_GPS,
+    TELEMETRY_SENSOR_ESC,
+    TELEMETRY_SENSOR_STATUS,        // any change
+    TELEMETRY_SENSOR_CLASS_COUNT
+} telemetrySensorClass_e;
+
+// returns the value of a sensor, in the units of its class, for change detection
+typedef int32_t telemetrySensorValueFn(uint16_t id);
+
+typedef struct telemetrySensor_s {
+    uint16_t id;                // protocol specific identifier
+    uint8_t sensorClass;
+    uint8_t size;               // link budget used by one frame of this sensor
+    int32_t lastValue;
+    timeUs_t lastSentAt;
+    bool sent;
+} telemetrySensor_t;
+
+typedef struct telemetryScheduler_s {
+    telemetrySensor_t *sensors;
+    uint8_t count;
+    uint8_t capacity;
+    telemetrySensorValueFn *valueFn;
+} telemetryScheduler_t;
+
+void telemetrySchedulerInit(telemetryScheduler_t *scheduler, telemetrySensor_t *sensors, uint8_t capacity, telemetrySensorValueFn *valueFn);
+bool telemetrySchedulerAdd(telemetryScheduler_t *scheduler, uint16_t id, telemetrySensorClass_e sensorClass, uint8_t size);
+telemetrySensor_t *telemetrySchedulerNext(telemetryScheduler_t *scheduler, timeUs_t currentTimeUs, unsigned budget, bool fillIdle);
+void telemetrySchedulerSent(telemetryScheduler_t *scheduler, telemetrySensor_t *sensor, timeUs_t currentTimeUs);
@@ -0,0 +1,308 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/display.h"
+
+    #include "interface/msp_protocol.h"
+
+    #include "io/displayport_msp.h"
+
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_ROWS   16
+#define TEST_COLS   30
+
+// Remote side, rebuilds the screen from the MSP_DISPLAYPORT frame stream
+
+static uint8_t remoteScreen[TEST_ROWS][TEST_COLS];
+static int frameCount;
+static int payloadBytes;
+static int drawCount;
+static uint32_t txBytesFree;
+
+static void decodeSpans(const uint8_t *data, int len)
+{
+    int pos = 0;
+    while (pos < len) {
+        ASSERT_LE(pos + 3, len);
+        const uint8_t row = data[pos++];
+        uint8_t col = data[pos++];
+        int count = data[pos++];
+        ASSERT_LT(row, TEST_ROWS);
+        ASSERT_LE(col + count, TEST_COLS);
+
+        while (count > 0) {
+            ASSERT_LT(pos, len);
+            const uint8_t token = data[pos++];
+            const int n = (token & 0x7f) + 1;
+            ASSERT_LE(n, count);
+            if (token & 0x80) {
+                ASSERT_LT(pos, len);
+                memset(&remoteScreen[row][col], data[pos++], n);
+            } else {
+                ASSERT_LE(pos + n, len);
+                memcpy(&remoteScreen[row][col], &data[pos], n);
+                pos += n;
+            }
+            col += n;
+            count -= n;
+        }
+    }
+}
+
+extern "C" {
+    uint8_t cliMode = 0;
+
+    int mspSerialPush(uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction)
+    {
+        EXPECT_EQ(MSP_DISPLAYPORT, cmd);
+        EXPECT_EQ(MSP_DIRECTION_REPLY, direction);
+        EXPECT_GE(datalen, 1);
+
+        frameCount++;
+        payloadBytes += datalen;
+
+        switch (data[0]) {
+        case MSP_DP_CLEAR_SCREEN:
+            memset(remoteScreen, ' ', sizeof(remoteScreen));
+            break;
+        case MSP_DP_WRITE_STRING:
+            memcpy(&remoteScreen[data[1]][data[2]], &data[4], datalen - 4);
+            break;
+        case MSP_DP_WRITE_SPANS:
+            decodeSpans(&data[1], datalen - 1);
+            break;
+        case MSP_DP_DRAW_SCREEN:
+            drawCount++;
+            break;
+        }
+
+        return datalen;
+    }
+
+    uint32_t mspSerialTxBytesFree(void)
+    {
+        return txBytesFree;
+    }
+}
+
+// What was written to the display port
+static uint8_t expectedScreen[TEST_ROWS][TEST_COLS];
+
+static displayPort_t *displayPort;
+
+static void write(uint8_t col, uint8_t row, const char *text)
+{
+    memcpy(&expectedScreen[row][col], text, strlen(text));
+    displayWrite(displayPort, col, row, text);
+}
+
+static void resetCounters(void)
+{
+    frameCount = 0;
+    payloadBytes = 0;
+    drawCount = 0;
+}
+
+static void expectRemoteMatches(void)
+{
+    for (int row = 0; row < TEST_ROWS; row++) {
+        EXPECT_EQ(0, memcmp(remoteScreen[row], expectedScreen[row], TEST_COLS)) << "row " << row;
+    }
+}
+
+class DisplayPortMspTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        txBytesFree = UINT32_MAX;
+        memset(remoteScreen, 0, sizeof(remoteScreen));
+        memset(expectedScreen, ' ', sizeof(expectedScreen));
+        displayPort = displayPortMspInit();
+        displayClearScreen(displayPort);
+        resetCounters();
+    }
+};
+
+TEST_F(DisplayPortMspTest, TestV1SendsEveryWrite)
+{
+    // given
+    memset(remoteScreen, ' ', sizeof(remoteScreen));
+
+    // when
+    write(2, 3, "HELLO");
+    write(2, 3, "HELLO");
+    displayDrawScreen(displayPort);
+    displayDrawScreen(displayPort);
+
+    // then
+    // both writes and a single draw, nothing changed for the second one
+    EXPECT_EQ(3, frameCount);
+    EXPECT_EQ(1, drawCount);
+    expectRemoteMatches();
+}
+
+TEST_F(DisplayPortMspTest, TestKeyframe)
+{
+    // given
+    write(1, 1, "ALT 12M");
+    write(20, 12, "12.6V");
+
+    // when
+    displayPortMspRequestKeyframe();
+    resetCounters();
+    memset(remoteScreen, 0, sizeof(remoteScreen));
+    displayDrawScreen(displayPort);
+
+    // then
+    // the remote screen is rebuilt from a clear and the non blank cells
+    expectRemoteMatches();
+    EXPECT_EQ(1, drawCount);
+    EXPECT_EQ(3, frameCount);
+}
+
+TEST_F(DisplayPortMspTest, TestV2SendsOnlyChangedCells)
+{
+    // given
+    displayPortMspRequestKeyframe();
+    write(3, 4, "12.34V");
+    displayDrawScreen(displayPort);
+    expectRemoteMatches();
+    resetCounters();
+
+    // when
+    // the writes are not sent immediately
+    write(3, 4, "12.35V");
+    EXPECT_EQ(0, frameCount);
+    displayDrawScreen(displayPort);
+
+    // then
+    // subcmd, span header, one literal token of one cell, then the draw
+    expectRemoteMatches();
+    EXPECT_EQ(2, frameCount);
+    EXPECT_EQ(1 + 3 + 2 + 1, payloadBytes);
+
+    // when
+    resetCounters();
+    write(3, 4, "12.35V");
+    displayDrawScreen(displayPort);
+
+    // then
+    // nothing changed, nothing sent
+    EXPECT_EQ(0, frameCount);
+}
+
+TEST_F(DisplayPortMspTest, TestV2RunLengthEncoding)
+{
+    // given
+    displayPortMspRequestKeyframe();
+    displayDrawScreen(displayPort);
+    resetCounters();
+
+    // when
+    write(0, 5, "------------------------------");
+    displayDrawScreen(displayPort);
+
+    // then
+    // subcmd, span header, one repeat token, then the draw
+    expectRemoteMatches();
+    EXPECT_EQ(1 + 3 + 2 + 1, payloadBytes);
+}
+
+TEST_F(DisplayPortMspTest, TestV2ClearSendsBlankRuns)
+{
+    // given
+    displayPortMspRequestKeyframe();
+    for (int row = 0; row < TEST_ROWS; row++) {
+        write(0, row, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123");
+    }
+    displayDrawScreen(displayPort);
+    expectRemoteMatches();
+    resetCounters();
+
+    // when
+    displayClearScreen(displayPort);
+    memset(expectedScreen, ' ', sizeof(expectedScreen));
+    write(10, 7, "ARMED");
+    displayDrawScreen(displayPort);
+
+    // then
+    // each row is a few bytes instead of 30 cells
+    expectRemoteMatches();
+    EXPECT_LT(payloadBytes, TEST_ROWS * 10);
+}
+
+TEST_F(DisplayPortMspTest, TestV2WaitsForTxSpace)
+{
+    // given
+    displayPortMspRequestKeyframe();
+    displayDrawScreen(displayPort);
+    resetCounters();
+
+    // when
+    txBytesFree = 10;
+    write(3, 4, "WAIT");
+    displayDrawScreen(displayPort);
+
+    // then
+    EXPECT_EQ(0, frameCount);
+
+    // when
+    txBytesFree = UINT32_MAX;
+    displayDrawScreen(displayPort);
+
+    // then
+    expectRemoteMatches();
+}
+
+TEST_F(DisplayPortMspTest, TestV2RandomUpdates)
+{
+    // given
+    displayPortMspRequestKeyframe();
+    displayDrawScreen(displayPort);
+    srand(42);
+
+    for (int round = 0; round < 50; round++) {
+        // when
+        for (int i = 0; i < 10; i++) {
+            char text[9];
+            const int len = 1 + rand() % 8;
+            for (int j = 0; j < len; j++) {
+                // mostly digits, sometimes repeated symbols
+                text[j] = (rand() % 4) ? '0' + rand() % 10 : '-';
+            }
+            text[len] = 0;
+            write(rand() % (TEST_COLS - len), rand() % TEST_ROWS, text);
+        }
+        displayDrawScreen(displayPort);
+
+        // then
+        expectRemoteMatches();
+    }
+}
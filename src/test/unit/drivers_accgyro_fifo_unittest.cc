@@ -0,0 +1,463 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/io.h"
+    #include "drivers/time.h"
+
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/accgyro_fifo.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Model of the sensor FIFO, driven by the SPI transcript
+
+#define SIM_READ                0x80
+#define SIM_MPU_FIFO_EN         0x23
+#define SIM_MPU_USER_CTRL       0x6A
+#define SIM_MPU_FIFO_COUNTH     0x72
+#define SIM_MPU_FIFO_COUNTL     0x73
+#define SIM_MPU_FIFO_R_W        0x74
+#define SIM_MPU_FIFO_RST        0x04
+#define SIM_BMI_FIFO_LENGTH_0   0x22
+#define SIM_BMI_FIFO_LENGTH_1   0x23
+#define SIM_BMI_FIFO_DATA       0x24
+#define SIM_BMI_FIFO_CONFIG_1   0x47
+#define SIM_BMI_CMD             0x7E
+#define SIM_BMI_FIFO_FLUSH      0xB0
+#define SIM_BMI_EMPTY_FRAME     0x80
+#define SIM_FIFO_SIZE           1024
+
+static struct {
+    gyroFifoFormat_e format;
+    uint8_t fifo[2048];
+    int fifoLength;
+    int fifoRead;
+    uint8_t regs[0x80];
+    bool selected;
+    bool haveAddress;
+    uint8_t address;
+    uint16_t divisor;
+    int transactions;
+    int resets;
+} chip;
+
+static int fifoPending(void)
+{
+    return chip.fifoLength - chip.fifoRead;
+}
+
+static void flushFifo(void)
+{
+    chip.fifoLength = 0;
+    chip.fifoRead = 0;
+    chip.resets++;
+}
+
+static uint8_t readRegister(uint8_t reg)
+{
+    // the FIFO is read at the clock the driver gave for it
+    EXPECT_EQ(SPI_CLOCK_STANDARD, chip.divisor);
+    if (chip.format == GYRO_FIFO_MPU) {
+        switch (reg) {
+        case SIM_MPU_FIFO_COUNTH:
+            return fifoPending() >> 8;
+        case SIM_MPU_FIFO_COUNTL:
+            return fifoPending() & 0xff;
+        case SIM_MPU_FIFO_R_W:
+            return fifoPending() ? chip.fifo[chip.fifoRead++] : 0xff;
+        }
+    } else {
+        switch (reg) {
+        case SIM_BMI_FIFO_LENGTH_0:
+            return fifoPending() & 0xff;
+        case SIM_BMI_FIFO_LENGTH_1:
+            return fifoPending() >> 8;
+        case SIM_BMI_FIFO_DATA:
+            return fifoPending() ? chip.fifo[chip.fifoRead++] : SIM_BMI_EMPTY_FRAME;
+        }
+    }
+    return chip.regs[reg];
+}
+
+static void writeRegister(uint8_t reg, uint8_t data)
+{
+    // and configured at the clock the drivers write their registers at
+    EXPECT_EQ(SPI_CLOCK_INITIALIZATON, chip.divisor);
+    chip.regs[reg] = data;
+    if (chip.format == GYRO_FIFO_MPU && reg == SIM_MPU_USER_CTRL && (data & SIM_MPU_FIFO_RST)) {
+        flushFifo();
+    }
+    if (chip.format == GYRO_FIFO_BMI160 && reg == SIM_BMI_CMD && data == SIM_BMI_FIFO_FLUSH) {
+        flushFifo();
+    }
+}
+
+static uint8_t simulateByte(uint8_t data)
+{
+    EXPECT_TRUE(chip.selected);
+    if (!chip.haveAddress) {
+        chip.address = data;
+        chip.haveAddress = true;
+        return 0;
+    }
+    if (!(chip.address & SIM_READ)) {
+        writeRegister(chip.address, data);
+        return 0;
+    }
+    const uint8_t reg = chip.address & ~SIM_READ;
+    const uint8_t rx = readRegister(reg);
+    // the data registers do not auto-increment
+    if (reg != SIM_MPU_FIFO_R_W && reg != SIM_BMI_FIFO_DATA) {
+        chip.address++;
+    }
+    return rx;
+}
+
+extern "C" {
+    void IOLo(IO_t)
+    {
+        chip.selected = true;
+        chip.haveAddress = false;
+        chip.transactions++;
+    }
+
+    void IOHi(IO_t)
+    {
+        chip.selected = false;
+    }
+
+    uint8_t spiTransferByte(SPI_TypeDef *, uint8_t data)
+    {
+        return simulateByte(data);
+    }
+
+    bool spiTransfer(SPI_TypeDef *, const uint8_t *txData, uint8_t *rxData, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            const uint8_t rx = simulateByte(txData ? txData[i] : 0xff);
+            if (rxData) {
+                rxData[i] = rx;
+            }
+        }
+        return true;
+    }
+
+    bool spiBusWriteRegister(const busDevice_t *bus, uint8_t reg, uint8_t data)
+    {
+        IOLo(bus->busdev_u.spi.csnPin);
+        spiTransferByte(bus->busdev_u.spi.instance, reg);
+        spiTransferByte(bus->busdev_u.spi.instance, data);
+        IOHi(bus->busdev_u.spi.csnPin);
+        return true;
+    }
+
+    bool spiBusReadRegisterBuffer(const busDevice_t *bus, uint8_t reg, uint8_t *data, uint8_t length)
+    {
+        IOLo(bus->busdev_u.spi.csnPin);
+        spiTransferByte(bus->busdev_u.spi.instance, reg | SIM_READ);
+        spiTransfer(bus->busdev_u.spi.instance, NULL, data, length);
+        IOHi(bus->busdev_u.spi.csnPin);
+        return true;
+    }
+
+    void spiSetDivisor(SPI_TypeDef *, uint16_t divisor)
+    {
+        chip.divisor = divisor;
+    }
+
+    void delayMicroseconds(timeUs_t) {}
+}
+
+static void pushBigEndian(int16_t value)
+{
+    chip.fifo[chip.fifoLength++] = (uint16_t)value >> 8;
+    chip.fifo[chip.fifoLength++] = value & 0xff;
+}
+
+static void pushLittleEndian(int16_t value)
+{
+    chip.fifo[chip.fifoLength++] = value & 0xff;
+    chip.fifo[chip.fifoLength++] = (uint16_t)value >> 8;
+}
+
+// acc then gyro, as the MPU queues ACCEL_XOUT_H..ZOUT_L and GYRO_XOUT_H..ZOUT_L
+static void pushMpuRecord(int16_t acc, int16_t gyro)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pushBigEndian(acc + axis);
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        pushBigEndian(gyro + axis);
+    }
+}
+
+static void pushBmi160Frame(uint8_t header, int16_t gyro, int16_t acc)
+{
+    chip.fifo[chip.fifoLength++] = header;
+    if (header & 0x08) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            pushLittleEndian(gyro + axis);
+        }
+    }
+    if (header & 0x04) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            pushLittleEndian(acc + axis);
+        }
+    }
+}
+
+static gyroDev_t testGyro;
+static gyroFifo_t fifo;
+static accDev_t accDev;
+
+static void initFifoWithSize(gyroFifoFormat_e format, uint16_t size)
+{
+    memset(&chip, 0, sizeof(chip));
+    memset(&accDev, 0, sizeof(accDev));
+    chip.format = format;
+    testGyro.fifoFormat = format;
+    testGyro.fifoSize = size;
+    testGyro.fifoSpiDivisor = SPI_CLOCK_STANDARD;
+    gyroFifoInit(&fifo, &testGyro);
+    gyroFifoAttachAcc(&fifo);
+    chip.transactions = 0;
+    chip.resets = 0;
+}
+
+static void initFifo(gyroFifoFormat_e format)
+{
+    initFifoWithSize(format, SIM_FIFO_SIZE);
+}
+
+TEST(GyroFifoTest, TestMpuInitEnablesAccAndGyroFifo)
+{
+    // when
+    initFifo(GYRO_FIFO_MPU);
+
+    // then
+    EXPECT_EQ(0x78, chip.regs[SIM_MPU_FIFO_EN]);
+    EXPECT_EQ(0x50, chip.regs[SIM_MPU_USER_CTRL]);
+}
+
+TEST(GyroFifoTest, TestMpuDrainsAllSamplesInOrder)
+{
+    // given
+    initFifo(GYRO_FIFO_MPU);
+    pushMpuRecord(100, -1000);
+    pushMpuRecord(200, -2000);
+    pushMpuRecord(300, -3000);
+
+    // when
+    const uint8_t count = gyroFifoDrain(&fifo);
+
+    // then
+    EXPECT_EQ(3, count);
+    for (int i = 0; i < count; i++) {
+        EXPECT_TRUE(fifo.samples[i].hasGyro);
+        EXPECT_TRUE(fifo.samples[i].hasAcc);
+        EXPECT_EQ(-1000 * (i + 1), fifo.samples[i].gyro[X]);
+        EXPECT_EQ(-1000 * (i + 1) + 1, fifo.samples[i].gyro[Y]);
+        EXPECT_EQ(-1000 * (i + 1) + 2, fifo.samples[i].gyro[Z]);
+        EXPECT_EQ(100 * (i + 1), fifo.samples[i].acc[X]);
+    }
+    // the fill level, then one burst for all samples
+    EXPECT_EQ(2, chip.transactions);
+    EXPECT_EQ(0, fifoPending());
+}
+
+TEST(GyroFifoTest, TestEmptyFifoNeedsNoBurst)
+{
+    // given
+    initFifo(GYRO_FIFO_MPU);
+
+    // when
+    const uint8_t count = gyroFifoDrain(&fifo);
+
+    // then
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(1, chip.transactions);
+}
+
+TEST(GyroFifoTest, TestMpuBacklogIsReadOverSeveralLoops)
+{
+    // given
+    initFifo(GYRO_FIFO_MPU);
+    for (int i = 0; i < GYRO_FIFO_MAX_SAMPLES + 3; i++) {
+        pushMpuRecord(0, i);
+    }
+
+    // when
+    const uint8_t first = gyroFifoDrain(&fifo);
+    const int16_t lastOfFirst = fifo.samples[first - 1].gyro[X];
+    const uint8_t second = gyroFifoDrain(&fifo);
+
+    // then
+    // nothing is lost, the rest stays queued for the next loop
+    EXPECT_EQ(GYRO_FIFO_MAX_SAMPLES, first);
+    EXPECT_EQ(GYRO_FIFO_MAX_SAMPLES - 1, lastOfFirst);
+    EXPECT_EQ(3, second);
+    EXPECT_EQ(GYRO_FIFO_MAX_SAMPLES, fifo.samples[0].gyro[X]);
+    EXPECT_EQ(0, fifo.overflowCount);
+}
+
+TEST(GyroFifoTest, TestMpuPartialRecordResetsFifo)
+{
+    // given
+    initFifo(GYRO_FIFO_MPU);
+    pushMpuRecord(0, 1);
+    chip.fifo[chip.fifoLength++] = 0x12;
+
+    // when
+    const uint8_t count = gyroFifoDrain(&fifo);
+
+    // then
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(1, fifo.overflowCount);
+    EXPECT_EQ(1, chip.resets);
+    EXPECT_EQ(0, fifoPending());
+    // the FIFO is running again
+    EXPECT_EQ(0x50, chip.regs[SIM_MPU_USER_CTRL]);
+}
+
+TEST(GyroFifoTest, TestMpuFullFifoOfThePartResets)
+{
+    // given
+    // ICM20602, whose FIFO holds 84 records
+    initFifoWithSize(GYRO_FIFO_MPU, 1008);
+    for (int i = 0; i < 84; i++) {
+        pushMpuRecord(0, i);
+    }
+
+    // when
+    const uint8_t count = gyroFifoDrain(&fifo);
+
+    // then
+    // a full FIFO may have dropped samples
+    EXPECT_EQ(0, count);
+    EXPECT_EQ(1, fifo.overflowCount);
+    EXPECT_EQ(1, chip.resets);
+    EXPECT_EQ(SPI_CLOCK_STANDARD, chip.divisor);
+}
+
+TEST(GyroFifoTest, TestAccIsAveragedFromDrainedSamples)
+{
+    // given
+    initFifo(GYRO_FIFO_MPU);
+    pushMpuRecord(100, 0);
+    pushMpuRecord(200, 0);
+    pushMpuRecord(300, 0);
+    pushMpuRecord(400, 0);
+    gyroFifoDrain(&fifo);
+    const int transactions = chip.transactions;
+
+    // when
+    const bool read = gyroFifoAccRead(&accDev);
+
+    // then
+    EXPECT_TRUE(read);
+    EXPECT_EQ(250, accDev.ADCRaw[X]);
+    EXPECT_EQ(251, accDev.ADCRaw[Y]);
+    EXPECT_EQ(252, accDev.ADCRaw[Z]);
+    // no bus traffic for the acc
+    EXPECT_EQ(transactions, chip.transactions);
+
+    // and the average starts again
+    EXPECT_FALSE(gyroFifoAccRead(&accDev));
+}
+
+TEST(GyroFifoTest, TestBmi160InitEnablesHeaderMode)
+{
+    // when
+    initFifo(GYRO_FIFO_BMI160);
+
+    // then
+    EXPECT_EQ(0xD0, chip.regs[SIM_BMI_FIFO_CONFIG_1]);
+}
+
+TEST(GyroFifoTest, TestBmi160MixedFrames)
+{
+    // given
+    // gyro at 3.2kHz, acc at 800Hz, so most frames hold gyro only
+    initFifo(GYRO_FIFO_BMI160);
+    pushBmi160Frame(0x8C, 10, 1000);
+    pushBmi160Frame(0x88, 20, 0);
+    chip.fifo[chip.fifoLength++] = 0x48;    // config change frame
+    chip.fifo[chip.fifoLength++] = 0x00;
+    pushBmi160Frame(0x88, 30, 0);
+    pushBmi160Frame(0x84, 0, 2000);
+
+    // when
+    const uint8_t count = gyroFifoDrain(&fifo);
+
+    // then
+    EXPECT_EQ(4, count);
+    EXPECT_TRUE(fifo.samples[0].hasGyro);
+    EXPECT_TRUE(fifo.samples[0].hasAcc);
+    EXPECT_EQ(10, fifo.samples[0].gyro[X]);
+    EXPECT_EQ(1002, fifo.samples[0].acc[Z]);
+    EXPECT_EQ(20, fifo.samples[1].gyro[X]);
+    EXPECT_FALSE(fifo.samples[1].hasAcc);
+    EXPECT_EQ(32, fifo.samples[2].gyro[Z]);
+    EXPECT_FALSE(fifo.samples[3].hasGyro);
+    EXPECT_EQ(2000, fifo.samples[3].acc[X]);
+    EXPECT_EQ(2, chip.transactions);
+
+    EXPECT_TRUE(gyroFifoAccRead(&accDev));
+    EXPECT_EQ(1500, accDev.ADCRaw[X]);
+}
+
+TEST(GyroFifoTest, TestBmi160StopsAtPartialFrame)
+{
+    // given
+    const uint8_t frame[] = { 0x88, 0x01, 0x00, 0x02, 0x00, 0x03 };
+    gyroFifoSample_t samples[GYRO_FIFO_MAX_SAMPLES];
+
+    // when
+    const uint8_t count = gyroFifoParse(GYRO_FIFO_BMI160, frame, sizeof(frame), samples, GYRO_FIFO_MAX_SAMPLES);
+
+    // then
+    EXPECT_EQ(0, count);
+}
+
+TEST(GyroFifoTest, TestBmi160NeverReadsMoreThanFits)
+{
+    // given
+    initFifo(GYRO_FIFO_BMI160);
+    for (int i = 0; i < GYRO_FIFO_MAX_SAMPLES + 4; i++) {
+        pushBmi160Frame(0x88, i, 0);
+    }
+
+    // when
+    const uint8_t first = gyroFifoDrain(&fifo);
+    const uint8_t second = gyroFifoDrain(&fifo);
+
+    // then
+    EXPECT_EQ(GYRO_FIFO_MAX_SAMPLES, first);
+    EXPECT_EQ(4, second);
+    EXPECT_EQ(GYRO_FIFO_MAX_SAMPLES, fifo.samples[0].gyro[X]);
+}
@@ -0,0 +1,346 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/accgyro/accgyro.h"
+    #include "drivers/accgyro/accgyro_imuf9001_link.h"
+
+    imufLink_t imufLink;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FRAME_SIZE      GTBCM_GYRO_ACC_QUAT_FILTER_F
+
+// Model of the IMU-F end of the link. Each transfer takes the command frame
+// the flight controller sends and answers with a data frame of its own.
+
+static struct {
+    uint32_t sample;            // counts up, written into every data frame
+    bool corruptData;           // the next data frame arrives damaged
+    bool corruptCommand;        // the next command frame arrives damaged
+    uint32_t lastSequence;
+    int updatesApplied;
+    int badCommands;
+    imufCommand_t applied;
+} imuf;
+
+static void transfer(imufLink_t *link, timeUs_t sampleTimeUs, bool complete = true);
+
+static void reset(uint8_t frameSize = FRAME_SIZE)
+{
+    memset(&imuf, 0, sizeof(imuf));
+    imufLinkInit(&imufLink, frameSize);
+}
+
+static void imufReceiveCommand(const uint32_t *tx)
+{
+    uint32_t command[IMUF_LINK_COMMAND_WORDS];
+    memcpy(command, tx, sizeof(command));
+    if (imuf.corruptCommand) {
+        command[3] ^= 0x10;
+        imuf.corruptCommand = false;
+    }
+    if (command[0] != IMUF_COMMAND_UPDATE_FILTERS) {
+        return;
+    }
+    if (command[IMUF_LINK_COMMAND_WORDS - 1] != getCrcImuf9001(command, IMUF_LINK_COMMAND_WORDS - 1)) {
+        imuf.badCommands++;
+        return;
+    }
+    const uint32_t version = command[1] >> 16;
+    const uint32_t sequence = command[1] & 0xFFFF;
+    if (version != IMUF_LINK_PROTOCOL_VERSION || sequence == imuf.lastSequence) {
+        return;
+    }
+    imuf.lastSequence = sequence;
+    imuf.updatesApplied++;
+    memcpy(&imuf.applied, command, sizeof(command));
+}
+
+static void imufSendData(uint32_t *rx, uint8_t frameSize)
+{
+    const int words = frameSize / sizeof(uint32_t);
+    for (int i = 0; i < words - 1; i++) {
+        const float value = imuf.sample + i * 0.25f;
+        memcpy(&rx[i], &value, sizeof(value));
+    }
+    rx[words - 1] = getCrcImuf9001(rx, words - 1);
+    if (imuf.corruptData) {
+        rx[0] ^= 0x01;
+        imuf.corruptData = false;
+    }
+    imuf.sample++;
+}
+
+// What the gyro driver does for every sample the IMU-F signals: start the
+// transfer and, unless it is held back, complete it from the interrupt
+static void transfer(imufLink_t *link, timeUs_t sampleTimeUs, bool complete)
+{
+    if (!imufLinkStartTransfer(link, sampleTimeUs)) {
+        return;
+    }
+    imufLinkWriteUpdate(link);
+    imufReceiveCommand(link->txBuffer);
+    imufSendData(link->rxBuffer[link->fill], link->frameSize);
+    if (complete) {
+        imufLinkTransferDone(link);
+    }
+}
+
+static float frameValue(const uint32_t *frame, int word)
+{
+    float value;
+    memcpy(&value, &frame[word], sizeof(value));
+    return value;
+}
+
+static imufCommand_t filterParams(uint32_t value)
+{
+    imufCommand_t params;
+    memset(&params, 0, sizeof(params));
+    params.param2 = value;
+    params.param10 = value + 1;
+    return params;
+}
+
+TEST(ImufLinkTest, GoodFramesAlternateBuffers)
+{
+    reset();
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS];
+    timeUs_t sampleTimeUs;
+
+    transfer(&imufLink, 1000);
+    EXPECT_EQ(1, imufLink.fill);
+    EXPECT_EQ(0, imufLink.ready);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1000u, sampleTimeUs);
+    EXPECT_FLOAT_EQ(0.0f, frameValue(frame, 0));
+
+    transfer(&imufLink, 1125);
+    EXPECT_EQ(0, imufLink.fill);
+    EXPECT_EQ(1, imufLink.ready);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1125u, sampleTimeUs);
+    EXPECT_FLOAT_EQ(1.0f, frameValue(frame, 0));
+    EXPECT_FLOAT_EQ(1.5f, frameValue(frame, 2));
+
+    EXPECT_EQ(2u, imufLink.stats.frames);
+    EXPECT_EQ(0u, imufLink.stats.crcErrors);
+}
+
+TEST(ImufLinkTest, NoNewFrameIsNotReadTwice)
+{
+    reset();
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS];
+    timeUs_t sampleTimeUs;
+
+    EXPECT_FALSE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    transfer(&imufLink, 1000);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_FALSE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+
+    // two frames between reads, only the newest is read
+    transfer(&imufLink, 1125);
+    transfer(&imufLink, 1250);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1250u, sampleTimeUs);
+    EXPECT_FLOAT_EQ(2.0f, frameValue(frame, 0));
+}
+
+TEST(ImufLinkTest, CrcErrorKeepsTheLastGoodFrame)
+{
+    reset();
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS];
+    timeUs_t sampleTimeUs;
+
+    transfer(&imufLink, 1000);
+    imuf.corruptData = true;
+    transfer(&imufLink, 1125);
+
+    EXPECT_EQ(1u, imufLink.stats.crcErrors);
+    EXPECT_EQ(1u, imufLink.stats.frames);
+    EXPECT_EQ(0, imufLink.ready);
+    // the damaged buffer is filled again by the next transfer
+    EXPECT_EQ(1, imufLink.fill);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1000u, sampleTimeUs);
+    EXPECT_FLOAT_EQ(0.0f, frameValue(frame, 0));
+
+    transfer(&imufLink, 1250);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1250u, sampleTimeUs);
+    EXPECT_FLOAT_EQ(2.0f, frameValue(frame, 0));
+}
+
+TEST(ImufLinkTest, OverrunSkipsOneSample)
+{
+    reset();
+
+    transfer(&imufLink, 1000, false);
+    EXPECT_TRUE(imufLink.busy);
+
+    // the transfer is still running when the next sample is signalled
+    EXPECT_FALSE(imufLinkStartTransfer(&imufLink, 1125));
+    EXPECT_EQ(1u, imufLink.stats.overruns);
+
+    // still running at the one after, it is restarted
+    EXPECT_TRUE(imufLinkStartTransfer(&imufLink, 1250));
+    EXPECT_EQ(2u, imufLink.stats.overruns);
+    imufSendData(imufLink.rxBuffer[imufLink.fill], imufLink.frameSize);
+    EXPECT_TRUE(imufLinkTransferDone(&imufLink));
+    EXPECT_FALSE(imufLink.busy);
+
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS];
+    timeUs_t sampleTimeUs;
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+    EXPECT_EQ(1250u, sampleTimeUs);
+
+    transfer(&imufLink, 1375);
+    EXPECT_EQ(2u, imufLink.stats.overruns);
+    EXPECT_EQ(2u, imufLink.stats.frames);
+}
+
+TEST(ImufLinkTest, UpdateIsRepeatedAndAppliedOnce)
+{
+    reset();
+    const imufCommand_t params = filterParams(650);
+    EXPECT_TRUE(imufLinkQueueUpdate(&imufLink, &params));
+
+    for (int i = 0; i < IMUF_LINK_UPDATE_REPEATS; i++) {
+        transfer(&imufLink, 1000 + i * 125);
+    }
+    EXPECT_EQ(1, imuf.updatesApplied);
+    EXPECT_EQ(1u, imuf.lastSequence);
+    EXPECT_EQ(650u, imuf.applied.param2);
+    EXPECT_EQ(651u, imuf.applied.param10);
+    EXPECT_EQ(1, imufLink.stats.updatesSent);
+    EXPECT_EQ(1, imufLink.stats.updateSequence);
+
+    // done repeating, the command frame goes back to empty
+    EXPECT_FALSE(imufLinkWriteUpdate(&imufLink));
+    for (unsigned i = 0; i < IMUF_LINK_COMMAND_WORDS; i++) {
+        EXPECT_EQ(0u, imufLink.txBuffer[i]);
+    }
+}
+
+TEST(ImufLinkTest, UpdateSurvivesDamagedCommandFrames)
+{
+    reset();
+    const imufCommand_t params = filterParams(300);
+    EXPECT_TRUE(imufLinkQueueUpdate(&imufLink, &params));
+
+    for (int i = 0; i < IMUF_LINK_UPDATE_REPEATS / 2; i++) {
+        imuf.corruptCommand = true;
+        transfer(&imufLink, 1000 + i * 125);
+    }
+    EXPECT_EQ(IMUF_LINK_UPDATE_REPEATS / 2, imuf.badCommands);
+    EXPECT_EQ(0, imuf.updatesApplied);
+
+    for (int i = IMUF_LINK_UPDATE_REPEATS / 2; i < IMUF_LINK_UPDATE_REPEATS + 4; i++) {
+        transfer(&imufLink, 1000 + i * 125);
+    }
+    EXPECT_EQ(1, imuf.updatesApplied);
+    EXPECT_EQ(300u, imuf.applied.param2);
+}
+
+TEST(ImufLinkTest, UpdateIsWrittenAgainAfterACalibrationCommand)
+{
+    reset();
+    const imufCommand_t params = filterParams(400);
+    EXPECT_TRUE(imufLinkQueueUpdate(&imufLink, &params));
+
+    // the first copy is lost, then a calibration command takes the frame
+    imuf.corruptCommand = true;
+    transfer(&imufLink, 1000);
+    EXPECT_TRUE(imufLinkStartTransfer(&imufLink, 1125));
+    memset(imufLink.txBuffer, 0, sizeof(imufLink.txBuffer));
+    imufLink.txBuffer[0] = IMUF_COMMAND_CALIBRATE;
+    imufReceiveCommand(imufLink.txBuffer);
+    imufSendData(imufLink.rxBuffer[imufLink.fill], imufLink.frameSize);
+    imufLinkTransferDone(&imufLink);
+    EXPECT_EQ(0, imuf.updatesApplied);
+
+    transfer(&imufLink, 1250);
+    EXPECT_EQ(1, imuf.updatesApplied);
+    EXPECT_EQ(400u, imuf.applied.param2);
+}
+
+TEST(ImufLinkTest, NextUpdateWaitsForThePreviousRepeats)
+{
+    reset();
+    const imufCommand_t first = filterParams(100);
+    const imufCommand_t second = filterParams(200);
+    EXPECT_TRUE(imufLinkQueueUpdate(&imufLink, &first));
+    EXPECT_FALSE(imufLinkQueueUpdate(&imufLink, &second));
+
+    transfer(&imufLink, 1000);
+    EXPECT_EQ(100u, imuf.applied.param2);
+
+    // the transfers copy the update until its last repeat
+    for (int i = 1; i < IMUF_LINK_UPDATE_REPEATS; i++) {
+        EXPECT_FALSE(imufLinkQueueUpdate(&imufLink, &second));
+        transfer(&imufLink, 1000 + 125 * i);
+    }
+    EXPECT_EQ(1, imuf.updatesApplied);
+
+    EXPECT_TRUE(imufLinkQueueUpdate(&imufLink, &second));
+    transfer(&imufLink, 2000);
+    EXPECT_EQ(2, imuf.updatesApplied);
+    EXPECT_EQ(2u, imuf.lastSequence);
+    EXPECT_EQ(200u, imuf.applied.param2);
+    EXPECT_EQ(2, imufLink.stats.updatesSent);
+}
+
+TEST(ImufLinkTest, ShortCommModeTakesNoUpdates)
+{
+    reset(GTBCM_GYRO_ACC_FILTER_F);
+    const imufCommand_t params = filterParams(100);
+    EXPECT_FALSE(imufLinkQueueUpdate(&imufLink, &params));
+
+    uint32_t frame[IMUF_LINK_BUFFER_WORDS];
+    timeUs_t sampleTimeUs;
+    transfer(&imufLink, 1000);
+    EXPECT_EQ(0, imuf.updatesApplied);
+    EXPECT_EQ(0u, imufLink.stats.crcErrors);
+    EXPECT_TRUE(imufLinkReadFrame(&imufLink, frame, &sampleTimeUs));
+}
+
+// STUBS
+
+extern "C" {
+// the crc unit of the STM32: crc32, msb first, a word at a time
+uint32_t getCrcImuf9001(uint32_t* data, uint32_t size)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 32; bit++) {
+            crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+        }
+    }
+    return crc;
+}
+}
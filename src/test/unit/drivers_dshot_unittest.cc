@@ -0,0 +1,254 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+extern "C" {
+    #include "common/utils.h"
+
+    #include "drivers/dshot.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_BIT_0          7
+#define TEST_BIT_1          14
+#define TEST_BUFFER_SIZE    (DSHOT_FRAME_BITS + DSHOT_RESET_SLOTS)
+
+// Reference bit-by-bit expansion, as done before the nibble tables were introduced
+static void referenceWaveform(uint32_t *buffer, int stride, uint16_t packet)
+{
+    for (int i = 0; i < DSHOT_FRAME_BITS; i++) {
+        buffer[i * stride] = (packet & 0x8000) ? TEST_BIT_1 : TEST_BIT_0;
+        packet <<= 1;
+    }
+}
+
+TEST(DshotUnittest, TestPacketEncoding)
+{
+    // 11 bit value, telemetry request bit, then the xor of the three preceding nibbles
+    EXPECT_EQ(0x82c6, dshotEncodePacket(1046, false, false));
+    EXPECT_EQ(0x82d7, dshotEncodePacket(1046, true, false));
+    EXPECT_EQ(0x0000, dshotEncodePacket(0, false, false));
+    EXPECT_EQ(0x0011, dshotEncodePacket(0, true, false));
+    EXPECT_EQ(0xffff, dshotEncodePacket(2047, true, false));
+
+    // bidirectional frames carry the inverted checksum
+    EXPECT_EQ(0x82c9, dshotEncodePacket(1046, false, true));
+    EXPECT_EQ(0x000f, dshotEncodePacket(0, false, true));
+}
+
+TEST(DshotUnittest, TestWaveformIsBitExact)
+{
+    dshotBuildNibbleTable(TEST_BIT_0, TEST_BIT_1);
+
+    for (uint32_t value = 0; value < 2048; value++) {
+        const uint16_t packet = dshotEncodePacket(value, value & 1, false);
+
+        uint32_t expected[TEST_BUFFER_SIZE];
+        uint32_t actual[TEST_BUFFER_SIZE];
+        memset(expected, 0, sizeof(expected));
+        memset(actual, 0, sizeof(actual));
+
+        referenceWaveform(expected, 1, packet);
+        EXPECT_EQ(TEST_BUFFER_SIZE, dshotLoadBuffer(actual, 1, packet));
+        ASSERT_EQ(0, memcmp(expected, actual, sizeof(expected))) << "value " << value;
+    }
+}
+
+TEST(DshotUnittest, TestBurstBufferIsInterleaved)
+{
+    dshotBuildNibbleTable(TEST_BIT_0, TEST_BIT_1);
+
+    const uint16_t packets[DSHOT_BURST_CHANNELS] = {
+        dshotEncodePacket(48, false, false),
+        dshotEncodePacket(1046, true, false),
+        dshotEncodePacket(2047, false, false),
+        dshotEncodePacket(0, false, false),
+    };
+
+    uint32_t expected[TEST_BUFFER_SIZE * DSHOT_BURST_CHANNELS];
+    uint32_t actual[TEST_BUFFER_SIZE * DSHOT_BURST_CHANNELS];
+    memset(expected, 0, sizeof(expected));
+    memset(actual, 0, sizeof(actual));
+
+    for (int channel = 0; channel < DSHOT_BURST_CHANNELS; channel++) {
+        referenceWaveform(&expected[channel], DSHOT_BURST_CHANNELS, packets[channel]);
+    }
+
+    dshotLoadBurstBuffer(actual, packets, 0x0f);
+    EXPECT_EQ(0, memcmp(expected, actual, sizeof(expected)));
+
+    // the frame reset slots must stay low on every channel
+    for (unsigned i = DSHOT_FRAME_BITS * DSHOT_BURST_CHANNELS; i < ARRAYLEN(actual); i++) {
+        EXPECT_EQ(0, actual[i]);
+    }
+}
+
+TEST(DshotUnittest, TestBurstBufferSkipsUnusedChannels)
+{
+    dshotBuildNibbleTable(TEST_BIT_0, TEST_BIT_1);
+
+    const uint16_t packets[DSHOT_BURST_CHANNELS] = { 0xffff, 0xffff, 0xffff, 0xffff };
+
+    uint32_t actual[TEST_BUFFER_SIZE * DSHOT_BURST_CHANNELS];
+    memset(actual, 0, sizeof(actual));
+
+    // only CCR2 and CCR4 drive motors
+    dshotLoadBurstBuffer(actual, packets, 0x0a);
+
+    for (int bit = 0; bit < DSHOT_FRAME_BITS; bit++) {
+        EXPECT_EQ(0, actual[bit * DSHOT_BURST_CHANNELS + 0]);
+        EXPECT_EQ(TEST_BIT_1, actual[bit * DSHOT_BURST_CHANNELS + 1]);
+        EXPECT_EQ(0, actual[bit * DSHOT_BURST_CHANNELS + 2]);
+        EXPECT_EQ(TEST_BIT_1, actual[bit * DSHOT_BURST_CHANNELS + 3]);
+    }
+}
+
+TEST(DshotUnittest, TestStridedBufferMatchesBurstLayout)
+{
+    dshotBuildNibbleTable(TEST_BIT_0, TEST_BIT_1);
+
+    const uint16_t packets[DSHOT_BURST_CHANNELS] = { 0x1234, 0x5678, 0x9abc, 0xdef0 };
+
+    uint32_t strided[TEST_BUFFER_SIZE * DSHOT_BURST_CHANNELS];
+    uint32_t burst[TEST_BUFFER_SIZE * DSHOT_BURST_CHANNELS];
+    memset(strided, 0, sizeof(strided));
+    memset(burst, 0, sizeof(burst));
+
+    for (int channel = 0; channel < DSHOT_BURST_CHANNELS; channel++) {
+        dshotLoadBuffer(&strided[channel], DSHOT_BURST_CHANNELS, packets[channel]);
+    }
+    dshotLoadBurstBuffer(burst, packets, 0x0f);
+
+    EXPECT_EQ(0, memcmp(strided, burst, sizeof(burst)));
+}
+
+static const uint8_t gcrEncodeTable[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17, 0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f
+};
+
+// Timer captures of the edges an ESC sends for a 12 bit eee mmmmmmmmm value, starting at startTicks
+static int synthesizeResponse(uint32_t *edges, uint16_t data, uint32_t startTicks, int jitterTicks)
+{
+    const uint16_t csum = ~(data ^ (data >> 4) ^ (data >> 8)) & 0xf;
+    const uint16_t payload = (data << 4) | csum;
+
+    uint32_t frame = 1;     // start edge
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        frame = (frame << 5) | gcrEncodeTable[(payload >> shift) & 0xf];
+    }
+
+    int count = 0;
+    for (int bit = 20; bit >= 0; bit--) {
+        if (frame & (1 << bit)) {
+            // alternate early and late edges
+            const int jitter = (count & 1) ? jitterTicks : -jitterTicks;
+            edges[count++] = startTicks + (20 - bit) * DSHOT_TELEMETRY_BIT_TICKS + jitter;
+        }
+    }
+    return count;
+}
+
+static uint16_t periodToData(uint32_t periodUs)
+{
+    int exponent = 0;
+    while ((periodUs >> exponent) > 0x1ff) {
+        exponent++;
+    }
+    return (exponent << 9) | (periodUs >> exponent);
+}
+
+TEST(DshotUnittest, TestTelemetryDecode)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+
+    const uint32_t periodsUs[] = { 1, 37, 511, 512, 1000, 2857, 10000, 65000 };
+    for (unsigned i = 0; i < ARRAYLEN(periodsUs); i++) {
+        const uint16_t data = periodToData(periodsUs[i]);
+        const uint32_t quantisedPeriodUs = (data & 0x1ff) << (data >> 9);
+        const uint32_t expectedErpm = (60000000 + quantisedPeriodUs / 2) / quantisedPeriodUs;
+
+        const int count = synthesizeResponse(edges, data, 1234, 0);
+        EXPECT_EQ(expectedErpm, dshotDecodeTelemetryPacket(edges, count)) << "period " << periodsUs[i];
+    }
+}
+
+TEST(DshotUnittest, TestTelemetryDecodeToleratesJitterAndWrap)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+    const uint16_t data = periodToData(2857);   // 21000 eRPM
+
+    // every edge off by up to 3 ticks, so consecutive runs are up to 6 ticks short or long
+    for (int jitter = -3; jitter <= 3; jitter++) {
+        // 16 bit counter wrapping part way through the response
+        const int count = synthesizeResponse(edges, data, 0xffc0, jitter);
+        for (int i = 0; i < count; i++) {
+            edges[i] &= 0xffff;
+        }
+        EXPECT_EQ(21008, dshotDecodeTelemetryPacket(edges, count)) << "jitter " << jitter;
+    }
+}
+
+TEST(DshotUnittest, TestTelemetryDecodeStoppedMotor)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+
+    const int count = synthesizeResponse(edges, 0x0fff, 0, 0);
+    EXPECT_EQ(0, dshotDecodeTelemetryPacket(edges, count));
+}
+
+TEST(DshotUnittest, TestTelemetryDecodeRejectsCorruptFrames)
+{
+    uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+    const uint16_t data = periodToData(2857);
+
+    // no response
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetryPacket(edges, 0));
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetryPacket(edges, 1));
+
+    // glitch edge right after the start edge
+    int count = synthesizeResponse(edges, data, 100, 0);
+    memmove(&edges[2], &edges[1], (count - 1) * sizeof(edges[0]));
+    edges[1] = edges[0] + 3;
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetryPacket(edges, count + 1));
+
+    // wrong checksum, the frame is otherwise well formed
+    uint32_t frame = 1;
+    const uint16_t payload = (data << 4) | ((~(data ^ (data >> 4) ^ (data >> 8)) & 0xf) ^ 0x1);
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        frame = (frame << 5) | gcrEncodeTable[(payload >> shift) & 0xf];
+    }
+    count = 0;
+    for (int bit = 20; bit >= 0; bit--) {
+        if (frame & (1 << bit)) {
+            edges[count++] = (20 - bit) * DSHOT_TELEMETRY_BIT_TICKS;
+        }
+    }
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetryPacket(edges, count));
+
+    // a stretched run pushes the frame past 21 bits
+    count = synthesizeResponse(edges, data, 0, 0);
+    for (int i = count / 2; i < count; i++) {
+        edges[i] += 3 * DSHOT_TELEMETRY_BIT_TICKS;
+    }
+    EXPECT_EQ(DSHOT_TELEMETRY_INVALID, dshotDecodeTelemetryPacket(edges, count));
+}
@@ -0,0 +1,284 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/io.h"
+    #include "drivers/max7456.h"
+    #include "drivers/time.h"
+
+    #include "pg/max7456.h"
+    #include "pg/vcd.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Model of the MAX7456 display memory, driven by the SPI transcript
+
+#define SIM_VM0         0x00
+#define SIM_DMM         0x04
+#define SIM_DMAH        0x05
+#define SIM_DMAL        0x06
+#define SIM_DMDI        0x07
+#define SIM_READ        0x80
+#define SIM_STAT        0xa0
+#define SIM_STAT_PAL    0x01
+#define SIM_END_STRING  0xff
+
+static struct {
+    uint8_t memory[VIDEO_BUFFER_CHARS_PAL];
+    uint8_t regs[0x80];
+    uint16_t address;
+    bool autoIncrement;
+    bool haveAddress;
+    uint8_t pendingAddress;
+    int transferredBytes;
+} chip;
+
+static uint8_t simulateRegister(uint8_t reg, uint8_t data)
+{
+    if (reg == SIM_STAT) {
+        return SIM_STAT_PAL;
+    }
+    if (reg & SIM_READ) {
+        return chip.regs[reg & ~SIM_READ];
+    }
+
+    switch (reg) {
+    case SIM_DMM:
+        chip.autoIncrement = data & 0x01;
+        if (data & 0x04) {
+            memset(chip.memory, ' ', sizeof(chip.memory));
+        }
+        break;
+    case SIM_DMAH:
+        chip.address = (chip.address & 0xff) | ((data & 0x01) << 8);
+        break;
+    case SIM_DMAL:
+        chip.address = (chip.address & 0x100) | data;
+        break;
+    case SIM_DMDI:
+        if (chip.autoIncrement && data == SIM_END_STRING) {
+            chip.autoIncrement = false;
+            break;
+        }
+        EXPECT_LT(chip.address, sizeof(chip.memory));
+        chip.memory[chip.address % sizeof(chip.memory)] = data;
+        if (chip.autoIncrement) {
+            chip.address++;
+        }
+        break;
+    }
+    chip.regs[reg] = data;
+
+    return 0;
+}
+
+static uint8_t simulateByte(uint8_t data)
+{
+    chip.transferredBytes++;
+    if (!chip.haveAddress) {
+        chip.pendingAddress = data;
+        chip.haveAddress = true;
+        return 0;
+    }
+    chip.haveAddress = false;
+    return simulateRegister(chip.pendingAddress, data);
+}
+
+extern "C" {
+    uint8_t spiTransferByte(SPI_TypeDef *, uint8_t data)
+    {
+        return simulateByte(data);
+    }
+
+    bool spiTransfer(SPI_TypeDef *, const uint8_t *txData, uint8_t *rxData, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            const uint8_t rx = simulateByte(txData[i]);
+            if (rxData) {
+                rxData[i] = rx;
+            }
+        }
+        return true;
+    }
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+
+    void spiSetDivisor(SPI_TypeDef *, uint16_t) {}
+    void spiBusSetInstance(busDevice_t *, SPI_TypeDef *) {}
+    SPI_TypeDef *spiInstanceByDevice(SPIDevice) { return NULL; }
+    IO_t IOGetByTag(ioTag_t) { return NULL; }
+    bool IOIsFreeOrPreinit(IO_t) { return true; }
+    void IOInit(IO_t, resourceOwner_e, uint8_t) {}
+    void IOConfigGPIO(IO_t, ioConfig_t) {}
+    void IOLo(IO_t) {}
+    void IOHi(IO_t) {}
+    void delay(timeMs_t) {}
+    timeMs_t millis(void) { return 0; }
+}
+
+// Every draw starts with a read of VM0 to detect a stalled chip
+#define STALL_CHECK_BYTES 2
+
+static const max7456Config_t testConfig = { .csTag = 1 };
+static const vcdProfile_t testVcdProfile = { .video_system = VIDEO_SYSTEM_PAL };
+
+static void drawUntilSynced(void)
+{
+    for (int i = 0; i < 100 && !max7456BuffersSynced(); i++) {
+        max7456DrawScreen();
+    }
+    EXPECT_TRUE(max7456BuffersSynced());
+}
+
+static void expectChipMatchesScreen(void)
+{
+    EXPECT_EQ(0, memcmp(chip.memory, max7456GetScreenBuffer(), sizeof(chip.memory)));
+    EXPECT_FALSE(chip.autoIncrement);
+    EXPECT_FALSE(chip.haveAddress);
+}
+
+class Max7456Test : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        memset(&chip, 0, sizeof(chip));
+        max7456Init(&testConfig, &testVcdProfile, false);
+        max7456ClearScreen();
+        drawUntilSynced();
+        expectChipMatchesScreen();
+        chip.transferredBytes = 0;
+    }
+};
+
+TEST_F(Max7456Test, TestTextUsesAutoIncrementRun)
+{
+    // when
+    max7456Write(3, 4, "12.34V");
+    drawUntilSynced();
+
+    // then
+    expectChipMatchesScreen();
+    // one run, instead of 6 bytes per char
+    EXPECT_EQ(STALL_CHECK_BYTES + 2 * 6 + 10, chip.transferredBytes);
+}
+
+TEST_F(Max7456Test, TestSingleCharsUseDirectAddressing)
+{
+    // when
+    max7456WriteChar(0, 0, 'A');
+    max7456WriteChar(20, 0, 'B');
+    max7456WriteChar(29, 15, 'C');
+    drawUntilSynced();
+
+    // then
+    expectChipMatchesScreen();
+    EXPECT_EQ(STALL_CHECK_BYTES + 3 * 6, chip.transferredBytes);
+}
+
+TEST_F(Max7456Test, TestSmallGapsAreBridged)
+{
+    // given
+    max7456Write(5, 2, "ABCDEFGH");
+    drawUntilSynced();
+    chip.transferredBytes = 0;
+
+    // when
+    // all but chars 2 and 5 of the string change
+    max7456Write(5, 2, "xyCxyFxy");
+    drawUntilSynced();
+
+    // then
+    // a single run across the unchanged chars
+    expectChipMatchesScreen();
+    EXPECT_EQ(STALL_CHECK_BYTES + 2 * 8 + 10, chip.transferredBytes);
+}
+
+TEST_F(Max7456Test, TestSparseChangesUseDirectAddressing)
+{
+    // given
+    max7456Write(5, 2, "ABCDEFGH");
+    drawUntilSynced();
+    chip.transferredBytes = 0;
+
+    // when
+    // chars 0, 3 and 7 of the string change
+    max7456Write(5, 2, "xBCxEFGx");
+    drawUntilSynced();
+
+    // then
+    // a run over all 8 chars would cost more than 3 single writes
+    expectChipMatchesScreen();
+    EXPECT_EQ(STALL_CHECK_BYTES + 3 * 6, chip.transferredBytes);
+}
+
+TEST_F(Max7456Test, TestEndStringIsNotSentInRun)
+{
+    // when
+    const char text[] = { 'A', 'B', 'C', (char)SIM_END_STRING, 'D', 'E', 'F', 'G', 0 };
+    max7456Write(10, 6, text);
+    drawUntilSynced();
+
+    // then
+    // 0xff would end auto-increment mode, so it is written on its own
+    expectChipMatchesScreen();
+    EXPECT_EQ(SIM_END_STRING, chip.memory[6 * 30 + 13]);
+}
+
+TEST_F(Max7456Test, TestClearAndRefill)
+{
+    // given
+    for (int row = 0; row < VIDEO_LINES_PAL; row++) {
+        max7456Write(0, row, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123");
+    }
+    drawUntilSynced();
+    expectChipMatchesScreen();
+
+    // when
+    max7456ClearScreen();
+    max7456Write(1, 1, "X");
+    drawUntilSynced();
+
+    // then
+    expectChipMatchesScreen();
+}
+
+TEST_F(Max7456Test, TestUnchangedWritesSendNothing)
+{
+    // given
+    max7456Write(3, 4, "HELLO");
+    drawUntilSynced();
+    chip.transferredBytes = 0;
+
+    // when
+    max7456Write(3, 4, "HELLO");
+    max7456DrawScreen();
+
+    // then
+    EXPECT_EQ(STALL_CHECK_BYTES, chip.transferredBytes);
+}
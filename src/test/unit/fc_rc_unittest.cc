@@ -0,0 +1,268 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/fc_rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/failsafe.h"
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+
+    #include "rx/rx.h"
+
+    #include "scheduler/scheduler.h"
+
+    #include "sensors/battery.h"
+
+    float applyBetaflightRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyRaceFlightRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyRatesLookup(const int axis, float rcCommandf, const float rcCommandfAbs);
+    uint16_t rcInterpolationAutoRefreshRate(void);
+    void updateRxRefreshRate(void);
+    int calcRcSmoothingCutoff(int avgRxFrameTimeUs, bool pt1);
+
+    extern uint16_t rateLookupSegments[XYZ_AXIS_COUNT];
+
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+    PG_REGISTER(rcControlsConfig_t, rcControlsConfig, PG_RC_CONTROLS_CONFIG, 0);
+    PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+    controlRateConfig_t testControlRateProfile;
+    controlRateConfig_t *currentControlRateProfile = &testControlRateProfile;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SETPOINT_RATE_LIMIT 1998.0f
+#define RATE_LOOKUP_MAX_ERROR 0.1f
+#define TEST_POINTS 20000
+
+static void setRates(uint8_t ratesType, uint8_t rcRate, uint8_t expo, uint8_t superRate)
+{
+    memset(&testControlRateProfile, 0, sizeof(testControlRateProfile));
+    testControlRateProfile.rates_type = ratesType;
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        testControlRateProfile.rcRates[axis] = rcRate;
+        testControlRateProfile.rcExpo[axis] = expo;
+        testControlRateProfile.rates[axis] = superRate;
+    }
+    initRcProcessing();
+}
+
+static float maxLookupError(int axis)
+{
+    float maxError = 0;
+    for (int i = -TEST_POINTS; i <= TEST_POINTS; i++) {
+        const float rcCommandf = (float)i / TEST_POINTS;
+        const float rcCommandfAbs = fabsf(rcCommandf);
+        const float curve = testControlRateProfile.rates_type == RATES_TYPE_RACEFLIGHT
+            ? applyRaceFlightRates(axis, rcCommandf, rcCommandfAbs)
+            : applyBetaflightRates(axis, rcCommandf, rcCommandfAbs);
+        const float lookup = applyRatesLookup(axis, rcCommandf, rcCommandfAbs);
+        // setpoints are limited after the rate curve is applied
+        maxError = fmaxf(maxError, fabsf(constrainf(lookup, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT) - constrainf(curve, -SETPOINT_RATE_LIMIT, SETPOINT_RATE_LIMIT)));
+    }
+    return maxError;
+}
+
+TEST(FcRcUnittest, TestBetaflightRatesLookupAccuracy)
+{
+    const uint8_t rcRates[] = { 1, 50, 100, 120, 200, 255 };
+    const uint8_t expos[] = { 0, 15, 50, 100 };
+    const uint8_t superRates[] = { 0, 40, 70, 80, 90, 100, 150, 255 };
+
+    for (unsigned r = 0; r < ARRAYLEN(rcRates); r++) {
+        for (unsigned e = 0; e < ARRAYLEN(expos); e++) {
+            for (unsigned s = 0; s < ARRAYLEN(superRates); s++) {
+                setRates(RATES_TYPE_BETAFLIGHT, rcRates[r], expos[e], superRates[s]);
+                EXPECT_LE(maxLookupError(FD_ROLL), RATE_LOOKUP_MAX_ERROR)
+                    << "rc_rate " << (int)rcRates[r] << " expo " << (int)expos[e] << " srate " << (int)superRates[s];
+            }
+        }
+    }
+}
+
+TEST(FcRcUnittest, TestRaceFlightRatesLookupAccuracy)
+{
+    const uint8_t rcRates[] = { 1, 37, 100, 200, 255 };
+    const uint8_t expos[] = { 0, 50, 100 };
+    const uint8_t superRates[] = { 0, 80, 255 };
+
+    for (unsigned r = 0; r < ARRAYLEN(rcRates); r++) {
+        for (unsigned e = 0; e < ARRAYLEN(expos); e++) {
+            for (unsigned s = 0; s < ARRAYLEN(superRates); s++) {
+                setRates(RATES_TYPE_RACEFLIGHT, rcRates[r], expos[e], superRates[s]);
+                EXPECT_LE(maxLookupError(FD_ROLL), RATE_LOOKUP_MAX_ERROR)
+                    << "rc_rate " << (int)rcRates[r] << " expo " << (int)expos[e] << " acro+ " << (int)superRates[s];
+            }
+        }
+    }
+}
+
+TEST(FcRcUnittest, TestRatesLookupCoverage)
+{
+    // typical rates are interpolated over the whole stick range
+    setRates(RATES_TYPE_BETAFLIGHT, 100, 0, 70);
+    EXPECT_EQ(512, rateLookupSegments[FD_ROLL]);
+    setRates(RATES_TYPE_RACEFLIGHT, 37, 50, 80);
+    EXPECT_EQ(512, rateLookupSegments[FD_ROLL]);
+
+    // very high super rates fall back to the curve near full deflection
+    setRates(RATES_TYPE_BETAFLIGHT, 10, 0, 99);
+    EXPECT_GT(rateLookupSegments[FD_ROLL], 256);
+    EXPECT_LT(rateLookupSegments[FD_ROLL], 512);
+}
+
+TEST(FcRcUnittest, TestRatesLookupRebuiltOnChange)
+{
+    setRates(RATES_TYPE_BETAFLIGHT, 100, 0, 70);
+    const float before = applyRatesLookup(FD_PITCH, 0.5f, 0.5f);
+
+    testControlRateProfile.rcRates[FD_PITCH] = 150;
+    initRcProcessing();
+    EXPECT_NEAR(applyBetaflightRates(FD_PITCH, 0.5f, 0.5f), applyRatesLookup(FD_PITCH, 0.5f, 0.5f), RATE_LOOKUP_MAX_ERROR);
+    EXPECT_GT(applyRatesLookup(FD_PITCH, 0.5f, 0.5f), before);
+
+    // other axes are unchanged
+    EXPECT_NEAR(before, applyRatesLookup(FD_ROLL, 0.5f, 0.5f), 1e-4f);
+    EXPECT_NEAR(-before, applyRatesLookup(FD_ROLL, -0.5f, 0.5f), 1e-4f);
+}
+
+// Frame timing as reported by the receiver and the rx task
+static timeDelta_t testFrameDeltaUs;
+static timeDelta_t testFrameAgeUs;
+static timeDelta_t testTaskDeltaUs;
+
+static void setFrameTiming(timeDelta_t frameDeltaUs, timeDelta_t frameAgeUs, timeDelta_t taskDeltaUs)
+{
+    testFrameDeltaUs = frameDeltaUs;
+    testFrameAgeUs = frameAgeUs;
+    testTaskDeltaUs = taskDeltaUs;
+    updateRxRefreshRate();
+}
+
+TEST(FcRcUnittest, TestAutoInterpolationFollowsTheFrameInterval)
+{
+    // crsf 150Hz, ibus, sbus and crsf 50Hz, each processed on arrival
+    const timeDelta_t frameIntervalsUs[] = { 6667, 7000, 9000, 20000 };
+    for (unsigned i = 0; i < ARRAYLEN(frameIntervalsUs); i++) {
+        // the rx task runs late, it does not change the frame interval
+        setFrameTiming(frameIntervalsUs[i], 0, frameIntervalsUs[i] + 3000);
+        EXPECT_EQ(frameIntervalsUs[i], currentRxRefreshRate);
+        EXPECT_EQ(frameIntervalsUs[i] + 1000, rcInterpolationAutoRefreshRate());
+    }
+}
+
+TEST(FcRcUnittest, TestAutoInterpolationIsShortenedByTheFrameAge)
+{
+    // the frame waited 1.5ms for the rx task, the next one is due that much sooner
+    setFrameTiming(6667, 1500, 6667);
+    EXPECT_EQ(6667 - 1500 + 1000, rcInterpolationAutoRefreshRate());
+
+    // never by more than half a frame interval
+    setFrameTiming(9000, 6000, 9000);
+    EXPECT_EQ(9000 - 4500 + 1000, rcInterpolationAutoRefreshRate());
+}
+
+TEST(FcRcUnittest, TestAutoInterpolationFallsBackToTheTaskInterval)
+{
+    // no frame timing from the receiver yet, the frame age is unknown and not used
+    setFrameTiming(0, 1500, 9000);
+    EXPECT_EQ(9000, currentRxRefreshRate);
+    EXPECT_EQ(9000 + 1000, rcInterpolationAutoRefreshRate());
+
+    // limited as before
+    setFrameTiming(0, 0, 500);
+    EXPECT_EQ(1000, currentRxRefreshRate);
+    setFrameTiming(0, 0, 50000);
+    EXPECT_EQ(20000, currentRxRefreshRate);
+}
+
+TEST(FcRcUnittest, TestAutoSmoothingCutoffFromTheFrameInterval)
+{
+    // 90% of the nyquist frequency of the frame rate for the biquad, and the pt1 of similar response
+    setFrameTiming(6667, 2000, 9000);
+    EXPECT_EQ(67, calcRcSmoothingCutoff(currentRxRefreshRate, false));
+    EXPECT_EQ(57, calcRcSmoothingCutoff(currentRxRefreshRate, true));
+
+    setFrameTiming(9000, 0, 9000);
+    EXPECT_EQ(50, calcRcSmoothingCutoff(currentRxRefreshRate, false));
+    EXPECT_EQ(31, calcRcSmoothingCutoff(currentRxRefreshRate, true));
+
+    setFrameTiming(20000, 0, 20000);
+    EXPECT_EQ(22, calcRcSmoothingCutoff(currentRxRefreshRate, false));
+
+    // falls back to the rx task interval
+    setFrameTiming(0, 0, 4000);
+    EXPECT_EQ(112, calcRcSmoothingCutoff(currentRxRefreshRate, false));
+}
+
+// STUBS
+
+extern "C" {
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+float rcCommand[4];
+int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+uint32_t targetPidLooptime;
+uint16_t flightModeFlags;
+quaternion qHeadfree;
+struct pidProfile_s *currentPidProfile;
+
+bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+bool failsafeIsActive(void) { return false; }
+bool feature(uint32_t) { return false; }
+const lowVoltageCutoff_t *getLowVoltageCutoff(void) { return NULL; }
+timeDelta_t getTaskDeltaTime(cfTaskId_e) { return testTaskDeltaUs; }
+uint32_t millis(void) { return 0; }
+bool pidAntiGravityEnabled(void) { return false; }
+void pidInitSetpointDerivativeLpf(uint16_t, uint8_t, uint8_t) {}
+void pidSetItermAccelerator(float) {}
+void pidUpdateSetpointDerivativeLpf(uint16_t) {}
+bool rxIsReceivingSignal(void) { return false; }
+timeDelta_t rxGetFrameDelta(timeDelta_t *frameAgeUs)
+{
+    if (frameAgeUs) {
+        *frameAgeUs = testFrameAgeUs;
+    }
+    return testFrameDeltaUs;
+}
+uint16_t rxGetRefreshRate(void) { return 0; }
+}
@@ -43,6 +43,7 @@ extern "C" {
     #include "flight/mixer.h"
     #include "flight/pid.h"
     #include "flight/imu.h"
+    #include "flight/position_estimator.h"
 
     #include "io/gps.h"
 
@@ -55,6 +56,8 @@ extern "C" {
     #include "sensors/sensors.h"
 
     void imuUpdateEulerAngles(void);
+    void imuMahonyAHRSupdate(float dt, quaternion *vGyro, quaternion *vError);
+    void imuCalculateAcceleration(timeDelta_t deltaT);
 
     PG_REGISTER(rcControlsConfig_t, rcControlsConfig, PG_RC_CONTROLS_CONFIG, 0);
     PG_REGISTER(barometerConfig_t, barometerConfig, PG_BAROMETER_CONFIG, 0);
@@ -67,10 +70,232 @@ extern "C" {
 #include "unittest_macros.h"
 #include "gtest/gtest.h"
 
+// double precision attitude integrated with the exact exponential map
+typedef struct {
+    double w, x, y, z;
+} referenceQuaternion_t;
+
+static referenceQuaternion_t reference;
+static uint32_t enabledSensors;
+
+static void resetAttitude(void)
+{
+    reference = { 1.0, 0.0, 0.0, 0.0 };
+    qAttitude.w = 1.0f;
+    qAttitude.x = 0.0f;
+    qAttitude.y = 0.0f;
+    qAttitude.z = 0.0f;
+    imuUpdateEulerAngles();
+}
+
+static void referenceRotate(double rateX, double rateY, double rateZ, double dt)
+{
+    const double rate = std::sqrt(rateX * rateX + rateY * rateY + rateZ * rateZ);
+    if (rate == 0.0) {
+        return;
+    }
+    const double halfAngle = 0.5 * rate * dt;
+    const double w = std::cos(halfAngle);
+    const double x = std::sin(halfAngle) * rateX / rate;
+    const double y = std::sin(halfAngle) * rateY / rate;
+    const double z = std::sin(halfAngle) * rateZ / rate;
+    const referenceQuaternion_t q = reference;
+    reference.w = q.w * w - q.x * x - q.y * y - q.z * z;
+    reference.x = q.w * x + q.x * w + q.y * z - q.z * y;
+    reference.y = q.w * y - q.x * z + q.y * w + q.z * x;
+    reference.z = q.w * z + q.x * y - q.y * x + q.z * w;
+}
+
+static void integrate(float rateX, float rateY, float rateZ, float dt)
+{
+    quaternion vGyro = { 0.0f, rateX, rateY, rateZ };
+    quaternion vError = VECTOR_INITIALIZE;
+    imuMahonyAHRSupdate(dt, &vGyro, &vError);
+    referenceRotate(rateX, rateY, rateZ, dt);
+}
+
+// angle between the estimated and the reference attitude, in degrees
+static double attitudeErrorDegrees(void)
+{
+    const double dot = qAttitude.w * reference.w + qAttitude.x * reference.x + qAttitude.y * reference.y + qAttitude.z * reference.z;
+    const double norm = std::sqrt(qAttitude.w * qAttitude.w + qAttitude.x * qAttitude.x + qAttitude.y * qAttitude.y + qAttitude.z * qAttitude.z);
+    return 2.0 * std::acos(std::fmin(std::fabs(dot) / norm, 1.0)) * 180.0 / M_PI;
+}
+
+TEST(FlightImuTest, TestConstantRateAccuracy)
+{
+    resetAttitude();
+
+    // 2 seconds at 1kHz, about 260 degrees around a tilted axis
+    for (int i = 0; i < 2000; i++) {
+        integrate(0.5f, -1.0f, 2.0f, 0.001f);
+    }
+
+    EXPECT_LT(attitudeErrorDegrees(), 0.05);
+}
+
+TEST(FlightImuTest, TestVaryingRateAccuracy)
+{
+    resetAttitude();
+
+    const float dt = 0.002f;
+    for (int i = 0; i < 2000; i++) {
+        const float t = i * dt;
+        integrate(6.0f * sinf(2.0f * t), 4.0f * cosf(3.0f * t), 3.0f * sinf(t), dt);
+    }
+
+    EXPECT_LT(attitudeErrorDegrees(), 0.05);
+}
+
+TEST(FlightImuTest, TestLargeAngleStepAccuracy)
+{
+    resetAttitude();
+
+    // 1500 deg/s at 100Hz, each step rotates well past the Taylor series range
+    const float rate = 1500.0f * RAD / sqrtf(3.0f);
+    for (int i = 0; i < 100; i++) {
+        integrate(rate, -rate, rate, 0.01f);
+    }
+
+    EXPECT_LT(attitudeErrorDegrees(), 0.05);
+}
+
+TEST(FlightImuTest, TestEulerAnglesComputedOnDemand)
+{
+    resetAttitude();
+    EXPECT_EQ(0, attitude.values.roll);
+
+    // 90 degrees of roll
+    for (int i = 0; i < 100; i++) {
+        integrate(M_PIf / 2.0f, 0.0f, 0.0f, 0.01f);
+    }
+
+    // attitude is left alone until it is read
+    EXPECT_EQ(0, attitude.values.roll);
+
+    imuRefreshEulerAngles();
+    const attitudeEulerAngles_t refreshed = attitude;
+    EXPECT_NEAR(900, refreshed.values.roll, 1);
+    EXPECT_NEAR(0, refreshed.values.pitch, 1);
+
+    imuUpdateEulerAngles();
+    EXPECT_EQ(refreshed.values.roll, attitude.values.roll);
+    EXPECT_EQ(refreshed.values.pitch, attitude.values.pitch);
+    EXPECT_EQ(refreshed.values.yaw, attitude.values.yaw);
+}
+
+static void configureGyroPropagation(bool enabled)
+{
+    imuConfigMutable()->gyro_propagation = enabled;
+    imuConfigure(800);
+    enabledSensors = SENSOR_ACC;
+    acc.isAccelUpdatedAtLeastOnce = true;
+}
+
+static void setGyro(float rollRate, float pitchRate, float yawRate)
+{
+    gyro.gyroADCf[FD_ROLL] = rollRate;
+    gyro.gyroADCf[FD_PITCH] = pitchRate;
+    gyro.gyroADCf[FD_YAW] = yawRate;
+}
+
+TEST(FlightImuTest, TestGyroPropagationMatchesAttitudeTask)
+{
+    configureGyroPropagation(true);
+    quaternion vError = VECTOR_INITIALIZE;
+    quaternion vNoGyro = VECTOR_INITIALIZE;
+
+    // the attitude task turning by the average gyro of a 4ms interval
+    resetAttitude();
+    quaternion vGyro = { 0.0f, 300.0f * RAD, -200.0f * RAD, 500.0f * RAD };
+    imuMahonyAHRSupdate(0.004f, &vGyro, &vError);
+    const quaternion qAttitudeTask = qAttitude;
+
+    // the PID loop at 8kHz over the same interval, then the correction step
+    resetAttitude();
+    setGyro(300.0f, -200.0f, 500.0f);
+    for (int i = 0; i < 32; i++) {
+        imuPropagateAttitude(0.000125f);
+    }
+    imuMahonyAHRSupdate(0.004f, &vNoGyro, &vError);
+
+    EXPECT_NEAR(qAttitudeTask.w, qAttitude.w, 1e-5f);
+    EXPECT_NEAR(qAttitudeTask.x, qAttitude.x, 1e-5f);
+    EXPECT_NEAR(qAttitudeTask.y, qAttitude.y, 1e-5f);
+    EXPECT_NEAR(qAttitudeTask.z, qAttitude.z, 1e-5f);
+}
+
+TEST(FlightImuTest, TestGyroPropagationIsCurrent)
+{
+    configureGyroPropagation(true);
+    resetAttitude();
+
+    // half way through an attitude task interval at 500deg/s of roll
+    setGyro(500.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 16; i++) {
+        imuPropagateAttitude(0.000125f);
+    }
+
+    imuRefreshEulerAngles();
+    EXPECT_EQ(10, attitude.values.roll);
+    EXPECT_EQ(0, attitude.values.pitch);
+}
+
+TEST(FlightImuTest, TestGyroPropagationDisabled)
+{
+    configureGyroPropagation(false);
+    resetAttitude();
+
+    setGyro(500.0f, 0.0f, 0.0f);
+    imuPropagateAttitude(0.000125f);
+
+    EXPECT_EQ(1.0f, qAttitude.w);
+    EXPECT_EQ(0.0f, qAttitude.x);
+}
+
+TEST(FlightImuTest, TestAccelerationAndGpsShareEarthFrame)
+{
+    // nose pointing east, a quarter turn clockwise seen from above
+    resetAttitude();
+    qAttitude.w = cosf(-M_PIf / 4.0f);
+    qAttitude.z = sinf(-M_PIf / 4.0f);
+    imuUpdateEulerAngles();
+    EXPECT_EQ(900, attitude.values.yaw);
+
+    positionEstimatorResetAxis(POSITION_NORTH);
+    positionEstimatorResetAxis(POSITION_EAST);
+    positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, 0.0f);
+    positionEstimatorUpdatePosition(POSITION_EAST, POSITION_SOURCE_GPS, 0.0f);
+
+    // 1m/s/s forwards, the acc at 1kHz and the GPS at 10Hz reporting the same flight
+    const float accelerationCmss = 100.0f;
+    acc.dev.acc_1G = 512;
+    acc.accADC[X] = accelerationCmss * acc.dev.acc_1G / 980.665f;
+    acc.accADC[Y] = 0;
+    acc.accADC[Z] = acc.dev.acc_1G;
+
+    float t = 0.0f;
+    for (int fix = 1; fix <= 20; fix++) {
+        for (int i = 0; i < 100; i++) {
+            imuCalculateAcceleration(1000);
+            t += 0.001f;
+        }
+        // as gps.c feeds a fix, the course is clockwise from north
+        const float groundSpeed = accelerationCmss * t;
+        const float course = DECIDEGREES_TO_RADIANS(900);
+        positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, 0.0f);
+        positionEstimatorUpdatePosition(POSITION_EAST, POSITION_SOURCE_GPS, 0.5f * accelerationCmss * t * t);
+        positionEstimatorUpdateVelocity(POSITION_NORTH, POSITION_SOURCE_GPS, groundSpeed * cos_approx(course));
+        positionEstimatorUpdateVelocity(POSITION_EAST, POSITION_SOURCE_GPS, groundSpeed * sin_approx(course));
+    }
+
+    EXPECT_NEAR(accelerationCmss * t, positionEstimatorGetVelocity(POSITION_EAST), 5.0f);
+    EXPECT_NEAR(0.0f, positionEstimatorGetVelocity(POSITION_NORTH), 5.0f);
+}
+
 // STUBS
 
 extern "C" {
-boxBitmask_t rcModeActivationMask;
 float rcCommand[4];
 int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
 float vGyroStdDevModulus;
@@ -81,6 +306,7 @@ mag_t mag;
 
 gpsSolutionData_t gpsSol;
 uint16_t GPS_distanceToHome = 0;
+uint8_t GPS_update = 0;
 
 uint8_t debugMode;
 int16_t debug[DEBUG16_VALUE_COUNT];
@@ -103,8 +329,7 @@ uint16_t disableFlightMode(flightModeFlags_e mask)
 
 bool sensors(uint32_t mask)
 {
-    UNUSED(mask);
-    return false;
+    return enabledSensors & mask;
 };
 
 uint32_t millis(void) { return 0; }
@@ -114,6 +339,7 @@ bool compassIsHealthy(quaternion *) { return true; }
 bool isBaroCalibrationComplete(void) { return true; }
 void performBaroCalibrationCycle(void) {}
 int32_t baroCalculateAltitude(void) { return 0; }
+uint16_t baroGetSampleCount(void) { return 0; }
 bool gyroGetAverage(quaternion *) { return false; }
 bool accGetAverage(quaternion *) { return false; }
 bool accIsHealthy(quaternion *) { return false; }
@@ -0,0 +1,349 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <limits.h>
+#include <cmath>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/filter.h"
+    #include "common/maths.h"
+
+    #include "config/feature.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "drivers/pwm_output.h"
+
+    #include "fc/config.h"
+    #include "fc/controlrate_profile.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/mixer.h"
+    #include "flight/pid.h"
+
+    #include "rx/rx.h"
+
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+    PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+    extern float motor[MAX_SUPPORTED_MOTORS];
+
+    float mixerLinearizeThrust(float thrust);
+    float mixerMotorThrust(float output);
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_MIN_THROTTLE 1000
+#define TEST_MAX_THROTTLE 2000
+#define TEST_MIN_CHECK 1000
+
+static const motorMixer_t testTricopterMix[] = {
+    { 1.0f,  0.0f,  1.333333f,  0.0f },     // REAR
+    { 1.0f, -1.0f, -0.666667f,  0.0f },     // RIGHT
+    { 1.0f,  1.0f, -0.666667f,  0.0f },     // LEFT
+};
+
+bool simulatedAirmode;
+bool simulatedFailsafe;
+controlRateConfig_t controlRateProfile;
+pidProfile_t pidProfile;
+
+class MixerTest : public ::testing::Test {
+protected:
+    uint8_t thrustLinear;
+
+    virtual void SetUp() {
+        thrustLinear = 0;
+        pgResetAll();
+        memset(&controlRateProfile, 0, sizeof(controlRateProfile));
+        controlRateProfile.throttle_limit_type = THROTTLE_LIMIT_TYPE_OFF;
+        controlRateProfile.throttle_limit_percent = 100;
+        currentControlRateProfile = &controlRateProfile;
+
+        memset(&pidProfile, 0, sizeof(pidProfile));
+        pidProfile.pidSumLimit = 1000;
+        currentPidProfile = &pidProfile;
+
+        memset(pidData, 0, sizeof(pidData));
+        memset(rcCommand, 0, sizeof(rcCommand));
+        memset(rcData, 0, sizeof(rcData));
+
+        motorConfigMutable()->dev.motorPwmProtocol = PWM_TYPE_STANDARD;
+        motorConfigMutable()->minthrottle = TEST_MIN_THROTTLE;
+        motorConfigMutable()->maxthrottle = TEST_MAX_THROTTLE;
+        rxConfigMutable()->mincheck = TEST_MIN_CHECK;
+        mixerConfigMutable()->yaw_motors_reversed = true;
+
+        simulatedAirmode = true;
+        simulatedFailsafe = false;
+        ENABLE_ARMING_FLAG(ARMED);
+    }
+
+    void configure(mixerMode_e mixerMode, mixerSaturation_e saturation) {
+        mixerConfigMutable()->saturation = saturation;
+        mixerConfigMutable()->thrust_linear = thrustLinear;
+        mixerInit(mixerMode);
+        mixerConfigureOutput();
+    }
+
+    void mix(float roll, float pitch, float yaw, float throttle) {
+        pidData[FD_ROLL].Sum = roll * PID_MIXER_SCALING;
+        pidData[FD_PITCH].Sum = pitch * PID_MIXER_SCALING;
+        pidData[FD_YAW].Sum = yaw * PID_MIXER_SCALING;
+        rcCommand[THROTTLE] = TEST_MIN_CHECK + throttle * (PWM_RANGE_MAX - TEST_MIN_CHECK);
+        mixTable(0, 0);
+    }
+
+    // motor output as a share of the motor range
+    float output(int index) {
+        return (motor[index] - TEST_MIN_THROTTLE) / (TEST_MAX_THROTTLE - TEST_MIN_THROTTLE);
+    }
+
+    // roll delivered by a quad X, the motors on the left against the right
+    float quadRoll(void) {
+        return (output(2) + output(3) - output(0) - output(1)) / 4;
+    }
+
+    float quadYaw(void) {
+        return (output(0) + output(3) - output(1) - output(2)) / 4;
+    }
+};
+
+TEST_F(MixerTest, TestQuadMotorsIdle)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+    simulatedAirmode = false;
+
+    mix(0, 0, 0, 0);
+
+    EXPECT_EQ(4, getMotorCount());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(TEST_MIN_THROTTLE, motor[i]);
+    }
+}
+
+TEST_F(MixerTest, TestPriorityMatchesScaleWithinRange)
+{
+    float scaled[4];
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+    mix(0.1f, -0.15f, 0.05f, 0.4f);
+    memcpy(scaled, motor, sizeof(scaled));
+
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+    mix(0.1f, -0.15f, 0.05f, 0.4f);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(scaled[i], motor[i], 0.01f);
+    }
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        EXPECT_FALSE(mixerIsOutputSaturated(axis, 0));
+    }
+}
+
+TEST_F(MixerTest, TestScaleLosesRollUnderYawSaturation)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+
+    mix(0.3f, 0, 0.4f, 0.5f);
+
+    // roll and yaw are scaled down together
+    EXPECT_LT(quadRoll(), 0.3f * 0.75f);
+    EXPECT_TRUE(mixerIsOutputSaturated(FD_ROLL, 0));
+}
+
+TEST_F(MixerTest, TestPriorityKeepsRollUnderYawSaturation)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+
+    mix(0.3f, 0, 0.4f, 0.5f);
+
+    // roll is delivered in full, yaw gets the rest of the motor range
+    EXPECT_NEAR(0.3f, quadRoll(), 0.01f);
+    EXPECT_NEAR(0.2f, std::fabs(quadYaw()), 0.01f);
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_ROLL, 0));
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_PITCH, 0));
+    EXPECT_TRUE(mixerIsOutputSaturated(FD_YAW, 0));
+    EXPECT_GT(getMotorMixRange(), 1.0f);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_GE(output(i), -0.001f);
+        EXPECT_LE(output(i), 1.001f);
+    }
+}
+
+TEST_F(MixerTest, TestPriorityScalesRollPitchBeyondRange)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+
+    mix(0.8f, 0, 0.2f, 0.5f);
+
+    // roll alone exceeds the range, it gets all of it and yaw nothing
+    EXPECT_NEAR(0.5f, quadRoll(), 0.01f);
+    EXPECT_NEAR(0.0f, quadYaw(), 0.01f);
+    EXPECT_TRUE(mixerIsOutputSaturated(FD_ROLL, 0));
+    EXPECT_TRUE(mixerIsOutputSaturated(FD_YAW, 0));
+}
+
+TEST_F(MixerTest, TestPriorityPlacesThrottleLast)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+
+    mix(0.2f, 0, 0, 0.95f);
+
+    // throttle is pulled down so the roll demand fits under full output
+    EXPECT_NEAR(0.2f, quadRoll(), 0.01f);
+    EXPECT_NEAR(1.0f, output(2), 0.01f);
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_ROLL, 0));
+}
+
+TEST_F(MixerTest, TestPriorityReportsSaturationWithoutAirmode)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+    simulatedAirmode = false;
+
+    mix(0.3f, 0, 0, 0.05f);
+
+    // low throttle without airmode clips the motors, the pseudo-inverse sees the loss
+    EXPECT_TRUE(mixerIsOutputSaturated(FD_ROLL, 0));
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_PITCH, 0));
+}
+
+TEST_F(MixerTest, TestPriorityCustomMixWithoutYaw)
+{
+    for (int i = 0; i < 3; i++) {
+        *customMotorMixerMutable(i) = testTricopterMix[i];
+    }
+    configure(MIXER_CUSTOM, MIXER_SATURATION_PRIORITY);
+    EXPECT_EQ(3, getMotorCount());
+
+    mix(0.2f, 0.1f, 0.5f, 0.5f);
+
+    // the motors have no yaw authority, yaw is left to the servo
+    EXPECT_NEAR(output(1), 0.5f - 0.2f - 0.0666667f, 0.01f);
+    EXPECT_NEAR(output(2), 0.5f + 0.2f - 0.0666667f, 0.01f);
+    EXPECT_NEAR(output(0), 0.5f + 0.1333333f, 0.01f);
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_ROLL, 0));
+    EXPECT_FALSE(mixerIsOutputSaturated(FD_PITCH, 0));
+}
+
+TEST_F(MixerTest, TestThrustLinearTable)
+{
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+    EXPECT_FLOAT_EQ(0.3f, mixerLinearizeThrust(0.3f));
+    EXPECT_FLOAT_EQ(0.3f, mixerMotorThrust(0.3f));
+
+    thrustLinear = 60;
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+    EXPECT_FLOAT_EQ(0.0f, mixerLinearizeThrust(0.0f));
+    EXPECT_FLOAT_EQ(1.0f, mixerLinearizeThrust(1.0f));
+    for (int i = 1; i < 100; i++) {
+        const float thrust = i / 100.0f;
+        // the table output delivers the requested thrust
+        EXPECT_NEAR(thrust, mixerMotorThrust(mixerLinearizeThrust(thrust)), 0.002f);
+        // low thrust needs more output than a linear motor would get
+        EXPECT_GT(mixerLinearizeThrust(thrust), thrust);
+    }
+}
+
+TEST_F(MixerTest, TestThrustLinearKeepsThrottleFeel)
+{
+    thrustLinear = 60;
+    configure(MIXER_QUADX, MIXER_SATURATION_SCALE);
+    simulatedAirmode = false;
+
+    mix(0, 0, 0, 0.3f);
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(0.3f, output(i), 0.002f);
+    }
+}
+
+TEST_F(MixerTest, TestThrustLinearConstantGain)
+{
+    thrustLinear = 60;
+    configure(MIXER_QUADX, MIXER_SATURATION_PRIORITY);
+
+    // the same roll demand gives the same thrust difference at low and high throttle
+    mix(0.05f, 0, 0, 0.2f);
+    const float lowThrottleRoll = mixerMotorThrust(output(2)) - mixerMotorThrust(output(0));
+    mix(0.05f, 0, 0, 0.8f);
+    const float highThrottleRoll = mixerMotorThrust(output(2)) - mixerMotorThrust(output(0));
+
+    EXPECT_NEAR(0.1f, lowThrottleRoll, 0.003f);
+    EXPECT_NEAR(0.1f, highThrottleRoll, 0.003f);
+}
+
+// STUBS
+
+extern "C" {
+int16_t debug[DEBUG16_VALUE_COUNT];
+uint8_t debugMode;
+
+uint8_t armingFlags;
+uint16_t flightModeFlags;
+uint8_t stateFlags;
+
+pidAxisData_t pidData[XYZ_AXIS_COUNT];
+float throttleBoost;
+pt1Filter_t throttleLpf;
+float rcCommand[4];
+int16_t rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+controlRateConfig_t *currentControlRateProfile;
+pidProfile_t *currentPidProfile;
+
+bool feature(uint32_t) { return false; }
+bool isAirmodeActive(void) { return simulatedAirmode; }
+bool failsafeIsActive(void) { return simulatedFailsafe; }
+bool isFlipOverAfterCrashMode(void) { return false; }
+bool isMotorsReversed(void) { return false; }
+bool isMotorProtocolDshot(void) { return false; }
+bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+float getRcDeflection(int) { return 0; }
+float getRcDeflectionAbs(int) { return 0; }
+float calculateVbatPidCompensation(void) { return 1.0f; }
+void pidUpdateAntiGravityThrottleFilter(float) {}
+void pidResetITerm(void) {}
+float gpsRescueGetThrottle(void) { return 0; }
+bool gyroYawSpinDetected(void) { return false; }
+ioTag_t timerioTagGetByUsage(timerUsageFlag_e, uint8_t) { return 0; }
+
+bool mixerTricopterIsServoSaturated(float) { return false; }
+void mixerTricopterInit(void) {}
+float mixerTricopterMotorCorrection(int) { return 0; }
+
+bool pwmAreMotorsEnabled(void) { return true; }
+void pwmWriteMotor(uint8_t, float) {}
+void pwmCompleteMotorUpdate(uint8_t) {}
+void pwmShutdownPulsesForAllMotors(uint8_t) {}
+void pwmDisableMotors(void) {}
+void pwmEnableMotors(void) {}
+void delay(uint32_t) {}
+void delayMicroseconds(uint32_t) {}
+float pt1FilterApply(pt1Filter_t *, float input) { return input; }
+}
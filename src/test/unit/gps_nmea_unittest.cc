@@ -0,0 +1,270 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/gps_conversion.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "io/dashboard.h"
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+
+    uint8_t stateFlags;
+    uint8_t armingFlags;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// One 1Hz cycle as logged from a multi-constellation receiver in NMEA mode
+static const char * const nmeaLog[] = {
+    "$GNRMC,123519.50,A,4807.0381,N,01131.0002,E,022.4,084.4,230394,003.1,W,A*31\r\n",
+    "$GNGGA,123519.50,4807.0381,N,01131.0002,E,1,08,0.9,545.4,M,46.9,M,,*71\r\n",
+    "$GNGSA,A,3,01,02,12,14,15,,,,,,,,1.8,1.0,1.5*21\r\n",
+    "$GPGSV,2,1,08,01,40,083,46,02,17,308,41,12,07,344,39,14,22,228,45*75\r\n",
+    "$GPGSV,2,2,08,15,10,010,30,17,20,020,31,19,30,030,32,24,40,040,33*7D\r\n",
+    "$GLGSV,1,1,02,65,30,100,35,66,40,200,*66\r\n",
+    "$GAGSV,1,1,01,07,50,060,40,7*42\r\n",
+};
+
+static int framesParsed;
+
+static void replay(const char *sentence)
+{
+    for (; *sentence; sentence++) {
+        if (gpsNewFrame(*sentence)) {
+            framesParsed++;
+        }
+    }
+}
+
+static void replayLog(void)
+{
+    for (unsigned i = 0; i < ARRAYLEN(nmeaLog); i++) {
+        replay(nmeaLog[i]);
+    }
+}
+
+static void resetParser(void)
+{
+    gpsConfigMutable()->provider = GPS_NMEA;
+    memset(&gpsSol, 0, sizeof(gpsSol));
+    stateFlags = 0;
+    framesParsed = 0;
+    GPS_numCh = 0;
+    memset(GPS_svinfo_svid, 0, sizeof(GPS_svinfo_svid));
+    memset(GPS_svinfo_cno, 0, sizeof(GPS_svinfo_cno));
+}
+
+TEST(GpsNmeaTest, TestLogIsParsed)
+{
+    // given
+    resetParser();
+
+    // when
+    replayLog();
+
+    // then
+    EXPECT_EQ(1, framesParsed);
+    EXPECT_TRUE(STATE(GPS_FIX));
+    EXPECT_EQ(481173016, gpsSol.llh.lat);
+    EXPECT_EQ(115166700, gpsSol.llh.lon);
+    EXPECT_EQ(54540, gpsSol.llh.alt);
+    EXPECT_EQ(8, gpsSol.numSat);
+    EXPECT_EQ(100, gpsSol.hdop);  // from GSA, which follows GGA
+    EXPECT_EQ(1152, gpsSol.groundSpeed);
+    EXPECT_EQ(844, gpsSol.groundCourse);
+}
+
+TEST(GpsNmeaTest, TestCoordinatesMatchStringConversion)
+{
+    static const char * const coordinates[] = {
+        "4807.0381", "01131.0002", "5128.3727", "00630.3372", "0.0001", "25599.99999", "17959.9999",
+    };
+
+    for (unsigned i = 0; i < ARRAYLEN(coordinates); i++) {
+        // given
+        resetParser();
+        char sentence[96];
+        const int length = snprintf(sentence, sizeof(sentence), "$GPGGA,000000.00,%s,N,%s,E,1,05,1.0,10.0,M,,,,*", coordinates[i], coordinates[i]);
+        uint8_t parity = 0;
+        for (int j = 1; j < length - 1; j++) {
+            parity ^= sentence[j];
+        }
+        snprintf(sentence + length, sizeof(sentence) - length, "%02X\r\n", parity);
+
+        // when
+        replay(sentence);
+
+        // then
+        EXPECT_EQ(1, framesParsed);
+        EXPECT_EQ((int32_t)GPS_coord_to_degrees(coordinates[i]), gpsSol.llh.lat);
+        EXPECT_EQ((int32_t)GPS_coord_to_degrees(coordinates[i]), gpsSol.llh.lon);
+    }
+}
+
+TEST(GpsNmeaTest, TestSouthWestAndNegativeAltitude)
+{
+    // given
+    resetParser();
+
+    // when
+    replay("$GPGGA,123520.00,3351.4120,S,15112.7312,W,1,05,2.5,-12.3,M,0.0,M,,*49\r\n");
+
+    // then
+    EXPECT_EQ(1, framesParsed);
+    EXPECT_EQ(-338568666, gpsSol.llh.lat);
+    EXPECT_EQ(-1512121866, gpsSol.llh.lon);
+    EXPECT_EQ(-1230, gpsSol.llh.alt);
+    EXPECT_EQ(250, gpsSol.hdop);
+}
+
+TEST(GpsNmeaTest, TestNoFixKeepsLastPosition)
+{
+    // given
+    resetParser();
+    replayLog();
+
+    // when
+    replay("$GPGGA,123521.00,,,,,0,00,99.99,,,,,,*60\r\n");
+
+    // then
+    EXPECT_EQ(2, framesParsed);
+    EXPECT_FALSE(STATE(GPS_FIX));
+    EXPECT_EQ(481173016, gpsSol.llh.lat);
+}
+
+TEST(GpsNmeaTest, TestBadChecksumIsRejected)
+{
+    // given
+    resetParser();
+    const uint32_t errorLogCount = GPS_packetCount;
+
+    // when
+    replay("$GNGGA,123519.50,4807.0381,N,01131.0002,E,1,08,0.9,545.4,M,46.9,M,,*70\r\n");
+    replay("$GNGGA,123519.50,4807.0381,N,01131.0002,E,1,08,0.9,545.4,M,46.9,M,,*7\r\n");
+
+    // then
+    EXPECT_EQ(0, framesParsed);
+    EXPECT_FALSE(STATE(GPS_FIX));
+    EXPECT_EQ(0, gpsSol.llh.lat);
+    EXPECT_EQ(errorLogCount, GPS_packetCount);
+}
+
+TEST(GpsNmeaTest, TestSatellitesOfAllConstellations)
+{
+    // given
+    resetParser();
+
+    // when
+    replayLog();
+
+    // then
+    EXPECT_EQ(11, GPS_numCh);
+    EXPECT_EQ(1, GPS_svinfo_svid[0]);
+    EXPECT_EQ(46, GPS_svinfo_cno[0]);
+    EXPECT_EQ(24, GPS_svinfo_svid[7]);
+    EXPECT_EQ(33, GPS_svinfo_cno[7]);
+    EXPECT_EQ(65, GPS_svinfo_svid[8]);
+    EXPECT_EQ(66, GPS_svinfo_svid[9]);
+    EXPECT_EQ(0, GPS_svinfo_cno[9]);    // not tracked
+    EXPECT_EQ(7, GPS_svinfo_svid[10]);
+    EXPECT_EQ(40, GPS_svinfo_cno[10]);  // signal id after the last satellite is not a satellite
+
+    // when
+    replayLog();
+
+    // then
+    EXPECT_EQ(11, GPS_numCh);
+}
+
+TEST(GpsNmeaTest, TestRepeatedReplay)
+{
+    // given
+    resetParser();
+    const int cycles = 100;
+
+    // when
+    for (int i = 0; i < cycles; i++) {
+        replayLog();
+    }
+
+    // then
+    EXPECT_EQ(cycles, framesParsed);
+}
+
+// STUBS
+
+extern "C" {
+uint32_t millis(void) { return 0; }
+timeUs_t micros(void) { return 0; }
+bool feature(uint32_t mask) { UNUSED(mask); return false; }
+
+bool rtcHasTime(void) { return true; }
+
+void sensorsSet(uint32_t mask) { UNUSED(mask); }
+void sensorsClear(uint32_t mask) { UNUSED(mask); }
+bool sensors(uint32_t mask) { UNUSED(mask); return false; }
+
+void ledToggle(int led) { UNUSED(led); }
+
+void dashboardShowFixedPage(pageId_e pageId) { UNUSED(pageId); }
+void dashboardUpdate(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+
+bool gpsRescueIsConfigured(void) { return false; }
+void updateGPSRescueState(void) {}
+void rescueNewGpsData(void) {}
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return NULL; }
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
+void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC)
+{
+    UNUSED(left);
+    UNUSED(right);
+    UNUSED(leftC);
+    UNUSED(rightC);
+}
+baudRate_e lookupBaudRateIndex(uint32_t baudRate) { UNUSED(baudRate); return BAUD_AUTO; }
+const uint32_t baudRates[] = { 0 };
+
+uint32_t serialRxBytesWaiting(const serialPort_t *instance) { UNUSED(instance); return 0; }
+uint8_t serialRead(serialPort_t *instance) { UNUSED(instance); return 0; }
+uint32_t serialGetBaudRate(serialPort_t *instance) { UNUSED(instance); return 0; }
+void serialSetMode(serialPort_t *instance, portMode_e mode) { UNUSED(instance); UNUSED(mode); }
+void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate) { UNUSED(instance); UNUSED(baudRate); }
+bool isSerialTransmitBufferEmpty(const serialPort_t *instance) { UNUSED(instance); return true; }
+uint32_t serialTxBytesFree(const serialPort_t *instance) { UNUSED(instance); return 0; }
+void serialWrite(serialPort_t *instance, uint8_t ch) { UNUSED(instance); UNUSED(ch); }
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count) { UNUSED(instance); UNUSED(data); UNUSED(count); }
+void serialPrint(serialPort_t *instance, const char *str) { UNUSED(instance); UNUSED(str); }
+}
@@ -0,0 +1,350 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "io/dashboard.h"
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    void gpsInitUblox(void);
+
+    PG_REGISTER(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+
+    uint8_t stateFlags;
+    uint8_t armingFlags;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Receiver output as captured from a u-blox M8 at 10Hz: NAV-PVT, a stray
+// NMEA fragment, ACK-ACK for CFG-MSG and the NAV-PVT of the next epoch.
+static const uint8_t capturedPvtStream[] = {
+    0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x00, 0xE6, 0xDF, 0x0C, 0xE2, 0x07,
+    0x07, 0x0E, 0x0C, 0x22, 0x38, 0x07, 0x19, 0x00, 0x00, 0x00, 0x40, 0x4B,
+    0x4C, 0x00, 0x03, 0x01, 0x00, 0x0C, 0x24, 0x97, 0x17, 0x05, 0x4C, 0x52,
+    0x40, 0x1C, 0x50, 0x99, 0x07, 0x00, 0xD0, 0xDD, 0x06, 0x00, 0xDC, 0x05,
+    0x00, 0x00, 0xC4, 0x09, 0x00, 0x00, 0xE8, 0x03, 0x00, 0x00, 0x30, 0xF8,
+    0xFF, 0xFF, 0x2C, 0x01, 0x00, 0x00, 0x39, 0x30, 0x00, 0x00, 0x40, 0x54,
+    0x89, 0x00, 0x90, 0x01, 0x00, 0x00, 0xF0, 0x49, 0x02, 0x00, 0x7B, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xCD, 0xEC, 0x24, 0x47, 0x50, 0x0D, 0x0A, 0xB5, 0x62, 0x05,
+    0x01, 0x02, 0x00, 0x06, 0x01, 0x0F, 0x38, 0xB5, 0x62, 0x01, 0x07, 0x5C,
+    0x00, 0x64, 0xE6, 0xDF, 0x0C, 0xE2, 0x07, 0x07, 0x0E, 0x0C, 0x22, 0x38,
+    0x07, 0x19, 0x00, 0x00, 0x00, 0x40, 0x4B, 0x4C, 0x00, 0x03, 0x01, 0x00,
+    0x0D, 0x88, 0x97, 0x17, 0x05, 0x56, 0x52, 0x40, 0x1C, 0xB4, 0x99, 0x07,
+    0x00, 0x34, 0xDE, 0x06, 0x00, 0xDC, 0x05, 0x00, 0x00, 0xC4, 0x09, 0x00,
+    0x00, 0xE8, 0x03, 0x00, 0x00, 0x30, 0xF8, 0xFF, 0xFF, 0x2C, 0x01, 0x00,
+    0x00, 0x70, 0x30, 0x00, 0x00, 0x50, 0x7B, 0x89, 0x00, 0x90, 0x01, 0x00,
+    0x00, 0xF0, 0x49, 0x02, 0x00, 0x7B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xD7, 0x75,
+};
+
+#define FIRST_PVT_FRAME_LENGTH 100
+
+static int framesParsed;
+
+static void replay(const uint8_t *data, int length)
+{
+    for (int i = 0; i < length; i++) {
+        if (gpsNewFrame(data[i])) {
+            framesParsed++;
+        }
+    }
+}
+
+static int ubxFrame(uint8_t *frame, uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t length)
+{
+    frame[0] = 0xB5;
+    frame[1] = 0x62;
+    frame[2] = msgClass;
+    frame[3] = msgId;
+    frame[4] = length & 0xFF;
+    frame[5] = length >> 8;
+    memcpy(&frame[6], payload, length);
+
+    uint8_t ck_a = 0, ck_b = 0;
+    for (int i = 2; i < 6 + length; i++) {
+        ck_a += frame[i];
+        ck_b += ck_a;
+    }
+    frame[6 + length] = ck_a;
+    frame[7 + length] = ck_b;
+    return 8 + length;
+}
+
+static void resetParser(void)
+{
+    static const uint8_t flush[] = { 0x00 };
+
+    gpsConfigMutable()->provider = GPS_UBLOX;
+    memset(&gpsSol, 0, sizeof(gpsSol));
+    memset(&gpsData, 0, sizeof(gpsData));
+    stateFlags = 0;
+    framesParsed = 0;
+    replay(flush, sizeof(flush));
+}
+
+TEST(GpsUbloxTest, TestNavPvtIsParsedFromCapture)
+{
+    // given
+    resetParser();
+
+    // when
+    replay(capturedPvtStream, FIRST_PVT_FRAME_LENGTH);
+
+    // then
+    EXPECT_EQ(1, framesParsed);
+    EXPECT_EQ(85432100, gpsSol.llh.lon);
+    EXPECT_EQ(473977420, gpsSol.llh.lat);
+    EXPECT_EQ(45000, gpsSol.llh.alt);
+    EXPECT_EQ(12, gpsSol.numSat);
+    EXPECT_EQ(123, gpsSol.hdop);
+    EXPECT_EQ(1234, gpsSol.groundSpeed);
+    EXPECT_EQ(900, gpsSol.groundCourse);
+    EXPECT_TRUE(STATE(GPS_FIX));
+    EXPECT_EQ(0, gpsData.errors);
+}
+
+TEST(GpsUbloxTest, TestCaptureReplayYieldsOneFixPerPvt)
+{
+    // given
+    resetParser();
+
+    // when
+    replay(capturedPvtStream, sizeof(capturedPvtStream));
+
+    // then
+    EXPECT_EQ(2, framesParsed);
+    EXPECT_EQ(85432200, gpsSol.llh.lon);
+    EXPECT_EQ(473977430, gpsSol.llh.lat);
+    EXPECT_EQ(13, gpsSol.numSat);
+    EXPECT_EQ(0, gpsData.errors);
+}
+
+TEST(GpsUbloxTest, TestCorruptedPvtIsRejected)
+{
+    // given
+    resetParser();
+    uint8_t frame[FIRST_PVT_FRAME_LENGTH];
+    memcpy(frame, capturedPvtStream, sizeof(frame));
+    frame[30] ^= 0x01;
+
+    // when
+    replay(frame, sizeof(frame));
+
+    // then
+    EXPECT_EQ(0, framesParsed);
+    EXPECT_EQ(0, gpsSol.llh.lon);
+    EXPECT_LT(0, gpsData.errors);
+}
+
+TEST(GpsUbloxTest, TestNoFixClearsFixState)
+{
+    // given
+    resetParser();
+    ENABLE_STATE(GPS_FIX);
+    uint8_t payload[92];
+    memcpy(payload, &capturedPvtStream[6], sizeof(payload));
+    payload[20] = 2; // fix type 2D
+    uint8_t frame[FIRST_PVT_FRAME_LENGTH];
+
+    // when
+    const int length = ubxFrame(frame, 0x01, 0x07, payload, sizeof(payload));
+    replay(frame, length);
+
+    // then
+    EXPECT_EQ(1, framesParsed);
+    EXPECT_FALSE(STATE(GPS_FIX));
+}
+
+TEST(GpsUbloxTest, TestNonNavMessageIsNotParsed)
+{
+    // given
+    resetParser();
+    uint8_t payload[28] = { 0 };
+    payload[4] = 0x01; // would be a longitude if taken as NAV-POSLLH
+    uint8_t frame[8 + sizeof(payload)];
+
+    // when
+    const int length = ubxFrame(frame, 0x0A, 0x02, payload, sizeof(payload)); // MON-IO
+    replay(frame, length);
+
+    // then
+    EXPECT_EQ(0, framesParsed);
+    EXPECT_EQ(0, gpsSol.llh.lon);
+    EXPECT_EQ(0, gpsData.errors);
+}
+
+TEST(GpsUbloxTest, TestLegacyMessagesStillParsed)
+{
+    // given
+    resetParser();
+    uint8_t frame[64];
+    uint8_t posllh[28] = { 0 };
+    posllh[4] = 0x10; // longitude 16
+    uint8_t velned[36] = { 0 };
+    velned[20] = 0x64; // speed_2d 100cm/s
+
+    // when
+    int length = ubxFrame(frame, 0x01, 0x02, posllh, sizeof(posllh));
+    replay(frame, length);
+
+    // then
+    EXPECT_EQ(0, framesParsed);
+
+    // when
+    length = ubxFrame(frame, 0x01, 0x12, velned, sizeof(velned));
+    replay(frame, length);
+
+    // then
+    EXPECT_EQ(1, framesParsed);
+    EXPECT_EQ(16, gpsSol.llh.lon);
+    EXPECT_EQ(100, gpsSol.groundSpeed);
+}
+
+// serial port capturing the configuration sent to the receiver
+#define SERIAL_TX_SIZE 64
+static uint8_t serialOutput[1024];
+static int serialOutputLength;
+
+static bool containsMessage(const uint8_t *message, int length)
+{
+    for (int i = 0; i + length <= serialOutputLength; i++) {
+        if (!memcmp(&serialOutput[i], message, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void runConfiguration(void)
+{
+    resetParser();
+    serialOutputLength = 0;
+    gpsConfigMutable()->autoConfig = GPS_AUTOCONFIG_ON;
+    gpsData.state = 3; // GPS_CONFIGURE
+    for (int i = 0; i < 100 && gpsData.state == 3; i++) {
+        gpsInitUblox();
+    }
+}
+
+TEST(GpsUbloxTest, TestPvtConfiguration)
+{
+    // given
+    gpsConfigMutable()->gps_ublox_use_pvt = true;
+    gpsConfigMutable()->gps_update_rate_hz = 10;
+
+    // when
+    runConfiguration();
+
+    // then
+    static const uint8_t enablePvt[] = { 0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x07, 0x01, 0x13, 0x51 };
+    static const uint8_t disableSol[] = { 0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x00, 0x11, 0x4E };
+    static const uint8_t rate10Hz[] = { 0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0x64, 0x00, 0x01, 0x00, 0x01, 0x00, 0x7A, 0x12 };
+    EXPECT_EQ(4, gpsData.state); // GPS_RECEIVING_DATA
+    EXPECT_TRUE(containsMessage(enablePvt, sizeof(enablePvt)));
+    EXPECT_TRUE(containsMessage(disableSol, sizeof(disableSol)));
+    EXPECT_TRUE(containsMessage(rate10Hz, sizeof(rate10Hz)));
+}
+
+TEST(GpsUbloxTest, TestLegacyConfiguration)
+{
+    // given
+    gpsConfigMutable()->gps_ublox_use_pvt = false;
+    gpsConfigMutable()->gps_update_rate_hz = 5;
+
+    // when
+    runConfiguration();
+
+    // then
+    static const uint8_t enableSol[] = { 0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0x01, 0x06, 0x01, 0x12, 0x4F };
+    static const uint8_t rate5Hz[] = { 0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8, 0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A };
+    EXPECT_EQ(4, gpsData.state);
+    EXPECT_TRUE(containsMessage(enableSol, sizeof(enableSol)));
+    EXPECT_TRUE(containsMessage(rate5Hz, sizeof(rate5Hz)));
+}
+
+// STUBS
+
+extern "C" {
+uint32_t millis(void) { return 0; }
+timeUs_t micros(void) { return 0; }
+bool feature(uint32_t mask) { UNUSED(mask); return false; }
+
+bool rtcHasTime(void) { return true; }
+
+void sensorsSet(uint32_t mask) { UNUSED(mask); }
+void sensorsClear(uint32_t mask) { UNUSED(mask); }
+bool sensors(uint32_t mask) { UNUSED(mask); return false; }
+
+void ledToggle(int led) { UNUSED(led); }
+
+void dashboardShowFixedPage(pageId_e pageId) { UNUSED(pageId); }
+void dashboardUpdate(timeUs_t currentTimeUs) { UNUSED(currentTimeUs); }
+
+bool gpsRescueIsConfigured(void) { return false; }
+void updateGPSRescueState(void) {}
+void rescueNewGpsData(void) {}
+
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function) { UNUSED(function); return NULL; }
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
+void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort) { UNUSED(serialPort); }
+void serialPassthrough(serialPort_t *left, serialPort_t *right, serialConsumer *leftC, serialConsumer *rightC)
+{
+    UNUSED(left);
+    UNUSED(right);
+    UNUSED(leftC);
+    UNUSED(rightC);
+}
+baudRate_e lookupBaudRateIndex(uint32_t baudRate) { UNUSED(baudRate); return BAUD_AUTO; }
+const uint32_t baudRates[] = { 0 };
+
+uint32_t serialRxBytesWaiting(const serialPort_t *instance) { UNUSED(instance); return 0; }
+uint8_t serialRead(serialPort_t *instance) { UNUSED(instance); return 0; }
+uint32_t serialGetBaudRate(serialPort_t *instance) { UNUSED(instance); return 0; }
+void serialSetMode(serialPort_t *instance, portMode_e mode) { UNUSED(instance); UNUSED(mode); }
+void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate) { UNUSED(instance); UNUSED(baudRate); }
+bool isSerialTransmitBufferEmpty(const serialPort_t *instance) { UNUSED(instance); return true; }
+uint32_t serialTxBytesFree(const serialPort_t *instance) { UNUSED(instance); return SERIAL_TX_SIZE; }
+void serialWrite(serialPort_t *instance, uint8_t ch)
+{
+    UNUSED(instance);
+    serialOutput[serialOutputLength++] = ch;
+}
+void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count)
+{
+    while (count--) {
+        serialWrite(instance, *data++);
+    }
+}
+void serialPrint(serialPort_t *instance, const char *str) { UNUSED(instance); UNUSED(str); }
+}
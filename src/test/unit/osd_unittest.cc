@@ -562,6 +562,68 @@ TEST(OsdTest, TestElementRssi)
     displayPortTestBufferSubstring(8, 1, "%c50", SYM_RSSI);
 }
 
+/*
+ * Tests that refreshes only touch elements that changed.
+ */
+TEST(OsdTest, TestElementIncrementalRedraw)
+{
+    // given
+    osdConfigMutable()->item_pos[OSD_RSSI_VALUE] = OSD_POS(8, 1) | VISIBLE_FLAG;
+    osdConfigMutable()->rssi_alarm = 0;
+    rssi = 1024;
+    displayClearScreen(&testDisplayPort);
+    osdRefresh(simulationTime);
+    displayPortTestBufferSubstring(8, 1, "%c99", SYM_RSSI);
+
+    // when
+    // the screen is not cleared and the value does not change
+    testDisplayPortBuffer[UNITTEST_DISPLAYPORT_COLS + 9] = 'X';
+    osdRefresh(simulationTime);
+
+    // then
+    // the element is not rewritten
+    displayPortTestBufferSubstring(8, 1, "%cX9", SYM_RSSI);
+
+    // when
+    // the value changes
+    rssi = 0;
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(8, 1, "%c 0", SYM_RSSI);
+
+    // when
+    // the element moves
+    osdConfigMutable()->item_pos[OSD_RSSI_VALUE] = OSD_POS(12, 2) | VISIBLE_FLAG;
+    osdRefresh(simulationTime);
+
+    // then
+    // the old cells are blanked
+    displayPortTestBufferSubstring(8, 1, "   ");
+    displayPortTestBufferSubstring(12, 2, "%c 0", SYM_RSSI);
+
+    // when
+    // the element is hidden
+    osdConfigMutable()->item_pos[OSD_RSSI_VALUE] = OSD_POS(12, 2);
+    osdRefresh(simulationTime);
+
+    // then
+    displayPortTestBufferSubstring(12, 2, "   ");
+
+    // when
+    // the CMS takes the display, draws its menu and hands the display back
+    osdConfigMutable()->item_pos[OSD_RSSI_VALUE] = OSD_POS(12, 2) | VISIBLE_FLAG;
+    displayGrab(&testDisplayPort);
+    displayWrite(&testDisplayPort, 1, 5, "MENU");
+    displayRelease(&testDisplayPort);
+    osdRefresh(simulationTime);
+
+    // then
+    // the menu is gone and the element is redrawn
+    displayPortTestBufferSubstring(1, 5, "    ");
+    displayPortTestBufferSubstring(12, 2, "%c 0", SYM_RSSI);
+}
+
 /*
  * Tests the instantaneous battery current OSD element.
  */
@@ -961,6 +1023,7 @@ TEST(OsdTest, TestConvertTemperatureUnits)
 // STUBS
 extern "C" {
     void beeperConfirmationBeeps(uint8_t) {}
+    void imuRefreshEulerAngles(void) {}
 
     bool isModeActivationConditionPresent(boxId_e) {
         return false;
@@ -64,6 +64,9 @@ extern "C" {
     gyro_t gyro;
     attitudeEulerAngles_t attitude;
 
+    int eulerAngleRefreshCount;
+    void imuRefreshEulerAngles(void) { eulerAngleRefreshCount++; }
+
     float getThrottlePIDAttenuation(void) { return simulatedThrottlePIDAttenuation; }
     float getMotorMixRange(void) { return simulatedMotorMixRange; }
     float getSetpointRate(int axis) { return simulatedSetpointRate[axis]; }
@@ -73,6 +76,8 @@ extern "C" {
     bool gyroOverflowDetected(void) { return false; }
     float getRcDeflection(int axis) { return simulatedRcDeflection[axis]; }
     void beeperConfirmationBeeps(uint8_t) { }
+    bool isAirmodeActivated() { return true; }
+    volatile bool isSetpointNew;
 }
 
 pidProfile_t *pidProfile;
@@ -465,6 +470,28 @@ TEST(pidControllerTest, testCrashRecoveryMode) {
     // Add additional verifications
 }
 
+TEST(pidControllerTest, testCrashRecoveryRefreshesAttitude) {
+    resetTest();
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    // a crash can be detected on any axis, the attitude has to be current before then
+    pidProfile->crash_recovery = PID_CRASH_RECOVERY_ON;
+    pidInit(pidProfile);
+    DISABLE_ARMING_FLAG(ARMED);
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_FALSE(crashRecoveryModeActive());
+    eulerAngleRefreshCount = 0;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_EQ(1, eulerAngleRefreshCount);
+
+    // acro without crash recovery leaves the attitude alone
+    pidProfile->crash_recovery = PID_CRASH_RECOVERY_OFF;
+    pidInit(pidProfile);
+    eulerAngleRefreshCount = 0;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_EQ(0, eulerAngleRefreshCount);
+}
+
 TEST(pidControllerTest, pidSetpointTransition) {
 // TODO
 }
@@ -476,3 +503,203 @@ TEST(pidControllerTest, testDtermFiltering) {
 TEST(pidControllerTest, testItermRotationHandling) {
 // TODO
 }
+
+TEST(pidControllerTest, testSlowTermsDecimation) {
+    resetTest();
+    pidProfile->dterm_iterm_denom = 2;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    float previousP = 0;
+    float previousI = 0;
+    float previousD = 0;
+    for (int loop = 0; loop < 8; loop++) {
+        gyro.gyroADCf[FD_ROLL] = 5.0f * (loop + 1) * (loop + 1);
+        pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+
+        // P follows the gyro every loop
+        EXPECT_NE(previousP, pidData[FD_ROLL].P);
+        if (loop % 2 == 0) {
+            // I and D hold until the second loop of each slow interval
+            EXPECT_FLOAT_EQ(previousI, pidData[FD_ROLL].I);
+            EXPECT_FLOAT_EQ(previousD, pidData[FD_ROLL].D);
+        } else {
+            EXPECT_NE(previousI, pidData[FD_ROLL].I);
+            EXPECT_NE(previousD, pidData[FD_ROLL].D);
+        }
+        EXPECT_FLOAT_EQ(pidData[FD_ROLL].P + pidData[FD_ROLL].I + pidData[FD_ROLL].D + pidData[FD_ROLL].F, pidData[FD_ROLL].Sum);
+        previousP = pidData[FD_ROLL].P;
+        previousI = pidData[FD_ROLL].I;
+        previousD = pidData[FD_ROLL].D;
+    }
+
+    // one full rate update with the average of the two gyro samples below
+    resetTest();
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+    gyro.gyroADCf[FD_ROLL] = 200;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    const float fullRateI = pidData[FD_ROLL].I;
+
+    // the slow I term integrates the averaged gyro over twice the loop time
+    resetTest();
+    pidProfile->dterm_iterm_denom = 2;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+    gyro.gyroADCf[FD_ROLL] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    gyro.gyroADCf[FD_ROLL] = 300;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(2 * fullRateI, pidData[FD_ROLL].I);
+}
+
+// D term after the gyro goes from 0 to 100 over a sample interval of intervalUs
+static float dtermAfterSampleInterval(uint8_t jitterThreshold, uint32_t intervalUs)
+{
+    resetTest();
+    pidConfigMutable()->dterm_jitter_threshold = jitterThreshold;
+    pidProfile->dterm_iterm_denom = 1;
+    pidProfile->dterm_lowpass_hz = 0;
+    pidProfile->dterm_notch_hz = 0;
+    pidInit(pidProfile);
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+
+    gyro.sampleTimeUs = 1000;
+    gyro.gyroADCf[FD_ROLL] = 0;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    gyro.sampleTimeUs += intervalUs;
+    gyro.gyroADCf[FD_ROLL] = 100;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    return pidData[FD_ROLL].D;
+}
+
+TEST(pidControllerTest, testDtermJitterCorrection) {
+    const float nominalD = dtermAfterSampleInterval(10, targetPidLooptime);
+    EXPECT_NE(0, nominalD);
+
+    // off by default, the D term keeps the fixed loop time
+    EXPECT_FLOAT_EQ(nominalD, dtermAfterSampleInterval(0, targetPidLooptime * 2));
+
+    // deviations within the threshold are left alone
+    EXPECT_FLOAT_EQ(nominalD, dtermAfterSampleInterval(10, targetPidLooptime * 105 / 100));
+
+    // beyond it the derivative is taken over the measured interval
+    EXPECT_FLOAT_EQ(nominalD / 2, dtermAfterSampleInterval(10, targetPidLooptime * 2));
+    EXPECT_FLOAT_EQ(nominalD * 2 / 3, dtermAfterSampleInterval(10, targetPidLooptime * 3 / 2));
+
+    // but never more than twice or half the loop time
+    EXPECT_FLOAT_EQ(nominalD / 2, dtermAfterSampleInterval(10, targetPidLooptime * 10));
+    EXPECT_FLOAT_EQ(nominalD * 2, dtermAfterSampleInterval(10, targetPidLooptime / 10));
+
+    // and a regular interval afterwards restores the fixed loop time
+    gyro.sampleTimeUs += targetPidLooptime;
+    gyro.gyroADCf[FD_ROLL] = 200;
+    pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+    EXPECT_FLOAT_EQ(nominalD, pidData[FD_ROLL].D);
+}
+
+#define GOLDEN_LOOPS 60
+#define GOLDEN_SAMPLE_INTERVAL 6
+#define GOLDEN_SAMPLES (GOLDEN_LOOPS / GOLDEN_SAMPLE_INTERVAL)
+
+typedef float goldenSample_t[XYZ_AXIS_COUNT][4];
+
+// Drives the controller with a fixed pattern of gyro, stick and mixer inputs
+// and records P, I, D and F of every axis at regular intervals.
+static void runGoldenScenario(goldenSample_t *samples)
+{
+    ENABLE_ARMING_FLAG(ARMED);
+    pidStabilisationState(PID_STABILISATION_ON);
+    int sample = 0;
+    for (int loop = 0; loop < GOLDEN_LOOPS; loop++) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            gyro.gyroADCf[axis] = ((loop * loop * 7 + axis * 13) % 41 - 20) * 9.5f;
+            setStickPosition(axis, ((loop / 10 + axis) % 3 - 1) * 0.15f);
+        }
+        simulatedMotorMixRange = (loop % 23) * 0.05f;
+        simulateMixerSaturated = (loop % 17) == 0;
+        pidController(pidProfile, &rollAndPitchTrims, currentTestTime());
+        if ((loop + 1) % GOLDEN_SAMPLE_INTERVAL == 0) {
+            for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+                samples[sample][axis][0] = pidData[axis].P;
+                samples[sample][axis][1] = pidData[axis].I;
+                samples[sample][axis][2] = pidData[axis].D;
+                samples[sample][axis][3] = pidData[axis].F;
+            }
+            sample++;
+        }
+    }
+}
+
+// Reference output of the controller, recorded before its per-axis state
+// was gathered into one block. Any change of these values is a change in
+// flight behaviour.
+static const goldenSample_t goldenClassic[GOLDEN_SAMPLES] = {
+    { { -44.2000198f, 0.303935796f, 257.216125f, -6.70507479f }, { -70.5919189f, 9.29619789f, 264.249329f, -0.0f }, { 175.999344f, 36.3574715f, -448.666504f, 12.3786001f } },
+    { { -290.182739f, 0.303935796f, 315.343231f, -0.0f }, { -278.652313f, 18.216423f, -712.218323f, 6.18930006f }, { 662.968262f, 127.870544f, 191.379089f, -12.3786001f } },
+    { { 21.7797203f, 0.303935796f, 7.803123f, -0.0f }, { 173.693268f, 19.1153374f, 451.442719f, 6.18930006f }, { -471.498871f, 146.824905f, -577.952087f, -12.3786001f } },
+    { { 187.689941f, 0.195871845f, -304.626923f, 6.70507479f }, { 117.033966f, 19.1153374f, -77.9501724f, -6.18930006f }, { -404.686401f, 136.540375f, 252.855713f, -0.0f } },
+    { { 207.547913f, 0.195871845f, -319.285004f, 6.70507479f }, { -300.015656f, 5.6272316f, 181.999786f, -6.18930006f }, { 234.29213f, 150.0f, -38.8967094f, -0.0f } },
+    { { 272.887085f, 0.19587186f, 830.217224f, -6.70507479f }, { 17.6479797f, 4.20116663f, -108.786713f, -0.0f }, { 282.495758f, 150.0f, -126.256882f, 12.3786001f } },
+    { { 243.420395f, 2.0749867f, 569.728821f, -0.0f }, { 197.843124f, 7.05403376f, -183.315491f, 6.18930006f }, { 364.77829f, 150.0f, -139.489243f, -12.3786001f } },
+    { { 170.394287f, 13.343626f, 433.880798f, -0.0f }, { 314.877106f, 7.03753901f, -235.780365f, 6.18930006f }, { -301.104584f, 141.545395f, -321.990082f, -12.3786001f } },
+    { { 53.8087196f, 4.97130394f, -526.835876f, 6.70507479f }, { -77.0938034f, 7.03753901f, -609.131836f, -6.18930006f }, { 234.29213f, 150.0f, 249.79364f, -0.0f } },
+    { { 341.429138f, 4.97130394f, 264.24939f, 6.70507479f }, { -105.887871f, 2.5813489f, -682.243347f, -6.18930006f }, { -404.686401f, 137.388474f, -381.7435f, -0.0f } },
+};
+static const goldenSample_t goldenButtered[GOLDEN_SAMPLES] = {
+    { { -274.4245f, -57.8498764f, 450.718414f, 0.0f }, { -70.5919189f, 6.96485806f, -472.302826f, -0.0f }, { 175.999344f, 33.1014061f, -420.38797f, 12.3786001f } },
+    { { -85.1971436f, -99.2636566f, -415.863464f, -0.0f }, { 203.787735f, 36.1894073f, -823.065552f, 0.0f }, { 662.968262f, 106.845184f, 254.427994f, -12.3786001f } },
+    { { 73.026123f, -102.792519f, 324.65033f, -0.0f }, { 433.211456f, 75.9086456f, -565.325439f, 0.0f }, { -471.498871f, 128.664398f, -520.272583f, -12.3786001f } },
+    { { 469.160797f, -73.3377686f, 249.701767f, 0.0f }, { -662.635193f, 43.9954185f, 290.81662f, 0.0f }, { -404.686401f, 108.417343f, -373.297913f, -0.0f } },
+    { { 335.279602f, 25.442997f, 174.319443f, 0.0f }, { -856.762939f, -68.2927704f, -740.532043f, 0.0f }, { 234.29213f, 113.014153f, 120.763329f, -0.0f } },
+    { { -213.569382f, -40.2215958f, 395.359344f, 0.0f }, { 17.6479797f, -50.8341904f, 123.389893f, -0.0f }, { 282.495758f, 133.548019f, -461.255859f, 12.3786001f } },
+    { { 243.420395f, -61.5820694f, 338.371094f, -0.0f }, { 680.283142f, -22.2098484f, 110.698441f, 0.0f }, { 364.77829f, 150.0f, 20.2599983f, -12.3786001f } },
+    { { 170.394287f, -43.5291557f, 262.998383f, -0.0f }, { 574.395264f, 8.62321472f, 22.7922192f, 0.0f }, { -301.104584f, 125.709511f, -29.7121964f, -12.3786001f } },
+    { { 335.279602f, 3.91986561f, -37.4802628f, 0.0f }, { -856.762939f, -36.7143478f, -139.902588f, 0.0f }, { 234.29213f, 114.246086f, 126.345093f, -0.0f } },
+    { { 469.160797f, 63.7083626f, 119.369781f, 0.0f }, { -662.635193f, -116.603958f, -129.454422f, 0.0f }, { -404.686401f, 106.222557f, -130.11235f, -0.0f } },
+};
+
+static void expectGolden(const goldenSample_t *expected, goldenSample_t *actual)
+{
+    for (int i = 0; i < GOLDEN_SAMPLES; i++) {
+        for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+            for (int term = 0; term < 4; term++) {
+                EXPECT_FLOAT_EQ(expected[i][axis][term], actual[i][axis][term]) << "sample " << i << " axis " << axis << " term " << term;
+            }
+        }
+    }
+}
+
+TEST(pidControllerTest, testGoldenOutputClassic) {
+    goldenSample_t samples[GOLDEN_SAMPLES];
+    resetTest();
+    pidConfigMutable()->pid_process_denom = 1;
+    pidProfile->dterm_notch_hz = 100;
+    pidProfile->dterm_notch_cutoff = 60;
+    pidProfile->iterm_relax = ITERM_RELAX_RP;
+    pidProfile->iterm_relax_type = ITERM_RELAX_SETPOINT;
+    pidProfile->iterm_relax_cutoff = 11;
+    pidProfile->abs_control_gain = 10;
+    pidProfile->abs_control_limit = 90;
+    pidProfile->abs_control_error_limit = 20;
+    pidProfile->rateAccelLimit = 50;
+    pidInit(pidProfile);
+
+    runGoldenScenario(samples);
+    expectGolden(goldenClassic, samples);
+}
+
+TEST(pidControllerTest, testGoldenOutputButtered) {
+    goldenSample_t samples[GOLDEN_SAMPLES];
+    resetTest();
+    pidConfigMutable()->pid_process_denom = 1;
+    pidProfile->buttered_pids = true;
+    pidProfile->dterm_filter_type = FILTER_PT1;
+    pidInit(pidProfile);
+
+    runGoldenScenario(samples);
+    expectGolden(goldenButtered, samples);
+}
@@ -71,6 +71,11 @@ typedef struct
     void* test;
 } TIM_OCInitTypeDef;
 
+typedef struct
+{
+    void* test;
+} TIM_ICInitTypeDef;
+
 typedef struct {
     void* test;
 } DMA_TypeDef;
@@ -79,6 +84,10 @@ typedef struct {
     void* test;
 } DMA_Channel_TypeDef;
 
+typedef struct {
+    void* test;
+} DMA_InitTypeDef;
+
 uint8_t DMA_GetFlagStatus(void *);
 void DMA_Cmd(DMA_Channel_TypeDef*, FunctionalState );
 void DMA_ClearFlag(uint32_t);
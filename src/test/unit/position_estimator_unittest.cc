@@ -0,0 +1,268 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/maths.h"
+
+    #include "flight/position_estimator.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define PREDICT_HZ      500
+#define BARO_DIVIDER    (PREDICT_HZ / 40)
+#define GPS_DIVIDER     (PREDICT_HZ / 10)
+#define GPS_DELAY       (PREDICT_HZ / 10)   // 100ms, matching the latency the estimator assumes
+
+#define ACC_BIAS        30.0f
+#define ACC_NOISE       50.0f
+#define BARO_NOISE      100.0f
+#define GPS_POS_NOISE   250.0f
+#define GPS_VEL_NOISE   50.0f
+
+// deterministic gaussian noise so the replay gives the same numbers every run
+static uint32_t noiseSeed;
+
+static float uniformNoise(void)
+{
+    noiseSeed = noiseSeed * 1664525 + 1013904223;
+    return ((noiseSeed >> 8) + 0.5f) / (1 << 24);
+}
+
+static float gaussianNoise(float stdDev)
+{
+    return stdDev * sqrtf(-2.0f * logf(uniformNoise())) * cosf(2.0f * M_PIf * uniformNoise());
+}
+
+// flight path: a slow circle horizontally while bobbing up and down
+typedef struct {
+    float position[POSITION_AXIS_COUNT];
+    float velocity[POSITION_AXIS_COUNT];
+    float acceleration[POSITION_AXIS_COUNT];
+} trajectory_t;
+
+static trajectory_t trajectoryAt(float t)
+{
+    const float r = 2000.0f, w = 0.3f;     // 20m radius, 6m/s
+    const float h = 500.0f, wz = 0.5f;     // +-5m altitude
+    trajectory_t s;
+    s.position[POSITION_NORTH] = r * cosf(w * t);
+    s.position[POSITION_EAST] = r * sinf(w * t);
+    s.position[POSITION_UP] = h * sinf(wz * t);
+    s.velocity[POSITION_NORTH] = -r * w * sinf(w * t);
+    s.velocity[POSITION_EAST] = r * w * cosf(w * t);
+    s.velocity[POSITION_UP] = h * wz * cosf(wz * t);
+    s.acceleration[POSITION_NORTH] = -r * w * w * cosf(w * t);
+    s.acceleration[POSITION_EAST] = -r * w * w * sinf(w * t);
+    s.acceleration[POSITION_UP] = -h * wz * wz * sinf(wz * t);
+    return s;
+}
+
+typedef struct {
+    float estimatePositionSq[POSITION_AXIS_COUNT];
+    float estimateVelocitySq[POSITION_AXIS_COUNT];
+    float baroSq;
+    float gpsPositionSq;
+    int estimateCount;
+    int baroCount;
+    int gpsCount;
+} replayErrors_t;
+
+static replayErrors_t replayFlight(float duration, float settleTime)
+{
+    replayErrors_t errors = {};
+    const float dT = 1.0f / PREDICT_HZ;
+    const int steps = duration * PREDICT_HZ;
+
+    for (int step = 0; step < steps; step++) {
+        const float t = step * dT;
+        const trajectory_t truth = trajectoryAt(t);
+        const bool settled = t >= settleTime;
+
+        float acc[POSITION_AXIS_COUNT];
+        for (int axis = 0; axis < POSITION_AXIS_COUNT; axis++) {
+            acc[axis] = truth.acceleration[axis] + ACC_BIAS + gaussianNoise(ACC_NOISE);
+        }
+        positionEstimatorPredict(acc, dT);
+
+        if (step % BARO_DIVIDER == 0) {
+            const float baro = truth.position[POSITION_UP] + gaussianNoise(BARO_NOISE);
+            positionEstimatorUpdatePosition(POSITION_UP, POSITION_SOURCE_BARO, baro);
+            if (settled) {
+                errors.baroSq += sq(baro - truth.position[POSITION_UP]);
+                errors.baroCount++;
+            }
+        }
+
+        if (step % GPS_DIVIDER == 0 && step >= GPS_DELAY) {
+            const trajectory_t delayed = trajectoryAt(t - GPS_DELAY * dT);
+            for (int axis = POSITION_NORTH; axis <= POSITION_EAST; axis++) {
+                const float gps = delayed.position[axis] + gaussianNoise(GPS_POS_NOISE);
+                positionEstimatorUpdatePosition((positionAxis_e)axis, POSITION_SOURCE_GPS, gps);
+                positionEstimatorUpdateVelocity((positionAxis_e)axis, POSITION_SOURCE_GPS, delayed.velocity[axis] + gaussianNoise(GPS_VEL_NOISE));
+                if (settled) {
+                    errors.gpsPositionSq += sq(gps - truth.position[axis]);
+                    errors.gpsCount++;
+                }
+            }
+        }
+
+        if (settled) {
+            for (int axis = 0; axis < POSITION_AXIS_COUNT; axis++) {
+                errors.estimatePositionSq[axis] += sq(positionEstimatorGetPosition((positionAxis_e)axis) - truth.position[axis]);
+                errors.estimateVelocitySq[axis] += sq(positionEstimatorGetVelocity((positionAxis_e)axis) - truth.velocity[axis]);
+            }
+            errors.estimateCount++;
+        }
+    }
+    return errors;
+}
+
+static void resetEstimator(void)
+{
+    for (int axis = 0; axis < POSITION_AXIS_COUNT; axis++) {
+        positionEstimatorResetAxis((positionAxis_e)axis);
+    }
+    noiseSeed = 12345;
+}
+
+static void convergeOnGpsPosition(positionAxis_e axis, float position)
+{
+    const float acc[POSITION_AXIS_COUNT] = { 0 };
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < GPS_DIVIDER; j++) {
+            positionEstimatorPredict(acc, 1.0f / PREDICT_HZ);
+        }
+        EXPECT_TRUE(positionEstimatorUpdatePosition(axis, POSITION_SOURCE_GPS, position));
+        EXPECT_TRUE(positionEstimatorUpdateVelocity(axis, POSITION_SOURCE_GPS, 0.0f));
+    }
+}
+
+TEST(PositionEstimatorUnittest, TestInvalidUntilFirstMeasurement)
+{
+    resetEstimator();
+
+    const float acc[POSITION_AXIS_COUNT] = { 100.0f, 100.0f, 100.0f };
+    positionEstimatorPredict(acc, 0.01f);
+
+    for (int axis = 0; axis < POSITION_AXIS_COUNT; axis++) {
+        EXPECT_FALSE(positionEstimatorIsValid((positionAxis_e)axis));
+        EXPECT_EQ(0.0f, positionEstimatorGetPosition((positionAxis_e)axis));
+    }
+
+    // velocity alone does not start an axis
+    EXPECT_FALSE(positionEstimatorUpdateVelocity(POSITION_NORTH, POSITION_SOURCE_GPS, 100.0f));
+    EXPECT_FALSE(positionEstimatorIsValid(POSITION_NORTH));
+
+    EXPECT_TRUE(positionEstimatorUpdatePosition(POSITION_UP, POSITION_SOURCE_BARO, 1234.0f));
+    EXPECT_TRUE(positionEstimatorIsValid(POSITION_UP));
+    EXPECT_FLOAT_EQ(1234.0f, positionEstimatorGetPosition(POSITION_UP));
+    EXPECT_FALSE(positionEstimatorIsValid(POSITION_NORTH));
+}
+
+TEST(PositionEstimatorUnittest, TestReplayBeatsRawSensors)
+{
+    resetEstimator();
+
+    const replayErrors_t errors = replayFlight(120.0f, 20.0f);
+
+    const float baroRms = sqrtf(errors.baroSq / errors.baroCount);
+    const float gpsRms = sqrtf(errors.gpsPositionSq / errors.gpsCount);
+    const float upRms = sqrtf(errors.estimatePositionSq[POSITION_UP] / errors.estimateCount);
+    const float northRms = sqrtf(errors.estimatePositionSq[POSITION_NORTH] / errors.estimateCount);
+    const float eastRms = sqrtf(errors.estimatePositionSq[POSITION_EAST] / errors.estimateCount);
+
+    // raw sensors as generated
+    EXPECT_NEAR(BARO_NOISE, baroRms, 10.0f);
+    EXPECT_NEAR(GPS_POS_NOISE, gpsRms, 25.0f);
+
+    // fused estimate, current rather than 100ms late, with the accelerometer bias learned
+    EXPECT_LT(upRms, 0.5f * baroRms);
+    EXPECT_LT(northRms, 0.5f * gpsRms);
+    EXPECT_LT(eastRms, 0.5f * gpsRms);
+
+    // vertical speed comes from baro alone, still far better than differentiating it
+    EXPECT_LT(sqrtf(errors.estimateVelocitySq[POSITION_UP] / errors.estimateCount), 50.0f);
+    EXPECT_LT(sqrtf(errors.estimateVelocitySq[POSITION_NORTH] / errors.estimateCount), GPS_VEL_NOISE);
+    EXPECT_LT(sqrtf(errors.estimateVelocitySq[POSITION_EAST] / errors.estimateCount), GPS_VEL_NOISE);
+}
+
+TEST(PositionEstimatorUnittest, TestGlitchRejected)
+{
+    resetEstimator();
+    convergeOnGpsPosition(POSITION_NORTH, 1000.0f);
+
+    // a single 100m jump is ignored
+    EXPECT_FALSE(positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, 11000.0f));
+    EXPECT_NEAR(1000.0f, positionEstimatorGetPosition(POSITION_NORTH), 10.0f);
+
+    // and does not spoil the following good fixes
+    EXPECT_TRUE(positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, 1000.0f));
+    EXPECT_NEAR(1000.0f, positionEstimatorGetPosition(POSITION_NORTH), 10.0f);
+}
+
+TEST(PositionEstimatorUnittest, TestPersistentJumpResets)
+{
+    resetEstimator();
+    convergeOnGpsPosition(POSITION_EAST, 0.0f);
+
+    // the source really moved, e.g. the receiver lost and regained its fix
+    int rejected = 0;
+    while (!positionEstimatorUpdatePosition(POSITION_EAST, POSITION_SOURCE_GPS, 50000.0f)) {
+        rejected++;
+        ASSERT_LE(rejected, 10);
+    }
+    EXPECT_EQ(10, rejected);
+    EXPECT_FLOAT_EQ(50000.0f, positionEstimatorGetPosition(POSITION_EAST));
+    EXPECT_TRUE(positionEstimatorIsValid(POSITION_EAST));
+}
+
+TEST(PositionEstimatorUnittest, TestInvalidAfterMeasurementsStop)
+{
+    resetEstimator();
+    convergeOnGpsPosition(POSITION_NORTH, 0.0f);
+    EXPECT_TRUE(positionEstimatorIsValid(POSITION_NORTH));
+
+    const float acc[POSITION_AXIS_COUNT] = { 0 };
+    for (int i = 0; i < PREDICT_HZ * 9 / 10; i++) {
+        positionEstimatorPredict(acc, 1.0f / PREDICT_HZ);
+    }
+    EXPECT_TRUE(positionEstimatorIsValid(POSITION_NORTH));
+
+    for (int i = 0; i < PREDICT_HZ / 5; i++) {
+        positionEstimatorPredict(acc, 1.0f / PREDICT_HZ);
+    }
+    EXPECT_FALSE(positionEstimatorIsValid(POSITION_NORTH));
+
+    // dead reckoning carries on and the next fix makes the axis valid again
+    EXPECT_TRUE(positionEstimatorUpdatePosition(POSITION_NORTH, POSITION_SOURCE_GPS, 0.0f));
+    EXPECT_TRUE(positionEstimatorIsValid(POSITION_NORTH));
+
+    positionEstimatorResetAxis(POSITION_NORTH);
+    EXPECT_FALSE(positionEstimatorIsValid(POSITION_NORTH));
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "fc/rc_prediction.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_MAX_JERK       1000000.0f
+#define TEST_LOOPTIME_US    125
+#define TEST_FRAME_US       6667
+
+// Inter-frame intervals of a 150Hz link in microseconds, with up to 300us of arrival
+// jitter and one dropped frame. The replay cycles through the table.
+static const uint32_t frameIntervalsUs[] = {
+    6698, 6521, 6771, 6416, 6441, 6915, 6463, 6741, 6963, 6426, 6886, 6586, 6405, 6455, 6811, 6795,
+    6438, 6613, 6459, 6931, 13468, 6427, 6946, 6493, 6595, 6963, 6430, 6957, 6966, 6773, 6417, 6593
+};
+
+// 1.5Hz stick sweep for two seconds, then a 60ms flick to full deflection which is held
+static float stickPosition(uint32_t timeUs)
+{
+    const float t = timeUs * 1e-6f;
+    if (t < 2.0f) {
+        return 350.0f * sinf(2.0f * M_PI * 1.5f * t);
+    }
+    return 500.0f * fminf((t - 2.0f) / 0.06f, 1.0f);
+}
+
+static float stickRate(uint32_t timeUs)
+{
+    return (stickPosition(timeUs + 1) - stickPosition(timeUs - 1)) / 2e-6f;
+}
+
+TEST(RcPredictionUnittest, TestFirstSampleIsHeld)
+{
+    rcPredictor_t predictor;
+    rcPredictorInit(&predictor, TEST_MAX_JERK);
+
+    rcPredictorAddSample(&predictor, 100.0f, TEST_FRAME_US * 1e-6f);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_FLOAT_EQ(100.0f, rcPredictorApply(&predictor, TEST_LOOPTIME_US * 1e-6f));
+        EXPECT_FLOAT_EQ(0.0f, rcPredictorDerivative(&predictor));
+    }
+}
+
+TEST(RcPredictionUnittest, TestRampIsExtrapolated)
+{
+    rcPredictor_t predictor;
+    rcPredictorInit(&predictor, TEST_MAX_JERK);
+
+    // 3000 units per second, frames every 4ms, pid loop at 8kHz
+    const float dT = TEST_LOOPTIME_US * 1e-6f;
+    for (int frame = 0; frame < 10; frame++) {
+        rcPredictorAddSample(&predictor, frame * 12.0f, 0.004f);
+        for (int loop = 1; loop <= 32; loop++) {
+            const float output = rcPredictorApply(&predictor, dT);
+            if (frame >= 3) {
+                // no lag once the predictor has seen enough frames
+                EXPECT_NEAR(frame * 12.0f + loop * 3000.0f * dT, output, 0.5f);
+                EXPECT_NEAR(3000.0f, rcPredictorDerivative(&predictor), 10.0f);
+            }
+        }
+    }
+}
+
+TEST(RcPredictionUnittest, TestPredictionStopsWhenFramesStop)
+{
+    rcPredictor_t predictor;
+    rcPredictorInit(&predictor, TEST_MAX_JERK);
+
+    const float dT = TEST_LOOPTIME_US * 1e-6f;
+    for (int frame = 0; frame < 5; frame++) {
+        rcPredictorAddSample(&predictor, frame * 20.0f, 0.004f);
+        for (int loop = 0; loop < 32; loop++) {
+            rcPredictorApply(&predictor, dT);
+        }
+    }
+
+    // the prediction runs on while the next frame could still be arriving, then eases to a stop
+    float previousOutput = rcPredictorApply(&predictor, dT);
+    for (int loop = 0; loop < 1000; loop++) {
+        const float output = rcPredictorApply(&predictor, dT);
+        EXPECT_GE(output, previousOutput);
+        previousOutput = output;
+    }
+    EXPECT_FLOAT_EQ(0.0f, rcPredictorDerivative(&predictor));
+    EXPECT_LT(previousOutput, 80.0f + 20.0f * 1.5f + 1.0f);
+}
+
+TEST(RcPredictionUnittest, TestReplayAgainstInterpolation)
+{
+    rcPredictor_t predictor;
+    rcPredictorInit(&predictor, TEST_MAX_JERK);
+
+    // linear interpolation as done by processRcInterpolation() with rc_interp = AUTO
+    float interpolated = 0.0f;
+    float interpolationStep = 0.0f;
+    int interpolationStepCount = 0;
+
+    uint32_t lastFrameAtUs = 0;
+    uint32_t nextFrameAtUs = 0;
+    unsigned frameIndex = 0;
+
+    double predictionError = 0;
+    double interpolationError = 0;
+    double predictionRateError = 0;
+    double interpolationRateError = 0;
+    int sampleCount = 0;
+    float maxOvershoot = 0;
+    float previousInterpolated = 0;
+
+    for (uint32_t timeUs = 0; timeUs < 2500000; timeUs += TEST_LOOPTIME_US) {
+        if (timeUs >= nextFrameAtUs) {
+            // the receiver resolves the stick to whole units
+            const float sample = roundf(stickPosition(timeUs));
+            const uint32_t frameDeltaUs = frameIndex ? timeUs - lastFrameAtUs : TEST_FRAME_US;
+            rcPredictorAddSample(&predictor, sample, frameDeltaUs * 1e-6f);
+
+            interpolationStepCount = (frameDeltaUs + 1000) / TEST_LOOPTIME_US;
+            interpolationStep = (sample - interpolated) / interpolationStepCount;
+
+            lastFrameAtUs = timeUs;
+            nextFrameAtUs = timeUs + frameIntervalsUs[frameIndex++ % ARRAYLEN(frameIntervalsUs)];
+        }
+
+        const float predicted = rcPredictorApply(&predictor, TEST_LOOPTIME_US * 1e-6f);
+        if (interpolationStepCount > 0) {
+            interpolated += interpolationStep;
+            interpolationStepCount--;
+        }
+
+        if (timeUs > 200000 && timeUs < 2000000) {
+            const float position = stickPosition(timeUs);
+            const float rate = stickRate(timeUs);
+            predictionError += sq(predicted - position);
+            interpolationError += sq(interpolated - position);
+            // feed forward differentiates the interpolated signal every pid loop
+            predictionRateError += sq(rcPredictorDerivative(&predictor) - rate);
+            interpolationRateError += sq((interpolated - previousInterpolated) / (TEST_LOOPTIME_US * 1e-6f) - rate);
+            sampleCount++;
+        } else if (timeUs > 2060000) {
+            maxOvershoot = fmaxf(maxOvershoot, predicted - 500.0f);
+        }
+        previousInterpolated = interpolated;
+    }
+
+    predictionError = sqrt(predictionError / sampleCount);
+    interpolationError = sqrt(interpolationError / sampleCount);
+    predictionRateError = sqrt(predictionRateError / sampleCount);
+    interpolationRateError = sqrt(interpolationRateError / sampleCount);
+
+    // interpolation lags by a frame, the prediction does not
+    EXPECT_LT(interpolationError, 20.0);
+    EXPECT_LT(predictionError, interpolationError / 4);
+    EXPECT_LT(predictionRateError, interpolationRateError * 0.75);
+
+    // stopping the stick overshoots by less than the distance covered in one and a half frames
+    EXPECT_LT(maxOvershoot, 500.0f / 0.06f * TEST_FRAME_US * 1e-6f * 1.5f);
+    EXPECT_NEAR(500.0f, rcPredictorApply(&predictor, TEST_LOOPTIME_US * 1e-6f), 0.5f);
+}
@@ -0,0 +1,224 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "drivers/dshot.h"
+
+    #include "flight/mixer.h"
+    #include "flight/rpm_filter.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(motorConfig_t, motorConfig, PG_MOTOR_CONFIG, 0);
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TEST_LOOPTIME_US    125
+#define TEST_MOTOR_COUNT    4
+#define TEST_MOTOR_POLES    14
+#define TEST_SAMPLES        8000
+
+static uint32_t motorErpm[TEST_MOTOR_COUNT];
+
+static const uint8_t gcrEncodeTable[16] = {
+    0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17, 0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f
+};
+
+// Edge captures of the response an ESC sends for a motor turning at motorHz, with some arrival jitter
+static int synthesizeResponse(uint32_t *edges, float motorHz)
+{
+    const uint32_t erpm = lrintf(motorHz * 60.0f * (TEST_MOTOR_POLES / 2));
+    uint32_t periodUs = (60000000 + erpm / 2) / erpm;
+    int exponent = 0;
+    while ((periodUs >> exponent) > 0x1ff) {
+        exponent++;
+    }
+    const uint16_t data = (exponent << 9) | (periodUs >> exponent);
+    const uint16_t payload = (data << 4) | (~(data ^ (data >> 4) ^ (data >> 8)) & 0xf);
+
+    uint32_t frame = 1;
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        frame = (frame << 5) | gcrEncodeTable[(payload >> shift) & 0xf];
+    }
+
+    int count = 0;
+    for (int bit = 20; bit >= 0; bit--) {
+        if (frame & (1 << bit)) {
+            edges[count] = 500 + (20 - bit) * DSHOT_TELEMETRY_BIT_TICKS + ((count * 7) % 5) - 2;
+            count++;
+        }
+    }
+    return count;
+}
+
+static void setMotorFrequencies(const float *motorHz)
+{
+    for (int i = 0; i < TEST_MOTOR_COUNT; i++) {
+        uint32_t edges[DSHOT_TELEMETRY_INPUT_LEN];
+        const int count = synthesizeResponse(edges, motorHz[i]);
+        motorErpm[i] = dshotDecodeTelemetryPacket(edges, count);
+        ASSERT_NE(DSHOT_TELEMETRY_INVALID, motorErpm[i]);
+    }
+}
+
+static void initFilter(uint8_t harmonics)
+{
+    motorConfigMutable()->dev.useDshotTelemetry = true;
+    motorConfigMutable()->motorPoleCount = TEST_MOTOR_POLES;
+
+    rpmFilterConfig_t config;
+    config.gyro_rpm_notch_harmonics = harmonics;
+    config.gyro_rpm_notch_min = 100;
+    config.gyro_rpm_notch_q = 500;
+    config.rpm_lpf = 150;
+    rpmFilterInit(&config, TEST_LOOPTIME_US);
+}
+
+// Amplitude of the hz component of the second half of the samples
+static float toneAmplitude(const float *samples, float hz)
+{
+    float re = 0.0f;
+    float im = 0.0f;
+    for (int i = TEST_SAMPLES / 2; i < TEST_SAMPLES; i++) {
+        const float phase = 2.0f * M_PIf * hz * i * TEST_LOOPTIME_US * 1e-6f;
+        re += samples[i] * cosf(phase);
+        im += samples[i] * sinf(phase);
+    }
+    return 2.0f * sqrtf(re * re + im * im) / (TEST_SAMPLES / 2);
+}
+
+static float samples[TEST_SAMPLES];
+
+TEST(RpmFilterUnittest, TestDisabledWithoutTelemetry)
+{
+    initFilter(3);
+    EXPECT_TRUE(isRpmFilterEnabled());
+
+    initFilter(0);
+    EXPECT_FALSE(isRpmFilterEnabled());
+
+    motorConfigMutable()->dev.useDshotTelemetry = false;
+    rpmFilterConfig_t config = { 3, 100, 500, 150 };
+    rpmFilterInit(&config, TEST_LOOPTIME_US);
+    EXPECT_FALSE(isRpmFilterEnabled());
+}
+
+TEST(RpmFilterUnittest, TestMotorFrequencyFromTelemetry)
+{
+    initFilter(3);
+
+    const float motorHz[TEST_MOTOR_COUNT] = { 180.0f, 200.0f, 220.0f, 240.0f };
+    setMotorFrequencies(motorHz);
+
+    for (int i = 0; i < 400; i++) {
+        rpmFilterUpdate();
+    }
+    for (int i = 0; i < TEST_MOTOR_COUNT; i++) {
+        EXPECT_NEAR(motorHz[i], rpmFilterGetMotorFrequency(i), 0.5f);
+    }
+}
+
+TEST(RpmFilterUnittest, TestMotorHarmonicsAreRemoved)
+{
+    initFilter(3);
+
+    const float motorHz[TEST_MOTOR_COUNT] = { 180.0f, 200.0f, 220.0f, 240.0f };
+    setMotorFrequencies(motorHz);
+
+    // 15Hz of actual rotation, the fundamental of motor 2 and the second harmonic of motor 4
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        const float t = i * TEST_LOOPTIME_US * 1e-6f;
+        const float gyro = 100.0f * sinf(2.0f * M_PIf * 15.0f * t)
+            + 50.0f * sinf(2.0f * M_PIf * motorHz[1] * t)
+            + 30.0f * sinf(2.0f * M_PIf * 2.0f * motorHz[3] * t);
+
+        rpmFilterUpdate();
+        samples[i] = rpmFilterGyro(0, FD_ROLL, gyro);
+    }
+
+    EXPECT_NEAR(100.0f, toneAmplitude(samples, 15.0f), 3.0f);
+    EXPECT_LT(toneAmplitude(samples, motorHz[1]), 1.0f);
+    EXPECT_LT(toneAmplitude(samples, 2.0f * motorHz[3]), 1.0f);
+}
+
+TEST(RpmFilterUnittest, TestNotchesFollowMotorSpeed)
+{
+    initFilter(1);
+
+    // all motors accelerate from 150Hz to 300Hz over the run, the ESCs report every loop
+    float motorHz[TEST_MOTOR_COUNT];
+    float phase = 0.0f;
+    for (int i = 0; i < TEST_SAMPLES; i++) {
+        const float hz = 150.0f + 150.0f * i / TEST_SAMPLES;
+        for (int motor = 0; motor < TEST_MOTOR_COUNT; motor++) {
+            motorHz[motor] = hz;
+        }
+        setMotorFrequencies(motorHz);
+
+        phase += 2.0f * M_PIf * hz * TEST_LOOPTIME_US * 1e-6f;
+        rpmFilterUpdate();
+        samples[i] = rpmFilterGyro(0, FD_YAW, 50.0f * sinf(phase));
+    }
+
+    // residual of the sweeping tone once the smoothing of the motor frequency has settled
+    float peak = 0.0f;
+    for (int i = TEST_SAMPLES / 2; i < TEST_SAMPLES; i++) {
+        peak = MAX(peak, fabsf(samples[i]));
+    }
+    EXPECT_LT(peak, 5.0f);
+}
+
+// STUBS
+
+extern "C" {
+uint8_t getMotorCount(void)
+{
+    return TEST_MOTOR_COUNT;
+}
+
+uint32_t getDshotTelemetry(uint8_t index)
+{
+    return motorErpm[index];
+}
+
+volatile bool isSetpointNew;
+
+float getSetpointRate(int axis)
+{
+    UNUSED(axis);
+    return 0.0f;
+}
+}
@@ -42,9 +42,11 @@ extern "C" {
     #include "telemetry/msp_shared.h"
 
     void crsfDataReceive(uint16_t c);
+    void crsfFrameReceive(const uint8_t *data, uint16_t length, void *callbackData);
     uint8_t crsfFrameCRC(void);
     uint8_t crsfFrameStatus(void);
     uint16_t crsfReadRawRC(const rxRuntimeConfig_t *rxRuntimeConfig, uint8_t chan);
+    timeUs_t crsfFrameTimeUs(void);
 
     extern bool crsfFrameDone;
     extern crsfFrame_t crsfFrame;
@@ -277,6 +279,77 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+TEST(CrossFireTest, TestCrsfFrameReceiveChunked)
+{
+    // replay the captured stream as the DMA idle line interrupt would deliver it, with the
+    // frames split into bursts of every size from one byte up to the whole frame
+    const int frameCount = sizeof(capturedData) / sizeof(crsfRcChannelsFrame_t);
+    const uint32_t expectedChannel3[] = { 983, 981 };
+
+    for (unsigned int chunkSize = 1; chunkSize <= sizeof(crsfRcChannelsFrame_t); ++chunkSize) {
+        for (int frame = 0; frame < frameCount; ++frame) {
+            // frames are sent at 250Hz, so there is always a gap before the next one
+            dummyTimeUs += 4000;
+            crsfFrameDone = false;
+            const uint8_t *pData = capturedData + frame * sizeof(crsfRcChannelsFrame_t);
+            unsigned int remaining = sizeof(crsfRcChannelsFrame_t);
+            while (remaining > 0) {
+                EXPECT_EQ(false, crsfFrameDone);
+                const unsigned int length = std::min(chunkSize, remaining);
+                crsfFrameReceive(pData, length, NULL);
+                pData += length;
+                remaining -= length;
+                // 21.43us per byte at 420000 baud
+                dummyTimeUs += 22 * length;
+            }
+            EXPECT_EQ(true, crsfFrameDone);
+            EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+            EXPECT_EQ(false, crsfFrameDone);
+            EXPECT_EQ(189, crsfChannelData[0]);
+            EXPECT_EQ(993, crsfChannelData[1]);
+            EXPECT_EQ(978, crsfChannelData[2]);
+            EXPECT_EQ(expectedChannel3[frame], crsfChannelData[3]);
+        }
+    }
+}
+
+TEST(CrossFireTest, TestCrsfFrameReceiveResyncAfterTruncatedFrame)
+{
+    // a burst that ends mid-frame is discarded once the line has been idle for longer than a frame takes
+    dummyTimeUs += 4000;
+    crsfFrameDone = false;
+    crsfFrameReceive(capturedData, 10, NULL);
+    EXPECT_EQ(false, crsfFrameDone);
+
+    dummyTimeUs += 4000;
+    crsfFrameReceive(capturedData + sizeof(crsfRcChannelsFrame_t), sizeof(crsfRcChannelsFrame_t), NULL);
+    EXPECT_EQ(true, crsfFrameDone);
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(981, crsfChannelData[3]);
+}
+
+TEST(CrossFireTest, TestCrsfFrameTimeIsArrivalTime)
+{
+    // the frame time is when the last byte arrived, not when the rx task got round to processing it
+    dummyTimeUs += 4000;
+    crsfFrameDone = false;
+    crsfFrameReceive(capturedData, sizeof(crsfRcChannelsFrame_t), NULL);
+    const timeUs_t arrivalTimeUs = dummyTimeUs;
+    dummyTimeUs += 1500;
+    EXPECT_EQ(RX_FRAME_COMPLETE, crsfFrameStatus());
+    EXPECT_EQ(arrivalTimeUs, crsfFrameTimeUs());
+
+    // a frame that fails its CRC does not update the frame time
+    dummyTimeUs += 4000;
+    crsfFrameDone = false;
+    uint8_t corruptFrame[sizeof(crsfRcChannelsFrame_t)];
+    memcpy(corruptFrame, capturedData, sizeof(corruptFrame));
+    corruptFrame[5] ^= 0x01;
+    crsfFrameReceive(corruptFrame, sizeof(corruptFrame), NULL);
+    EXPECT_EQ(RX_FRAME_PENDING, crsfFrameStatus());
+    EXPECT_EQ(arrivalTimeUs, crsfFrameTimeUs());
+}
+
 // STUBS
 
 extern "C" {
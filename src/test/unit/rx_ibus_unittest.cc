@@ -84,6 +84,7 @@ static serialPortConfig_t serialTestInstanceConfig = {
 };
 
 static serialReceiveCallbackPtr stub_serialRxCallback;
+static serialReceiveFrameCallbackPtr stub_serialRxFrameCallback;
 static serialPortConfig_t *findSerialPortConfig_stub_retval;
 static bool openSerial_called = false;
 static serialPortStub_t serialWriteStub;
@@ -130,6 +131,12 @@ serialPort_t *openSerialPort(
     return &serialTestInstance;
 }
 
+void serialSetRxFrameCb(serialPort_t *instance, serialReceiveFrameCallbackPtr cb)
+{
+    EXPECT_EQ(instance, &serialTestInstance);
+    stub_serialRxFrameCallback = cb;
+}
+
 void serialWrite(serialPort_t *instance, uint8_t ch)
 {
     EXPECT_EQ(instance, &serialTestInstance);
@@ -144,6 +151,7 @@ void serialTestResetPort()
 {
     openSerial_called = false;
     stub_serialRxCallback = NULL;
+    stub_serialRxFrameCallback = NULL;
     portIsShared = false;
     serialExpectedMode = MODE_RX;
     serialExpectedOptions = SERIAL_UNIDIR;
@@ -304,6 +312,38 @@ TEST_F(IbusRxProtocollUnitTest, Test_IA6B_OnePacketReceived)
 }
 
 
+TEST_F(IbusRxProtocollUnitTest, Test_IA6B_OnePacketReceivedInDmaBursts)
+{
+    uint8_t packet[] = {0x20, 0x00, //length and reserved (unknown) bits
+                        0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, //channel 1..5
+                        0x05, 0x00, 0x06, 0x00, 0x07, 0x00, 0x08, 0x00, 0x09, 0x00, //channel 6..10
+                        0x0a, 0x00, 0x0b, 0x00, 0x0c, 0x00, 0x0d, 0x00,             //channel 11..14
+                        0x84, 0xff}; //checksum
+
+    ASSERT_FALSE(NULL == stub_serialRxFrameCallback);
+
+    // the idle line interrupt may split a frame at any point, e.g. where the DMA buffer wraps
+    const size_t bursts[] = { 1, 7, 2, 13, 9 };
+    size_t pos = 0;
+    for (size_t i = 0; i < sizeof(bursts) / sizeof(bursts[0]); i++) {
+        EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+        stub_serialRxFrameCallback(&packet[pos], bursts[i], NULL);
+        pos += bursts[i];
+        microseconds_stub_value += 100;
+    }
+    EXPECT_EQ(sizeof(packet), pos);
+
+    //report frame complete once
+    EXPECT_EQ(RX_FRAME_COMPLETE, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+    EXPECT_EQ(RX_FRAME_PENDING, rxRuntimeConfig.rcFrameStatusFn(&rxRuntimeConfig));
+
+    //check that channel values have been updated
+    for (int i=0; i<14; i++) {
+        ASSERT_EQ(i, rxRuntimeConfig.rcReadRawFn(&rxRuntimeConfig, i));
+    }
+}
+
+
 TEST_F(IbusRxProtocollUnitTest, Test_IA6B_OnePacketReceivedWithBadCrc)
 {
     uint8_t packet[] = {0x20, 0x00, //length and reserved (unknown) bits
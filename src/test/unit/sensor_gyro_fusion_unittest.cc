@@ -0,0 +1,246 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+
+    #include "sensors/gyro_fusion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define LOOPTIME_US 125
+#define OUTLIER_THRESHOLD 200.0f
+#define SAMPLES_PER_SECOND (1000000 / LOOPTIME_US)
+
+static gyroFusion_t fusion;
+
+// Synthetic gyro streams: the same slow motion on every sensor, each with
+// noise of its own. Deterministic, so the tests do not depend on a seed.
+static uint32_t noiseState;
+static float noise(float amplitude)
+{
+    // sum of uniforms, near enough to gaussian with a standard deviation of amplitude
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        noiseState = noiseState * 1664525u + 1013904223u;
+        sum += (noiseState >> 8) / (float)(1 << 24) - 0.5f;
+    }
+    return sum * amplitude * sqrtf(3.0f);
+}
+
+static float motion(int sample, int axis)
+{
+    return 100.0f * sinf(2.0f * M_PIf * 5.0f * sample / SAMPLES_PER_SECOND + axis);
+}
+
+typedef struct stream_s {
+    float noise;
+    float offset;
+    bool stuck;
+    float sample[XYZ_AXIS_COUNT];
+} stream_t;
+
+static void streamNext(stream_t *stream, int sample)
+{
+    if (stream->stuck) {
+        return;
+    }
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        stream->sample[axis] = motion(sample, axis) + stream->offset + noise(stream->noise);
+    }
+}
+
+// Runs the fusion over the streams and returns the rms error of the fused
+// output against the true motion over the last half of the run
+static float run(stream_t *stream1, stream_t *stream2, int samples, int *sampleIndex, bool fault1 = false, bool fault2 = false)
+{
+    float squareSum = 0.0f;
+    int count = 0;
+    for (int i = 0; i < samples; i++) {
+        const int sample = (*sampleIndex)++;
+        streamNext(stream1, sample);
+        streamNext(stream2, sample);
+        float fused[XYZ_AXIS_COUNT];
+        gyroFusionUpdate(&fusion, stream1->sample, stream2->sample, fault1, fault2, fused);
+        if (i >= samples / 2) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                squareSum += powf(fused[axis] - motion(sample, axis), 2);
+                count++;
+            }
+        }
+    }
+    return sqrtf(squareSum / count);
+}
+
+static void reset(void)
+{
+    noiseState = 12345;
+    gyroFusionInit(&fusion, LOOPTIME_US, OUTLIER_THRESHOLD);
+}
+
+TEST(GyroFusionTest, EqualSensorsAreAveraged)
+{
+    reset();
+    stream_t stream1 = { .noise = 4.0f };
+    stream_t stream2 = { .noise = 4.0f };
+    int sample = 0;
+    const float error = run(&stream1, &stream2, SAMPLES_PER_SECOND, &sample);
+
+    EXPECT_NEAR(0.5f, fusion.sensor[0].weight, 0.1f);
+    EXPECT_NEAR(0.5f, fusion.sensor[1].weight, 0.1f);
+    // two independent sensors, the noise drops by sqrt(2)
+    EXPECT_NEAR(4.0f / sqrtf(2.0f), error, 0.4f);
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 0));
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+}
+
+TEST(GyroFusionTest, NoisySensorIsWeightedDown)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 6.0f };
+    int sample = 0;
+    const float error = run(&stream1, &stream2, SAMPLES_PER_SECOND, &sample);
+
+    // inverse variance weights are 0.9 and 0.1
+    EXPECT_NEAR(0.9f, fusion.sensor[0].weight, 0.05f);
+    // better than either sensor and better than the plain average
+    const float averageError = sqrtf(2.0f * 2.0f + 6.0f * 6.0f) / 2.0f;
+    EXPECT_LT(error, 2.0f);
+    EXPECT_LT(error, averageError * 0.65f);
+}
+
+TEST(GyroFusionTest, WeightsFollowAChangeInNoise)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 6.0f };
+    int sample = 0;
+    run(&stream1, &stream2, SAMPLES_PER_SECOND, &sample);
+    EXPECT_GT(fusion.sensor[0].weight, 0.8f);
+
+    // a prop strike shakes the first gyro loose
+    stream1.noise = 12.0f;
+    run(&stream1, &stream2, SAMPLES_PER_SECOND, &sample);
+    EXPECT_LT(fusion.sensor[0].weight, 0.3f);
+}
+
+TEST(GyroFusionTest, ReportedFaultDropsTheSensor)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 2.0f, .offset = 50.0f };
+    int sample = 0;
+    run(&stream1, &stream2, 100, &sample);
+
+    const float error = run(&stream1, &stream2, 100, &sample, false, true);
+    EXPECT_FLOAT_EQ(1.0f, fusion.sensor[0].weight);
+    EXPECT_FLOAT_EQ(0.0f, fusion.sensor[1].weight);
+    EXPECT_FALSE(gyroFusionSensorHealthy(&fusion, 1));
+    EXPECT_EQ(GYRO_FUSION_FAULT_REPORTED, fusion.sensor[1].faults);
+    EXPECT_EQ(1, fusion.sensor[1].dropCount);
+    EXPECT_LT(error, 3.0f);
+
+    // back as soon as the fault clears
+    run(&stream1, &stream2, 1, &sample);
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+}
+
+TEST(GyroFusionTest, StuckSensorIsDropped)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 2.0f };
+    int sample = 0;
+    run(&stream1, &stream2, 1000, &sample);
+
+    // the second gyro stops updating, within the outlier threshold
+    stream2.stuck = true;
+    run(&stream1, &stream2, 20000 / LOOPTIME_US - 1, &sample);
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+    run(&stream1, &stream2, 1, &sample);
+    EXPECT_FALSE(gyroFusionSensorHealthy(&fusion, 1));
+    EXPECT_TRUE(fusion.sensor[1].faults & GYRO_FUSION_FAULT_STUCK);
+    EXPECT_FLOAT_EQ(1.0f, fusion.sensor[0].weight);
+
+    stream2.stuck = false;
+    run(&stream1, &stream2, 2, &sample);
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+}
+
+TEST(GyroFusionTest, OutlierIsDroppedUntilItAgreesAgain)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 2.0f };
+    int sample = 0;
+    run(&stream1, &stream2, 1000, &sample);
+
+    // the second gyro jumps away and stays away
+    stream2.offset = 500.0f;
+    const float error = run(&stream1, &stream2, 2000, &sample);
+    EXPECT_FALSE(gyroFusionSensorHealthy(&fusion, 1));
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 0));
+    EXPECT_EQ(GYRO_FUSION_FAULT_OUTLIER, fusion.sensor[1].faults);
+    EXPECT_EQ(1, fusion.sensor[1].dropCount);
+    EXPECT_EQ(0, fusion.sensor[0].dropCount);
+    EXPECT_LT(error, 3.0f);
+
+    // it has to agree for the hold time before it is used again
+    stream2.offset = 0.0f;
+    run(&stream1, &stream2, 100000 / LOOPTIME_US - 1, &sample);
+    EXPECT_FALSE(gyroFusionSensorHealthy(&fusion, 1));
+    run(&stream1, &stream2, 2, &sample);
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+}
+
+TEST(GyroFusionTest, OutlierOnTheFirstSensor)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 2.0f };
+    int sample = 0;
+    run(&stream1, &stream2, 1000, &sample);
+
+    stream1.offset = -400.0f;
+    const float error = run(&stream1, &stream2, 1000, &sample);
+    EXPECT_FALSE(gyroFusionSensorHealthy(&fusion, 0));
+    EXPECT_TRUE(gyroFusionSensorHealthy(&fusion, 1));
+    EXPECT_FLOAT_EQ(1.0f, fusion.sensor[1].weight);
+    EXPECT_LT(error, 3.0f);
+}
+
+TEST(GyroFusionTest, BothFaultyFallsBackToTheAverage)
+{
+    reset();
+    stream_t stream1 = { .noise = 2.0f };
+    stream_t stream2 = { .noise = 6.0f };
+    int sample = 0;
+    run(&stream1, &stream2, 1000, &sample, true, true);
+
+    EXPECT_FLOAT_EQ(0.5f, fusion.sensor[0].weight);
+    EXPECT_FLOAT_EQ(0.5f, fusion.sensor[1].weight);
+}
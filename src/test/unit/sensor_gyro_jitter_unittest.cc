@@ -0,0 +1,146 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "sensors/gyro_jitter.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define EXPECTED_US 250
+
+static gyroJitterStats_t stats;
+
+// feeds a sample taken intervalUs after the previous one, used latencyUs later
+static timeUs_t sampleTimeUs;
+static uint32_t feed(uint32_t intervalUs, uint32_t latencyUs)
+{
+    sampleTimeUs += intervalUs;
+    return gyroJitterUpdate(&stats, sampleTimeUs, sampleTimeUs + latencyUs);
+}
+
+static void start(void)
+{
+    gyroJitterInit(&stats, EXPECTED_US);
+    sampleTimeUs = 1000;
+    gyroJitterUpdate(&stats, sampleTimeUs, sampleTimeUs);
+}
+
+TEST(GyroJitterTest, FirstSampleOnlySetsTheReference)
+{
+    gyroJitterInit(&stats, EXPECTED_US);
+    EXPECT_EQ(0, gyroJitterUpdate(&stats, 1000, 1010));
+    EXPECT_EQ(0, stats.sampleCount);
+    EXPECT_EQ(0, gyroJitterMeanIntervalUs(&stats));
+}
+
+TEST(GyroJitterTest, RepeatedSampleIsNotCounted)
+{
+    start();
+    EXPECT_EQ(EXPECTED_US, feed(EXPECTED_US, 0));
+    EXPECT_EQ(0, gyroJitterUpdate(&stats, sampleTimeUs, sampleTimeUs + 300));
+    EXPECT_EQ(1, stats.sampleCount);
+}
+
+TEST(GyroJitterTest, SteadyIntervalsFallInTheFirstBucket)
+{
+    start();
+    for (int i = 0; i < 100; i++) {
+        feed(EXPECTED_US, 20);
+    }
+
+    EXPECT_EQ(100, stats.sampleCount);
+    EXPECT_EQ(100, stats.histogram[0]);
+    EXPECT_EQ(EXPECTED_US, stats.minIntervalUs);
+    EXPECT_EQ(EXPECTED_US, stats.maxIntervalUs);
+    EXPECT_EQ(EXPECTED_US, gyroJitterMeanIntervalUs(&stats));
+    EXPECT_EQ(0, gyroJitterMeanDeviationUs(&stats));
+    EXPECT_EQ(20, gyroJitterMeanLatencyUs(&stats));
+    EXPECT_EQ(20, stats.maxLatencyUs);
+}
+
+TEST(GyroJitterTest, DeviationsAreSortedIntoBuckets)
+{
+    start();
+    feed(EXPECTED_US + 2, 0);       // 0.8%
+    feed(EXPECTED_US - 3, 0);       // 1.2%
+    feed(EXPECTED_US + 10, 0);      // 4%
+    feed(EXPECTED_US + 25, 0);      // 10%, on the edge goes up
+    feed(EXPECTED_US - 100, 0);     // 40%
+    feed(EXPECTED_US * 2, 0);       // 100%, a lost sample
+    feed(EXPECTED_US * 3, 0);       // 200%
+
+    EXPECT_EQ(1, stats.histogram[0]);
+    EXPECT_EQ(1, stats.histogram[1]);
+    EXPECT_EQ(1, stats.histogram[2]);
+    EXPECT_EQ(0, stats.histogram[3]);
+    EXPECT_EQ(1, stats.histogram[4]);
+    EXPECT_EQ(1, stats.histogram[5]);
+    EXPECT_EQ(0, stats.histogram[6]);
+    EXPECT_EQ(2, stats.histogram[7]);
+    EXPECT_EQ(EXPECTED_US - 100, stats.minIntervalUs);
+    EXPECT_EQ(EXPECTED_US * 3, stats.maxIntervalUs);
+}
+
+TEST(GyroJitterTest, MeansAndLatency)
+{
+    start();
+    feed(EXPECTED_US - 50, 10);
+    feed(EXPECTED_US + 50, 30);
+
+    EXPECT_EQ(EXPECTED_US, gyroJitterMeanIntervalUs(&stats));
+    EXPECT_EQ(50, gyroJitterMeanDeviationUs(&stats));
+    EXPECT_EQ(20, gyroJitterMeanLatencyUs(&stats));
+    EXPECT_EQ(30, stats.maxLatencyUs);
+}
+
+TEST(GyroJitterTest, TimerWrapIsHandled)
+{
+    gyroJitterInit(&stats, EXPECTED_US);
+    sampleTimeUs = UINT32_MAX - 100;
+    gyroJitterUpdate(&stats, sampleTimeUs, sampleTimeUs);
+
+    EXPECT_EQ(EXPECTED_US, feed(EXPECTED_US, 5));
+    EXPECT_EQ(1, stats.histogram[0]);
+    EXPECT_EQ(5, stats.maxLatencyUs);
+}
+
+TEST(GyroJitterTest, ResetKeepsTheReference)
+{
+    start();
+    feed(EXPECTED_US * 2, 0);
+    gyroJitterReset(&stats);
+
+    EXPECT_EQ(0, stats.sampleCount);
+    EXPECT_EQ(0, stats.histogram[7]);
+    EXPECT_EQ(EXPECTED_US, feed(EXPECTED_US, 0));
+    EXPECT_EQ(1, stats.sampleCount);
+    EXPECT_EQ(EXPECTED_US, stats.minIntervalUs);
+}
+
+TEST(GyroJitterTest, BucketEdges)
+{
+    EXPECT_EQ(1, gyroJitterBucketEdge(0));
+    EXPECT_EQ(100, gyroJitterBucketEdge(GYRO_JITTER_BUCKET_COUNT - 2));
+    EXPECT_EQ(0, gyroJitterBucketEdge(GYRO_JITTER_BUCKET_COUNT - 1));
+}
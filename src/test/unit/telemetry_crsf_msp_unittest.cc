@@ -88,6 +88,8 @@ extern "C" {
     extern mspPackage_t mspPackage;
     extern uint8_t checksum;
 
+    void crsfFrameReceive(const uint8_t *data, uint16_t length, void *callbackData);
+
     uint32_t dummyTimeUs;
 
 }
@@ -245,6 +247,136 @@ TEST(CrossFireMSPTest, SendMspReply) {
     EXPECT_EQ(0x71, sbufReadU8(&payloadOutputBuf)); // CRC
 }
 
+#define TEST_MSP_FRAMES_MAX 16
+#define TEST_LONG_REPLY_CMD 0x71
+#define TEST_LONG_REPLY_SIZE 100
+
+static uint8_t testMspFrames[TEST_MSP_FRAMES_MAX][CRSF_FRAME_SIZE_MAX];
+static int testMspFrameCount;
+
+static void testWriteBuf(serialPort_t *, const void *buf, int count)
+{
+    const uint8_t *data = (const uint8_t *)buf;
+    if (data[2] == CRSF_FRAMETYPE_MSP_RESP && testMspFrameCount < TEST_MSP_FRAMES_MAX) {
+        memcpy(testMspFrames[testMspFrameCount++], data, count);
+    }
+}
+
+static const struct serialPortVTable testSerialVTable = { .writeBuf = testWriteBuf };
+
+// sends a single frame MSP request from the radio, as the link would deliver it
+static void testReceiveMspRequest(uint8_t cmd)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    uint8_t *p = frame;
+    *p++ = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    *p++ = CRSF_FRAME_LENGTH_EXT_TYPE_CRC + CRSF_FRAME_RX_MSP_FRAME_SIZE;
+    *p++ = CRSF_FRAMETYPE_MSP_REQ;
+    *p++ = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    *p++ = CRSF_ADDRESS_RADIO_TRANSMITTER;
+    *p++ = 0x30; // version 1, start of request
+    *p++ = 0; // payload size
+    *p++ = cmd;
+    *p++ = cmd; // checksum
+    memset(p, 0, 4);
+    p += 4;
+    uint8_t crc = 0;
+    for (uint8_t *c = &frame[2]; c < p; c++) {
+        crc = crc8_dvb_s2(crc, *c);
+    }
+    *p++ = crc;
+
+    dummyTimeUs += 4000;
+    crsfFrameReceive(frame, p - frame, NULL);
+}
+
+// a link frame that carries no request but still opens a reply slot
+static void testReceiveRcFrame(void)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+    memset(frame, 0, sizeof(frame));
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[1] = CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + CRSF_FRAME_LENGTH_TYPE_CRC;
+    frame[2] = CRSF_FRAMETYPE_RC_CHANNELS_PACKED;
+
+    dummyTimeUs += 4000;
+    crsfFrameReceive(frame, CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE + 4, NULL);
+}
+
+static void testRunTelemetry(int cycles)
+{
+    for (int i = 0; i < cycles; i++) {
+        dummyTimeUs += 1000;
+        handleCrsfTelemetry(dummyTimeUs);
+    }
+    crsfRxSendTelemetryData();
+}
+
+static void testExpectPidReply(const uint8_t *frame)
+{
+    EXPECT_EQ(CRSF_FRAME_TX_MSP_FRAME_SIZE + CRSF_FRAME_LENGTH_EXT_TYPE_CRC, frame[1]);
+    EXPECT_EQ(CRSF_ADDRESS_RADIO_TRANSMITTER, frame[3]);
+    EXPECT_EQ(CRSF_ADDRESS_FLIGHT_CONTROLLER, frame[4]);
+    const uint8_t *payload = &frame[5];
+    EXPECT_EQ(0x10, payload[0] & 0xF0); // start of reply
+    EXPECT_EQ(30, payload[1]);
+    for (int ii = 1; ii <= 30; ii++) {
+        EXPECT_EQ(ii, payload[1 + ii]);
+    }
+    EXPECT_EQ(0x71, payload[32]);
+}
+
+TEST(CrossFireMSPTest, WindowedReplies)
+{
+    rxConfig_t testRxConfig;
+    memset(&testRxConfig, 0, sizeof(testRxConfig));
+    rxRuntimeConfig_t rxRuntimeConfig;
+    EXPECT_TRUE(crsfRxInit(&testRxConfig, &rxRuntimeConfig));
+    initCrsfMspBuffer();
+    initCrsfTelemetry();
+    EXPECT_TRUE(checkCrsfTelemetryState());
+    testMspFrameCount = 0;
+
+    // three requests in flight before the first reply goes out
+    testReceiveMspRequest(0x70);
+    testReceiveMspRequest(TEST_LONG_REPLY_CMD);
+    testReceiveMspRequest(0x70);
+
+    // each received frame opens one reply slot, running telemetry more often does not send faster
+    testRunTelemetry(50);
+    EXPECT_EQ(3, testMspFrameCount);
+    testExpectPidReply(testMspFrames[0]);
+
+    // the long reply is split over two frames, the sequence number runs on between replies
+    const uint8_t *first = &testMspFrames[1][5];
+    const uint8_t *second = &testMspFrames[2][5];
+    EXPECT_EQ(0x10 | ((testMspFrames[0][5] + 1) & 0x0F), first[0]);
+    EXPECT_EQ(TEST_LONG_REPLY_SIZE, first[1]);
+    uint8_t replyChecksum = TEST_LONG_REPLY_SIZE ^ TEST_LONG_REPLY_CMD;
+    for (int ii = 0; ii < CRSF_FRAME_TX_MSP_FRAME_SIZE - 2; ii++) {
+        EXPECT_EQ(ii, first[2 + ii]);
+        replyChecksum ^= first[2 + ii];
+    }
+    EXPECT_EQ((first[0] + 1) & 0x0F, second[0]);
+    const int remaining = TEST_LONG_REPLY_SIZE - (CRSF_FRAME_TX_MSP_FRAME_SIZE - 2);
+    for (int ii = 0; ii < remaining; ii++) {
+        EXPECT_EQ(CRSF_FRAME_TX_MSP_FRAME_SIZE - 2 + ii, second[1 + ii]);
+        replyChecksum ^= second[1 + ii];
+    }
+    EXPECT_EQ(replyChecksum, second[1 + remaining]);
+
+    // the last reply goes out with the next slot
+    testReceiveRcFrame();
+    testRunTelemetry(50);
+    EXPECT_EQ(4, testMspFrameCount);
+    testExpectPidReply(testMspFrames[3]);
+
+    // nothing left to send
+    testReceiveRcFrame();
+    testRunTelemetry(50);
+    EXPECT_EQ(4, testMspFrameCount);
+}
+
 // STUBS
 
 extern "C" {
@@ -253,8 +385,11 @@ extern "C" {
     attitudeEulerAngles_t attitude = { { 0, 0, 0 } };
 
     uint32_t micros(void) {return dummyTimeUs;}
-    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
-    serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return NULL;}
+    void imuRefreshEulerAngles(void) {}
+    static serialPort_t testSerialPort = { .vTable = &testSerialVTable };
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return &testSerialPort;}
+    static serialPortConfig_t testSerialPortConfig;
+    serialPortConfig_t *findSerialPortConfig(serialPortFunction_e ) {return &testSerialPortConfig;}
     bool isBatteryVoltageConfigured(void) { return true; }
     uint16_t getBatteryVoltage(void) {
         return testBatteryVoltage;
@@ -284,6 +419,10 @@ extern "C" {
             for (unsigned int ii=1; ii<=30; ii++) {
                 sbufWriteU8(dst, ii);
             }
+        } else if (cmdMSP == TEST_LONG_REPLY_CMD) {
+            for (unsigned int ii=0; ii<TEST_LONG_REPLY_SIZE; ii++) {
+                sbufWriteU8(dst, ii);
+            }
         } else if (cmdMSP == 0xCA) {
             return MSP_RESULT_ACK;
         }
@@ -293,6 +432,10 @@ extern "C" {
 
     void beeperConfirmationBeeps(uint8_t ) {}
 
+    int16_t getEstimatedVario(void) {
+        return 0;
+    }
+
     int32_t getMAhDrawn(void) {
       return testmAhDrawn;
     }
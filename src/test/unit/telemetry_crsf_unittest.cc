@@ -66,6 +66,10 @@ extern "C" {
     uint16_t testBatteryVoltage = 0;
     int32_t testAmperage = 0;
     int32_t testmAhDrawn = 0;
+    int16_t testVario = 0;
+
+    uint8_t testFrameCount[UINT8_MAX + 1];
+    int testFrameBytes = 0;
 
     serialPort_t *telemetrySharedPort;
     PG_REGISTER(batteryConfig_t, batteryConfig, PG_BATTERY_CONFIG, 0);
@@ -212,6 +216,69 @@ TEST(TelemetryCrsfTest, TestAttitude)
     EXPECT_EQ(crfsCrc(frame, frameLen), frame[9]);
 }
 
+/*
+0x07 Vario sensor
+Payload:
+int16_t     Vertical speed ( cm/s )
+*/
+TEST(TelemetryCrsfTest, TestVario)
+{
+    uint8_t frame[CRSF_FRAME_SIZE_MAX];
+
+    testVario = -123;
+    int frameLen = getCrsfFrame(frame, CRSF_FRAMETYPE_VARIO_SENSOR);
+    EXPECT_EQ(CRSF_FRAME_VARIO_SENSOR_PAYLOAD_SIZE + FRAME_HEADER_FOOTER_LEN, frameLen);
+    EXPECT_EQ(CRSF_SYNC_BYTE, frame[0]); // address
+    EXPECT_EQ(4, frame[1]); // length
+    EXPECT_EQ(0x07, frame[2]); // type
+    int16_t vario = frame[3] << 8 | frame[4]; // cm/s
+    EXPECT_EQ(-123, vario);
+    EXPECT_EQ(crfsCrc(frame, frameLen), frame[5]);
+}
+
+TEST(TelemetryCrsfTest, TestTelemetrySchedule)
+{
+    rxConfig_t testRxConfig;
+    memset(&testRxConfig, 0, sizeof(testRxConfig));
+    rxRuntimeConfig_t rxRuntimeConfig;
+    EXPECT_TRUE(crsfRxInit(&testRxConfig, &rxRuntimeConfig));
+
+    sensorsSet(SENSOR_ACC | SENSOR_BARO);
+    initCrsfTelemetry();
+    EXPECT_TRUE(checkCrsfTelemetryState());
+
+    memset(testFrameCount, 0, sizeof(testFrameCount));
+    testFrameBytes = 0;
+    testBatteryVoltage = 168;
+
+    // two seconds of the telemetry task at 1kHz while climbing faster and faster
+    for (timeUs_t currentTimeUs = 1000000; currentTimeUs <= 3000000; currentTimeUs += 1000) {
+        testVario = currentTimeUs / 1000 % 1000;
+        handleCrsfTelemetry(currentTimeUs);
+    }
+
+    // attitude and vario at 20Hz
+    EXPECT_GE(testFrameCount[CRSF_FRAMETYPE_ATTITUDE], 38);
+    EXPECT_GE(testFrameCount[CRSF_FRAMETYPE_VARIO_SENSOR], 38);
+    // while GPS keeps its 5Hz and the unchanging battery and flight mode are refreshed every second
+    EXPECT_GE(testFrameCount[CRSF_FRAMETYPE_GPS], 9);
+    EXPECT_GE(testFrameCount[CRSF_FRAMETYPE_BATTERY_SENSOR], 2);
+    EXPECT_LE(testFrameCount[CRSF_FRAMETYPE_BATTERY_SENSOR], 3);
+    EXPECT_GE(testFrameCount[CRSF_FRAMETYPE_FLIGHT_MODE], 2);
+    EXPECT_LE(testFrameCount[CRSF_FRAMETYPE_FLIGHT_MODE], 3);
+
+    // all within the link budget
+    EXPECT_LE(testFrameBytes, 2 * 500 + CRSF_FRAME_SIZE_MAX);
+
+    // a changed flight mode goes out within 50ms
+    memset(testFrameCount, 0, sizeof(testFrameCount));
+    airMode = !airMode;
+    for (timeUs_t currentTimeUs = 3001000; currentTimeUs <= 3060000; currentTimeUs += 1000) {
+        handleCrsfTelemetry(currentTimeUs);
+    }
+    EXPECT_EQ(1, testFrameCount[CRSF_FRAMETYPE_FLIGHT_MODE]);
+}
+
 TEST(TelemetryCrsfTest, TestFlightMode)
 {
     uint8_t frame[CRSF_FRAME_SIZE_MAX];
@@ -292,6 +359,7 @@ gpsSolutionData_t gpsSol;
 void beeperConfirmationBeeps(uint8_t beepCount) {UNUSED(beepCount);}
 
 uint32_t micros(void) {return 0;}
+void imuRefreshEulerAngles(void) {}
 
 bool feature(uint32_t) {return true;}
 
@@ -299,13 +367,20 @@ uint32_t serialRxBytesWaiting(const serialPort_t *) {return 0;}
 uint32_t serialTxBytesFree(const serialPort_t *) {return 0;}
 uint8_t serialRead(serialPort_t *) {return 0;}
 void serialWrite(serialPort_t *, uint8_t) {}
-void serialWriteBuf(serialPort_t *, const uint8_t *, int) {}
+void serialWriteBuf(serialPort_t *, const uint8_t *data, int count)
+{
+    testFrameCount[data[2]]++;
+    testFrameBytes += count;
+}
 void serialSetMode(serialPort_t *, portMode_e) {}
-serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return NULL;}
+void serialSetRxFrameCb(serialPort_t *, serialReceiveFrameCallbackPtr) {}
+static serialPort_t testSerialPort;
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) {return &testSerialPort;}
 void closeSerialPort(serialPort_t *) {}
 bool isSerialTransmitBufferEmpty(const serialPort_t *) { return true; }
 
-serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) {return NULL;}
+static serialPortConfig_t testSerialPortConfig;
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) {return &testSerialPortConfig;}
 
 bool telemetryDetermineEnabledState(portSharing_e) {return true;}
 bool telemetryCheckRxPortShared(const serialPortConfig_t *) {return true;}
@@ -330,6 +405,11 @@ uint8_t calculateBatteryPercentageRemaining(void) {
     return 67;
 }
 
+int16_t getEstimatedVario(void)
+{
+    return testVario;
+}
+
 int32_t getMAhDrawn(void){
   return testmAhDrawn;
 }
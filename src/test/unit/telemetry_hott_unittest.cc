@@ -55,7 +55,14 @@ extern "C" {
     uint16_t testBatteryVoltage = 0;
     int32_t testAmperage = 0;
     int32_t testMAhDrawn = 0;
-
+    int32_t testAltitude = 0;
+    int16_t testVario = 0;
+
+    uint8_t testRxBuffer[2];
+    uint8_t testRxCount = 0;
+    uint8_t testRxIndex = 0;
+    uint8_t testTxBuffer[256];
+    int testTxCount = 0;
 }
 
 #include "unittest_macros.h"
@@ -141,6 +148,60 @@ TEST(TelemetryHottTest, UpdateGPSCoordinates3)
     EXPECT_EQ((int16_t)(hottGPSMessage->pos_EW_sec_H << 8 | hottGPSMessage->pos_EW_sec_L), 9999);
 }
 
+// Sends an EAM request and runs the telemetry task until the reply is out
+static const HOTT_EAM_MSG_t *requestEAMMessage(timeUs_t *currentTimeUs)
+{
+    testRxBuffer[0] = HOTT_BINARY_MODE_REQUEST_ID;
+    testRxBuffer[1] = HOTT_TELEMETRY_EAM_SENSOR_ID;
+    testRxCount = 2;
+    testRxIndex = 0;
+    testTxCount = 0;
+
+    while (testTxCount < (int)sizeof(HOTT_EAM_MSG_t) + 1) {
+        handleHoTTTelemetry(*currentTimeUs);
+        *currentTimeUs += 3000;
+    }
+    // back to receiving
+    handleHoTTTelemetry(*currentTimeUs);
+    *currentTimeUs += 3000;
+
+    return (const HOTT_EAM_MSG_t *)testTxBuffer;
+}
+
+TEST(TelemetryHottTest, FieldsRefreshedAtTheirOwnRate)
+{
+    // given
+    initHoTTTelemetry();
+    checkHoTTTelemetryState();
+
+    timeUs_t currentTimeUs = 1000000;
+    testVario = 100;
+    testBatteryVoltage = 160;
+
+    // when
+    const HOTT_EAM_MSG_t *eam = requestEAMMessage(&currentTimeUs);
+
+    // then
+    EXPECT_EQ(0x7C, eam->start_byte);
+    EXPECT_EQ(30000 + 100, eam->climbrate_H << 8 | eam->climbrate_L);
+    EXPECT_EQ(160, eam->main_voltage_H << 8 | eam->main_voltage_L);
+
+    // when both change, the climb rate is refreshed on the next request
+    testVario = 300;
+    testBatteryVoltage = 150;
+    eam = requestEAMMessage(&currentTimeUs);
+
+    // then
+    EXPECT_EQ(30000 + 300, eam->climbrate_H << 8 | eam->climbrate_L);
+    EXPECT_EQ(160, eam->main_voltage_H << 8 | eam->main_voltage_L);
+
+    // and the battery within its slower refresh interval
+    currentTimeUs += 200000;
+    eam = requestEAMMessage(&currentTimeUs);
+    EXPECT_EQ(30000 + 300, eam->climbrate_H << 8 | eam->climbrate_L);
+    EXPECT_EQ(150, eam->main_voltage_H << 8 | eam->main_voltage_L);
+}
+
 /*
 TEST(TelemetryHottTest, PrepareGPSMessage_Altitude1m)
 {
@@ -180,8 +241,8 @@ uint32_t fixedMillis = 0;
 
 baro_t baro;
 
-uint32_t getEstimatedAltitude() { return 0; }
-uint32_t getEstimatedVario() { return 0; }
+int32_t getEstimatedAltitude(void) { return testAltitude; }
+int16_t getEstimatedVario(void) { return testVario; }
 
 uint32_t millis(void) {
     return fixedMillis;
@@ -192,7 +253,7 @@ uint32_t micros(void) { return 0; }
 uint32_t serialRxBytesWaiting(const serialPort_t *instance)
 {
     UNUSED(instance);
-    return 0;
+    return testRxCount - testRxIndex;
 }
 
 uint32_t serialTxBytesFree(const serialPort_t *instance)
@@ -204,13 +265,15 @@ uint32_t serialTxBytesFree(const serialPort_t *instance)
 uint8_t serialRead(serialPort_t *instance)
 {
     UNUSED(instance);
-    return 0;
+    return testRxIndex < testRxCount ? testRxBuffer[testRxIndex++] : 0;
 }
 
 void serialWrite(serialPort_t *instance, uint8_t ch)
 {
     UNUSED(instance);
-    UNUSED(ch);
+    if (testTxCount < (int)sizeof(testTxBuffer)) {
+        testTxBuffer[testTxCount++] = ch;
+    }
 }
 
 void serialSetMode(serialPort_t *instance, portMode_e mode)
@@ -229,7 +292,8 @@ serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFuncti
     UNUSED(mode);
     UNUSED(options);
 
-    return NULL;
+    static serialPort_t testSerialPort;
+    return &testSerialPort;
 }
 
 void closeSerialPort(serialPort_t *serialPort)
@@ -241,7 +305,8 @@ serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
 {
     UNUSED(function);
 
-    return NULL;
+    static serialPortConfig_t testPortConfig = { .identifier = SERIAL_PORT_SOFTSERIAL1 };
+    return &testPortConfig;
 }
 
 bool sensors(uint32_t mask)
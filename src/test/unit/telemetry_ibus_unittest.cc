@@ -117,6 +117,10 @@ bool sensors(sensors_e sensor)
 {
     return (definedSensors & sensor) != 0;
 }
+
+void imuRefreshEulerAngles(void)
+{
+}
 }
 
 #define SERIAL_BUFFER_SIZE 256
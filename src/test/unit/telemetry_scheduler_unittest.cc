@@ -0,0 +1,209 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "telemetry/telemetry_scheduler.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+enum {
+    TEST_ATTITUDE = 1,
+    TEST_VARIO,
+    TEST_BATTERY,
+    TEST_GPS,
+    TEST_SENSOR_COUNT
+};
+
+static int32_t testValue[TEST_SENSOR_COUNT];
+
+static int32_t testSensorValue(uint16_t id)
+{
+    return testValue[id];
+}
+
+static telemetrySensor_t testSensors[8];
+static telemetryScheduler_t scheduler;
+
+static void initScheduler(void)
+{
+    memset(testValue, 0, sizeof(testValue));
+    telemetrySchedulerInit(&scheduler, testSensors, ARRAYLEN(testSensors), testSensorValue);
+}
+
+// Sends whatever is due every millisecond, returns how often each sensor went out
+static void runScheduler(timeUs_t *currentTimeUs, int durationMs, unsigned budget, int sent[TEST_SENSOR_COUNT])
+{
+    for (int i = 0; i < durationMs; i++) {
+        telemetrySensor_t *sensor = telemetrySchedulerNext(&scheduler, *currentTimeUs, budget, false);
+        if (sensor) {
+            telemetrySchedulerSent(&scheduler, sensor, *currentTimeUs);
+            sent[sensor->id]++;
+        }
+        *currentTimeUs += 1000;
+    }
+}
+
+TEST(TelemetrySchedulerTest, TestCapacity)
+{
+    initScheduler();
+
+    for (unsigned i = 0; i < ARRAYLEN(testSensors); i++) {
+        EXPECT_TRUE(telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 1));
+    }
+    EXPECT_FALSE(telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 1));
+    EXPECT_EQ(ARRAYLEN(testSensors), scheduler.count);
+}
+
+TEST(TelemetrySchedulerTest, TestEmpty)
+{
+    initScheduler();
+
+    EXPECT_EQ(NULL, telemetrySchedulerNext(&scheduler, 0, 100, false));
+    EXPECT_EQ(NULL, telemetrySchedulerNext(&scheduler, 0, 100, true));
+}
+
+TEST(TelemetrySchedulerTest, TestEverySensorSentFirst)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, 1);
+
+    // never sent sensors go first, highest priority first
+    telemetrySensor_t *sensor = telemetrySchedulerNext(&scheduler, 0, 1, false);
+    ASSERT_TRUE(sensor != NULL);
+    EXPECT_EQ(TEST_ATTITUDE, sensor->id);
+    telemetrySchedulerSent(&scheduler, sensor, 0);
+
+    sensor = telemetrySchedulerNext(&scheduler, 0, 1, false);
+    ASSERT_TRUE(sensor != NULL);
+    EXPECT_EQ(TEST_BATTERY, sensor->id);
+    telemetrySchedulerSent(&scheduler, sensor, 0);
+
+    EXPECT_EQ(NULL, telemetrySchedulerNext(&scheduler, 1000, 1, false));
+}
+
+TEST(TelemetrySchedulerTest, TestFixedRate)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_GPS, TELEMETRY_SENSOR_GPS, 1);
+
+    int sent[TEST_SENSOR_COUNT] = { 0 };
+    timeUs_t currentTimeUs = 0;
+    runScheduler(&currentTimeUs, 1000, 1, sent);
+
+    // 20Hz and 5Hz
+    EXPECT_EQ(20, sent[TEST_ATTITUDE]);
+    EXPECT_EQ(5, sent[TEST_GPS]);
+}
+
+TEST(TelemetrySchedulerTest, TestChangeThreshold)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_VARIO, TELEMETRY_SENSOR_VARIO, 1);
+
+    int sent[TEST_SENSOR_COUNT] = { 0 };
+    timeUs_t currentTimeUs = 0;
+
+    // a steady value is only refreshed every 200ms
+    runScheduler(&currentTimeUs, 1000, 1, sent);
+    EXPECT_EQ(5, sent[TEST_VARIO]);
+
+    // small changes do not count
+    sent[TEST_VARIO] = 0;
+    for (int i = 0; i < 1000; i++) {
+        testValue[TEST_VARIO] = i % 2 ? 5 : -4;
+        runScheduler(&currentTimeUs, 1, 1, sent);
+    }
+    EXPECT_EQ(5, sent[TEST_VARIO]);
+
+    // a moving value every 50ms
+    sent[TEST_VARIO] = 0;
+    for (int i = 0; i < 1000; i++) {
+        testValue[TEST_VARIO] = i;
+        runScheduler(&currentTimeUs, 1, 1, sent);
+    }
+    EXPECT_EQ(20, sent[TEST_VARIO]);
+}
+
+TEST(TelemetrySchedulerTest, TestBudget)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, 10);
+    telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 12);
+
+    // only what fits
+    telemetrySensor_t *sensor = telemetrySchedulerNext(&scheduler, 0, 11, false);
+    ASSERT_TRUE(sensor != NULL);
+    EXPECT_EQ(TEST_ATTITUDE, sensor->id);
+    telemetrySchedulerSent(&scheduler, sensor, 0);
+
+    EXPECT_EQ(NULL, telemetrySchedulerNext(&scheduler, 0, 11, false));
+    sensor = telemetrySchedulerNext(&scheduler, 0, 12, false);
+    ASSERT_TRUE(sensor != NULL);
+    EXPECT_EQ(TEST_BATTERY, sensor->id);
+}
+
+TEST(TelemetrySchedulerTest, TestNoStarvation)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_VARIO, TELEMETRY_SENSOR_VARIO, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_GPS, TELEMETRY_SENSOR_GPS, 1);
+
+    // a link that can only carry one frame every 40ms, less than the sensors ask for
+    int sent[TEST_SENSOR_COUNT] = { 0 };
+    timeUs_t currentTimeUs = 0;
+    for (int i = 0; i < 250; i++) {
+        testValue[TEST_VARIO] = i * 100;
+        runScheduler(&currentTimeUs, 1, 1, sent);
+        currentTimeUs += 39000;
+    }
+
+    // every sensor slows down, attitude and vario the least, but battery and GPS still get through
+    EXPECT_EQ(250, sent[TEST_ATTITUDE] + sent[TEST_VARIO] + sent[TEST_BATTERY] + sent[TEST_GPS]);
+    EXPECT_GE(sent[TEST_ATTITUDE], 100);
+    EXPECT_GE(sent[TEST_VARIO], 100);
+    EXPECT_GE(sent[TEST_GPS], 10);
+    EXPECT_GE(sent[TEST_BATTERY], 3);
+}
+
+TEST(TelemetrySchedulerTest, TestFillIdle)
+{
+    initScheduler();
+    telemetrySchedulerAdd(&scheduler, TEST_ATTITUDE, TELEMETRY_SENSOR_ATTITUDE, 1);
+    telemetrySchedulerAdd(&scheduler, TEST_BATTERY, TELEMETRY_SENSOR_BATTERY, 1);
+
+    telemetrySchedulerSent(&scheduler, &testSensors[0], 0);
+    telemetrySchedulerSent(&scheduler, &testSensors[1], 0);
+
+    // nothing due, but a slot that would be wasted gets the most urgent one
+    EXPECT_EQ(NULL, telemetrySchedulerNext(&scheduler, 10000, 1, false));
+    telemetrySensor_t *sensor = telemetrySchedulerNext(&scheduler, 10000, 1, true);
+    ASSERT_TRUE(sensor != NULL);
+    EXPECT_EQ(TEST_ATTITUDE, sensor->id);
+}
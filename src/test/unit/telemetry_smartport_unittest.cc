@@ -0,0 +1,166 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/runtime_config.h"
+
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "sensors/acceleration.h"
+    #include "sensors/battery.h"
+    #include "sensors/sensors.h"
+
+    #include "telemetry/smartport.h"
+    #include "telemetry/telemetry.h"
+
+    PG_REGISTER(telemetryConfig_t, telemetryConfig, PG_TELEMETRY_CONFIG, 0);
+
+    attitudeEulerAngles_t attitude;
+    acc_t acc;
+    gpsSolutionData_t gpsSol;
+    uint16_t GPS_distanceToHome;
+    pidProfile_t *currentPidProfile;
+    controlRateConfig_t *currentControlRateProfile;
+
+    timeUs_t testTimeUs;
+    int16_t testVario;
+    uint16_t testFrameCount[UINT16_MAX + 1];
+    int testFrames;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// data ids as sent by the FC
+#define TEST_DATAID_VFAS        0x0210
+#define TEST_DATAID_CURRENT     0x0200
+#define TEST_DATAID_FUEL        0x0600
+#define TEST_DATAID_A4          0x0910
+#define TEST_DATAID_ALTITUDE    0x0100
+#define TEST_DATAID_VARIO       0x0110
+#define TEST_DATAID_HEADING     0x0840
+#define TEST_DATAID_ACCX        0x0700
+#define TEST_DATAID_T1          0x0400
+#define TEST_DATAID_T2          0x0410
+#define TEST_DATAID_LATLONG     0x0800
+#define TEST_DATAID_SPEED       0x0830
+
+static void testWriteFrame(const smartPortPayload_t *payload)
+{
+    EXPECT_EQ(FSSP_DATA_FRAME, payload->frameId);
+    testFrameCount[payload->valueId]++;
+    testFrames++;
+}
+
+// The receiver polls the FC sensor id about every 12ms, run it for a while
+static void pollSmartPort(int durationMs)
+{
+    for (int i = 0; i < durationMs / 12; i++) {
+        bool clearToSend = true;
+        processSmartPortTelemetry(NULL, &clearToSend, NULL);
+        EXPECT_FALSE(clearToSend);
+        testTimeUs += 12000;
+        testVario += 20;
+    }
+}
+
+TEST(TelemetrySmartPortTest, TestSensorRates)
+{
+    // given
+    acc.dev.acc_1G = 512;
+    sensorsSet(SENSOR_ACC | SENSOR_BARO);
+    ENABLE_STATE(GPS_FIX);
+    testTimeUs = 1000000;
+    EXPECT_TRUE(initSmartPortTelemetryExternal(testWriteFrame));
+
+    // when
+    pollSmartPort(200);
+    memset(testFrameCount, 0, sizeof(testFrameCount));
+    testFrames = 0;
+    pollSmartPort(2000);
+
+    // then every poll was answered
+    EXPECT_EQ(2000 / 12, testFrames);
+
+    // heading and a moving vario at close to 20Hz
+    EXPECT_GE(testFrameCount[TEST_DATAID_HEADING], 30);
+    EXPECT_GE(testFrameCount[TEST_DATAID_VARIO], 30);
+
+    // the rest keeps coming
+    EXPECT_GE(testFrameCount[TEST_DATAID_ALTITUDE], 2);
+    EXPECT_GE(testFrameCount[TEST_DATAID_ACCX], 2);
+    EXPECT_GE(testFrameCount[TEST_DATAID_T1], 2);
+    EXPECT_GE(testFrameCount[TEST_DATAID_T2], 2);
+    EXPECT_GE(testFrameCount[TEST_DATAID_VFAS], 1);
+    EXPECT_GE(testFrameCount[TEST_DATAID_CURRENT], 1);
+    EXPECT_GE(testFrameCount[TEST_DATAID_FUEL], 1);
+    EXPECT_GE(testFrameCount[TEST_DATAID_A4], 1);
+    EXPECT_GE(testFrameCount[TEST_DATAID_SPEED], 2);
+    // latitude and longitude take turns
+    EXPECT_GE(testFrameCount[TEST_DATAID_LATLONG], 4);
+
+    // attitude and vario get more than the slow values
+    EXPECT_GT(testFrameCount[TEST_DATAID_HEADING], 2 * testFrameCount[TEST_DATAID_SPEED]);
+    EXPECT_GT(testFrameCount[TEST_DATAID_VARIO], 2 * testFrameCount[TEST_DATAID_T1]);
+}
+
+// STUBS
+
+extern "C" {
+
+timeUs_t micros(void) { return testTimeUs; }
+
+bool feature(uint32_t) { return true; }
+
+void beeperConfirmationBeeps(uint8_t) {}
+void imuRefreshEulerAngles(void) {}
+
+int32_t getEstimatedAltitude(void) { return 0; }
+int16_t getEstimatedVario(void) { return testVario; }
+
+bool isBatteryVoltageConfigured(void) { return true; }
+bool isAmperageConfigured(void) { return true; }
+uint16_t getBatteryVoltage(void) { return 168; }
+uint8_t getBatteryCellCount(void) { return 4; }
+int32_t getAmperage(void) { return 1000; }
+int32_t getMAhDrawn(void) { return 100; }
+
+uint32_t serialRxBytesWaiting(const serialPort_t *) { return 0; }
+uint8_t serialRead(serialPort_t *) { return 0; }
+void serialWrite(serialPort_t *, uint8_t) {}
+serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
+void closeSerialPort(serialPort_t *) {}
+serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return NULL; }
+portSharing_e determinePortSharing(const serialPortConfig_t *, serialPortFunction_e) { return PORTSHARING_NOT_SHARED; }
+bool telemetryDetermineEnabledState(portSharing_e) { return true; }
+
+}
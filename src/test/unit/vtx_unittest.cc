@@ -114,6 +114,8 @@ extern "C" {
     uint32_t micros(void) { return simulationTime; }
     uint32_t millis(void) { return micros() / 1000; }
     bool rxIsReceivingSignal(void) { return simulationHaveRx; }
+    void imuRefreshEulerAngles(void) {}
+    void imuPropagateAttitude(float) {}
 
     bool feature(uint32_t f) { return simulationFeatureFlags & f; }
     void warningLedFlash(void) {}
@@ -33,8 +33,33 @@ extern "C" {
 extern "C" {
 STATIC_UNIT_TESTED extern uint16_t dmaBufferOffset;
 
-STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(rgbColor24bpp_t *color);
+STATIC_UNIT_TESTED void fastUpdateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color);
 STATIC_UNIT_TESTED void updateLEDDMABuffer(uint8_t componentValue);
+
+static int hsvToRgb24CallCount;
+}
+
+#define TEST_BIT_COMPARE_1 67
+#define TEST_BIT_COMPARE_0 33
+
+static void initStrip(void)
+{
+    BIT_COMPARE_1 = TEST_BIT_COMPARE_1;
+    BIT_COMPARE_0 = TEST_BIT_COMPARE_0;
+    ws2811LedDataTransferInProgress = 0;
+    ws2811LedStripInit(IO_TAG_NONE);
+    ws2811LedDataTransferInProgress = 0;
+    hsvToRgb24CallCount = 0;
+}
+
+// the test colour conversion maps h, s, v straight onto r, g, b
+static void expectLedEncoded(int ledIndex, uint8_t first, uint8_t second, uint8_t third)
+{
+    const uint32_t packed = (first << 16) | (second << 8) | third;
+    for (int bit = 0; bit < WS2811_BITS_PER_LED; bit++) {
+        const uint16_t expected = (packed & (1 << (23 - bit))) ? TEST_BIT_COMPARE_1 : TEST_BIT_COMPARE_0;
+        EXPECT_EQ(expected, ledStripDMABuffer[ledIndex * WS2811_BITS_PER_LED + bit]);
+    }
 }
 
 TEST(WS2812, updateDMABuffer) {
@@ -42,6 +67,7 @@ TEST(WS2812, updateDMABuffer) {
     rgbColor24bpp_t color1 = { .raw = {0xFF,0xAA,0x55} };
 
     // and
+    initStrip();
     dmaBufferOffset = 0;
 
     // when
@@ -50,7 +76,7 @@ TEST(WS2812, updateDMABuffer) {
     updateLEDDMABuffer(color1.rgb.r);
     updateLEDDMABuffer(color1.rgb.b);
 #else
-    fastUpdateLEDDMABuffer(&color1);
+    fastUpdateLEDDMABuffer(LED_GRB, &color1);
 #endif
 
     // then
@@ -90,10 +116,105 @@ TEST(WS2812, updateDMABuffer) {
     byteIndex++;
 }
 
+TEST(WS2812, initEncodesWholeStrip) {
+    // when
+    initStrip();
+
+    // then
+    for (int i = 0; i < WS2811_LED_STRIP_LENGTH; i++) {
+        expectLedEncoded(i, 0, 255, 255);
+    }
+
+    // and the reset period stays low
+    for (int i = WS2811_DATA_BUFFER_SIZE; i < WS2811_DMA_BUFFER_SIZE; i++) {
+        EXPECT_EQ(0, ledStripDMABuffer[i]);
+    }
+}
+
+TEST(WS2812, onlyChangedLedsAreEncoded) {
+    // given
+    initStrip();
+    const hsvColor_t red = { 0, 10, 20 };
+
+    // and
+    ledStripDMABuffer[5 * WS2811_BITS_PER_LED] = 0;
+
+    // when
+    setLedHsv(3, &red);
+    ws2811UpdateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(1, hsvToRgb24CallCount);
+    expectLedEncoded(3, 0, 10, 20);
+    EXPECT_EQ(0, ledStripDMABuffer[5 * WS2811_BITS_PER_LED]);
+}
+
+TEST(WS2812, ledRestoredBeforeUpdateIsNotEncoded) {
+    // given
+    initStrip();
+    const hsvColor_t white = { 0, 255, 255 };
+    const hsvColor_t black = { 0, 0, 0 };
+
+    // when
+    setLedHsv(7, &black);
+    setLedValue(8, 0);
+    setLedHsv(7, &white);
+    setLedValue(8, 255);
+    ws2811UpdateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(0, hsvToRgb24CallCount);
+}
+
+TEST(WS2812, ledsAreKeptDirtyWhileTransferInProgress) {
+    // given
+    initStrip();
+    const hsvColor_t color = { 1, 2, 3 };
+
+    // when
+    ws2811LedDataTransferInProgress = 1;
+    setLedHsv(0, &color);
+    ws2811UpdateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(0, hsvToRgb24CallCount);
+
+    // when
+    ws2811LedDataTransferInProgress = 0;
+    ws2811UpdateStrip(LED_RGB);
+
+    // then
+    EXPECT_EQ(1, hsvToRgb24CallCount);
+    expectLedEncoded(0, 1, 2, 3);
+}
+
+TEST(WS2812, formatChangeEncodesWholeStrip) {
+    // given
+    initStrip();
+    const hsvColor_t color = { 1, 2, 3 };
+    setStripColor(&color);
+    ws2811UpdateStrip(LED_RGB);
+    ws2811LedDataTransferInProgress = 0;
+    hsvToRgb24CallCount = 0;
+
+    // when
+    ws2811UpdateStrip(LED_GRB);
+
+    // then
+    EXPECT_EQ(WS2811_LED_STRIP_LENGTH, hsvToRgb24CallCount);
+    for (int i = 0; i < WS2811_LED_STRIP_LENGTH; i++) {
+        expectLedEncoded(i, 2, 1, 3);
+    }
+}
+
 extern "C" {
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t *c) {
-    UNUSED(c);
-    return NULL;
+    static rgbColor24bpp_t rgb;
+    hsvToRgb24CallCount++;
+    rgb.rgb.r = c->h;
+    rgb.rgb.g = c->s;
+    rgb.rgb.b = c->v;
+    return &rgb;
 }
 
 void ws2811LedStripHardwareInit(ioTag_t ioTag) {